@@ -75,6 +75,7 @@ _(ACL_DEL, acl_del)				\
 _(ACL_INTERFACE_ADD_DEL, acl_interface_add_del)	\
 _(ACL_INTERFACE_SET_ACL_LIST, acl_interface_set_acl_list)	\
 _(ACL_DUMP, acl_dump)  \
+_(ACL_GET, acl_get)  \
 _(ACL_INTERFACE_LIST_DUMP, acl_interface_list_dump) \
 _(MACIP_ACL_ADD, macip_acl_add) \
 _(MACIP_ACL_ADD_REPLACE, macip_acl_add_replace) \
@@ -2612,6 +2613,22 @@ vl_api_acl_dump_t_handler (vl_api_acl_dump_t * mp)
     }
 }
 
+static void
+vl_api_acl_get_t_handler (vl_api_acl_get_t * mp)
+{
+  acl_main_t *am = &acl_main;
+  vl_api_acl_get_reply_t *rmp;
+  int rv = 0;
+
+  /* *INDENT-OFF* */
+  REPLY_AND_DETAILS_MACRO (VL_API_ACL_GET_REPLY, am->acls,
+  ({
+    send_acl_details (am, rp, pool_elt_at_index (am->acls, cursor),
+                      mp->context);
+  }));
+  /* *INDENT-ON* */
+}
+
 static void
 send_acl_interface_list_details (acl_main_t * am,
 				 vl_api_registration_t * reg,
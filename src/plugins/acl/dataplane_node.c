@@ -559,6 +559,7 @@ VNET_FEATURE_INIT (acl_in_ip6_fa_feature, static) =
   .arc_name = "ip6-unicast",
   .node_name = "acl-plugin-in-ip6-fa",
   .runs_before = VNET_FEATURES ("ip6-flow-classify"),
+  .runs_after = VNET_FEATURES ("ip6-flow-cache"),
 };
 
 VLIB_REGISTER_NODE (acl_in_fa_ip4_node) =
@@ -581,6 +582,8 @@ VNET_FEATURE_INIT (acl_in_ip4_fa_feature, static) =
   .arc_name = "ip4-unicast",
   .node_name = "acl-plugin-in-ip4-fa",
   .runs_before = VNET_FEATURES ("ip4-flow-classify"),
+  .runs_after = VNET_FEATURES ("ip4-sv-reassembly-feature",
+                               "ip4-flow-cache"),
 };
 
 
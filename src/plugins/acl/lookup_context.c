@@ -16,6 +16,7 @@
 #include <plugins/acl/acl.h>
 #include <plugins/acl/fa_node.h>
 #include <vlib/unix/plugin.h>
+#include <vnet/ip/ip_flow_cache.h>
 #include <plugins/acl/public_inlines.h>
 #include "hash_lookup.h"
 #include "elog_acl_trace.h"
@@ -256,6 +257,8 @@ static int acl_plugin_set_acl_vec_for_context (u32 lc_index, u32 *acl_list)
   unlock_acl_vec(lc_index, old_acl_vector);
   lock_acl_vec(lc_index, acontext->acl_indices);
   apply_acl_vec(lc_index, acontext->acl_indices);
+  /* the flows permitted by the old ACLs may be cached */
+  ip_flow_cache_invalidate();
 
   vec_free(old_acl_vector);
 
@@ -279,6 +282,8 @@ void acl_plugin_lookup_context_notify_acl_change(u32 acl_num)
     /* this is a deletion notification */
     hash_acl_delete(am, acl_num);
   }
+  /* the flows permitted by the ACL may be cached */
+  ip_flow_cache_invalidate();
 }
 
 
@@ -19,6 +19,7 @@
 #include <stdint.h>
 
 #include <vlib/unix/plugin.h>
+#include <vnet/ip/ip4_sv_reass.h>
 #include <plugins/acl/acl.h>
 #include <plugins/acl/fa_node.h>
 #include <plugins/acl/hash_lookup_private.h>
@@ -218,6 +219,31 @@ acl_fill_5tuple_l4_and_pkt_data (acl_main_t * am, u32 sw_if_index0, vlib_buffer_
   p5tuple_l4->as_u64 = tmp_l4.as_u64;
 }
 
+/*
+ * A TCP or UDP non-first fragment annotated by ip4 shallow virtual
+ * reassembly is matched with the ports and flags of its first fragment,
+ * so that it hits the same rules and session as the rest of its packet.
+ */
+always_inline void
+acl_fill_5tuple_l4_from_reass (vlib_buffer_t * b0, int l3_offset,
+                               fa_5tuple_t * p5tuple_pkt)
+{
+  ip4_header_t *ip4 = get_ptr_to_offset (b0, l3_offset);
+  u16 ports[2];
+
+  if (!ip4_sv_reass_get_l4_ports (b0, ip4, ports))
+    return;
+
+  p5tuple_pkt->l4.port[0] = clib_net_to_host_u16 (ports[0]);
+  p5tuple_pkt->l4.port[1] = clib_net_to_host_u16 (ports[1]);
+  p5tuple_pkt->l4.is_slowpath = 0;
+  p5tuple_pkt->pkt.tcp_flags =
+    vnet_buffer (b0)->ip.reass.icmp_type_or_tcp_flags;
+  p5tuple_pkt->pkt.tcp_flags_valid = (IP_PROTOCOL_TCP == ip4->protocol);
+  p5tuple_pkt->pkt.l4_valid = 1;
+  p5tuple_pkt->pkt.is_nonfirst_fragment = 0;
+}
+
 always_inline void
 acl_fill_5tuple (acl_main_t * am, u32 sw_if_index0, vlib_buffer_t * b0, int is_ip6,
 		 int is_input, int is_l2_path, fa_5tuple_t * p5tuple_pkt)
@@ -240,6 +266,11 @@ acl_fill_5tuple (acl_main_t * am, u32 sw_if_index0, vlib_buffer_t * b0, int is_i
   /* Remainder of the key and per-packet non-key data */
   acl_fill_5tuple_l3_data(am, b0, is_ip6, l3_offset, p5tuple_pkt);
   acl_fill_5tuple_l4_and_pkt_data(am, sw_if_index0, b0, is_ip6, is_input, l3_offset, &p5tuple_pkt->l4, &p5tuple_pkt->pkt);
+
+  /* the annotation is only there on the ip4-unicast arc */
+  if (!is_ip6 && is_input && !is_l2_path &&
+      PREDICT_FALSE (p5tuple_pkt->pkt.is_nonfirst_fragment))
+    acl_fill_5tuple_l4_from_reass (b0, l3_offset, p5tuple_pkt);
 }
 
 always_inline void
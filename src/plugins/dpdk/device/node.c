@@ -45,19 +45,23 @@ enum
   DPDK_RX_F_CKSUM_GOOD = 7,
   DPDK_RX_F_CKSUM_BAD = 4,
   DPDK_RX_F_FDIR = 2,
+  DPDK_RX_F_L4_CKSUM_GOOD = 8,
 };
 
 /* currently we are just copying bit positions from DPDK, but that
    might change in future, in case we strart to be interested in something
-   stored in upper bytes. Curently we store only lower byte for perf reasons */
+   stored in upper bytes. Curently we store only lower 16 bits for perf
+   reasons */
 STATIC_ASSERT (1 << DPDK_RX_F_CKSUM_GOOD == PKT_RX_IP_CKSUM_GOOD, "");
 STATIC_ASSERT (1 << DPDK_RX_F_CKSUM_BAD == PKT_RX_IP_CKSUM_BAD, "");
 STATIC_ASSERT (1 << DPDK_RX_F_FDIR == PKT_RX_FDIR, "");
-STATIC_ASSERT ((PKT_RX_IP_CKSUM_GOOD | PKT_RX_IP_CKSUM_BAD | PKT_RX_FDIR) <
-	       256, "dpdk flags not un lower byte, fix needed");
+STATIC_ASSERT (1 << DPDK_RX_F_L4_CKSUM_GOOD == PKT_RX_L4_CKSUM_GOOD, "");
+STATIC_ASSERT ((PKT_RX_IP_CKSUM_GOOD | PKT_RX_IP_CKSUM_BAD | PKT_RX_FDIR |
+		PKT_RX_L4_CKSUM_GOOD) < 65536,
+	       "dpdk flags not in lower 16 bits, fix needed");
 
 always_inline u32
-dpdk_rx_next (vlib_node_runtime_t * node, u16 etype, u8 flags)
+dpdk_rx_next (vlib_node_runtime_t * node, u16 etype, u16 flags)
 {
   if (PREDICT_TRUE (etype == clib_host_to_net_u16 (ETHERNET_TYPE_IP4)))
     {
@@ -195,16 +199,16 @@ dpdk_prefetch_buffer_data_x4 (struct rte_mbuf *mb[])
       <code>xd->per_interface_next_index</code>
 */
 
-static_always_inline u8
-dpdk_ol_flags_extract (struct rte_mbuf **mb, u8 * flags, int count)
+static_always_inline u16
+dpdk_ol_flags_extract (struct rte_mbuf **mb, u16 * flags, int count)
 {
-  u8 rv = 0;
+  u16 rv = 0;
   int i;
   for (i = 0; i < count; i++)
     {
-      /* all flags we are interested in are in lower 8 bits but
+      /* all flags we are interested in are in lower 16 bits but
          that might change */
-      flags[i] = (u8) mb[i]->ol_flags;
+      flags[i] = (u16) mb[i]->ol_flags;
       rv |= flags[i];
     }
   return rv;
@@ -212,7 +216,7 @@ dpdk_ol_flags_extract (struct rte_mbuf **mb, u8 * flags, int count)
 
 static_always_inline uword
 dpdk_process_rx_burst (vlib_main_t * vm, dpdk_per_thread_data_t * ptd,
-		       uword n_rx_packets, int maybe_multiseg, u8 * or_flagsp)
+		       uword n_rx_packets, int maybe_multiseg, u16 * or_flagsp)
 {
   u32 n_left = n_rx_packets;
   vlib_buffer_t *b[4];
@@ -220,7 +224,7 @@ dpdk_process_rx_burst (vlib_main_t * vm, dpdk_per_thread_data_t * ptd,
   struct rte_mbuf **mb = ptd->mbufs;
   uword n_bytes = 0;
   i16 off;
-  u8 *flags, or_flags = 0;
+  u16 *flags, or_flags = 0;
   u16 *next;
 
   fl = vlib_buffer_get_free_list (vm, VLIB_BUFFER_DEFAULT_FREE_LIST_INDEX);
@@ -339,7 +343,7 @@ dpdk_set_next_from_etype (vlib_main_t * vm, vlib_node_runtime_t * node,
   i16 adv[4];
   u16 etype[4];
   struct rte_mbuf **mb = ptd->mbufs;
-  u8 *flags = ptd->flags;
+  u16 *flags = ptd->flags;
   u16 *next = ptd->next;
   u32 n_left = n_rx_packets;
 
@@ -443,7 +447,7 @@ dpdk_device_input (vlib_main_t * vm, dpdk_main_t * dm, dpdk_device_t * xd,
   vlib_buffer_t *b0;
   int known_next = 0;
   u16 *next;
-  u8 or_flags;
+  u16 or_flags;
   u32 n;
 
   dpdk_per_thread_data_t *ptd = vec_elt_at_index (dm->per_thread_data,
@@ -526,6 +530,18 @@ dpdk_device_input (vlib_main_t * vm, dpdk_main_t * dm, dpdk_device_t * xd,
 	ptd->next[n] = VNET_DEVICE_INPUT_NEXT_DROP;
       }
 
+  /* TCP/UDP checksums verified by the device need not be verified again */
+  if (PREDICT_FALSE (or_flags & (1 << DPDK_RX_F_L4_CKSUM_GOOD)))
+    for (n = 0; n < n_rx_packets; n++)
+      {
+	if ((ptd->flags[n] & (1 << DPDK_RX_F_L4_CKSUM_GOOD)) == 0)
+	  continue;
+
+	b0 = vlib_buffer_from_rte_mbuf (ptd->mbufs[n]);
+	b0->flags |= (VNET_BUFFER_F_L4_CHECKSUM_COMPUTED |
+		      VNET_BUFFER_F_L4_CHECKSUM_CORRECT);
+      }
+
   /* enqueue buffers to the next node */
   vlib_get_buffer_indices_with_offset (vm, (void **) ptd->mbufs, ptd->buffers,
 				       n_rx_packets,
@@ -315,8 +315,6 @@ gtpu_encap_inline (vlib_main_t * vm,
 	    }
 	  else /* ipv6 */
 	    {
-              int bogus = 0;
-
 	      ip6_0 = vlib_buffer_get_current(b0);
 	      ip6_1 = vlib_buffer_get_current(b1);
 	      ip6_2 = vlib_buffer_get_current(b2);
@@ -377,22 +375,10 @@ gtpu_encap_inline (vlib_main_t * vm,
 	      udp3->src_port = flow_hash3;
 
 	      /* IPv6 UDP checksum is mandatory */
-	      udp0->checksum = ip6_tcp_udp_icmp_compute_checksum(vm, b0,
-								 ip6_0, &bogus);
-	      if (udp0->checksum == 0)
-		udp0->checksum = 0xffff;
-	      udp1->checksum = ip6_tcp_udp_icmp_compute_checksum(vm, b1,
-                                                        ip6_1, &bogus);
-	      if (udp1->checksum == 0)
-		udp1->checksum = 0xffff;
-	      udp2->checksum = ip6_tcp_udp_icmp_compute_checksum(vm, b2,
-								 ip6_2, &bogus);
-	      if (udp2->checksum == 0)
-		udp2->checksum = 0xffff;
-	      udp3->checksum = ip6_tcp_udp_icmp_compute_checksum(vm, b3,
-                                                        ip6_3, &bogus);
-	      if (udp3->checksum == 0)
-		udp3->checksum = 0xffff;
+	      ip6_udp_encap_checksum (vm, b0, ip6_0, udp0);
+	      ip6_udp_encap_checksum (vm, b1, ip6_1, udp1);
+	      ip6_udp_encap_checksum (vm, b2, ip6_2, udp2);
+	      ip6_udp_encap_checksum (vm, b3, ip6_3, udp3);
 
 	      /* Fix GTPU length */
 	      gtpu0 = (gtpu_header_t *)(udp0+1);
@@ -562,8 +548,6 @@ gtpu_encap_inline (vlib_main_t * vm,
 
 	  else /* ip6 path */
 	    {
-              int bogus = 0;
-
 	      ip6_0 = vlib_buffer_get_current(b0);
 	      /* Copy the fixed header */
 	      copy_dst0 = (u64 *) ip6_0;
@@ -584,10 +568,7 @@ gtpu_encap_inline (vlib_main_t * vm,
 	      udp0->src_port = flow_hash0;
 
 	      /* IPv6 UDP checksum is mandatory */
-	      udp0->checksum = ip6_tcp_udp_icmp_compute_checksum(vm, b0,
-								 ip6_0, &bogus);
-	      if (udp0->checksum == 0)
-		udp0->checksum = 0xffff;
+	      ip6_udp_encap_checksum (vm, b0, ip6_0, udp0);
 
 	      /* Fix GTPU length */
 	      gtpu0 = (gtpu_header_t *)(udp0+1);
@@ -1326,6 +1326,114 @@ vl_api_nat44_user_session_dump_t_print (vl_api_nat44_user_session_dump_t * mp,
   FINISH;
 }
 
+/*
+ * The cursor of a paged user session dump is the session index plus one,
+ * so that zero means the start of the user's session list.
+ */
+static int
+nat44_user_session_cursor_valid (snat_main_per_thread_data_t * tsm,
+				 snat_user_t * u, u32 cursor)
+{
+  snat_session_t *s;
+
+  if (!u || 0 == cursor || pool_is_free_index (tsm->sessions, cursor - 1))
+    return 0;
+
+  s = pool_elt_at_index (tsm->sessions, cursor - 1);
+
+  return (s->per_user_list_head_index ==
+	  u->sessions_per_user_list_head_index);
+}
+
+static u32
+nat44_user_session_cursor_next (snat_main_per_thread_data_t * tsm,
+				snat_user_t * u, u32 cursor)
+{
+  dlist_elt_t *elt;
+  snat_session_t *s;
+
+  if (!u)
+    return ~0;
+
+  if (0 == cursor)
+    elt = pool_elt_at_index (tsm->list_pool,
+			     u->sessions_per_user_list_head_index);
+  else
+    {
+      /* the session was deleted since the last page */
+      if (!nat44_user_session_cursor_valid (tsm, u, cursor))
+	return ~0;
+      s = pool_elt_at_index (tsm->sessions, cursor - 1);
+      elt = pool_elt_at_index (tsm->list_pool, s->per_user_index);
+    }
+
+  elt = pool_elt_at_index (tsm->list_pool, elt->next);
+
+  return (~0 == elt->value ? ~0 : elt->value + 1);
+}
+
+static void
+vl_api_nat44_user_session_get_t_handler (vl_api_nat44_user_session_get_t *
+					 mp)
+{
+  vl_api_nat44_user_session_get_reply_t *rmp;
+  snat_main_t *sm = &snat_main;
+  snat_main_per_thread_data_t *tsm;
+  clib_bihash_kv_8_8_t key, value;
+  snat_user_key_t ukey;
+  snat_user_t *u = 0;
+  ip4_header_t ip;
+  int rv = 0;
+
+  if (sm->deterministic)
+    {
+      rv = VNET_API_ERROR_UNSUPPORTED;
+      tsm = 0;
+      goto send;
+    }
+
+  clib_memcpy (&ukey.addr, mp->ip_address, 4);
+  ip.src_address.as_u32 = ukey.addr.as_u32;
+  ukey.fib_index = fib_table_find (FIB_PROTOCOL_IP4, ntohl (mp->vrf_id));
+  key.key = ukey.as_u64;
+  if (sm->num_workers > 1)
+    tsm =
+      vec_elt_at_index (sm->per_thread_data,
+			sm->worker_in2out_cb (&ip, ukey.fib_index));
+  else
+    tsm = vec_elt_at_index (sm->per_thread_data, sm->num_workers);
+  if (!clib_bihash_search_8_8 (&tsm->user_hash, &key, &value))
+    u = pool_elt_at_index (tsm->users, value.value);
+
+send:
+  /* *INDENT-OFF* */
+  REPLY_AND_DETAILS_ITER_MACRO (VL_API_NAT44_USER_SESSION_GET_REPLY,
+    nat44_user_session_cursor_valid (tsm, u, cursor),
+    nat44_user_session_cursor_next (tsm, u, cursor),
+  ({
+    send_nat44_user_session_details (pool_elt_at_index (tsm->sessions,
+                                                        cursor - 1),
+                                     rp, mp->context);
+  }));
+  /* *INDENT-ON* */
+}
+
+static void *
+vl_api_nat44_user_session_get_t_print (vl_api_nat44_user_session_get_t * mp,
+				       void *handle)
+{
+  u8 *s;
+
+  s = format (0, "SCRIPT: nat44_user_session_get ");
+  s = format (s, "ip_address %U vrf_id %d cursor %d max_entries %d\n",
+	      format_ip4_address, mp->ip_address,
+	      clib_net_to_host_u32 (mp->vrf_id),
+	      clib_net_to_host_u32 (mp->cursor),
+	      clib_net_to_host_u32 (mp->max_entries));
+
+  FINISH;
+}
+
 static nat44_lb_addr_port_t *
 unformat_nat44_lb_addr_port (vl_api_nat44_lb_addr_port_t * addr_port_pairs,
 			     u8 addr_port_pair_num)
@@ -3058,6 +3166,7 @@ _(NAT44_ADD_DEL_INTERFACE_ADDR, nat44_add_del_interface_addr)           \
 _(NAT44_INTERFACE_ADDR_DUMP, nat44_interface_addr_dump)                 \
 _(NAT44_USER_DUMP, nat44_user_dump)                                     \
 _(NAT44_USER_SESSION_DUMP, nat44_user_session_dump)                     \
+_(NAT44_USER_SESSION_GET, nat44_user_session_get)                       \
 _(NAT44_INTERFACE_ADD_DEL_OUTPUT_FEATURE,                               \
   nat44_interface_add_del_output_feature)                               \
 _(NAT44_INTERFACE_OUTPUT_FEATURE_DUMP,                                  \
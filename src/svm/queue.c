@@ -27,7 +27,40 @@
 #include <vppinfra/cache.h>
 #include <svm/queue.h>
 #include <vppinfra/time.h>
+#include <vppinfra/lock.h>
 #include <signal.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+static void
+svm_queue_init_sync (svm_queue_t * q)
+{
+  pthread_mutexattr_t attr;
+  pthread_condattr_t cattr;
+
+  memset (&attr, 0, sizeof (attr));
+  memset (&cattr, 0, sizeof (cattr));
+
+  if (pthread_mutexattr_init (&attr))
+    clib_unix_warning ("mutexattr_init");
+  if (pthread_mutexattr_setpshared (&attr, PTHREAD_PROCESS_SHARED))
+    clib_unix_warning ("pthread_mutexattr_setpshared");
+  if (pthread_mutex_init (&q->mutex, &attr))
+    clib_unix_warning ("mutex_init");
+  if (pthread_mutexattr_destroy (&attr))
+    clib_unix_warning ("mutexattr_destroy");
+  if (pthread_condattr_init (&cattr))
+    clib_unix_warning ("condattr_init");
+  /* prints funny-looking messages in the Linux target */
+  if (pthread_condattr_setpshared (&cattr, PTHREAD_PROCESS_SHARED))
+    clib_unix_warning ("condattr_setpshared");
+  if (pthread_cond_init (&q->condvar, &cattr))
+    clib_unix_warning ("cond_init1");
+  if (pthread_condattr_destroy (&cattr))
+    clib_unix_warning ("cond_init2");
+}
 
 /*
  * svm_queue_init
@@ -52,8 +85,6 @@ svm_queue_init (int nels,
 		int elsize, int consumer_pid, int signal_when_queue_non_empty)
 {
   svm_queue_t *q;
-  pthread_mutexattr_t attr;
-  pthread_condattr_t cattr;
 
   q = clib_mem_alloc_aligned (sizeof (svm_queue_t)
 			      + nels * elsize, CLIB_CACHE_LINE_BYTES);
@@ -64,26 +95,247 @@ svm_queue_init (int nels,
   q->consumer_pid = consumer_pid;
   q->signal_when_queue_non_empty = signal_when_queue_non_empty;
 
-  memset (&attr, 0, sizeof (attr));
-  memset (&cattr, 0, sizeof (cattr));
+  svm_queue_init_sync (q);
 
-  if (pthread_mutexattr_init (&attr))
-    clib_unix_warning ("mutexattr_init");
-  if (pthread_mutexattr_setpshared (&attr, PTHREAD_PROCESS_SHARED))
-    clib_unix_warning ("pthread_mutexattr_setpshared");
-  if (pthread_mutex_init (&q->mutex, &attr))
-    clib_unix_warning ("mutex_init");
-  if (pthread_mutexattr_destroy (&attr))
-    clib_unix_warning ("mutexattr_destroy");
-  if (pthread_condattr_init (&cattr))
-    clib_unix_warning ("condattr_init");
-  /* prints funny-looking messages in the Linux target */
-  if (pthread_condattr_setpshared (&cattr, PTHREAD_PROCESS_SHARED))
-    clib_unix_warning ("condattr_setpshared");
-  if (pthread_cond_init (&q->condvar, &cattr))
-    clib_unix_warning ("cond_init1");
-  if (pthread_condattr_destroy (&cattr))
-    clib_unix_warning ("cond_init2");
+  return (q);
+}
+
+/*
+ * Lock-free queues
+ *
+ * Bounded multi-producer / multi-consumer ring. Every slot carries a
+ * sequence number stored after the element data: a slot at position
+ * pos is free for a producer when seq == pos, and holds a message for
+ * the consumer when seq == pos + 1. Producers and consumers claim a
+ * position with a compare-and-swap on lf_tail / lf_head and then own
+ * the slot, so neither side ever takes the queue mutex.
+ *
+ * Wakeups are batched through an event count: a thread about to
+ * sleep samples lf_wake_seq, sets lf_want_wakeup, re-checks the ring
+ * and waits on the lf_wake_seq futex. The other side clears
+ * lf_want_wakeup and bumps lf_wake_seq once, which releases every
+ * thread parked on the old value. A burst of messages therefore costs
+ * at most one syscall, and none at all while the peer is busy. The
+ * futex word lives in the shared segment, which makes this work across
+ * processes without having to pass descriptors around.
+ *
+ * The ring size is rounded up to a power of two so that free-running
+ * u32 positions map onto slots consistently across wrap-around.
+ */
+
+static inline u32 *
+svm_queue_lf_seq (svm_queue_t * q)
+{
+  uword offset = round_pow2 ((uword) q->maxsize * q->elsize, sizeof (u32));
+  return (u32 *) (&q->data[0] + offset);
+}
+
+static inline int
+svm_queue_lf_can_add (svm_queue_t * q)
+{
+  u32 pos = q->lf_tail;
+  return (i32) (svm_queue_lf_seq (q)[pos & (q->maxsize - 1)] - pos) >= 0;
+}
+
+static inline int
+svm_queue_lf_can_sub (svm_queue_t * q)
+{
+  u32 pos = q->lf_head;
+  return (i32) (svm_queue_lf_seq (q)[pos & (q->maxsize - 1)] - pos) > 0;
+}
+
+static void
+svm_queue_lf_wake (svm_queue_t * q)
+{
+  CLIB_MEMORY_BARRIER ();
+  if (PREDICT_TRUE (q->lf_want_wakeup == 0))
+    return;
+  if (!__sync_bool_compare_and_swap (&q->lf_want_wakeup, 1, 0))
+    return;
+
+  __sync_fetch_and_add (&q->lf_wake_seq, 1);
+  syscall (SYS_futex, &q->lf_wake_seq, FUTEX_WAKE, INT_MAX, 0, 0, 0);
+  q->lf_n_wakeups++;
+}
+
+static int
+svm_queue_lf_sleep (svm_queue_t * q, int (*ready) (svm_queue_t *),
+		    f64 deadline)
+{
+  struct timespec ts, *tsp = 0;
+  u32 wake_seq = q->lf_wake_seq;
+  int rv = 0;
+
+  __sync_lock_test_and_set (&q->lf_want_wakeup, 1);
+  CLIB_MEMORY_BARRIER ();
+
+  if (ready (q))
+    return 0;
+
+  if (deadline != 0.0)
+    {
+      f64 left = deadline - unix_time_now ();
+      if (left <= 0.0)
+	return ETIMEDOUT;
+      ts.tv_sec = (time_t) left;
+      ts.tv_nsec = (long) ((left - (f64) ts.tv_sec) * 1e9);
+      tsp = &ts;
+    }
+
+  if (syscall (SYS_futex, &q->lf_wake_seq, FUTEX_WAIT, wake_seq, tsp, 0, 0)
+      < 0 && errno == ETIMEDOUT)
+    rv = ETIMEDOUT;
+
+  return rv;
+}
+
+static inline int
+svm_queue_lf_can_add2 (svm_queue_t * q)
+{
+  u32 pos = q->lf_tail;
+  return (i32) (svm_queue_lf_seq (q)[(pos + 1) & (q->maxsize - 1)]
+		- (pos + 1)) >= 0;
+}
+
+/*
+ * Reserve n (1 or 2) consecutive slots at once, so that the elements of
+ * a pair are never interleaved with those of other producers. Each
+ * element is written before its slot is published, and cursize only
+ * counts published elements.
+ */
+static int
+svm_queue_add_lockfree (svm_queue_t * q, u8 ** elems, u32 n, int nowait)
+{
+  u32 *seq = svm_queue_lf_seq (q);
+  u32 pos, slot, i;
+  i32 diff, diff_last;
+
+  while (1)
+    {
+      pos = q->lf_tail;
+      slot = pos & (q->maxsize - 1);
+      diff = (i32) (seq[slot] - pos);
+      diff_last = (i32) (seq[(pos + n - 1) & (q->maxsize - 1)]
+			 - (pos + n - 1));
+
+      if (diff == 0 && diff_last == 0)
+	{
+	  if (__sync_bool_compare_and_swap (&q->lf_tail, pos, pos + n))
+	    break;
+	}
+      else if (diff < 0 || diff_last < 0)
+	{
+	  /* full */
+	  if (nowait)
+	    return (-2);
+	  svm_queue_lf_sleep (q, n == 1 ? svm_queue_lf_can_add :
+			      svm_queue_lf_can_add2, 0.0);
+	}
+      else
+	CLIB_PAUSE ();
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      slot = (pos + i) & (q->maxsize - 1);
+      clib_memcpy (&q->data[0] + q->elsize * slot, elems[i], q->elsize);
+      CLIB_MEMORY_STORE_BARRIER ();
+      seq[slot] = pos + i + 1;
+    }
+
+  if (__sync_fetch_and_add (&q->cursize, n) == 0
+      && q->signal_when_queue_non_empty)
+    kill (q->consumer_pid, q->signal_when_queue_non_empty);
+
+  svm_queue_lf_wake (q);
+  return 0;
+}
+
+static int
+svm_queue_sub_lockfree (svm_queue_t * q, u8 * elem,
+			svm_q_conditional_wait_t cond, u32 time)
+{
+  u32 *seq = svm_queue_lf_seq (q);
+  f64 deadline = 0.0;
+  u32 pos, slot;
+  i32 diff;
+
+  if (cond == SVM_Q_TIMEDWAIT)
+    deadline = unix_time_now () + time;
+
+  while (1)
+    {
+      pos = q->lf_head;
+      slot = pos & (q->maxsize - 1);
+      diff = (i32) (seq[slot] - (pos + 1));
+
+      if (diff == 0)
+	{
+	  if (__sync_bool_compare_and_swap (&q->lf_head, pos, pos + 1))
+	    break;
+	}
+      else if (diff < 0)
+	{
+	  /* empty */
+	  if (cond == SVM_Q_NOWAIT)
+	    return (-2);
+	  if (svm_queue_lf_sleep (q, svm_queue_lf_can_sub, deadline)
+	      == ETIMEDOUT)
+	    return ETIMEDOUT;
+	}
+      else
+	CLIB_PAUSE ();
+    }
+
+  clib_memcpy (elem, &q->data[0] + q->elsize * slot, q->elsize);
+  CLIB_MEMORY_BARRIER ();
+  seq[slot] = pos + q->maxsize;
+
+  /* Keep the classic fields meaningful for pollers and "show" commands */
+  q->head = (pos + 1) & (q->maxsize - 1);
+
+  /* Producers blocked on a full queue wait for it to drain to half */
+  if (__sync_sub_and_fetch (&q->cursize, 1) <= q->maxsize / 2)
+    svm_queue_lf_wake (q);
+  return 0;
+}
+
+/*
+ * svm_queue_init_lockfree
+ *
+ * Same contract as svm_queue_init, but the queue is served by the
+ * lock-free ring above. nels is rounded up to a power of two.
+ * The mutex and condvar are still initialized, so code which locks the
+ * queue to serialize against other users keeps working.
+ */
+svm_queue_t *
+svm_queue_init_lockfree (int nels,
+			 int elsize, int consumer_pid,
+			 int signal_when_queue_non_empty)
+{
+  svm_queue_t *q;
+  uword data_bytes;
+  u32 *seq;
+  int i;
+
+  nels = max_pow2 (nels);
+  data_bytes = round_pow2 ((uword) nels * elsize, sizeof (u32));
+
+  q = clib_mem_alloc_aligned (sizeof (svm_queue_t) + data_bytes
+			      + nels * sizeof (u32), CLIB_CACHE_LINE_BYTES);
+  memset (q, 0, sizeof (*q));
+
+  q->elsize = elsize;
+  q->maxsize = nels;
+  q->consumer_pid = consumer_pid;
+  q->signal_when_queue_non_empty = signal_when_queue_non_empty;
+  q->flags = SVM_QUEUE_F_LOCKFREE;
+
+  seq = svm_queue_lf_seq (q);
+  for (i = 0; i < nels; i++)
+    seq[i] = i;
+
+  svm_queue_init_sync (q);
 
   return (q);
 }
@@ -126,6 +378,9 @@ svm_queue_add_nolock (svm_queue_t * q, u8 * elem)
   i8 *tailp;
   int need_broadcast = 0;
 
+  if (svm_queue_is_lockfree (q))
+    return svm_queue_add_lockfree (q, &elem, 1, 0 /* nowait */ );
+
   if (PREDICT_FALSE (q->cursize == q->maxsize))
     {
       while (q->cursize == q->maxsize)
@@ -159,6 +414,9 @@ svm_queue_add_raw (svm_queue_t * q, u8 * elem)
 {
   i8 *tailp;
 
+  if (svm_queue_is_lockfree (q))
+    return svm_queue_add_lockfree (q, &elem, 1, 0 /* nowait */ );
+
   if (PREDICT_FALSE (q->cursize == q->maxsize))
     {
       while (q->cursize == q->maxsize)
@@ -186,6 +444,9 @@ svm_queue_add (svm_queue_t * q, u8 * elem, int nowait)
   i8 *tailp;
   int need_broadcast = 0;
 
+  if (svm_queue_is_lockfree (q))
+    return svm_queue_add_lockfree (q, &elem, 1, nowait);
+
   if (nowait)
     {
       /* zero on success */
@@ -241,6 +502,15 @@ svm_queue_add2 (svm_queue_t * q, u8 * elem, u8 * elem2, int nowait)
   i8 *tailp;
   int need_broadcast = 0;
 
+  if (svm_queue_is_lockfree (q))
+    {
+      u8 *elems[2] = { elem, elem2 };
+
+      if (q->maxsize < 2)
+	return (-2);
+      return svm_queue_add_lockfree (q, elems, 2, nowait);
+    }
+
   if (nowait)
     {
       /* zero on success */
@@ -307,6 +577,9 @@ svm_queue_sub (svm_queue_t * q, u8 * elem, svm_q_conditional_wait_t cond,
   int need_broadcast = 0;
   int rc = 0;
 
+  if (svm_queue_is_lockfree (q))
+    return svm_queue_sub_lockfree (q, elem, cond, time);
+
   if (cond == SVM_Q_NOWAIT)
     {
       /* zero on success */
@@ -376,6 +649,9 @@ svm_queue_sub2 (svm_queue_t * q, u8 * elem)
   int need_broadcast;
   i8 *headp;
 
+  if (svm_queue_is_lockfree (q))
+    return svm_queue_sub_lockfree (q, elem, SVM_Q_NOWAIT, 0) ? -1 : 0;
+
   pthread_mutex_lock (&q->mutex);
   if (q->cursize == 0)
     {
@@ -405,6 +681,9 @@ svm_queue_sub_raw (svm_queue_t * q, u8 * elem)
 {
   i8 *headp;
 
+  if (svm_queue_is_lockfree (q))
+    return svm_queue_sub_lockfree (q, elem, SVM_Q_WAIT, 0);
+
   if (PREDICT_FALSE (q->cursize == 0))
     {
       while (q->cursize == 0)
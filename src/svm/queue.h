@@ -21,6 +21,7 @@
 #define included_svm_queue_h
 
 #include <pthread.h>
+#include <vppinfra/types.h>
 
 typedef struct _svm_queue
 {
@@ -33,9 +34,23 @@ typedef struct _svm_queue
   int elsize;
   int consumer_pid;
   int signal_when_queue_non_empty;
+  u32 flags;			/* SVM_QUEUE_F_* */
+  /*
+   * Lock-free mode only. Positions are free-running; each slot carries
+   * a sequence number (after the element data) telling producers and
+   * the consumer whose turn it is.
+   */
+  volatile u32 lf_head;		/* consumer position */
+  volatile u32 lf_tail;		/* next position producers reserve */
+  volatile u32 lf_wake_seq;	/* futex word, bumped to wake sleepers */
+  volatile u32 lf_want_wakeup;	/* someone may be parked on lf_wake_seq */
+  u32 lf_n_wakeups;		/* futex wakeups issued */
   char data[0];
 } svm_queue_t;
 
+/** Queue uses per-slot sequence numbers and futex wakeups, no mutex */
+#define SVM_QUEUE_F_LOCKFREE (1 << 0)
+
 typedef enum
 {
   /**
@@ -58,6 +73,10 @@ svm_queue_t *svm_queue_init (int nels,
 			     int elsize,
 			     int consumer_pid,
 			     int signal_when_queue_non_empty);
+svm_queue_t *svm_queue_init_lockfree (int nels,
+				      int elsize,
+				      int consumer_pid,
+				      int signal_when_queue_non_empty);
 void svm_queue_free (svm_queue_t * q);
 int svm_queue_add (svm_queue_t * q, u8 * elem, int nowait);
 int svm_queue_add2 (svm_queue_t * q, u8 * elem, u8 * elem2, int nowait);
@@ -71,6 +90,12 @@ int svm_queue_add_nolock (svm_queue_t * q, u8 * elem);
 int svm_queue_sub_raw (svm_queue_t * q, u8 * elem);
 int svm_queue_add_raw (svm_queue_t * q, u8 * elem);
 
+static inline int
+svm_queue_is_lockfree (svm_queue_t * q)
+{
+  return (q->flags & SVM_QUEUE_F_LOCKFREE) != 0;
+}
+
 /*
  * DEPRECATED please use svm_queue_t instead
  */
@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2018 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <svm/queue.h>
+#include <vppinfra/time.h>
+#include <vppinfra/error.h>
+#include <vppinfra/format.h>
+
+#define test_error(_fmt, _args...)			\
+{							\
+    error = clib_error_return (0, _fmt, ##_args);	\
+    goto done;						\
+}
+
+static svm_queue_t *
+test_queue_alloc (int nels, int lockfree)
+{
+  if (lockfree)
+    return svm_queue_init_lockfree (nels, sizeof (uword), getpid (), 0);
+  return svm_queue_init (nels, sizeof (uword), getpid (), 0);
+}
+
+/*
+ * Basic FIFO semantics, including wrap-around and the full / empty
+ * return codes the binary API code relies on.
+ */
+static clib_error_t *
+test1 (int lockfree, int verbose)
+{
+  clib_error_t *error = 0;
+  svm_queue_t *q;
+  uword v;
+  int i, j;
+
+  q = test_queue_alloc (8, lockfree);
+
+  if (svm_queue_sub (q, (u8 *) & v, SVM_Q_NOWAIT, 0) != -2)
+    test_error ("failed: sub from empty queue");
+
+  for (j = 0; j < 5; j++)
+    {
+      for (i = 0; i < 8; i++)
+	{
+	  v = (j << 8) | i;
+	  if (svm_queue_add (q, (u8 *) & v, 1 /* nowait */ ))
+	    test_error ("failed: add %d round %d", i, j);
+	}
+
+      v = ~0;
+      if (svm_queue_add (q, (u8 *) & v, 1 /* nowait */ ) != -2)
+	test_error ("failed: add to full queue");
+      if (q->cursize != 8)
+	test_error ("failed: cursize %d, expected 8", q->cursize);
+
+      for (i = 0; i < 8; i++)
+	{
+	  if (svm_queue_sub2 (q, (u8 *) & v))
+	    test_error ("failed: sub %d round %d", i, j);
+	  if (v != ((j << 8) | i))
+	    test_error ("failed: got %lx, expected %lx", v, (j << 8) | i);
+	}
+      if (q->cursize != 0)
+	test_error ("failed: cursize %d, expected 0", q->cursize);
+    }
+
+  if (svm_queue_sub (q, (u8 *) & v, SVM_Q_TIMEDWAIT, 1) != ETIMEDOUT)
+    test_error ("failed: timed wait on empty queue");
+
+  if (verbose)
+    clib_warning ("%s queue: basic tests OK", lockfree ? "lock-free" :
+		  "mutex");
+done:
+  svm_queue_free (q);
+  return error;
+}
+
+typedef struct
+{
+  svm_queue_t *q;
+  svm_queue_t *reply_q;
+  uword n_msgs;
+} test_thread_args_t;
+
+static void *
+test_producer_fn (void *arg)
+{
+  test_thread_args_t *a = arg;
+  uword i;
+
+  for (i = 1; i <= a->n_msgs; i++)
+    svm_queue_add (a->q, (u8 *) & i, 0 /* nowait */ );
+  return 0;
+}
+
+static void *
+test_echo_fn (void *arg)
+{
+  test_thread_args_t *a = arg;
+  uword i, v;
+
+  for (i = 0; i < a->n_msgs; i++)
+    {
+      svm_queue_sub (a->q, (u8 *) & v, SVM_Q_WAIT, 0);
+      svm_queue_add (a->reply_q, (u8 *) & v, 0 /* nowait */ );
+    }
+  return 0;
+}
+
+/*
+ * Throughput: n_producers threads blast messages at one blocking
+ * consumer, i.e. the binary API input queue pattern.
+ * Latency: one request / reply ping-pong between two threads.
+ */
+static clib_error_t *
+test_perf (int lockfree, int n_producers, uword n_msgs)
+{
+  test_thread_args_t args;
+  pthread_t threads[16];
+  clib_error_t *error = 0;
+  svm_queue_t *q, *reply_q;
+  uword i, v, sum = 0;
+  f64 t0, dt;
+
+  n_producers = clib_min (n_producers, ARRAY_LEN (threads));
+  q = test_queue_alloc (1024, lockfree);
+  reply_q = test_queue_alloc (1024, lockfree);
+  args.q = q;
+  args.reply_q = reply_q;
+  args.n_msgs = n_msgs;
+
+  t0 = unix_time_now ();
+  for (i = 0; i < n_producers; i++)
+    pthread_create (&threads[i], 0, test_producer_fn, &args);
+  for (i = 0; i < n_msgs * n_producers; i++)
+    {
+      svm_queue_sub (q, (u8 *) & v, SVM_Q_WAIT, 0);
+      sum += v;
+    }
+  dt = unix_time_now () - t0;
+  for (i = 0; i < n_producers; i++)
+    pthread_join (threads[i], 0);
+
+  if (sum != n_producers * (n_msgs * (n_msgs + 1) / 2))
+    test_error ("failed: checksum mismatch");
+
+  fformat (stdout, "%-9s %d producer(s): %.2f Mmsgs/sec\n",
+	   lockfree ? "lock-free" : "mutex", n_producers,
+	   (f64) (n_msgs * n_producers) / dt / 1e6);
+
+  t0 = unix_time_now ();
+  pthread_create (&threads[0], 0, test_echo_fn, &args);
+  for (i = 0; i < n_msgs; i++)
+    {
+      svm_queue_add (q, (u8 *) & i, 0 /* nowait */ );
+      svm_queue_sub (reply_q, (u8 *) & v, SVM_Q_WAIT, 0);
+      if (v != i)
+	test_error ("failed: ping-pong reply %lu, expected %lu", v, i);
+    }
+  dt = unix_time_now () - t0;
+  pthread_join (threads[0], 0);
+
+  fformat (stdout, "%-9s round-trip latency: %.2f usec\n",
+	   lockfree ? "lock-free" : "mutex", dt / n_msgs * 1e6);
+
+  if (lockfree)
+    fformat (stdout, "%-9s futex wakeups: %d\n", "lock-free",
+	     q->lf_n_wakeups + reply_q->lf_n_wakeups);
+done:
+  svm_queue_free (q);
+  svm_queue_free (reply_q);
+  return error;
+}
+
+int
+test_svm_queue (unformat_input_t * input)
+{
+  clib_error_t *error = 0;
+  uword n_msgs = 1 << 20;
+  int n_producers = 1;
+  int verbose = 0;
+  int test_id = 0;
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "test1"))
+	test_id = 1;
+      else if (unformat (input, "perf"))
+	test_id = 2;
+      else if (unformat (input, "producers %d", &n_producers))
+	;
+      else if (unformat (input, "msgs %lu", &n_msgs))
+	;
+      else if (unformat (input, "verbose"))
+	verbose = 1;
+      else
+	{
+	  error = clib_error_create ("unknown input `%U'\n",
+				     format_unformat_error, input);
+	  goto out;
+	}
+    }
+
+  switch (test_id)
+    {
+    case 1:
+      if ((error = test1 (0 /* lockfree */ , verbose)))
+	break;
+      error = test1 (1 /* lockfree */ , verbose);
+      break;
+    case 2:
+      if ((error = test_perf (0 /* lockfree */ , n_producers, n_msgs)))
+	break;
+      error = test_perf (1 /* lockfree */ , n_producers, n_msgs);
+      break;
+    }
+out:
+  if (error)
+    clib_error_report (error);
+  else
+    clib_warning ("success");
+
+  return error != 0;
+}
+
+int
+main (int argc, char *argv[])
+{
+  unformat_input_t i;
+  int r;
+
+  clib_mem_init (0, 64 << 20);
+  unformat_init_command_line (&i, argv);
+  r = test_svm_queue (&i);
+  unformat_free (&i);
+  return r;
+}
+
+/*
+ * fd.io coding-style-patch-verification: ON
+ *
+ * Local Variables:
+ * eval: (c-set-style "gnu")
+ * End:
+ */
@@ -5362,6 +5362,7 @@ _(l2fib_add_del_reply)                                  \
 _(l2fib_flush_int_reply)                                \
 _(l2fib_flush_bd_reply)                                 \
 _(ip_add_del_route_reply)                               \
+_(ip_route_add_del_bulk_reply)                          \
 _(ip_table_add_del_reply)                               \
 _(ip_mroute_add_del_reply)                              \
 _(mpls_route_add_del_reply)                             \
@@ -5576,6 +5577,7 @@ _(BOND_DETACH_SLAVE_REPLY, bond_detach_slave_reply)			\
 _(SW_INTERFACE_BOND_DETAILS, sw_interface_bond_details)                 \
 _(SW_INTERFACE_SLAVE_DETAILS, sw_interface_slave_details)               \
 _(IP_ADD_DEL_ROUTE_REPLY, ip_add_del_route_reply)			\
+_(IP_ROUTE_ADD_DEL_BULK_REPLY, ip_route_add_del_bulk_reply)		\
 _(IP_TABLE_ADD_DEL_REPLY, ip_table_add_del_reply)			\
 _(IP_MROUTE_ADD_DEL_REPLY, ip_mroute_add_del_reply)			\
 _(MPLS_TABLE_ADD_DEL_REPLY, mpls_table_add_del_reply)			\
@@ -7890,6 +7892,7 @@ api_tap_create_v2 (vat_main_t * vam)
   u32 host_ip6_prefix_len = 0;
   int ret;
   u32 rx_ring_sz = 0, tx_ring_sz = 0;
+  u8 gso_enabled = 0;
 
   memset (mac_address, 0, sizeof (mac_address));
 
@@ -7927,6 +7930,8 @@ api_tap_create_v2 (vat_main_t * vam)
 	;
       else if (unformat (i, "tx-ring-size %d", &tx_ring_sz))
 	;
+      else if (unformat (i, "gso"))
+	gso_enabled = 1;
       else
 	break;
     }
@@ -7989,6 +7994,7 @@ api_tap_create_v2 (vat_main_t * vam)
   mp->host_ip6_addr_set = host_ip6_prefix_len != 0;
   mp->rx_ring_sz = ntohs (rx_ring_sz);
   mp->tx_ring_sz = ntohs (tx_ring_sz);
+  mp->gso_enabled = gso_enabled;
 
   if (random_mac == 0)
     clib_memcpy (mp->mac_address, mac_address, 6);
@@ -8590,6 +8596,176 @@ api_ip_add_del_route (vat_main_t * vam)
   return (vam->retval);
 }
 
+/*
+ * Add / delete 'count' consecutive prefixes, 'batch' routes per message
+ */
+static int
+api_ip_route_add_del_bulk (vat_main_t * vam)
+{
+  unformat_input_t *i = vam->input;
+  vl_api_ip_route_add_del_bulk_t *mp;
+  vl_api_ip_bulk_route_t *route;
+  u32 sw_if_index = ~0, vrf_id = 0, next_hop_table_id = 0;
+  u32 next_hop_weight = 1, dst_address_length = 0;
+  u8 is_ipv6 = 0, is_add = 1, is_drop = 0, is_local = 0;
+  u8 address_set = 0, address_length_set = 0, next_hop_set = 0;
+  ip4_address_t v4_dst_address, v4_next_hop_address;
+  ip6_address_t v6_dst_address, v6_next_hop_address;
+  u32 count = 1, batch = 256, n_msgs = 0, n, j;
+  f64 before, after;
+  int ret;
+
+  /* Parse args required to build the message */
+  while (unformat_check_input (i) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (i, "%U", api_unformat_sw_if_index, vam, &sw_if_index))
+	;
+      else if (unformat (i, "sw_if_index %d", &sw_if_index))
+	;
+      else if (unformat (i, "%U", unformat_ip4_address, &v4_dst_address))
+	{
+	  address_set = 1;
+	  is_ipv6 = 0;
+	}
+      else if (unformat (i, "%U", unformat_ip6_address, &v6_dst_address))
+	{
+	  address_set = 1;
+	  is_ipv6 = 1;
+	}
+      else if (unformat (i, "/%d", &dst_address_length))
+	address_length_set = 1;
+      else if (is_ipv6 == 0 && unformat (i, "via %U", unformat_ip4_address,
+					 &v4_next_hop_address))
+	next_hop_set = 1;
+      else if (is_ipv6 == 1 && unformat (i, "via %U", unformat_ip6_address,
+					 &v6_next_hop_address))
+	next_hop_set = 1;
+      else if (unformat (i, "weight %d", &next_hop_weight))
+	;
+      else if (unformat (i, "drop"))
+	is_drop = 1;
+      else if (unformat (i, "local"))
+	is_local = 1;
+      else if (unformat (i, "del"))
+	is_add = 0;
+      else if (unformat (i, "add"))
+	is_add = 1;
+      else if (unformat (i, "vrf %d", &vrf_id))
+	;
+      else if (unformat (i, "next-hop-table %d", &next_hop_table_id))
+	;
+      else if (unformat (i, "count %d", &count))
+	;
+      else if (unformat (i, "batch %d", &batch))
+	;
+      else
+	{
+	  clib_warning ("parse error '%U'", format_unformat_error, i);
+	  return -99;
+	}
+    }
+
+  if (is_add && !next_hop_set && !is_drop && !is_local)
+    {
+      errmsg ("next hop / local / drop not set");
+      return -99;
+    }
+  if (address_set == 0 || address_length_set == 0)
+    {
+      errmsg ("missing address or address length");
+      return -99;
+    }
+  if (batch == 0 || count == 0)
+    {
+      errmsg ("count and batch must be non-zero");
+      return -99;
+    }
+
+  /* Turn on async mode */
+  vam->async_mode = 1;
+  vam->async_errors = 0;
+  before = vat_time_now (vam);
+
+  for (n = 0; n < count; n += batch)
+    {
+      u32 n_routes = clib_min (batch, count - n);
+
+      /* Construct the API message */
+      M2 (IP_ROUTE_ADD_DEL_BULK, mp, n_routes * sizeof (*route));
+
+      mp->table_id = ntohl (vrf_id);
+      mp->is_add = is_add;
+      mp->is_ipv6 = is_ipv6;
+      mp->n_routes = ntohl (n_routes);
+
+      for (j = 0; j < n_routes; j++)
+	{
+	  route = &mp->routes[j];
+	  memset (route, 0, sizeof (*route));
+	  route->dst_address_length = dst_address_length;
+	  route->path.sw_if_index = ntohl (sw_if_index);
+	  route->path.table_id = ntohl (next_hop_table_id);
+	  route->path.weight = next_hop_weight;
+	  route->path.is_drop = is_drop;
+	  route->path.is_local = is_local;
+	  route->path.via_label = ntohl (MPLS_LABEL_INVALID);
+
+	  if (is_ipv6)
+	    {
+	      route->path.afi = DPO_PROTO_IP6;
+	      clib_memcpy (route->dst_address, &v6_dst_address,
+			   sizeof (v6_dst_address));
+	      if (next_hop_set)
+		clib_memcpy (route->path.next_hop, &v6_next_hop_address,
+			     sizeof (v6_next_hop_address));
+	      increment_v6_address (&v6_dst_address);
+	    }
+	  else
+	    {
+	      route->path.afi = DPO_PROTO_IP4;
+	      clib_memcpy (route->dst_address, &v4_dst_address,
+			   sizeof (v4_dst_address));
+	      if (next_hop_set)
+		clib_memcpy (route->path.next_hop, &v4_next_hop_address,
+			     sizeof (v4_next_hop_address));
+	      increment_v4_address (&v4_dst_address);
+	    }
+	}
+
+      /* send it... */
+      S (mp);
+      n_msgs++;
+
+      /* If we receive SIGTERM, stop now... */
+      if (vam->do_exit)
+	break;
+    }
+
+  /* Shut off async mode and use a control-ping to sync */
+  vam->async_mode = 0;
+  {
+    vl_api_control_ping_t *mp_ping;
+
+    MPING (CONTROL_PING, mp_ping);
+    S (mp_ping);
+  }
+  W (ret);
+
+  if (vam->async_errors > 0)
+    {
+      errmsg ("%d asynchronous errors", vam->async_errors);
+      ret = -98;
+    }
+  vam->async_errors = 0;
+  after = vat_time_now (vam);
+
+  print (vam->ofp, "%d routes in %d messages in %.6f secs, %.2f routes/sec",
+	 clib_min (count, n_msgs * batch), n_msgs, after - before,
+	 clib_min (count, n_msgs * batch) / (after - before));
+
+  return ret;
+}
+
 static int
 api_ip_mroute_add_del (vat_main_t * vam)
 {
@@ -13758,6 +13934,7 @@ api_create_vhost_user_if (vat_main_t * vam)
   u8 hwaddr[6];
   u8 use_custom_mac = 0;
   u8 *tag = 0;
+  u8 enable_gso = 0;
   int ret;
 
   /* Shut up coverity */
@@ -13777,6 +13954,8 @@ api_create_vhost_user_if (vat_main_t * vam)
 	is_server = 1;
       else if (unformat (i, "tag %s", &tag))
 	;
+      else if (unformat (i, "gso"))
+	enable_gso = 1;
       else
 	break;
     }
@@ -13809,6 +13988,7 @@ api_create_vhost_user_if (vat_main_t * vam)
   if (tag)
     strncpy ((char *) mp->tag, (char *) tag, ARRAY_LEN (mp->tag) - 1);
   vec_free (tag);
+  mp->enable_gso = enable_gso;
 
   S (mp);
   W (ret);
@@ -13826,6 +14006,7 @@ api_modify_vhost_user_if (vat_main_t * vam)
   u32 custom_dev_instance = ~0;
   u8 sw_if_index_set = 0;
   u32 sw_if_index = (u32) ~ 0;
+  u8 enable_gso = 0;
   int ret;
 
   while (unformat_check_input (i) != UNFORMAT_END_OF_INPUT)
@@ -13842,6 +14023,8 @@ api_modify_vhost_user_if (vat_main_t * vam)
 	;
       else if (unformat (i, "server"))
 	is_server = 1;
+      else if (unformat (i, "gso"))
+	enable_gso = 1;
       else
 	break;
     }
@@ -13876,6 +14059,7 @@ api_modify_vhost_user_if (vat_main_t * vam)
       mp->renumber = 1;
       mp->custom_dev_instance = ntohl (custom_dev_instance);
     }
+  mp->enable_gso = enable_gso;
 
   S (mp);
   W (ret);
@@ -20902,12 +21086,15 @@ api_pg_create_interface (vat_main_t * vam)
   unformat_input_t *input = vam->input;
   vl_api_pg_create_interface_t *mp;
 
-  u32 if_id = ~0;
+  u32 if_id = ~0, gso_size = 0;
+  u8 gso_enabled = 0;
   int ret;
   while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
     {
       if (unformat (input, "if_id %d", &if_id))
 	;
+      else if (unformat (input, "gso-enabled gso-size %d", &gso_size))
+	gso_enabled = 1;
       else
 	break;
     }
@@ -20921,6 +21108,8 @@ api_pg_create_interface (vat_main_t * vam)
   M (PG_CREATE_INTERFACE, mp);
   mp->context = 0;
   mp->interface_id = ntohl (if_id);
+  mp->gso_enabled = gso_enabled;
+  mp->gso_size = ntohl (gso_size);
 
   S (mp);
   W (ret);
@@ -22179,12 +22368,15 @@ api_sock_init_shm (vat_main_t * vam)
   unformat_input_t *i = vam->input;
   vl_api_shm_elem_config_t *config = 0;
   u64 size = 64 << 20;
+  u8 lockfree = 0;
   int rv;
 
   while (unformat_check_input (i) != UNFORMAT_END_OF_INPUT)
     {
       if (unformat (i, "size %U", unformat_memory_size, &size))
 	;
+      else if (unformat (i, "lockfree"))
+	lockfree = 1;
       else
 	break;
     }
@@ -22218,10 +22410,14 @@ api_sock_init_shm (vat_main_t * vam)
   config[5].size = 4096;
   config[5].count = 2;
 
-  config[6].type = VL_API_QUEUE;
+  config[6].type = lockfree ? VL_API_QUEUE_LOCKFREE : VL_API_QUEUE;
   config[6].count = 128;
   config[6].size = sizeof (uword);
 
+  /* Our own input queue in the new segment follows suit */
+  if (lockfree)
+    vl_set_api_lockfree_queues (1);
+
   rv = vl_socket_client_init_shm (config);
   if (!rv)
     vam->client_index_invalid = 1;
@@ -23183,7 +23379,7 @@ _(tap_delete,                                                           \
   "<vpp-if-name> | sw_if_index <id>")                                   \
 _(sw_interface_tap_dump, "")                                            \
 _(tap_create_v2,                                                        \
-  "id <num> [hw-addr <mac-addr>] [host-ns <name>] [rx-ring-size <num> [tx-ring-size <num>]") \
+  "id <num> [hw-addr <mac-addr>] [host-ns <name>] [rx-ring-size <num> [tx-ring-size <num>] [gso]") \
 _(tap_delete_v2,                                                        \
   "<vpp-if-name> | sw_if_index <id>")                                   \
 _(sw_interface_tap_v2_dump, "")                                         \
@@ -23206,6 +23402,10 @@ _(ip_add_del_route,                                                     \
   "[<intfc> | sw_if_index <id>] [resolve-attempts <n>]\n"               \
   "[weight <n>] [drop] [local] [classify <n>] [del]\n"                  \
   "[multipath] [count <n>]")                                            \
+_(ip_route_add_del_bulk,                                                \
+  "<addr>/<mask> via <addr> [vrf <n>] [next-hop-table <n>]\n"           \
+  "[<intfc> | sw_if_index <id>] [weight <n>] [drop] [local] [del]\n"    \
+  "[count <n>] [batch <n>]")                                            \
 _(ip_mroute_add_del,                                                    \
   "<src> <grp>/<mask> [table-id <n>]\n"                                 \
   "[<intfc> | sw_if_index <id>] [local] [del]")                         \
@@ -23329,10 +23529,10 @@ _(l2_interface_vlan_tag_rewrite,                                        \
   "[translate-2-[1|2]] [push_dot1q 0] tag1 <nn> tag2 <nn>")             \
 _(create_vhost_user_if,                                                 \
         "socket <filename> [server] [renumber <dev_instance>] "         \
-        "[mac <mac_address>]")                                          \
+        "[mac <mac_address>] [gso]")                                    \
 _(modify_vhost_user_if,                                                 \
         "<intfc> | sw_if_index <nn> socket <filename>\n"                \
-        "[server] [renumber <dev_instance>]")                           \
+        "[server] [renumber <dev_instance>] [gso]")                     \
 _(delete_vhost_user_if, "<intfc> | sw_if_index <nn>")                   \
 _(sw_interface_vhost_user_dump, "")                                     \
 _(show_version, "")                                                     \
@@ -23556,7 +23756,7 @@ _(ipfix_classify_table_dump, "")                                        \
 _(sw_interface_span_enable_disable, "[l2] [src <intfc> | src_sw_if_index <id>] [disable | [[dst <intfc> | dst_sw_if_index <id>] [both|rx|tx]]]") \
 _(sw_interface_span_dump, "[l2]")                                           \
 _(get_next_index, "node-name <node-name> next-node-name <node-name>")   \
-_(pg_create_interface, "if_id <nn>")                                    \
+_(pg_create_interface, "if_id <nn> [gso-enabled gso-size <nn>]")        \
 _(pg_capture, "if_id <nnn> pcap <file_name> count <nnn> [disable]")     \
 _(pg_enable_disable, "[stream <id>] disable")                           \
 _(ip_source_and_port_range_check_add_del,                               \
@@ -23594,7 +23794,7 @@ _(lldp_config, "system-name <name> tx-hold <nn> tx-interval <nn>") \
 _(sw_interface_set_lldp, "<intfc> | sw_if_index <nn> [port-desc <description>]\n" \
   " [mgmt-ip4 <ip4>] [mgmt-ip6 <ip6>] [mgmt-oid <object id>] [disable]") \
 _(tcp_configure_src_addresses, "<ip4|6>first-<ip4|6>last [vrf <id>]")	\
-_(sock_init_shm, "size <nnn>")						\
+_(sock_init_shm, "size <nnn> [lockfree]")						\
 _(app_namespace_add_del, "[add] id <ns-id> secret <nn> sw_if_index <nn>")\
 _(dns_enable_disable, "[enable][disable]")				\
 _(dns_name_server_add_del, "<ip-address> [del]")			\
@@ -355,13 +355,16 @@ main (int argc, char **argv)
 	{
 	  vl_set_memory_root_path ((char *) chroot_prefix);
 	}
+      else if (unformat (a, "lockfree-queue"))
+	vl_set_api_lockfree_queues (1);
       else
 	{
 	  fformat
 	    (stderr,
 	     "%s: usage [in <f1> ... in <fn>] [out <fn>] [script] [json]\n"
 	     "[plugin_path <path>][default-socket][socket-name <name>]\n"
-	     "[plugin_name_filter <filter>][chroot prefix <path>]\n",
+	     "[plugin_name_filter <filter>][chroot prefix <path>]\n"
+	     "[lockfree-queue]\n",
 	     argv[0]);
 	  exit (1);
 	}
@@ -188,6 +188,9 @@ typedef struct vlib_main_t
   volatile u32 queue_signal_pending;
   volatile u32 api_queue_nonempty;
   void (*queue_signal_callback) (struct vlib_main_t *);
+
+  /* main thread: called before and after sleeping for input */
+  void (*main_loop_sleep_callback) (struct vlib_main_t *, int is_sleeping);
   u8 **argv;
 
   /* debugging */
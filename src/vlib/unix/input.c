@@ -148,6 +148,9 @@ linux_epoll_input_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
     int timeout_ms = 0, max_timeout_ms = 10;
     f64 vector_rate = vlib_last_vectors_per_main_loop (vm);
 
+    if (is_main && vm->main_loop_sleep_callback)
+      vm->main_loop_sleep_callback (vm, 1 /* is_sleeping */ );
+
     /*
      * If we've been asked for a fixed-sleep between main loop polls,
      * do so right away.
@@ -223,6 +226,9 @@ linux_epoll_input_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 				      em->epoll_events,
 				      vec_len (em->epoll_events), timeout_ms);
 	  }
+
+	if (is_main && vm->main_loop_sleep_callback)
+	  vm->main_loop_sleep_callback (vm, 0 /* is_sleeping */ );
       }
     else
       {
@@ -25,6 +25,7 @@
  */
 
 #include <vppinfra/clib_error.h>
+#include <vppinfra/lock.h>
 #include <svm/svm_common.h>
 #include <svm/queue.h>
 
@@ -129,6 +130,7 @@ typedef struct
   int replay;			/**< is this message to be replayed?  */
   int message_bounce;		/**< do not free message after processing */
   int is_mp_safe;		/**< worker thread barrier required?  */
+  int is_readonly;		/**< may run on the read-only API thread */
 } vl_msg_api_msg_config_t;
 
 /** Message header structure */
@@ -140,6 +142,14 @@ typedef struct msgbuf_
   u8 data[0];			 /**< actual message begins here  */
 } msgbuf_t;
 
+/** Per message type handler latency, in CPU clocks */
+typedef struct
+{
+  u64 count;			/**< number of handler invocations */
+  u64 total_clocks;		/**< sum of handler run times */
+  u64 max_clocks;		/**< longest handler run time */
+} vl_api_msg_latency_t;
+
 /* api_shared.c prototypes */
 void vl_msg_api_handler (void *the_msg);
 void vl_msg_api_handler_no_free (void *the_msg);
@@ -156,6 +166,14 @@ void vl_msg_api_set_handlers (int msg_id, char *msg_name,
 void vl_msg_api_clean_handlers (int msg_id);
 void vl_msg_api_config (vl_msg_api_msg_config_t *);
 void vl_msg_api_set_cleanup_handler (int msg_id, void *fp);
+void vl_msg_api_set_readonly (int msg_id, int is_readonly);
+int vl_msg_api_readonly_offload (void *the_msg);
+void vl_msg_api_readonly_handler (void *the_msg);
+void vl_msg_api_writer_lock (void);
+void vl_msg_api_writer_unlock (void);
+struct vlib_main_t;
+void vl_msg_api_readonly_main_loop_sleep (struct vlib_main_t *vm,
+					  int is_sleeping);
 void vl_msg_api_queue_handler (svm_queue_t * q);
 
 void vl_msg_api_barrier_sync (void) __attribute__ ((weak));
@@ -223,6 +241,12 @@ typedef struct
   /** Message is mp safe vector */
   u8 *is_mp_safe;
 
+  /** Message handler only reads state, may run off the main thread */
+  u8 *is_readonly;
+
+  /** Per message handler latency */
+  vl_api_msg_latency_t *msg_latency;
+
   /** Allocator ring vectors (in shared memory) */
   struct ring_alloc_ *arings;
 
@@ -320,6 +344,9 @@ typedef struct
   /** vpp/vlib input queue length */
   u32 vlib_input_queue_length;
 
+  /** Allocate our input queue(s) as lock-free rings */
+  u8 lockfree_queues;
+
   /** client message index hash table */
   uword *msg_index_by_name_and_crc;
 
@@ -341,6 +368,17 @@ typedef struct
   /** List of API client reaper functions */
   _vl_msg_api_function_list_elt_t *reaper_function_registrations;
 
+  /** vlib/vpp only: read-only handler thread input queue, 0 if disabled */
+  svm_queue_t *readonly_queue;
+
+  /** Held for read by read-only handlers, for write by the main thread
+      except while it sleeps */
+  clib_rwlock_t readonly_lock;
+
+  /** Read-only messages handed to the API thread / run inline */
+  u64 readonly_offloaded;
+  u64 readonly_inline;
+
 } api_main_t;
 
 extern api_main_t api_main;
@@ -106,6 +106,58 @@ do {                                                                    \
     vl_api_send_msg (rp, (u8 *)rmp);                                    \
 } while(0);
 
+/*
+ * Paged dumps. The request carries a cursor, from which to (re)start,
+ * and max_entries, the most entries to visit in this call (0 for no
+ * limit). Details are sent for the entries from the cursor on until the
+ * table is exhausted, max_entries are visited, the client's queue is half
+ * full or the time slice is used up, so that a huge table never stalls
+ * the main thread nor overruns the client. The reply then carries the
+ * cursor to resume from with retval VNET_API_ERROR_EAGAIN, or ~0 and 0
+ * once the table is exhausted. The body may 'continue' to skip an entry.
+ *
+ * valid - expression: is the entry at 'cursor' present
+ * next  - expression: the entry after 'cursor', or ~0
+ */
+#define REPLY_AND_DETAILS_ITER_MACRO(t, valid, next, body)              \
+do {                                                                    \
+    vl_api_registration_t *rp;                                          \
+    u32 cursor, _max_entries, _n_entries = 0;                           \
+    f64 _start;                                                         \
+                                                                        \
+    rp = vl_api_client_index_to_registration (mp->client_index);        \
+    if (rp == 0)                                                        \
+      return;                                                           \
+                                                                        \
+    cursor = ntohl (mp->cursor);                                        \
+    _max_entries = ntohl (mp->max_entries);                             \
+    _start = unix_time_now ();                                          \
+    if (~0 != cursor && !(valid))                                       \
+      cursor = (next);                                                  \
+                                                                        \
+    while (~0 != cursor)                                                \
+      {                                                                 \
+        do {body;} while (0);                                           \
+        cursor = (next);                                                \
+        if ((_max_entries && ++_n_entries >= _max_entries) ||           \
+            !vl_api_details_may_continue (rp, _start, unix_time_now ()))\
+          {                                                             \
+            if (~0 != cursor)                                           \
+              rv = VNET_API_ERROR_EAGAIN;                               \
+            break;                                                      \
+          }                                                             \
+      }                                                                 \
+    REPLY_MACRO2 (t,                                                    \
+    ({                                                                  \
+      rmp->cursor = htonl (cursor);                                     \
+    }));                                                                \
+} while(0);
+
+/* Paged dump over the elements of pool p, the cursor is a pool index */
+#define REPLY_AND_DETAILS_MACRO(t, p, body)                             \
+  REPLY_AND_DETAILS_ITER_MACRO (t, !pool_is_free_index (p, cursor),     \
+                                pool_next_index (p, cursor), body)
+
 /* "trust, but verify" */
 
 static inline uword
@@ -389,6 +389,23 @@ vl_msg_api_barrier_release (void)
 {
 }
 
+always_inline void
+vl_msg_api_latency_update (api_main_t * am, u16 id, u64 t0)
+{
+  vl_api_msg_latency_t *l;
+  u64 dt;
+
+  if (PREDICT_FALSE (id >= vec_len (am->msg_latency)))
+    return;
+
+  dt = clib_cpu_time_now () - t0;
+  l = am->msg_latency + id;
+  l->count++;
+  l->total_clocks += dt;
+  if (dt > l->max_clocks)
+    l->max_clocks = dt;
+}
+
 always_inline void
 msg_handler_internal (api_main_t * am,
 		      void *the_msg, int trace_it, int do_it, int free_it)
@@ -417,6 +434,8 @@ msg_handler_internal (api_main_t * am,
 
       if (do_it)
 	{
+	  u64 t0 = clib_cpu_time_now ();
+
 	  if (!am->is_mp_safe[id])
 	    {
 	      vl_msg_api_barrier_trace_context (am->msg_names[id]);
@@ -425,6 +444,7 @@ msg_handler_internal (api_main_t * am,
 	  (*am->msg_handlers[id]) (the_msg);
 	  if (!am->is_mp_safe[id])
 	    vl_msg_api_barrier_release ();
+	  vl_msg_api_latency_update (am, id, t0);
 	}
     }
   else
@@ -495,6 +515,8 @@ vl_msg_api_handler_with_vm_node (api_main_t * am,
 
   if (id < vec_len (am->msg_handlers) && am->msg_handlers[id])
     {
+      u64 t0 = clib_cpu_time_now ();
+
       handler = (void *) am->msg_handlers[id];
 
       if (am->rx_trace && am->rx_trace->enabled)
@@ -508,6 +530,7 @@ vl_msg_api_handler_with_vm_node (api_main_t * am,
       (*handler) (the_msg, vm, node);
       if (!am->is_mp_safe[id])
 	vl_msg_api_barrier_release ();
+      vl_msg_api_latency_update (am, id, t0);
     }
   else
     {
@@ -658,7 +681,9 @@ _(msg_endian_handlers)                          \
 _(msg_print_handlers)                           \
 _(api_trace_cfg)				\
 _(message_bounce)				\
-_(is_mp_safe)
+_(is_mp_safe)					\
+_(is_readonly)					\
+_(msg_latency)
 
 void
 vl_msg_api_config (vl_msg_api_msg_config_t * c)
@@ -699,6 +724,7 @@ vl_msg_api_config (vl_msg_api_msg_config_t * c)
   am->msg_print_handlers[c->id] = c->print;
   am->message_bounce[c->id] = c->message_bounce;
   am->is_mp_safe[c->id] = c->is_mp_safe;
+  am->is_readonly[c->id] = c->is_readonly;
 
   am->api_trace_cfg[c->id].size = c->size;
   am->api_trace_cfg[c->id].trace_enable = c->traced;
@@ -728,6 +754,7 @@ vl_msg_api_set_handlers (int id, char *name, void *handler, void *cleanup,
   c->replay = 1;
   c->message_bounce = 0;
   c->is_mp_safe = 0;
+  c->is_readonly = 0;
   vl_msg_api_config (c);
 }
 
@@ -753,6 +780,128 @@ vl_msg_api_set_cleanup_handler (int msg_id, void *fp)
   am->msg_cleanup_handlers[msg_id] = fp;
 }
 
+/*
+ * Read-only handlers.
+ *
+ * A handler marked read-only promises to look at, never modify,
+ * forwarding and API state. When the read-only API thread is
+ * configured, such messages arriving on the main shared-memory input
+ * queue are handed to that thread and run under the reader side of
+ * am->readonly_lock.
+ *
+ * The main thread holds the writer side whenever it runs, and lets
+ * readers in only while it sleeps waiting for input, see
+ * vl_msg_api_readonly_main_loop_sleep. Every mutation the main thread
+ * makes - API handlers, CLI, RPCs, control-plane processes - is thus
+ * excluded, not only those made on behalf of an API client, and code
+ * nested in an API handler (a CLI replaying an API trace) never takes
+ * the lock again.
+ *
+ * The main thread cannot resume before the reader is done, so only
+ * handlers doing a bounded amount of work per call, paged dumps, are
+ * to be marked read-only.
+ */
+void
+vl_msg_api_set_readonly (int msg_id, int is_readonly)
+{
+  api_main_t *am = &api_main;
+  ASSERT (msg_id > 0);
+
+  vec_validate (am->is_readonly, msg_id);
+  am->is_readonly[msg_id] = is_readonly;
+}
+
+/*
+ * Try to hand a message to the read-only API thread.
+ * Returns 1 if the thread now owns the message.
+ */
+int
+vl_msg_api_readonly_offload (void *the_msg)
+{
+  api_main_t *am = &api_main;
+  u16 id = ntohs (*((u16 *) the_msg));
+  uword msg = pointer_to_uword (the_msg);
+
+  if (PREDICT_TRUE (am->readonly_queue == 0))
+    return 0;
+
+  if (id >= vec_len (am->is_readonly) || !am->is_readonly[id]
+      || am->message_bounce[id] || am->msg_handlers[id] == 0)
+    return 0;
+
+  /* Keep the rx trace in arrival order */
+  if (am->rx_trace && am->rx_trace->enabled)
+    return 0;
+
+  /* Queue full: run it inline rather than stall the main thread */
+  if (svm_queue_add (am->readonly_queue, (u8 *) & msg, 1 /* nowait */ ))
+    {
+      am->readonly_inline++;
+      return 0;
+    }
+
+  am->readonly_offloaded++;
+  return 1;
+}
+
+/* Runs on the read-only API thread */
+void
+vl_msg_api_readonly_handler (void *the_msg)
+{
+  api_main_t *am = &api_main;
+  u16 id = ntohs (*((u16 *) the_msg));
+  u64 t0;
+
+  clib_rwlock_reader_lock (&am->readonly_lock);
+  t0 = clib_cpu_time_now ();
+  (*am->msg_handlers[id]) (the_msg);
+  vl_msg_api_latency_update (am, id, t0);
+  clib_rwlock_reader_unlock (&am->readonly_lock);
+
+  vl_msg_api_free (the_msg);
+}
+
+/*
+ * Writer side for threads other than the main thread, which already
+ * holds it: they wait for the main thread to sleep. A no-op on the main
+ * thread, so nested callers cannot deadlock.
+ */
+void
+vl_msg_api_writer_lock (void)
+{
+  api_main_t *am = &api_main;
+
+  if (am->readonly_queue && vlib_get_thread_index () != 0)
+    clib_rwlock_writer_lock (&am->readonly_lock);
+}
+
+void
+vl_msg_api_writer_unlock (void)
+{
+  api_main_t *am = &api_main;
+
+  if (am->readonly_queue && vlib_get_thread_index () != 0)
+    clib_rwlock_writer_unlock (&am->readonly_lock);
+}
+
+/*
+ * Main loop sleep callback, main thread only: hand the lock to the
+ * read-only thread while the main thread sleeps, take it back before
+ * anything else runs.
+ */
+void
+vl_msg_api_readonly_main_loop_sleep (vlib_main_t * vm, int is_sleeping)
+{
+  api_main_t *am = &api_main;
+
+  ASSERT (vlib_get_thread_index () == 0);
+
+  if (is_sleeping)
+    clib_rwlock_writer_unlock (&am->readonly_lock);
+  else
+    clib_rwlock_writer_lock (&am->readonly_lock);
+}
+
 void
 vl_msg_api_queue_handler (svm_queue_t * q)
 {
@@ -52,6 +52,31 @@ vl_api_can_send_msg (vl_api_registration_t * rp)
     return vl_mem_api_can_send (rp->vl_input_queue);
 }
 
+/*
+ * Time a paged dump may hold the main thread for in one call
+ */
+#define VL_API_DETAILS_TIME_SLICE (1e-3)
+
+/**
+ * Can a paged dump send another details message to this client?
+ * Only while the client's queue is less than half full, so the reply
+ * and other traffic still fit, and the time slice is not used up.
+ */
+always_inline int
+vl_api_details_may_continue (vl_api_registration_t * rp, f64 start, f64 now)
+{
+  svm_queue_t *q;
+
+  if (now - start > VL_API_DETAILS_TIME_SLICE)
+    return 0;
+
+  if (PREDICT_FALSE (rp->registration_type > REGISTRATION_TYPE_SHMEM))
+    return 1;
+
+  q = rp->vl_input_queue;
+  return (q->cursize < q->maxsize / 2);
+}
+
 always_inline vl_api_registration_t *
 vl_api_client_index_to_registration (u32 index)
 {
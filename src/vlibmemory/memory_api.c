@@ -694,8 +694,17 @@ int
 vl_mem_api_handle_msg_main (vlib_main_t * vm, vlib_node_runtime_t * node)
 {
   api_main_t *am = &api_main;
-  return void_mem_api_handle_msg_i (am, vm, node,
-				    am->shmem_hdr->vl_input_queue);
+  uword mp;
+
+  if (svm_queue_sub2 (am->shmem_hdr->vl_input_queue, (u8 *) & mp))
+    return -1;
+
+  /* Read-only messages may be served by the read-only API thread */
+  if (vl_msg_api_readonly_offload ((void *) mp))
+    return 0;
+
+  vl_msg_api_handler_with_vm_node (am, (void *) mp, vm, node);
+  return 0;
 }
 
 int
@@ -782,6 +791,7 @@ format_api_message_rings (u8 * s, va_list * args)
   vl_shmem_hdr_t *shmem_hdr = va_arg (*args, vl_shmem_hdr_t *);
   int main_segment = va_arg (*args, int);
   ring_alloc_t *ap;
+  svm_queue_t *q;
   int i;
 
   if (shmem_hdr == 0)
@@ -806,6 +816,17 @@ format_api_message_rings (u8 * s, va_list * args)
       ap++;
     }
 
+  q = shmem_hdr->vl_input_queue;
+  if (q)
+    {
+      if (svm_queue_is_lockfree (q))
+	s = format (s, "input queue: lock-free, %d/%d, %d wakeups\n",
+		    q->cursize, q->maxsize, q->lf_n_wakeups);
+      else
+	s = format (s, "input queue: mutex, %d/%d\n", q->cursize,
+		    q->maxsize);
+    }
+
   if (main_segment)
     {
       s = format (s, "%d ring miss fallback allocations\n", am->ring_misses);
@@ -199,8 +199,12 @@ vl_client_connect (const char *name, int ctx_quota, int input_queue_size)
 
   pthread_mutex_lock (&svm->mutex);
   oldheap = svm_push_data_heap (svm);
-  vl_input_queue = svm_queue_init (input_queue_size, sizeof (uword),
-				   getpid (), 0);
+  if (am->lockfree_queues)
+    vl_input_queue = svm_queue_init_lockfree (input_queue_size,
+					      sizeof (uword), getpid (), 0);
+  else
+    vl_input_queue = svm_queue_init (input_queue_size, sizeof (uword),
+				     getpid (), 0);
   svm_pop_heap (oldheap);
   pthread_mutex_unlock (&svm->mutex);
 
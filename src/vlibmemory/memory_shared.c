@@ -201,9 +201,10 @@ vl_msg_api_alloc (int nbytes)
   vl_shmem_hdr_t *shmem_hdr = am->shmem_hdr;
 
   /*
-   * Clients use pool-0, vlib proc uses pool 1
+   * Clients use pool-0, vlib proc uses pool 1. Pool 1 is unlocked,
+   * so other vlib threads (e.g. the read-only API thread) use pool 0.
    */
-  pool = (am->our_pid == shmem_hdr->vl_pid);
+  pool = (am->our_pid == shmem_hdr->vl_pid) && vlib_get_thread_index () == 0;
   return vl_msg_api_alloc_internal (nbytes, pool, 0 /* may_return_null */ );
 }
 
@@ -214,7 +215,7 @@ vl_msg_api_alloc_or_null (int nbytes)
   api_main_t *am = &api_main;
   vl_shmem_hdr_t *shmem_hdr = am->shmem_hdr;
 
-  pool = (am->our_pid == shmem_hdr->vl_pid);
+  pool = (am->our_pid == shmem_hdr->vl_pid) && vlib_get_thread_index () == 0;
   return vl_msg_api_alloc_internal (nbytes, pool, 1 /* may_return_null */ );
 }
 
@@ -381,6 +382,14 @@ vl_set_api_pvt_heap_size (u64 size)
   am->api_pvt_heap_size = size;
 }
 
+void
+vl_set_api_lockfree_queues (int is_enabled)
+{
+  api_main_t *am = &api_main;
+
+  am->lockfree_queues = (is_enabled != 0);
+}
+
 static void
 vl_api_default_mem_config (vl_shmem_hdr_t * shmem_hdr)
 {
@@ -392,9 +401,14 @@ vl_api_default_mem_config (vl_shmem_hdr_t * shmem_hdr)
   if (am->vlib_input_queue_length)
     vlib_input_queue_length = am->vlib_input_queue_length;
 
-  shmem_hdr->vl_input_queue =
-    svm_queue_init (vlib_input_queue_length, sizeof (uword),
-		    getpid (), am->vlib_signal);
+  if (am->lockfree_queues)
+    shmem_hdr->vl_input_queue =
+      svm_queue_init_lockfree (vlib_input_queue_length, sizeof (uword),
+			       getpid (), am->vlib_signal);
+  else
+    shmem_hdr->vl_input_queue =
+      svm_queue_init (vlib_input_queue_length, sizeof (uword),
+		      getpid (), am->vlib_signal);
 
 #define _(sz,n)                                                 \
     do {                                                        \
@@ -448,6 +462,12 @@ vl_api_mem_config (vl_shmem_hdr_t * hdr, vl_api_shm_elem_config_t * config)
 					      c->size,
 					      getpid (), am->vlib_signal);
 	continue;
+      case VL_API_QUEUE_LOCKFREE:
+	hdr->vl_input_queue = svm_queue_init_lockfree (c->count,
+						       c->size,
+						       getpid (),
+						       am->vlib_signal);
+	continue;
       case VL_API_VLIB_RING:
 	vec_add2 (hdr->vl_rings, rp, 1);
 	break;
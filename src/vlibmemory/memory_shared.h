@@ -45,7 +45,8 @@ typedef enum
 {
   VL_API_VLIB_RING,
   VL_API_CLIENT_RING,
-  VL_API_QUEUE
+  VL_API_QUEUE,
+  VL_API_QUEUE_LOCKFREE,
 } vl_api_shm_config_type_t;
 
 typedef struct vl_api_shm_elem_config_
@@ -131,6 +132,7 @@ void vl_set_global_memory_size (u64 size);
 void vl_set_api_memory_size (u64 size);
 void vl_set_global_pvt_heap_size (u64 size);
 void vl_set_api_pvt_heap_size (u64 size);
+void vl_set_api_lockfree_queues (int is_enabled);
 void vl_init_shmem (svm_region_t * vlib_rp, vl_api_shm_elem_config_t * config,
 		    int is_vlib, int is_private_region);
 
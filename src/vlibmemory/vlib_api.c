@@ -737,6 +737,74 @@ rpc_api_hookup (vlib_main_t * vm)
 
 VLIB_API_INIT_FUNCTION (rpc_api_hookup);
 
+/*
+ * Read-only API thread. Enabled with "cpu { api-readonly 1 }", serves
+ * the messages whose handlers are marked read-only (dumps, gets...)
+ * so that large walks don't hold up the main thread.
+ */
+static void
+vl_api_readonly_thread_fn (void *arg)
+{
+  api_main_t *am = &api_main;
+  vlib_worker_thread_t *w = (vlib_worker_thread_t *) arg;
+  vlib_thread_main_t *tm = vlib_get_thread_main ();
+  svm_queue_t *q;
+  uword mp;
+
+  /* api thread wants no signals. */
+  {
+    sigset_t s;
+    sigfillset (&s);
+    pthread_sigmask (SIG_SETMASK, &s, 0);
+  }
+
+  if (vec_len (tm->thread_prefix))
+    vlib_set_thread_name ((char *)
+			  format (0, "%v_api%c", tm->thread_prefix, '\0'));
+
+  clib_mem_set_heap (w->thread_mheap);
+
+  while ((q = *(svm_queue_t * volatile *) &am->readonly_queue) == 0)
+    usleep (1000);
+
+  while (1)
+    {
+      if (svm_queue_sub (q, (u8 *) & mp, SVM_Q_WAIT, 0))
+	continue;
+      vl_msg_api_readonly_handler ((void *) mp);
+    }
+}
+
+/* *INDENT-OFF* */
+VLIB_REGISTER_THREAD (api_readonly_thread_reg, static) = {
+  .name = "api-readonly",
+  .function = vl_api_readonly_thread_fn,
+  .no_data_structure_clone = 1,
+  .use_pthreads = 1,
+};
+/* *INDENT-ON* */
+
+static clib_error_t *
+api_readonly_thread_init (vlib_main_t * vm)
+{
+  api_main_t *am = &api_main;
+
+  if (api_readonly_thread_reg.count == 0)
+    return 0;
+
+  clib_rwlock_init (&am->readonly_lock);
+
+  /* The main thread runs under the writer side, except while asleep */
+  clib_rwlock_writer_lock (&am->readonly_lock);
+  vm->main_loop_sleep_callback = vl_msg_api_readonly_main_loop_sleep;
+  CLIB_MEMORY_BARRIER ();
+  am->readonly_queue = svm_queue_init (1024, sizeof (uword), getpid (),
+				       0 /* signal when queue non-empty */ );
+  return 0;
+}
+
+VLIB_INIT_FUNCTION (api_readonly_thread_init);
+
 /*
  * fd.io coding-style-patch-verification: ON
  *
@@ -94,6 +94,87 @@ VLIB_CLI_COMMAND (cli_clear_api_histogram_command, static) =
 };
 /* *INDENT-ON* */
 
+static clib_error_t *
+vl_api_show_handler_latency_command (vlib_main_t * vm,
+				     unformat_input_t * input,
+				     vlib_cli_command_t * cli_cmd)
+{
+  api_main_t *am = &api_main;
+  vl_api_msg_latency_t *l;
+  f64 usec_per_clock;
+  int i, all = 0;
+
+  if (unformat (input, "all"))
+    all = 1;
+
+  usec_per_clock = 1e6 / vm->clib_time.clocks_per_second;
+
+  if (am->readonly_queue)
+    vlib_cli_output (vm, "Read-only thread: %llu offloaded, %llu inline",
+		     am->readonly_offloaded, am->readonly_inline);
+  else
+    vlib_cli_output (vm, "Read-only thread: not configured");
+
+  vlib_cli_output (vm, "%-40s %3s %10s %12s %12s", "Name", "RO", "Calls",
+		   "Avg (us)", "Max (us)");
+
+  for (i = 1; i < vec_len (am->msg_latency); i++)
+    {
+      l = am->msg_latency + i;
+      if (l->count == 0 && !all)
+	continue;
+      if (am->msg_names[i] == 0)
+	continue;
+      vlib_cli_output (vm, "%-40s %3s %10llu %12.2f %12.2f",
+		       am->msg_names[i], am->is_readonly[i] ? "y" : "",
+		       l->count,
+		       l->count ? (f64) l->total_clocks / (f64) l->count
+		       * usec_per_clock : 0.0,
+		       (f64) l->max_clocks * usec_per_clock);
+    }
+
+  return 0;
+}
+
+/*?
+ * Display per message type binary api handler latency: number of
+ * calls, average and worst handler run time. Messages marked read-only
+ * may be served by the read-only API thread, configured with
+ * "cpu { api-readonly 1 }".
+?*/
+/* *INDENT-OFF* */
+VLIB_CLI_COMMAND (cli_show_api_handler_latency_command, static) =
+{
+  .path = "show api handler-latency",
+  .short_help = "show api handler-latency [all]",
+  .function = vl_api_show_handler_latency_command,
+};
+/* *INDENT-ON* */
+
+static clib_error_t *
+vl_api_clear_handler_latency_command (vlib_main_t * vm,
+				      unformat_input_t * input,
+				      vlib_cli_command_t * cli_cmd)
+{
+  api_main_t *am = &api_main;
+
+  vec_zero (am->msg_latency);
+  am->readonly_offloaded = am->readonly_inline = 0;
+  return 0;
+}
+
+/*?
+ * Clear the binary api handler latency statistics
+?*/
+/* *INDENT-OFF* */
+VLIB_CLI_COMMAND (cli_clear_api_handler_latency_command, static) =
+{
+  .path = "clear api handler-latency",
+  .short_help = "clear api handler-latency",
+  .function = vl_api_clear_handler_latency_command,
+};
+/* *INDENT-ON* */
+
 static clib_error_t *
 vl_api_client_command (vlib_main_t * vm,
 		       unformat_input_t * input, vlib_cli_command_t * cli_cmd)
@@ -239,8 +320,8 @@ vl_api_message_table_command (vlib_main_t * vm,
   if (verbose == 0)
     vlib_cli_output (vm, "%-4s %s", "ID", "Name");
   else
-    vlib_cli_output (vm, "%-4s %-40s %6s %7s", "ID", "Name", "Bounce",
-		     "MP-safe");
+    vlib_cli_output (vm, "%-4s %-40s %6s %7s %9s", "ID", "Name", "Bounce",
+		     "MP-safe", "Read-only");
 
   for (i = 1; i < vec_len (am->msg_names); i++)
     {
@@ -252,10 +333,10 @@ vl_api_message_table_command (vlib_main_t * vm,
 	}
       else
 	{
-	  vlib_cli_output (vm, "%-4d %-40s %6d %7d", i,
+	  vlib_cli_output (vm, "%-4d %-40s %6d %7d %9d", i,
 			   am->msg_names[i] ? am->msg_names[i] :
 			   "  [no handler]", am->message_bounce[i],
-			   am->is_mp_safe[i]);
+			   am->is_mp_safe[i], am->is_readonly[i]);
 	}
     }
 
@@ -347,8 +428,44 @@ typedef enum
   CUSTOM_DUMP,
   REPLAY,
   INITIALIZERS,
+  BENCHMARK,
 } vl_api_replay_t;
 
+/*
+ * Replay benchmark state: a trace is replayed, optionally paced and
+ * repeated, recording each handler's run time per message type, the
+ * time workers are held at the barrier and the main heap usage.
+ */
+typedef struct
+{
+  /* configuration */
+  f64 rate;			/* messages / sec, 0 for flat out */
+  u32 n_repeats;
+
+  /* per message type handler latency samples, usec */
+  f64 **latency_by_msg_id;
+
+  /* worker barrier hold time samples, usec */
+  f64 *barrier_hold;
+
+  /* main heap bytes in use, before the first and after each repeat */
+  uword *heap_used;
+
+  u64 n_msgs;
+  u64 n_skipped;
+  f64 start_time;
+  f64 wall_time;
+} vl_api_replay_benchmark_t;
+
+static uword
+vl_api_replay_heap_used (void)
+{
+  clib_mem_usage_t usage;
+
+  clib_mem_usage (&usage);
+  return usage.bytes_used;
+}
+
 u8 *
 format_vl_msg_api_trace_status (u8 * s, va_list * args)
 {
@@ -395,7 +512,8 @@ vl_msg_api_custom_dump_configure (api_main_t * am)
 static void
 vl_msg_api_process_file (vlib_main_t * vm, u8 * filename,
 			 u32 first_index, u32 last_index,
-			 vl_api_replay_t which)
+			 vl_api_replay_t which,
+			 vl_api_replay_benchmark_t * bm)
 {
   vl_api_trace_file_header_t *hp;
   int i, fd;
@@ -501,7 +619,7 @@ vl_msg_api_process_file (vlib_main_t * vm, u8 * filename,
       msg += size;
     }
 
-  if (which == REPLAY)
+  if (which == REPLAY || which == BENCHMARK)
     am->replay_in_progress = 1;
 
   for (; i <= last_index; i++)
@@ -639,6 +757,57 @@ vl_msg_api_process_file (vlib_main_t * vm, u8 * filename,
 	      break;
 	    }
 	  break;
+
+	case BENCHMARK:
+	  if (msg_id < vec_len (am->msg_handlers) &&
+	      am->msg_handlers[msg_id] && cfgp->replay_enable)
+	    {
+	      void (*handler) (void *, vlib_main_t *);
+	      f64 usec_per_clock = vm->clib_time.seconds_per_clock * 1e6;
+	      int use_barrier = !am->is_mp_safe[msg_id]
+		&& vec_len (vlib_mains) > 1;
+	      u64 t0, t1 = 0, t2 = 0, t3;
+
+	      /*
+	       * pace to the requested rate; the command is mp-safe, so
+	       * the workers run while we wait, and the barrier is taken
+	       * below for each message that needs it
+	       */
+	      if (bm->rate > 0.0)
+		{
+		  f64 due = bm->start_time + (f64) bm->n_msgs / bm->rate;
+		  f64 now = vlib_time_now (vm);
+
+		  if (due > now)
+		    vlib_process_suspend (vm, due - now);
+		}
+
+	      handler = (void *) am->msg_handlers[msg_id];
+
+	      t0 = clib_cpu_time_now ();
+	      if (use_barrier)
+		{
+		  t1 = clib_cpu_time_now ();
+		  vl_msg_api_barrier_sync ();
+		}
+	      (*handler) (tmpbuf + sizeof (uword), vm);
+	      if (use_barrier)
+		{
+		  vl_msg_api_barrier_release ();
+		  t2 = clib_cpu_time_now ();
+		}
+	      t3 = clib_cpu_time_now ();
+
+	      vec_validate (bm->latency_by_msg_id, msg_id);
+	      vec_add1 (bm->latency_by_msg_id[msg_id],
+			(f64) (t3 - t0) * usec_per_clock);
+	      if (use_barrier)
+		vec_add1 (bm->barrier_hold, (f64) (t2 - t1) * usec_per_clock);
+	      bm->n_msgs++;
+	    }
+	  else
+	    bm->n_skipped++;
+	  break;
 	}
 
       _vec_len (tmpbuf) = 0;
@@ -728,19 +897,23 @@ api_trace_command_fn (vlib_main_t * vm,
 	}
       else if (unformat (input, "dump %s", &filename))
 	{
-	  vl_msg_api_process_file (vm, filename, first, last, DUMP);
+	  vl_msg_api_process_file (vm, filename, first, last, DUMP,
+				   0 /* benchmark */ );
 	}
       else if (unformat (input, "custom-dump %s", &filename))
 	{
-	  vl_msg_api_process_file (vm, filename, first, last, CUSTOM_DUMP);
+	  vl_msg_api_process_file (vm, filename, first, last, CUSTOM_DUMP,
+				   0 /* benchmark */ );
 	}
       else if (unformat (input, "replay %s", &filename))
 	{
-	  vl_msg_api_process_file (vm, filename, first, last, REPLAY);
+	  vl_msg_api_process_file (vm, filename, first, last, REPLAY,
+				   0 /* benchmark */ );
 	}
       else if (unformat (input, "initializers %s", &filename))
 	{
-	  vl_msg_api_process_file (vm, filename, first, last, INITIALIZERS);
+	  vl_msg_api_process_file (vm, filename, first, last, INITIALIZERS,
+				   0 /* benchmark */ );
 	}
       else if (unformat (input, "tx"))
 	{
@@ -789,6 +962,177 @@ VLIB_CLI_COMMAND (api_trace_command, static) =
 };
 /* *INDENT-ON* */
 
+static int
+vl_api_replay_sample_cmp (void *a1, void *a2)
+{
+  f64 *s1 = a1, *s2 = a2;
+
+  return (*s1 < *s2) ? -1 : (*s1 > *s2);
+}
+
+/* sorted samples in, q-quantile out */
+static f64
+vl_api_replay_quantile (f64 * samples, f64 q)
+{
+  u32 i = (u32) (q * vec_len (samples));
+
+  return samples[clib_min (i, vec_len (samples) - 1)];
+}
+
+static u8 *
+format_vl_api_replay_samples (u8 * s, va_list * args)
+{
+  f64 *samples = va_arg (*args, f64 *);
+  f64 sum = 0.0, *v;
+
+  if (samples == 0)
+    return format (s, "%10s%10s%10s%10s%10s%10s%10s",
+		   "Count", "Min", "Avg", "P50", "P90", "P99", "Max");
+
+  vec_foreach (v, samples) sum += *v;
+
+  return format (s, "%10u%10.2f%10.2f%10.2f%10.2f%10.2f%10.2f",
+		 vec_len (samples), samples[0], sum / vec_len (samples),
+		 vl_api_replay_quantile (samples, 0.5),
+		 vl_api_replay_quantile (samples, 0.9),
+		 vl_api_replay_quantile (samples, 0.99),
+		 samples[vec_len (samples) - 1]);
+}
+
+static void
+vl_api_replay_benchmark_report (vlib_main_t * vm,
+				vl_api_replay_benchmark_t * bm)
+{
+  api_main_t *am = &api_main;
+  f64 held = 0.0, *v;
+  int i;
+
+  vlib_cli_output (vm, "Replayed %llu messages (%llu skipped) in %.3f sec, "
+		   "%.1f msgs/sec", bm->n_msgs, bm->n_skipped,
+		   bm->wall_time, bm->n_msgs / bm->wall_time);
+
+  vlib_cli_output (vm, "\nHandler latency (usec):");
+  vlib_cli_output (vm, "%-40s%U", "Name", format_vl_api_replay_samples, 0);
+  for (i = 0; i < vec_len (bm->latency_by_msg_id); i++)
+    {
+      if (vec_len (bm->latency_by_msg_id[i]) == 0)
+	continue;
+      vec_sort_with_function (bm->latency_by_msg_id[i],
+			      vl_api_replay_sample_cmp);
+      vlib_cli_output (vm, "%-40s%U", am->msg_names[i],
+		       format_vl_api_replay_samples,
+		       bm->latency_by_msg_id[i]);
+    }
+
+  vlib_cli_output (vm, "\nWorker barrier hold (usec):");
+  if (vec_len (bm->barrier_hold))
+    {
+      vec_foreach (v, bm->barrier_hold) held += *v;
+      vec_sort_with_function (bm->barrier_hold, vl_api_replay_sample_cmp);
+      vlib_cli_output (vm, "%-40s%U", "", format_vl_api_replay_samples, 0);
+      vlib_cli_output (vm, "%-40s%U", "barrier",
+		       format_vl_api_replay_samples, bm->barrier_hold);
+      vlib_cli_output (vm, "held %.3f msec, %.2f%% of the run",
+		       held * 1e-3, held * 1e-4 / bm->wall_time);
+    }
+  else
+    vlib_cli_output (vm, "not taken (no workers, or only mp-safe messages)");
+
+  vlib_cli_output (vm, "\nMain heap in use:");
+  vlib_cli_output (vm, "%-10s%U", "before", format_memory_size,
+		   bm->heap_used[0]);
+  for (i = 1; i < vec_len (bm->heap_used); i++)
+    vlib_cli_output (vm, "pass %-5d%U, growth %lld bytes", i,
+		     format_memory_size, bm->heap_used[i],
+		     (i64) bm->heap_used[i] - (i64) bm->heap_used[i - 1]);
+}
+
+static clib_error_t *
+api_trace_benchmark_command_fn (vlib_main_t * vm,
+				unformat_input_t * input,
+				vlib_cli_command_t * cmd)
+{
+  vl_api_replay_benchmark_t _bm, *bm = &_bm;
+  u32 first = 0, last = (u32) ~ 0;
+  u8 *filename = 0;
+  int i;
+
+  memset (bm, 0, sizeof (*bm));
+  bm->n_repeats = 1;
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "rate %f", &bm->rate))
+	;
+      else if (unformat (input, "repeat %u", &bm->n_repeats))
+	;
+      else if (unformat (input, "first %u", &first))
+	;
+      else if (unformat (input, "last %u", &last))
+	;
+      else if (!filename && unformat (input, "%s", &filename))
+	;
+      else
+	return clib_error_return (0, "unknown input `%U'",
+				  format_unformat_error, input);
+    }
+
+  if (!filename)
+    return clib_error_return (0, "trace file required");
+  if (bm->n_repeats == 0)
+    return clib_error_return (0, "repeat count must be non-zero");
+
+  vec_add1 (bm->heap_used, vl_api_replay_heap_used ());
+  bm->start_time = vlib_time_now (vm);
+
+  for (i = 0; i < bm->n_repeats; i++)
+    {
+      vl_msg_api_process_file (vm, filename, first, last, BENCHMARK, bm);
+      vec_add1 (bm->heap_used, vl_api_replay_heap_used ());
+    }
+
+  bm->wall_time = vlib_time_now (vm) - bm->start_time;
+
+  if (bm->n_msgs)
+    vl_api_replay_benchmark_report (vm, bm);
+  else
+    vlib_cli_output (vm, "Nothing replayed");
+
+  for (i = 0; i < vec_len (bm->latency_by_msg_id); i++)
+    vec_free (bm->latency_by_msg_id[i]);
+  vec_free (bm->latency_by_msg_id);
+  vec_free (bm->barrier_hold);
+  vec_free (bm->heap_used);
+  vec_free (filename);
+
+  return 0;
+}
+
+/*?
+ * Replay a saved binary API trace as a control-plane benchmark, e.g.
+ * one captured with "api trace save" on a production system. Messages
+ * are replayed flat out, or paced at "rate" messages per second, the
+ * whole trace "repeat" times. Reported are the handler latency
+ * distribution per message type, the time worker threads are held at
+ * the barrier and the main heap usage before and after each pass; a
+ * heap which keeps growing over identical passes points at a leak.
+ * Replies go nowhere, the clients in the trace are not connected.
+ *
+ * @cliexpar
+ * @cliexcmd{api trace benchmark /tmp/prod.api rate 1000 repeat 3}
+?*/
+/* *INDENT-OFF* */
+VLIB_CLI_COMMAND (api_trace_benchmark_command, static) =
+{
+  .path = "api trace benchmark",
+  .short_help = "api trace benchmark <file> [rate <msgs/sec>] "
+      "[repeat <n>] [first <n>] [last <n>]",
+  .function = api_trace_benchmark_command_fn,
+  /* takes the barrier per replayed message, to measure its hold time */
+  .is_mp_safe = 1,
+};
+/* *INDENT-ON* */
+
 static clib_error_t *
 vl_api_trace_command (vlib_main_t * vm,
 		      unformat_input_t * input, vlib_cli_command_t * cli_cmd)
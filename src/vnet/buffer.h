@@ -64,7 +64,22 @@
   _(16, L4_HDR_OFFSET_VALID, 0)				\
   _(17, FLOW_REPORT, "flow-report")			\
   _(18, IS_DVR, "dvr")                                  \
-  _(19, QOS_DATA_VALID, 0)
+  _(19, QOS_DATA_VALID, 0)				\
+  _(20, GSO, "gso")					\
+  _(21, FLOW_CACHE_LEARN, 0)
+
+/*
+ * Checksum flags:
+ * L4_CHECKSUM_COMPUTED|L4_CHECKSUM_CORRECT - the TCP/UDP checksum of a
+ *   received packet was verified, by the NIC or in software, and need
+ *   not be verified again.
+ * OFFLOAD_{IP,TCP,UDP}_CKSUM - the checksum at l3/l4_hdr_offset is yet
+ *   to be computed, by the NIC or, if it cannot, at interface-output.
+ *   Until then the checksum field is don't-care and nodes rewriting the
+ *   packet need not update it.
+ */
+#define VNET_BUFFER_F_OFFLOAD_L4_CKSUM \
+  (VNET_BUFFER_F_OFFLOAD_TCP_CKSUM | VNET_BUFFER_F_OFFLOAD_UDP_CKSUM)
 
 #define VNET_BUFFER_FLAGS_VLAN_BITS \
   (VNET_BUFFER_F_VLAN_1_DEEP | VNET_BUFFER_F_VLAN_2_DEEP)
@@ -167,6 +182,7 @@ typedef struct
 	  {
 	    u32 next_index;	/* index of next node - ignored if "feature" node */
 	    u16 estimated_mtu;	/* estimated MTU calculated during reassembly */
+	    u32 owner_thread_index;	/* thread a fragment is handed off to */
 	  };
 	  /* internal variables used during reassembly */
 	  struct
@@ -178,6 +194,19 @@ typedef struct
 	    u32 next_range_bi;
 	    u16 ip6_frag_hdr_offset;
 	  };
+	  /* output of shallow virtual reassembly: the L4 info of the
+	   * packet a fragment belongs to, ports in network byte order.
+	   * Valid from ip4-sv-reassembly-feature up to ip4-lookup, or up
+	   * to the first classify feature which does not restore it (the
+	   * ports share l2_classify's space), see vnet_classify.h */
+	  struct
+	  {
+	    u8 ip_proto;
+	    u8 icmp_type_or_tcp_flags;
+	    u8 is_non_first_fragment;
+	    u16 l4_src_port;
+	    u16 l4_dst_port;
+	  };
 	} reass;
       };
 
@@ -380,6 +409,15 @@ typedef struct
     u32 src_epg;
   } gbp;
 
+  /**
+   * Generic segmentation offload, valid with VNET_BUFFER_F_GSO.
+   * The packet is to be cut into segments of gso_size bytes of L4
+   * payload, each carrying a copy of the L2-L4 headers. The L3 and L4
+   * headers are at vnet_buffer(b)->l3_hdr_offset and l4_hdr_offset.
+   */
+  u16 gso_size;
+  u16 gso_l4_hdr_sz;
+
   union
   {
     struct
@@ -394,12 +432,41 @@ typedef struct
       u64 pad[1];
       u64 pg_replay_timestamp;
     };
-    u32 unused[10];
+    u32 unused[8];
   };
 } vnet_buffer_opaque2_t;
 
 #define vnet_buffer2(b) ((vnet_buffer_opaque2_t *) (b)->opaque2)
 
+/**
+ * The L3 size of the segments a GSO packet is cut into, i.e. what the
+ * MTU of the egress interface is checked against.
+ */
+static_always_inline u16
+gso_mtu_sz (vlib_buffer_t * b)
+{
+  return (vnet_buffer2 (b)->gso_size + vnet_buffer2 (b)->gso_l4_hdr_sz +
+	  vnet_buffer (b)->l4_hdr_offset - vnet_buffer (b)->l3_hdr_offset);
+}
+
+/**
+ * The smallest gso_size a GSO packet may have; anything smaller would
+ * cut it into an absurd number of segments.
+ */
+#define VNET_GSO_MIN_SIZE 64
+
+/**
+ * Whether the GSO metadata of b can be acted on: a sane gso_size and
+ * the L2-L4 headers in the first buffer.
+ */
+static_always_inline int
+gso_is_valid (vlib_buffer_t * b)
+{
+  return (vnet_buffer2 (b)->gso_size >= VNET_GSO_MIN_SIZE &&
+	  vnet_buffer (b)->l4_hdr_offset + vnet_buffer2 (b)->gso_l4_hdr_sz <=
+	  b->current_data + b->current_length);
+}
+
 /*
  * The opaque2 field of the vlib_buffer_t is intepreted as a
  * vnet_buffer_opaque2_t. Hence it should be big enough to accommodate one.
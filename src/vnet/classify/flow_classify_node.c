@@ -75,8 +75,12 @@ flow_classify_inline (vlib_main_t * vm,
   u32 misses = 0;
   u32 chain_hits = 0;
   u32 drop = 0;
+  int is_ip4 = (FLOW_CLASSIFY_TABLE_IP4 == tid);
+  u16 reass_ports[VLIB_FRAME_SIZE][2];
+  u32x4 copy[VNET_CLASSIFY_REWRITE_N_VECTORS];
+  u32 *buffers;
 
-  from = vlib_frame_vector_args (frame);
+  from = buffers = vlib_frame_vector_args (frame);
   n_left_from = frame->n_vectors;
 
   /* First pass: compute hashes */
@@ -122,11 +126,27 @@ flow_classify_inline (vlib_main_t * vm,
 
       t1 = pool_elt_at_index (vcm->tables, table_index1);
 
+      if (is_ip4)
+	{
+	  u16 *ports0 = reass_ports[from - buffers];
+
+	  vnet_classify_get_ip4_reass_ports (b0, ports0);
+	  h0 = vnet_classify_ip4_reass_data (b0, t0, h0, ports0, copy);
+	}
+
       vnet_buffer (b0)->l2_classify.hash =
 	vnet_classify_hash_packet (t0, (u8 *) h0);
 
       vnet_classify_prefetch_bucket (t0, vnet_buffer (b0)->l2_classify.hash);
 
+      if (is_ip4)
+	{
+	  u16 *ports1 = reass_ports[from + 1 - buffers];
+
+	  vnet_classify_get_ip4_reass_ports (b1, ports1);
+	  h1 = vnet_classify_ip4_reass_data (b1, t1, h1, ports1, copy);
+	}
+
       vnet_buffer (b1)->l2_classify.hash =
 	vnet_classify_hash_packet (t1, (u8 *) h1);
 
@@ -158,6 +178,15 @@ flow_classify_inline (vlib_main_t * vm,
 	fcm->classify_table_index_by_sw_if_index[tid][sw_if_index0];
 
       t0 = pool_elt_at_index (vcm->tables, table_index0);
+
+      if (is_ip4)
+	{
+	  u16 *ports0 = reass_ports[from - buffers];
+
+	  vnet_classify_get_ip4_reass_ports (b0, ports0);
+	  h0 = vnet_classify_ip4_reass_data (b0, t0, h0, ports0, copy);
+	}
+
       vnet_buffer (b0)->l2_classify.hash =
 	vnet_classify_hash_packet (t0, (u8 *) h0);
 
@@ -169,7 +198,7 @@ flow_classify_inline (vlib_main_t * vm,
     }
 
   next_index = node->cached_next_index;
-  from = vlib_frame_vector_args (frame);
+  from = buffers;
   n_left_from = frame->n_vectors;
 
   while (n_left_from > 0)
@@ -189,6 +218,7 @@ flow_classify_inline (vlib_main_t * vm,
 	  vnet_classify_entry_t *e0;
 	  u64 hash0;
 	  u8 *h0;
+	  u16 *ports0;
 
 	  /* Stride 3 seems to work best */
 	  if (PREDICT_TRUE (n_left_from > 3))
@@ -210,6 +240,7 @@ flow_classify_inline (vlib_main_t * vm,
 
 	  /* Speculatively enqueue b0 to the current next frame */
 	  bi0 = from[0];
+	  ports0 = reass_ports[from - buffers];
 	  to_next[0] = bi0;
 	  from += 1;
 	  to_next += 1;
@@ -230,6 +261,8 @@ flow_classify_inline (vlib_main_t * vm,
 	    {
 	      hash0 = vnet_buffer (b0)->l2_classify.hash;
 	      t0 = pool_elt_at_index (vcm->tables, table_index0);
+	      if (is_ip4)
+		h0 = vnet_classify_ip4_reass_data (b0, t0, h0, ports0, copy);
 	      e0 = vnet_classify_find_entry (t0, (u8 *) h0, hash0, now);
 	      if (e0)
 		{
@@ -244,6 +277,12 @@ flow_classify_inline (vlib_main_t * vm,
 		  vnet_classify_find_entry (t0, (u8 *) h0, hash0, now);
 		}
 	    }
+	  /* give the features after this one their annotation back */
+	  if (is_ip4 && PREDICT_FALSE (ports0[0] | ports0[1]))
+	    {
+	      vnet_buffer (b0)->ip.reass.l4_src_port = ports0[0];
+	      vnet_buffer (b0)->ip.reass.l4_dst_port = ports0[1];
+	    }
 	  if (PREDICT_FALSE ((node->flags & VLIB_NODE_FLAG_TRACE)
 			     && (b0->flags & VLIB_BUFFER_IS_TRACED)))
 	    {
@@ -15,6 +15,7 @@
 #include <vnet/classify/vnet_classify.h>
 #include <vnet/classify/in_out_acl.h>
 #include <vnet/ip/ip.h>
+#include <vnet/ip/ip_flow_cache.h>
 #include <vnet/api_errno.h>	/* for API error numbers */
 #include <vnet/l2/l2_classify.h>	/* for L2_INPUT_CLASSIFY_NEXT_xxx */
 #include <vnet/fib/fib_table.h>
@@ -754,6 +755,9 @@ vnet_classify_add_del_table (vnet_classify_main_t * cm,
 {
   vnet_classify_table_t *t;
 
+  /* classified flows may be cached */
+  ip_flow_cache_invalidate ();
+
   if (is_add)
     {
       if (*table_index == ~0)	/* add */
@@ -2188,6 +2192,7 @@ vnet_classify_add_del_session (vnet_classify_main_t * cm,
     e->key[i] &= t->mask[i];
 
   rv = vnet_classify_add_del (t, e, is_add);
+  ip_flow_cache_invalidate ();
 
   vnet_classify_entry_release_resource (e);
 
@@ -25,6 +25,7 @@
 #include <vnet/ip/ip_packet.h>
 #include <vnet/ip/ip4_packet.h>
 #include <vnet/ip/ip6_packet.h>
+#include <vnet/ip/ip4_sv_reass.h>
 #include <vlib/cli.h>
 #include <vnet/l2/l2_input.h>
 #include <vnet/l2/l2_output.h>
@@ -214,6 +215,65 @@ extern vnet_classify_main_t vnet_classify_main;
 
 u8 *format_classify_table (u8 * s, va_list * args);
 
+/*
+ * The most vectors of a packet vnet_classify_rewrite_data will copy.
+ */
+#define VNET_CLASSIFY_REWRITE_N_VECTORS 16
+
+/*
+ * The data to match a packet on in table t, when the n_bytes at offset
+ * from h are to be seen as value: h itself when those bytes are outside
+ * the table's skip + match vectors, else a copy of those vectors with
+ * the value written in. copy holds VNET_CLASSIFY_REWRITE_N_VECTORS; h
+ * is used as is for a table which matches further into the packet.
+ */
+static inline u8 *
+vnet_classify_rewrite_data (vnet_classify_table_t * t, u8 * h, i32 offset,
+			    const void *value, u32 n_bytes, u32x4 * copy)
+{
+  u32 n_vectors = t->skip_n_vectors + t->match_n_vectors;
+
+  if (offset < 0 || n_vectors > VNET_CLASSIFY_REWRITE_N_VECTORS)
+    return (h);
+  if (offset + n_bytes <= t->skip_n_vectors * sizeof (u32x4) ||
+      offset >= n_vectors * sizeof (u32x4))
+    return (h);
+  /* the value may run past the vectors, not past the copy */
+  if (offset + n_bytes > VNET_CLASSIFY_REWRITE_N_VECTORS * sizeof (u32x4))
+    return (h);
+
+  clib_memcpy (copy, h, n_vectors * sizeof (u32x4));
+  clib_memcpy ((u8 *) copy + offset, value, n_bytes);
+  return ((u8 *) copy);
+}
+
+/*
+ * An ip4 non-first fragment annotated by shallow virtual reassembly is
+ * matched with the ports of its first fragment. The annotation shares
+ * its space with the l2_classify metadata, so a node reads the ports,
+ * zero for any other packet, before it writes that metadata.
+ */
+static inline void
+vnet_classify_get_ip4_reass_ports (vlib_buffer_t * b, u16 * ports)
+{
+  if (!ip4_sv_reass_get_l4_ports (b, vlib_buffer_get_current (b), ports))
+    ports[0] = ports[1] = 0;
+}
+
+static inline u8 *
+vnet_classify_ip4_reass_data (vlib_buffer_t * b, vnet_classify_table_t * t,
+			      u8 * h, u16 * ports, u32x4 * copy)
+{
+  ip4_header_t *ip;
+
+  if (PREDICT_TRUE (0 == (ports[0] | ports[1])))
+    return (h);
+
+  ip = vlib_buffer_get_current (b);
+  return (vnet_classify_rewrite_data (t, h, (u8 *) ip4_next_header (ip) - h,
+				      ports, 2 * sizeof (u16), copy));
+}
+
 u64 vnet_classify_hash_packet (vnet_classify_table_t * t, u8 * h);
 
 static inline u64
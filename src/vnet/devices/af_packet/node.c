@@ -280,6 +280,9 @@ af_packet_device_input_fn (vlib_main_t * vm, vlib_node_runtime_t * node,
 		  first_b0 = vlib_get_buffer (vm, first_bi0);
 		  if (tph->tp_status & TP_STATUS_CSUMNOTREADY)
 		    mark_tcp_udp_cksum_calc (first_b0);
+		  else if (tph->tp_status & TP_STATUS_CSUM_VALID)
+		    first_b0->flags |= (VNET_BUFFER_F_L4_CHECKSUM_COMPUTED |
+					VNET_BUFFER_F_L4_CHECKSUM_CORRECT);
 		}
 	      else
 		buffer_add_to_chain (vm, bi0, first_bi0, prev_bi0);
@@ -41,6 +41,7 @@ typedef struct
   u8 host_ip6_prefix_len;
   ip6_address_t host_ip6_gw;
   u8 host_ip6_gw_set;
+  u8 gso_enabled;
   /* return */
   u32 sw_if_index;
   int rv;
@@ -33,6 +33,7 @@
 #include <vnet/ip/ip4_packet.h>
 #include <vnet/ip/ip6_packet.h>
 #include <vnet/devices/virtio/virtio.h>
+#include <vnet/devices/virtio/virtio_offload.h>
 
 
 #define foreach_virtio_input_error \
@@ -198,6 +199,9 @@ virtio_device_input_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 		}
 	    }
 
+	  if (vif->flags & VIRTIO_IF_FLAG_GSO)
+	    virtio_offload_hdr_to_buffer (b0, (struct virtio_net_hdr *) hdr);
+
 	  if (PREDICT_FALSE (vif->per_interface_next_index != ~0))
 	    next0 = vif->per_interface_next_index;
 	  else
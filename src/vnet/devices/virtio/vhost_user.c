@@ -378,6 +378,7 @@ vhost_user_socket_read (clib_file_t * uf)
   u8 q;
   clib_file_t template = { 0 };
   vnet_main_t *vnm = vnet_get_main ();
+  vnet_hw_interface_t *hw;
 
   vui = pool_elt_at_index (vum->vhost_user_interfaces, uf->private_data);
 
@@ -471,6 +472,8 @@ vhost_user_socket_read (clib_file_t * uf)
 	(1ULL << FEAT_VIRTIO_NET_F_MQ) |
 	(1ULL << FEAT_VHOST_USER_F_PROTOCOL_FEATURES) |
 	(1ULL << FEAT_VIRTIO_F_VERSION_1);
+      if (vui->enable_gso)
+	msg.u64 |= VHOST_USER_GSO_FEATURE_BITS;
       msg.u64 &= vui->feature_mask;
       msg.size = sizeof (msg.u64);
       DBG_SOCK ("if %d msg VHOST_USER_GET_FEATURES - reply 0x%016llx",
@@ -493,6 +496,22 @@ vhost_user_socket_read (clib_file_t * uf)
       vui->is_any_layout =
 	(vui->features & (1 << FEAT_VIRTIO_F_ANY_LAYOUT)) ? 1 : 0;
 
+      /* Leave checksums and segmentation to the guest if it takes them */
+      hw = vnet_get_hw_interface (vnm, vui->hw_if_index);
+      if (vui->features & (1ULL << FEAT_VIRTIO_NET_F_GUEST_CSUM))
+	hw->flags |= VNET_HW_INTERFACE_FLAG_SUPPORTS_TX_L4_CKSUM_OFFLOAD;
+      else
+	hw->flags &= ~VNET_HW_INTERFACE_FLAG_SUPPORTS_TX_L4_CKSUM_OFFLOAD;
+      if ((vui->features & ((1ULL << FEAT_VIRTIO_NET_F_GUEST_CSUM) |
+			    (1ULL << FEAT_VIRTIO_NET_F_GUEST_TSO4) |
+			    (1ULL << FEAT_VIRTIO_NET_F_GUEST_TSO6))) ==
+	  ((1ULL << FEAT_VIRTIO_NET_F_GUEST_CSUM) |
+	   (1ULL << FEAT_VIRTIO_NET_F_GUEST_TSO4) |
+	   (1ULL << FEAT_VIRTIO_NET_F_GUEST_TSO6)))
+	hw->flags |= VNET_HW_INTERFACE_FLAG_SUPPORTS_GSO;
+      else
+	hw->flags &= ~VNET_HW_INTERFACE_FLAG_SUPPORTS_GSO;
+
       ASSERT (vui->virtio_net_hdr_sz < VLIB_BUFFER_PRE_DATA_SIZE);
       vnet_hw_interface_set_flags (vnm, vui->hw_if_index, 0);
       vui->is_up = 0;
@@ -1361,7 +1380,7 @@ vhost_user_vui_init (vnet_main_t * vnm,
 		     vhost_user_intf_t * vui,
 		     int server_sock_fd,
 		     const char *sock_filename,
-		     u64 feature_mask, u32 * sw_if_index)
+		     u64 feature_mask, u8 enable_gso, u32 * sw_if_index)
 {
   vnet_sw_interface_t *sw;
   int q;
@@ -1389,6 +1408,7 @@ vhost_user_vui_init (vnet_main_t * vnm,
   vui->sock_errno = 0;
   vui->is_up = 0;
   vui->feature_mask = feature_mask;
+  vui->enable_gso = enable_gso;
   vui->clib_file_index = ~0;
   vui->log_base_addr = 0;
   vui->if_index = vui - vum->vhost_user_interfaces;
@@ -1399,6 +1419,8 @@ vhost_user_vui_init (vnet_main_t * vnm,
     vhost_user_vring_init (vui, q);
 
   hw->flags |= VNET_HW_INTERFACE_FLAG_SUPPORTS_INT_MODE;
+  hw->flags &= ~(VNET_HW_INTERFACE_FLAG_SUPPORTS_GSO |
+		 VNET_HW_INTERFACE_FLAG_SUPPORTS_TX_L4_CKSUM_OFFLOAD);
   vnet_hw_interface_set_flags (vnm, vui->hw_if_index, 0);
 
   if (sw_if_index)
@@ -1422,7 +1444,8 @@ vhost_user_create_if (vnet_main_t * vnm, vlib_main_t * vm,
 		      u8 is_server,
 		      u32 * sw_if_index,
 		      u64 feature_mask,
-		      u8 renumber, u32 custom_dev_instance, u8 * hwaddr)
+		      u8 renumber, u32 custom_dev_instance, u8 * hwaddr,
+		      u8 enable_gso)
 {
   vhost_user_intf_t *vui = NULL;
   u32 sw_if_idx = ~0;
@@ -1460,7 +1483,7 @@ vhost_user_create_if (vnet_main_t * vnm, vlib_main_t * vm,
 
   vhost_user_create_ethernet (vnm, vm, vui, hwaddr);
   vhost_user_vui_init (vnm, vui, server_sock_fd, sock_filename,
-		       feature_mask, &sw_if_idx);
+		       feature_mask, enable_gso, &sw_if_idx);
 
   if (renumber)
     vnet_interface_name_renumber (sw_if_idx, custom_dev_instance);
@@ -1479,7 +1502,8 @@ vhost_user_modify_if (vnet_main_t * vnm, vlib_main_t * vm,
 		      const char *sock_filename,
 		      u8 is_server,
 		      u32 sw_if_index,
-		      u64 feature_mask, u8 renumber, u32 custom_dev_instance)
+		      u64 feature_mask, u8 renumber, u32 custom_dev_instance,
+		      u8 enable_gso)
 {
   vhost_user_main_t *vum = &vhost_user_main;
   vhost_user_intf_t *vui = NULL;
@@ -1514,7 +1538,7 @@ vhost_user_modify_if (vnet_main_t * vnm, vlib_main_t * vm,
 
   vhost_user_term_if (vui);
   vhost_user_vui_init (vnm, vui, server_sock_fd,
-		       sock_filename, feature_mask, &sw_if_idx);
+		       sock_filename, feature_mask, enable_gso, &sw_if_idx);
 
   if (renumber)
     vnet_interface_name_renumber (sw_if_idx, custom_dev_instance);
@@ -1536,6 +1560,7 @@ vhost_user_connect_command_fn (vlib_main_t * vm,
   u8 is_server = 0;
   u64 feature_mask = (u64) ~ (0ULL);
   u8 renumber = 0;
+  u8 enable_gso = 0;
   u32 custom_dev_instance = ~0;
   u8 hwaddr[6];
   u8 *hw = NULL;
@@ -1553,6 +1578,8 @@ vhost_user_connect_command_fn (vlib_main_t * vm,
 	is_server = 1;
       else if (unformat (line_input, "feature-mask 0x%llx", &feature_mask))
 	;
+      else if (unformat (line_input, "gso"))
+	enable_gso = 1;
       else
 	if (unformat
 	    (line_input, "hwaddr %U", unformat_ethernet_address, hwaddr))
@@ -1574,7 +1601,8 @@ vhost_user_connect_command_fn (vlib_main_t * vm,
   int rv;
   if ((rv = vhost_user_create_if (vnm, vm, (char *) sock_filename,
 				  is_server, &sw_if_index, feature_mask,
-				  renumber, custom_dev_instance, hw)))
+				  renumber, custom_dev_instance, hw,
+				  enable_gso)))
     {
       error = clib_error_return (0, "vhost_user_create_if returned %d", rv);
       goto done;
@@ -1770,11 +1798,12 @@ show_vhost_user_command_fn (vlib_main_t * vm,
       vlib_cli_output (vm, "Interface: %s (ifindex %d)",
 		       hi->name, hw_if_indices[i]);
 
-      vlib_cli_output (vm, "virtio_net_hdr_sz %d\n"
+      vlib_cli_output (vm, "virtio_net_hdr_sz %d%s\n"
 		       " features mask (0x%llx): \n"
 		       " features (0x%llx): \n",
-		       vui->virtio_net_hdr_sz, vui->feature_mask,
-		       vui->features);
+		       vui->virtio_net_hdr_sz,
+		       vui->enable_gso ? " gso enabled" : "",
+		       vui->feature_mask, vui->features);
 
       feat_entry = (struct feat_struct *) &feat_array;
       while (feat_entry->str)
@@ -1937,6 +1966,12 @@ done:
  * startup. <b>This is intended for degugging only.</b> It is recommended that this
  * parameter not be used except by experienced users. By default, all supported
  * features will be advertised. Otherwise, provide the set of features desired.
+ *   - 0x000000001 (0)  - VIRTIO_NET_F_CSUM
+ *   - 0x000000002 (1)  - VIRTIO_NET_F_GUEST_CSUM
+ *   - 0x000000080 (7)  - VIRTIO_NET_F_GUEST_TSO4
+ *   - 0x000000100 (8)  - VIRTIO_NET_F_GUEST_TSO6
+ *   - 0x000000800 (11) - VIRTIO_NET_F_HOST_TSO4
+ *   - 0x000001000 (12) - VIRTIO_NET_F_HOST_TSO6
  *   - 0x000008000 (15) - VIRTIO_NET_F_MRG_RXBUF
  *   - 0x000020000 (17) - VIRTIO_NET_F_CTRL_VQ
  *   - 0x000200000 (21) - VIRTIO_NET_F_GUEST_ANNOUNCE
@@ -1954,6 +1989,10 @@ done:
  * in the name to be specified. If instance already exists, name will be used
  * anyway and multiple instances will have the same name. Use with caution.
  *
+ * - <b>gso</b> - Optional flag to also advertise the checksum and TCP
+ * segmentation offload features (bits 0-12 above). Large TCP packets are
+ * then exchanged with the guest unsegmented.
+ *
  * @cliexpar
  * Example of how to create a vhost interface with VPP as the client and all features enabled:
  * @cliexstart{create vhost-user socket /var/run/vpp/vhost1.sock}
@@ -1971,7 +2010,8 @@ done:
 VLIB_CLI_COMMAND (vhost_user_connect_command, static) = {
     .path = "create vhost-user",
     .short_help = "create vhost-user socket <socket-filename> [server] "
-    "[feature-mask <hex>] [hwaddr <mac-addr>] [renumber <dev_instance>] ",
+    "[feature-mask <hex>] [hwaddr <mac-addr>] [renumber <dev_instance>] "
+    "[gso]",
     .function = vhost_user_connect_command_fn,
 };
 /* *INDENT-ON* */
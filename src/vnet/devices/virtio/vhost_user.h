@@ -80,6 +80,12 @@ typedef enum
 } virtio_trace_flag_t;
 
 #define foreach_virtio_net_feature      \
+ _ (VIRTIO_NET_F_CSUM, 0)               \
+ _ (VIRTIO_NET_F_GUEST_CSUM, 1)         \
+ _ (VIRTIO_NET_F_GUEST_TSO4, 7)         \
+ _ (VIRTIO_NET_F_GUEST_TSO6, 8)         \
+ _ (VIRTIO_NET_F_HOST_TSO4, 11)         \
+ _ (VIRTIO_NET_F_HOST_TSO6, 12)         \
  _ (VIRTIO_NET_F_MRG_RXBUF, 15)         \
  _ (VIRTIO_NET_F_CTRL_VQ, 17)           \
  _ (VIRTIO_NET_F_GUEST_ANNOUNCE, 21)    \
@@ -97,14 +103,25 @@ typedef enum
 #undef _
 } virtio_net_feature_t;
 
+/* Features advertised only on interfaces created with GSO enabled */
+#define VHOST_USER_GSO_FEATURE_BITS                \
+  ((1ULL << FEAT_VIRTIO_NET_F_CSUM) |              \
+   (1ULL << FEAT_VIRTIO_NET_F_GUEST_CSUM) |        \
+   (1ULL << FEAT_VIRTIO_NET_F_GUEST_TSO4) |        \
+   (1ULL << FEAT_VIRTIO_NET_F_GUEST_TSO6) |        \
+   (1ULL << FEAT_VIRTIO_NET_F_HOST_TSO4) |         \
+   (1ULL << FEAT_VIRTIO_NET_F_HOST_TSO6))
+
 int vhost_user_create_if (vnet_main_t * vnm, vlib_main_t * vm,
 			  const char *sock_filename, u8 is_server,
 			  u32 * sw_if_index, u64 feature_mask,
-			  u8 renumber, u32 custom_dev_instance, u8 * hwaddr);
+			  u8 renumber, u32 custom_dev_instance, u8 * hwaddr,
+			  u8 enable_gso);
 int vhost_user_modify_if (vnet_main_t * vnm, vlib_main_t * vm,
 			  const char *sock_filename, u8 is_server,
 			  u32 sw_if_index, u64 feature_mask,
-			  u8 renumber, u32 custom_dev_instance);
+			  u8 renumber, u32 custom_dev_instance,
+			  u8 enable_gso);
 int vhost_user_delete_if (vnet_main_t * vnm, vlib_main_t * vm,
 			  u32 sw_if_index);
 
@@ -266,6 +283,7 @@ typedef struct
   u64 features;
   u64 feature_mask;
   u64 protocol_features;
+  u8 enable_gso;
 
   //Memory region information
   u32 nregions;
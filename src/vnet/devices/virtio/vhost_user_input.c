@@ -41,6 +41,7 @@
 
 #include <vnet/devices/virtio/vhost_user.h>
 #include <vnet/devices/virtio/vhost_user_inline.h>
+#include <vnet/devices/virtio/virtio_offload.h>
 
 /*
  * When an RX queue is down but active, received packets
@@ -258,6 +259,9 @@ vhost_user_if_input (vlib_main_t * vm,
   u32 map_hint = 0;
   u16 thread_index = vm->thread_index;
   u16 copy_len = 0;
+  u32 i, n_offload = 0;
+  u32 offload_bi[VLIB_FRAME_SIZE];
+  virtio_net_hdr_t offload_hdr[VLIB_FRAME_SIZE];
 
   {
     /* do we have pending interrupts ? */
@@ -379,6 +383,7 @@ vhost_user_if_input (vlib_main_t * vm,
 	  u16 desc_current;
 	  u32 desc_data_offset;
 	  vring_desc_t *desc_table = txvq->desc;
+	  virtio_net_hdr_t *net_hdr = 0;
 
 	  if (PREDICT_FALSE (vum->cpus[thread_index].rx_buffers_len <= 1))
 	    {
@@ -458,6 +463,11 @@ vhost_user_if_input (vlib_main_t * vm,
 	      desc_data_offset = desc_table[desc_current].len;
 	    }
 
+	  if (PREDICT_FALSE (vui->features &
+			     (1ULL << FEAT_VIRTIO_NET_F_CSUM)))
+	    net_hdr = map_guest_mem (vui, desc_table[desc_current].addr,
+				     &map_hint);
+
 	  while (1)
 	    {
 	      /* Get more input if necessary. Or end of packet. */
@@ -548,6 +558,21 @@ vhost_user_if_input (vlib_main_t * vm,
 	  vnet_buffer (b_head)->sw_if_index[VLIB_TX] = (u32) ~ 0;
 	  b_head->error = 0;
 
+	  /*
+	   * The guest may reuse the header once the descriptor is
+	   * returned, keep a copy to set the offload metadata from
+	   * when the packet data has been copied.
+	   */
+	  if (PREDICT_FALSE (net_hdr != 0) &&
+	      (net_hdr->flags & (VIRTIO_NET_HDR_F_NEEDS_CSUM |
+				 VIRTIO_NET_HDR_F_DATA_VALID)))
+	    {
+	      offload_bi[n_offload] = to_next[-1];
+	      clib_memcpy (&offload_hdr[n_offload], net_hdr,
+			   sizeof (offload_hdr[0]));
+	      n_offload++;
+	    }
+
 	  {
 	    u32 next0 = VNET_DEVICE_INPUT_NEXT_ETHERNET_INPUT;
 
@@ -598,6 +623,10 @@ vhost_user_if_input (vlib_main_t * vm,
 			VHOST_USER_INPUT_FUNC_ERROR_MMAP_FAIL, 1);
     }
 
+  for (i = 0; i < n_offload; i++)
+    virtio_offload_hdr_to_buffer (vlib_get_buffer (vm, offload_bi[i]),
+				  (struct virtio_net_hdr *) &offload_hdr[i]);
+
   /* give buffers back to driver */
   CLIB_MEMORY_BARRIER ();
   txvq->used->idx = txvq->last_used_idx;
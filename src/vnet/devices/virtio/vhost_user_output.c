@@ -41,6 +41,7 @@
 
 #include <vnet/devices/virtio/vhost_user.h>
 #include <vnet/devices/virtio/vhost_user_inline.h>
+#include <vnet/devices/virtio/virtio_offload.h>
 
 /*
  * On the transmit side, we keep processing the buffers from vlib in the while
@@ -243,6 +244,7 @@ CLIB_MULTIARCH_FN (vhost_user_tx) (vlib_main_t * vm,
   u8 retry = 8;
   u16 copy_len;
   u16 tx_headers_len;
+  int is_csum_enabled, is_gso_enabled;
 
   if (PREDICT_FALSE (!vui->admin_up))
     {
@@ -263,6 +265,12 @@ CLIB_MULTIARCH_FN (vhost_user_tx) (vlib_main_t * vm,
   if (PREDICT_FALSE (vui->use_tx_spinlock))
     vhost_user_vring_lock (vui, qid);
 
+  is_csum_enabled =
+    (vui->features & (1ULL << FEAT_VIRTIO_NET_F_GUEST_CSUM)) != 0;
+  is_gso_enabled = is_csum_enabled &&
+    (vui->features & (1ULL << FEAT_VIRTIO_NET_F_GUEST_TSO4)) &&
+    (vui->features & (1ULL << FEAT_VIRTIO_NET_F_GUEST_TSO6));
+
 retry:
   error = VHOST_USER_TX_FUNC_ERROR_NONE;
   tx_headers_len = 0;
@@ -333,6 +341,9 @@ retry:
 	hdr->hdr.flags = 0;
 	hdr->hdr.gso_type = 0;
 	hdr->num_buffers = 1;	//This is local, no need to check
+	if (PREDICT_FALSE (is_csum_enabled))
+	  virtio_offload_buffer_to_hdr (b0, (struct virtio_net_hdr *)
+					&hdr->hdr, is_gso_enabled);
 
 	// Prepare a copy order executed later for the header
 	vhost_copy_t *cpy = &vum->cpus[thread_index].copy[copy_len];
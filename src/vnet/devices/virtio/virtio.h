@@ -55,7 +55,8 @@
 
 #define foreach_virtio_if_flag		\
   _(0, ADMIN_UP, "admin-up")		\
-  _(1, DELETING, "deleting")
+  _(1, DELETING, "deleting")		\
+  _(2, GSO, "gso")
 
 typedef enum
 {
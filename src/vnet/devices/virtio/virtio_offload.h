@@ -0,0 +1,205 @@
+/*
+ *------------------------------------------------------------------
+ * Copyright (c) 2018 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *------------------------------------------------------------------
+ */
+
+/*
+ * Translation between the checksum and segmentation offload fields of a
+ * virtio-net header and the vnet buffer metadata, shared by the tap and
+ * vhost-user drivers.
+ */
+
+#ifndef _VNET_DEVICES_VIRTIO_VIRTIO_OFFLOAD_H_
+#define _VNET_DEVICES_VIRTIO_VIRTIO_OFFLOAD_H_
+
+#include <linux/virtio_net.h>
+#include <vnet/ethernet/ethernet.h>
+#include <vnet/ip/ip4_packet.h>
+#include <vnet/ip/ip6_packet.h>
+#include <vnet/udp/udp_packet.h>
+
+/*
+ * Set the offload metadata of a packet received with the given
+ * virtio-net header. A checksum the peer vouches for is marked correct;
+ * one left to us is zeroed and flagged, as the output path expects; a
+ * TCP packet larger than the MTU is flagged as GSO, provided its
+ * gso_size is sane and its TCP header is in the first buffer. The L2-L4
+ * headers must be in the first buffer.
+ */
+static_always_inline void
+virtio_offload_hdr_to_buffer (vlib_buffer_t * b, struct virtio_net_hdr *hdr)
+{
+  ethernet_header_t *eth = vlib_buffer_get_current (b);
+  u16 ethertype = clib_net_to_host_u16 (eth->type);
+  u16 l2_hdr_sz = sizeof (ethernet_header_t);
+  u8 gso_type = hdr->gso_type & ~VIRTIO_NET_HDR_GSO_ECN;
+  i16 l3_hdr_offset, l4_hdr_offset;
+
+  if (hdr->flags & VIRTIO_NET_HDR_F_DATA_VALID)
+    b->flags |= (VNET_BUFFER_F_L4_CHECKSUM_COMPUTED |
+		 VNET_BUFFER_F_L4_CHECKSUM_CORRECT);
+
+  if (PREDICT_TRUE (!(hdr->flags & VIRTIO_NET_HDR_F_NEEDS_CSUM)))
+    return;
+
+  while (ethernet_frame_is_tagged (ethertype) &&
+	 l2_hdr_sz < 2 * sizeof (ethernet_vlan_header_t) +
+	 sizeof (ethernet_header_t))
+    {
+      ethernet_vlan_header_t *vlan = (void *) eth + l2_hdr_sz;
+      ethertype = clib_net_to_host_u16 (vlan->type);
+      l2_hdr_sz += sizeof (*vlan);
+    }
+
+  l3_hdr_offset = b->current_data + l2_hdr_sz;
+  l4_hdr_offset = b->current_data + hdr->csum_start;
+  if (hdr->csum_start <= l2_hdr_sz ||
+      hdr->csum_start + sizeof (tcp_header_t) > b->current_length)
+    return;
+
+  if (ethertype == ETHERNET_TYPE_IP4)
+    b->flags |= VNET_BUFFER_F_IS_IP4;
+  else if (ethertype == ETHERNET_TYPE_IP6)
+    b->flags |= VNET_BUFFER_F_IS_IP6;
+  else
+    return;
+
+  vnet_buffer (b)->l3_hdr_offset = l3_hdr_offset;
+  vnet_buffer (b)->l4_hdr_offset = l4_hdr_offset;
+  b->flags |= (VNET_BUFFER_F_L3_HDR_OFFSET_VALID |
+	       VNET_BUFFER_F_L4_HDR_OFFSET_VALID);
+
+  if (hdr->csum_offset == STRUCT_OFFSET_OF (tcp_header_t, checksum))
+    {
+      tcp_header_t *tcp = (tcp_header_t *) (b->data + l4_hdr_offset);
+      tcp->checksum = 0;
+      b->flags |= VNET_BUFFER_F_OFFLOAD_TCP_CKSUM;
+
+      /* a GSO packet we could not segment is left as it is, too big */
+      if ((gso_type == VIRTIO_NET_HDR_GSO_TCPV4 ||
+	   gso_type == VIRTIO_NET_HDR_GSO_TCPV6) &&
+	  tcp_header_bytes (tcp) >= sizeof (tcp_header_t))
+	{
+	  vnet_buffer2 (b)->gso_size = hdr->gso_size;
+	  vnet_buffer2 (b)->gso_l4_hdr_sz = tcp_header_bytes (tcp);
+	  if (gso_is_valid (b))
+	    b->flags |= VNET_BUFFER_F_GSO;
+	}
+    }
+  else if (hdr->csum_offset == STRUCT_OFFSET_OF (udp_header_t, checksum))
+    {
+      udp_header_t *udp = (udp_header_t *) (b->data + l4_hdr_offset);
+      udp->checksum = 0;
+      b->flags |= VNET_BUFFER_F_OFFLOAD_UDP_CKSUM;
+    }
+}
+
+/*
+ * The pseudo header checksum a virtio peer expects in the L4 checksum
+ * field of a packet sent with VIRTIO_NET_HDR_F_NEEDS_CSUM.
+ */
+static_always_inline u16
+virtio_offload_pseudo_header_csum (vlib_buffer_t * b, u8 protocol)
+{
+  ip_csum_t sum;
+  u16 l4_len;
+
+  if (b->flags & VNET_BUFFER_F_IS_IP4)
+    {
+      ip4_header_t *ip4 =
+	(ip4_header_t *) (b->data + vnet_buffer (b)->l3_hdr_offset);
+      l4_len = clib_net_to_host_u16 (ip4->length) - ip4_header_bytes (ip4);
+      sum = clib_host_to_net_u32 (l4_len + (protocol << 16));
+      sum = ip_csum_with_carry (sum, ip4->src_address.as_u32);
+      sum = ip_csum_with_carry (sum, ip4->dst_address.as_u32);
+    }
+  else
+    {
+      ip6_header_t *ip6 =
+	(ip6_header_t *) (b->data + vnet_buffer (b)->l3_hdr_offset);
+      l4_len = clib_net_to_host_u16 (ip6->payload_length) -
+	(vnet_buffer (b)->l4_hdr_offset - vnet_buffer (b)->l3_hdr_offset -
+	 sizeof (ip6_header_t));
+      sum = clib_host_to_net_u32 (l4_len + (protocol << 16));
+      sum = ip_csum_with_carry (sum, ip6->src_address.as_u64[0]);
+      sum = ip_csum_with_carry (sum, ip6->src_address.as_u64[1]);
+      sum = ip_csum_with_carry (sum, ip6->dst_address.as_u64[0]);
+      sum = ip_csum_with_carry (sum, ip6->dst_address.as_u64[1]);
+    }
+
+  return ip_csum_fold (sum);
+}
+
+/*
+ * Fill the offload fields of the virtio-net header a packet is sent
+ * with, leaving its L4 checksum to the peer. GSO is passed on only if
+ * the peer accepts it, is_gso_enabled, else it must have been segmented
+ * already.
+ */
+static_always_inline void
+virtio_offload_buffer_to_hdr (vlib_buffer_t * b, struct virtio_net_hdr *hdr,
+			      int is_gso_enabled)
+{
+  i16 l4_hdr_offset = vnet_buffer (b)->l4_hdr_offset;
+
+  if (PREDICT_TRUE (!(b->flags & (VNET_BUFFER_F_OFFLOAD_TCP_CKSUM |
+				  VNET_BUFFER_F_OFFLOAD_UDP_CKSUM))) ||
+      !(b->flags & (VNET_BUFFER_F_IS_IP4 | VNET_BUFFER_F_IS_IP6)))
+    return;
+
+  if (b->flags & VNET_BUFFER_F_OFFLOAD_IP_CKSUM)
+    {
+      ip4_header_t *ip4 =
+	(ip4_header_t *) (b->data + vnet_buffer (b)->l3_hdr_offset);
+      ip4->checksum = ip4_header_checksum (ip4);
+      b->flags &= ~VNET_BUFFER_F_OFFLOAD_IP_CKSUM;
+    }
+
+  hdr->flags = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+  hdr->csum_start = l4_hdr_offset - b->current_data;
+
+  if (b->flags & VNET_BUFFER_F_OFFLOAD_TCP_CKSUM)
+    {
+      tcp_header_t *tcp = (tcp_header_t *) (b->data + l4_hdr_offset);
+      hdr->csum_offset = STRUCT_OFFSET_OF (tcp_header_t, checksum);
+      tcp->checksum = virtio_offload_pseudo_header_csum (b,
+							 IP_PROTOCOL_TCP);
+
+      if (is_gso_enabled && (b->flags & VNET_BUFFER_F_GSO))
+	{
+	  hdr->gso_type = (b->flags & VNET_BUFFER_F_IS_IP4) ?
+	    VIRTIO_NET_HDR_GSO_TCPV4 : VIRTIO_NET_HDR_GSO_TCPV6;
+	  hdr->gso_size = vnet_buffer2 (b)->gso_size;
+	  hdr->hdr_len = hdr->csum_start + vnet_buffer2 (b)->gso_l4_hdr_sz;
+	}
+    }
+  else
+    {
+      udp_header_t *udp = (udp_header_t *) (b->data + l4_hdr_offset);
+      hdr->csum_offset = STRUCT_OFFSET_OF (udp_header_t, checksum);
+      udp->checksum = virtio_offload_pseudo_header_csum (b,
+							 IP_PROTOCOL_UDP);
+    }
+}
+
+#endif /* _VNET_DEVICES_VIRTIO_VIRTIO_OFFLOAD_H_ */
+
+/*
+ * fd.io coding-style-patch-verification: ON
+ *
+ * Local Variables:
+ * eval: (c-set-style "gnu")
+ * End:
+ */
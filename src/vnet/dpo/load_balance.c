@@ -21,6 +21,7 @@
 #include <vnet/adj/adj.h>
 #include <vnet/adj/adj_internal.h>
 #include <vnet/fib/fib_urpf_list.h>
+#include <vnet/ip/ip_flow_cache.h>
 #include <vnet/bier/bier_hdr_inlines.h>
 
 /*
@@ -28,6 +29,16 @@
  */
 const f64 multipath_next_hop_error_tolerance = 0.1;
 
+/*
+ * Default seconds between ageing the resilient load-balance bucket activity
+ */
+#define LB_RESILIENT_DEFAULT_AGE_INTERVAL 30.0
+
+/*
+ * Default number of buckets in a resilient load-balance
+ */
+#define LB_RESILIENT_DEFAULT_N_BUCKETS 1024
+
 #undef LB_DEBUG
 
 #ifdef LB_DEBUG
@@ -122,6 +133,14 @@ load_balance_format (index_t lbi,
     s = format(s, "[proto:%U ", format_dpo_proto, lb->lb_proto);
     s = format(s, "index:%d buckets:%d ", lbi, lb->lb_n_buckets);
     s = format(s, "uRPF:%d ", lb->lb_urpf);
+    if (lb->lb_flags & LOAD_BALANCE_FLAG_RESILIENT)
+    {
+        s = format(s, "resilient active:%d was-active:%d ",
+                   clib_bitmap_count_set_bits(
+                       load_balance_main.lbm_bucket_active[lbi]),
+                   clib_bitmap_count_set_bits(
+                       load_balance_main.lbm_bucket_was_active[lbi]));
+    }
     s = format(s, "to:[%Ld:%Ld]", to.packets, to.bytes);
     if (0 != via.packets)
     {
@@ -205,6 +224,7 @@ load_balance_set_bucket_i (load_balance_t *lb,
                            const dpo_id_t *next)
 {
     dpo_stack(DPO_LOAD_BALANCE, lb->lb_proto, &buckets[bucket], next);
+    ip_flow_cache_invalidate();
 }
 
 void
@@ -490,6 +510,185 @@ load_balance_set_n_buckets (load_balance_t *lb,
     lb->lb_n_buckets_minus_1 = n_buckets-1;
 }
 
+/*
+ * Resilient hashing.
+ * The load-balance has a fixed, large, number of buckets and each path
+ * owns a share of them in proportion to its weight. When the paths change
+ * a bucket only moves if the path it uses is gone or has more than its
+ * share, so the flows in all other buckets keep their next-hop. Of the
+ * buckets a path must give up, those that have carried no traffic
+ * recently go first.
+ */
+static int
+load_balance_use_resilient (const load_balance_t *lb,
+                            const load_balance_path_t *nhs)
+{
+    switch (lb->lb_proto)
+    {
+    case DPO_PROTO_IP4:
+    case DPO_PROTO_IP6:
+    case DPO_PROTO_MPLS:
+        return (vec_len(nhs) > 1 &&
+                vec_len(nhs) <= load_balance_main.lbm_resilient_n_buckets);
+    default:
+        break;
+    }
+    return (0);
+}
+
+/*
+ * Share out n_buckets among the normalised paths; each gets at least one.
+ */
+static void
+load_balance_resilient_share (load_balance_path_t *nhs,
+                              u32 n_buckets)
+{
+    u32 sum_of_weights, n_left, ii;
+    load_balance_path_t *nh;
+
+    sum_of_weights = 0;
+    vec_foreach (nh, nhs)
+    {
+        sum_of_weights += nh->path_weight;
+    }
+
+    n_left = n_buckets - vec_len(nhs);
+    vec_foreach (nh, nhs)
+    {
+        nh->path_weight = 1 + ((u64) nh->path_weight *
+                               (n_buckets - vec_len(nhs)) / sum_of_weights);
+        n_left -= nh->path_weight - 1;
+    }
+
+    /*
+     * the rounding remainder goes to the heaviest paths, which the
+     * normalisation left at the end
+     */
+    for (ii = vec_len(nhs) - 1; n_left > 0; ii = (ii ? ii - 1 : vec_len(nhs) - 1))
+    {
+        nhs[ii].path_weight++;
+        n_left--;
+    }
+}
+
+static void
+load_balance_resilient_validate (load_balance_t *lb,
+                                 u32 n_buckets)
+{
+    load_balance_main_t *lbm = &load_balance_main;
+    index_t lbi = load_balance_get_index(lb);
+
+    vec_validate(lbm->lbm_bucket_active, lbi);
+    vec_validate(lbm->lbm_bucket_was_active, lbi);
+    clib_bitmap_validate(lbm->lbm_bucket_active[lbi], n_buckets);
+    clib_bitmap_validate(lbm->lbm_bucket_was_active[lbi], n_buckets);
+}
+
+static void
+load_balance_resilient_free (load_balance_t *lb)
+{
+    load_balance_main_t *lbm = &load_balance_main;
+    index_t lbi = load_balance_get_index(lb);
+
+    lb->lb_flags &= ~LOAD_BALANCE_FLAG_RESILIENT;
+
+    if (lbi < vec_len(lbm->lbm_bucket_active))
+    {
+        clib_bitmap_free(lbm->lbm_bucket_active[lbi]);
+        clib_bitmap_free(lbm->lbm_bucket_was_active[lbi]);
+    }
+}
+
+static int
+load_balance_resilient_bucket_is_active (index_t lbi,
+                                         u32 bucket)
+{
+    load_balance_main_t *lbm = &load_balance_main;
+
+    return (clib_bitmap_get(lbm->lbm_bucket_active[lbi], bucket) ||
+            clib_bitmap_get(lbm->lbm_bucket_was_active[lbi], bucket));
+}
+
+/*
+ * Reassign the buckets of a resilient load-balance to the new paths,
+ * whose weights are their share of the buckets, leaving as many buckets
+ * as possible where they are.
+ */
+static void
+load_balance_resilient_fill_buckets (load_balance_t *lb,
+                                     load_balance_path_t *nhs,
+                                     u32 n_buckets)
+{
+    u32 *owner, *n_owned, bucket, ii, pass;
+    dpo_id_t *buckets;
+    index_t lbi;
+
+    owner = n_owned = NULL;
+    lbi = load_balance_get_index(lb);
+    buckets = load_balance_get_buckets(lb);
+
+    vec_validate_init_empty(owner, n_buckets - 1, ~0);
+    vec_validate_init_empty(n_owned, vec_len(nhs) - 1, 0);
+
+    /*
+     * which of the new paths, if any, each bucket already uses
+     */
+    for (bucket = 0; bucket < n_buckets; bucket++)
+    {
+        vec_foreach_index (ii, nhs)
+        {
+            if (buckets[bucket].dpoi_type == nhs[ii].path_dpo.dpoi_type &&
+                buckets[bucket].dpoi_index == nhs[ii].path_dpo.dpoi_index)
+            {
+                owner[bucket] = ii;
+                n_owned[ii]++;
+                break;
+            }
+        }
+    }
+
+    /*
+     * paths with more than their share give up the excess; idle buckets
+     * on the first pass, any on the second
+     */
+    for (pass = 0; pass < 2; pass++)
+    {
+        for (bucket = 0; bucket < n_buckets; bucket++)
+        {
+            ii = owner[bucket];
+
+            if (~0 == ii || n_owned[ii] <= nhs[ii].path_weight)
+                continue;
+            if (0 == pass &&
+                load_balance_resilient_bucket_is_active(lbi, bucket))
+                continue;
+
+            owner[bucket] = ~0;
+            n_owned[ii]--;
+        }
+    }
+
+    /*
+     * the free buckets go to the paths short of their share
+     */
+    ii = 0;
+    for (bucket = 0; bucket < n_buckets; bucket++)
+    {
+        if (~0 != owner[bucket])
+            continue;
+
+        while (n_owned[ii] >= nhs[ii].path_weight)
+            ii++;
+
+        ASSERT(ii < vec_len(nhs));
+        n_owned[ii]++;
+        load_balance_set_bucket_i(lb, bucket, buckets, &nhs[ii].path_dpo);
+    }
+
+    vec_free(owner);
+    vec_free(n_owned);
+}
+
 void
 load_balance_multipath_update (const dpo_id_t *dpo,
                                const load_balance_path_t * raw_nhs,
@@ -500,6 +699,7 @@ load_balance_multipath_update (const dpo_id_t *dpo,
     index_t lbmi, old_lbmi;
     load_balance_t *lb;
     dpo_id_t *tmp_dpo;
+    int is_resilient;
 
     nhs = NULL;
 
@@ -516,11 +716,24 @@ load_balance_multipath_update (const dpo_id_t *dpo,
 
     ASSERT (n_buckets >= vec_len (raw_nhs));
 
+    /*
+     * A resilient load-balance has the configured number of buckets,
+     * shared between the paths. It does not use a map, since the buckets
+     * of each path are not contiguous.
+     */
+    is_resilient = load_balance_use_resilient(lb, nhs);
+    if (is_resilient)
+    {
+        n_buckets = load_balance_main.lbm_resilient_n_buckets;
+        load_balance_resilient_share(nhs, n_buckets);
+        load_balance_resilient_validate(lb, n_buckets);
+    }
+
     /*
      * Save the old load-balance map used, and get a new one if required.
      */
     old_lbmi = lb->lb_map;
-    if (flags & LOAD_BALANCE_FLAG_USES_MAP)
+    if ((flags & LOAD_BALANCE_FLAG_USES_MAP) && !is_resilient)
     {
         lbmi = load_balance_map_add_or_lock(n_buckets, sum_of_weights, nhs);
     }
@@ -561,11 +774,19 @@ load_balance_multipath_update (const dpo_id_t *dpo,
         {
             /*
              * no change in the number of buckets. we can simply fill what
-             * is new over what is old.
+             * is new over what is old; a resilient update changes only
+             * the buckets it must.
              */
-            load_balance_fill_buckets(lb, nhs,
-                                      load_balance_get_buckets(lb),
-                                      n_buckets);
+            if (is_resilient && (lb->lb_flags & LOAD_BALANCE_FLAG_RESILIENT))
+            {
+                load_balance_resilient_fill_buckets(lb, nhs, n_buckets);
+            }
+            else
+            {
+                load_balance_fill_buckets(lb, nhs,
+                                          load_balance_get_buckets(lb),
+                                          n_buckets);
+            }
             lb->lb_map = lbmi;
         }
         else if (n_buckets > lb->lb_n_buckets)
@@ -714,6 +935,15 @@ load_balance_multipath_update (const dpo_id_t *dpo,
         }
     }
 
+    if (is_resilient)
+    {
+        lb->lb_flags |= LOAD_BALANCE_FLAG_RESILIENT;
+    }
+    else if (lb->lb_flags & LOAD_BALANCE_FLAG_RESILIENT)
+    {
+        load_balance_resilient_free(lb);
+    }
+
     vec_foreach (nh, nhs)
     {
         dpo_reset(&nh->path_dpo);
@@ -756,6 +986,11 @@ load_balance_destroy (load_balance_t *lb)
     fib_urpf_list_unlock(lb->lb_urpf);
     load_balance_map_unlock(lb->lb_map);
 
+    if (lb->lb_flags & LOAD_BALANCE_FLAG_RESILIENT)
+    {
+        load_balance_resilient_free(lb);
+    }
+
     pool_put(load_balance_pool, lb);
 }
 
@@ -858,6 +1093,9 @@ load_balance_module_init (void)
     lbi = load_balance_create(1, DPO_PROTO_IP4, 0);
     load_balance_set_bucket(lbi, 0, drop_dpo_get(DPO_PROTO_IP4));
 
+    load_balance_main.lbm_resilient_age_interval =
+        LB_RESILIENT_DEFAULT_AGE_INTERVAL;
+
     load_balance_map_module_init();
 }
 
@@ -902,6 +1140,129 @@ VLIB_CLI_COMMAND (load_balance_show_command, static) = {
     .function = load_balance_show,
 };
 
+/**
+ * Age the bucket activity of the resilient load-balances; a bucket is
+ * idle once it has carried no traffic for one whole interval.
+ */
+static void
+load_balance_resilient_age (void)
+{
+    load_balance_main_t *lbm = &load_balance_main;
+    uword *active, *was_active;
+    index_t lbi;
+    u32 ii;
+
+    vec_foreach_index (lbi, lbm->lbm_bucket_active)
+    {
+        active = lbm->lbm_bucket_active[lbi];
+        was_active = lbm->lbm_bucket_was_active[lbi];
+
+        for (ii = 0; ii < vec_len(active); ii++)
+        {
+            was_active[ii] = active[ii];
+            active[ii] = 0;
+        }
+    }
+}
+
+static uword
+load_balance_resilient_process (vlib_main_t * vm,
+                                vlib_node_runtime_t * rt,
+                                vlib_frame_t * f)
+{
+    load_balance_main_t *lbm = &load_balance_main;
+
+    while (1)
+    {
+        if (0 == lbm->lbm_resilient_n_buckets)
+        {
+            vlib_process_wait_for_event (vm);
+        }
+        else
+        {
+            vlib_process_wait_for_event_or_clock (
+                vm, lbm->lbm_resilient_age_interval);
+        }
+        vlib_process_get_events (vm, NULL);
+
+        load_balance_resilient_age();
+    }
+
+    return (0);
+}
+
+/* *INDENT-OFF* */
+VLIB_REGISTER_NODE (load_balance_resilient_process_node,static) = {
+    .function = load_balance_resilient_process,
+    .type = VLIB_NODE_TYPE_PROCESS,
+    .name = "load-balance-resilient-age",
+};
+/* *INDENT-ON* */
+
+static clib_error_t *
+load_balance_set_resilient (vlib_main_t * vm,
+                            unformat_input_t * input,
+                            vlib_cli_command_t * cmd)
+{
+    load_balance_main_t *lbm = &load_balance_main;
+    u32 n_buckets = (lbm->lbm_resilient_n_buckets ?
+                     lbm->lbm_resilient_n_buckets :
+                     LB_RESILIENT_DEFAULT_N_BUCKETS);
+    f64 age = lbm->lbm_resilient_age_interval;
+
+    while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+        if (unformat (input, "buckets %d", &n_buckets))
+            ;
+        else if (unformat (input, "age %f", &age))
+            ;
+        else if (unformat (input, "disable") ||
+                 unformat (input, "off"))
+            n_buckets = 0;
+        else
+            return (clib_error_return (0, "unknown input `%U'",
+                                       format_unformat_error, input));
+    }
+
+    /* the bucket count is a u16 power of 2 */
+    if (0 != n_buckets &&
+        (!is_pow2(n_buckets) || n_buckets < 2 || n_buckets > (1 << 15)))
+        return (clib_error_return (0, "buckets must be a power of 2 "
+                                   "between 2 and %d", 1 << 15));
+    if (age <= 0)
+        return (clib_error_return (0, "age must be positive"));
+
+    lbm->lbm_resilient_n_buckets = n_buckets;
+    lbm->lbm_resilient_age_interval = age;
+
+    vlib_process_signal_event (vm, load_balance_resilient_process_node.index,
+                               0, 0);
+
+    return (NULL);
+}
+
+/*?
+ * Use resilient hashing for IPv4, IPv6 and MPLS ECMP. A resilient
+ * load-balance has the given number of buckets, shared between its paths
+ * by weight. When a path is added or removed only the buckets that must
+ * move do so, idle ones first, so most flows keep their next-hop. A
+ * bucket is idle once it has carried no traffic for one 'age' interval.
+ * The setting applies to each load-balance the next time its paths
+ * change. Resilient load-balances do not use load-balance maps, so a
+ * recursive route's failover waits for its paths to be updated.
+ *
+ * @cliexpar
+ * @cliexcmd{set load-balance resilient buckets 512 age 10}
+ * @cliexcmd{set load-balance resilient disable}
+ ?*/
+/* *INDENT-OFF* */
+VLIB_CLI_COMMAND (load_balance_set_resilient_command, static) = {
+    .path = "set load-balance resilient",
+    .short_help = "set load-balance resilient [buckets <n>] [age <seconds>] [disable]",
+    .function = load_balance_set_resilient,
+};
+/* *INDENT-ON* */
+
 
 always_inline u32
 ip_flow_hash (void *data)
@@ -45,6 +45,25 @@ typedef struct load_balance_main_t_
 {
     vlib_combined_counter_main_t lbm_to_counters;
     vlib_combined_counter_main_t lbm_via_counters;
+
+    /**
+     * The number of buckets in a resilient load-balance.
+     * 0 => resilient hashing is off.
+     */
+    u32 lbm_resilient_n_buckets;
+
+    /**
+     * Seconds between each ageing of the bucket activity
+     */
+    f64 lbm_resilient_age_interval;
+
+    /**
+     * Per-load-balance bitmaps of the buckets used since, and in the
+     * interval before, the last ageing. Indexed by load-balance index
+     * and only allocated for resilient load-balances.
+     */
+    uword **lbm_bucket_active;
+    uword **lbm_bucket_was_active;
 } load_balance_main_t;
 
 extern load_balance_main_t load_balance_main;
@@ -105,6 +124,11 @@ typedef struct load_balance_t_ {
      */
     dpo_proto_t lb_proto;
 
+    /**
+     * load_balance_flags_t describing how the buckets are assigned. u8.
+     */
+    u8 lb_flags;
+
     /**
      * Flags from the load-balance's associated fib_entry_t
      */
@@ -164,6 +188,11 @@ typedef enum load_balance_format_flags_t_ {
 typedef enum load_balance_flags_t_ {
     LOAD_BALANCE_FLAG_NONE = 0,
     LOAD_BALANCE_FLAG_USES_MAP = (1 << 0),
+    /**
+     * The buckets are assigned resiliently, i.e. a path change only moves
+     * the buckets it must. Set by the load-balance itself, not the caller.
+     */
+    LOAD_BALANCE_FLAG_RESILIENT = (1 << 1),
 } load_balance_flags_t;
 
 extern index_t load_balance_create(u32 num_buckets,
@@ -202,6 +231,27 @@ load_balance_get (index_t lbi)
     return (pool_elt_at_index(load_balance_pool, lbi));
 }
 
+/**
+ * @brief Note that a bucket of a resilient load-balance carried traffic,
+ * so it is not chosen to move when the paths change. The bit is only
+ * written the first time in each interval, and a bit lost to a
+ * concurrent write from another thread just makes the bucket look idle.
+ */
+static inline void
+load_balance_bucket_mark_active (const load_balance_t *lb,
+                                 u32 bucket)
+{
+    uword *active, mask;
+
+    active = load_balance_main.lbm_bucket_active[lb - load_balance_pool];
+    mask = (uword) 1 << (bucket % BITS(uword));
+
+    if (PREDICT_FALSE(!(active[bucket / BITS(uword)] & mask)))
+    {
+        __sync_fetch_and_or(&active[bucket / BITS(uword)], mask);
+    }
+}
+
 #define LB_HAS_INLINE_BUCKETS(_lb)		\
     ((_lb)->lb_n_buckets <= LB_NUM_INLINE_BUCKETS)
 
@@ -19,6 +19,7 @@
 #include <vnet/fib/fib_node_list.h>
 #include <vnet/dpo/load_balance_map.h>
 #include <vnet/dpo/load_balance.h>
+#include <vnet/ip/ip_flow_cache.h>
 
 /**
  * A hash-table of load-balance maps by path index.
@@ -513,6 +514,7 @@ load_balance_map_path_state_change (fib_node_index_t path_index)
         return;
 
     fib_node_list_walk(p[0], load_balance_map_path_state_change_walk, NULL);
+    ip_flow_cache_invalidate();
 }
 
 /**
@@ -96,6 +96,11 @@ load_balance_get_fwd_bucket (const load_balance_t *lb,
 {
     ASSERT(bucket < lb->lb_n_buckets);
 
+    if (PREDICT_FALSE(lb->lb_flags & LOAD_BALANCE_FLAG_RESILIENT))
+    {
+        load_balance_bucket_mark_active(lb, bucket);
+    }
+
     if (INDEX_INVALID != lb->lb_map)
     {
         bucket = load_balance_map_translate(lb->lb_map, bucket);
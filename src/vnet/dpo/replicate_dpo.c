@@ -631,90 +631,111 @@ replicate_inline (vlib_main_t * vm,
 {
     vlib_combined_counter_main_t * cm = &replicate_main.repm_counters;
     replicate_main_t * rm = &replicate_main;
-    u32 n_left_from, * from, * to_next, next_index;
+    u32 n_left_from, * from, * clones, n_clones;
     u32 thread_index = vlib_get_thread_index();
+    u16 * nexts;
 
     from = vlib_frame_vector_args (frame);
     n_left_from = frame->n_vectors;
-    next_index = node->cached_next_index;
-  
+    clones = rm->clones[thread_index];
+    nexts = rm->nexts[thread_index];
+    n_clones = 0;
+
+    /*
+     * The clones of all packets are gathered, with their next nodes, and
+     * enqueued a frame's worth at a time; so the replicas of the packets
+     * of a group, which go to the same set of next nodes, are enqueued
+     * as runs and not one at a time.
+     */
     while (n_left_from > 0)
     {
-        u32 n_left_to_next;
-
-        vlib_get_next_frame (vm, node, next_index,
-                             to_next, n_left_to_next);
+        u32 next0, ci0, bi0, bucket, repi0;
+        const replicate_t *rep0;
+        vlib_buffer_t * b0, *c0;
+        const dpo_id_t *dpo0;
+        u16 num_cloned;
 
-        while (n_left_from > 0 && n_left_to_next > 0)
-	{
-            u32 next0, ci0, bi0, bucket, repi0;
-            const replicate_t *rep0;
-            vlib_buffer_t * b0, *c0;
-            const dpo_id_t *dpo0;
-	    u8 num_cloned;
+        bi0 = from[0];
+        from += 1;
+        n_left_from -= 1;
 
-            bi0 = from[0];
-            from += 1;
-            n_left_from -= 1;
-
-            b0 = vlib_get_buffer (vm, bi0);
-            repi0 = vnet_buffer (b0)->ip.adj_index[VLIB_TX];
-            rep0 = replicate_get(repi0);
+        if (PREDICT_TRUE(n_left_from > 0))
+        {
+            vlib_buffer_t * p1;
 
-            vlib_increment_combined_counter(
-                cm, thread_index, repi0, 1,
-                vlib_buffer_length_in_chain(vm, b0));
+            p1 = vlib_get_buffer (vm, from[0]);
+            vlib_prefetch_buffer_header (p1, LOAD);
+        }
 
-	    vec_validate (rm->clones[thread_index], rep0->rep_n_buckets - 1);
+        b0 = vlib_get_buffer (vm, bi0);
+        repi0 = vnet_buffer (b0)->ip.adj_index[VLIB_TX];
+        rep0 = replicate_get(repi0);
 
-	    num_cloned = vlib_buffer_clone (vm, bi0, rm->clones[thread_index],
-                                            rep0->rep_n_buckets, 128);
+        vlib_increment_combined_counter(
+            cm, thread_index, repi0, 1,
+            vlib_buffer_length_in_chain(vm, b0));
 
-	    if (num_cloned != rep0->rep_n_buckets)
-	      {
-		vlib_node_increment_counter
-		  (vm, node->node_index,
-		   REPLICATE_DPO_ERROR_BUFFER_ALLOCATION_FAILURE, 1);
-	      }
+        /*
+         * the enqueue compares the nexts a vector register at a time, so
+         * it may read up to 32 past the last
+         */
+        vec_validate (clones, n_clones + rep0->rep_n_buckets - 1);
+        vec_validate (nexts, n_clones + rep0->rep_n_buckets + 31);
 
-            for (bucket = 0; bucket < num_cloned; bucket++)
-            {
-                ci0 = rm->clones[thread_index][bucket];
-                c0 = vlib_get_buffer(vm, ci0);
+        /*
+         * the clones are allocated in bulk and share the payload,
+         * each with its own copy of the headers to rewrite
+         */
+        num_cloned = vlib_buffer_clone (vm, bi0, clones + n_clones,
+                                        rep0->rep_n_buckets, 128);
 
-                to_next[0] = ci0;
-                to_next += 1;
-                n_left_to_next -= 1;
+        if (num_cloned != rep0->rep_n_buckets)
+        {
+            vlib_node_increment_counter
+                (vm, node->node_index,
+                 REPLICATE_DPO_ERROR_BUFFER_ALLOCATION_FAILURE, 1);
+        }
 
-                dpo0 = replicate_get_bucket_i(rep0, bucket);
-                next0 = dpo0->dpoi_next_node;
-                vnet_buffer (c0)->ip.adj_index[VLIB_TX] = dpo0->dpoi_index;
+        for (bucket = 0; bucket < num_cloned; bucket++)
+        {
+            ci0 = clones[n_clones + bucket];
+            c0 = vlib_get_buffer(vm, ci0);
 
-                if (PREDICT_FALSE(c0->flags & VLIB_BUFFER_IS_TRACED))
-                {
-                    replicate_trace_t *t;
+            dpo0 = replicate_get_bucket_i(rep0, bucket);
+            next0 = dpo0->dpoi_next_node;
+            nexts[n_clones + bucket] = next0;
+            vnet_buffer (c0)->ip.adj_index[VLIB_TX] = dpo0->dpoi_index;
 
-                    vlib_trace_buffer (vm, node, next0, c0, 0);
-                    t = vlib_add_trace (vm, node, c0, sizeof (*t));
-                    t->rep_index = repi0;
-                    t->dpo = *dpo0;
-                }
+            if (PREDICT_FALSE(c0->flags & VLIB_BUFFER_IS_TRACED))
+            {
+                replicate_trace_t *t;
 
-                vlib_validate_buffer_enqueue_x1 (vm, node, next_index,
-                                                 to_next, n_left_to_next,
-                                                 ci0, next0);
-		if (PREDICT_FALSE (n_left_to_next == 0))
-		  {
-		    vlib_put_next_frame (vm, node, next_index, n_left_to_next);
-		    vlib_get_next_frame (vm, node, next_index, to_next, n_left_to_next);
-		  }
+                vlib_trace_buffer (vm, node, next0, c0, 0);
+                t = vlib_add_trace (vm, node, c0, sizeof (*t));
+                t->rep_index = repi0;
+                t->dpo = *dpo0;
             }
-	    vec_reset_length (rm->clones[thread_index]);
         }
+        n_clones += num_cloned;
 
-        vlib_put_next_frame (vm, node, next_index, n_left_to_next);
+        if (n_clones >= VLIB_FRAME_SIZE)
+        {
+            vlib_buffer_enqueue_to_next (vm, node, clones, nexts, n_clones);
+            n_clones = 0;
+        }
     }
 
+    if (n_clones)
+    {
+        vlib_buffer_enqueue_to_next (vm, node, clones, nexts, n_clones);
+    }
+
+    /*
+     * save the per-cpu vectors, they may have grown
+     */
+    rm->clones[thread_index] = clones;
+    rm->nexts[thread_index] = nexts;
+
     return frame->n_vectors;
 }
 
@@ -815,6 +836,7 @@ replicate_dpo_init (vlib_main_t * vm)
   replicate_main_t * rm = &replicate_main;
 
   vec_validate (rm->clones, vlib_num_workers());
+  vec_validate (rm->nexts, vlib_num_workers());
 
   return 0;
 }
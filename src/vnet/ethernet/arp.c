@@ -21,6 +21,7 @@
 #include <vnet/ethernet/arp.h>
 #include <vnet/l2/l2_input.h>
 #include <vppinfra/mhash.h>
+#include <vppinfra/bihash_8_8.h>
 #include <vnet/fib/ip4_fib.h>
 #include <vnet/fib/fib_entry_src.h>
 #include <vnet/adj/adj_nbr.h>
@@ -44,10 +45,10 @@ void vl_api_rpc_call_main_thread (void *fp, u8 * data, u32 data_length);
 typedef struct ethernet_arp_interface_t_
 {
   /**
-   * Hash table of ARP entries.
-   * Since this hash table is per-interface, the key is only the IPv4 address.
+   * The number of ARP entries on the interface. The entries themselves
+   * are in the global DB, keyed by interface and address.
    */
-  uword *arp_entries;
+  u32 n_entries;
 } ethernet_arp_interface_t;
 
 typedef struct
@@ -68,6 +69,24 @@ typedef struct
   u32 pid;
 } pending_resolution_t;
 
+/**
+ * @brief ARP table counters, shown by 'show ip arp summary'
+ */
+typedef struct ethernet_arp_counters_t_
+{
+  /** Entries created */
+  u64 n_added;
+  /** Addresses sent to the main thread to learn, and in how many batches */
+  u64 n_learns;
+  u64 n_learn_batches;
+  /** Dynamic entries removed to make room for new ones at the limit */
+  u64 n_recycled;
+  /** New entries refused at the limit, having found none to recycle */
+  u64 n_limit_drops;
+  /** Dynamic entries removed by the age scan */
+  u64 n_aged;
+} ethernet_arp_counters_t;
+
 typedef struct
 {
   /* Hash tables mapping name to opcode. */
@@ -83,10 +102,32 @@ typedef struct
 
   ethernet_arp_ip4_entry_t *ip4_entry_pool;
 
+  /**
+   * Indices of the ARP entries keyed by {sw_if_index, IPv4 address}
+   */
+  clib_bihash_8_8_t arp_db;
+
   /* ARP attack mitigation */
   u32 arp_delete_rotor;
   u32 limit_arp_cache_size;
 
+  /**
+   * Dynamic entries not refreshed for this many seconds are removed.
+   * Zero disables aging.
+   */
+  u32 arp_age;
+
+  /** The age scan's position in the entry pool */
+  u32 arp_age_rotor;
+
+  /**
+   * Per-thread batch of addresses learned by arp-input, sent to the main
+   * thread in one RPC at the end of each frame.
+   */
+  u8 **learn_batch_by_thread;
+
+  ethernet_arp_counters_t counters;
+
   /** Per interface state */
   ethernet_arp_interface_t *ethernet_arp_by_sw_if_index;
 
@@ -112,6 +153,30 @@ typedef struct
 #define ETHERNET_ARP_ARGS_WC_PUB  (1<<3)
 } vnet_arp_set_ip4_over_ethernet_rpc_args_t;
 
+/**
+ * @brief A batch of ARP RPCs that the main thread applies under one
+ * barrier sync.
+ */
+typedef struct arp_rpc_batch_t_
+{
+  u32 n_args;
+  vnet_arp_set_ip4_over_ethernet_rpc_args_t args[0];
+} arp_rpc_batch_t;
+
+/**
+ * Number of seconds between age scans
+ */
+#define ARP_AGE_SCAN_INTERVAL 1.0
+
+/**
+ * The least number of pool slots each age scan visits. More are visited
+ * when needed to scan the whole pool once per age period.
+ */
+#define ARP_AGE_SCAN_MIN 1024
+
+#define ARP_DB_N_BUCKETS (64 * 1024)
+#define ARP_DB_MEMORY_SIZE (32 << 20)
+
 static const u8 vrrp_prefix[] = { 0x00, 0x00, 0x5E, 0x00, 0x01 };
 
 /* Node index for send_garp_na_process */
@@ -404,23 +469,50 @@ arp_mk_incomplete (adj_index_t ai)
 			     VNET_REWRITE_FOR_SW_INTERFACE_ADDRESS_BROADCAST));
 }
 
+static inline void
+arp_db_mk_key (clib_bihash_kv_8_8_t * kv,
+	       u32 sw_if_index, const ip4_address_t * addr)
+{
+  kv->key = ((u64) sw_if_index << 32) | addr->as_u32;
+}
+
 static ethernet_arp_ip4_entry_t *
-arp_entry_find (ethernet_arp_interface_t * eai, const ip4_address_t * addr)
+arp_entry_find (u32 sw_if_index, const ip4_address_t * addr)
 {
   ethernet_arp_main_t *am = &ethernet_arp_main;
-  ethernet_arp_ip4_entry_t *e = NULL;
-  uword *p;
+  clib_bihash_kv_8_8_t kv;
 
-  if (NULL != eai->arp_entries)
-    {
-      p = hash_get (eai->arp_entries, addr->as_u32);
-      if (!p)
-	return (NULL);
+  arp_db_mk_key (&kv, sw_if_index, addr);
 
-      e = pool_elt_at_index (am->ip4_entry_pool, p[0]);
-    }
+  if (clib_bihash_search_8_8 (&am->arp_db, &kv, &kv))
+    return (NULL);
+
+  return (pool_elt_at_index (am->ip4_entry_pool, kv.value));
+}
+
+static void
+arp_db_add (ethernet_arp_ip4_entry_t * e)
+{
+  ethernet_arp_main_t *am = &ethernet_arp_main;
+  clib_bihash_kv_8_8_t kv;
+
+  arp_db_mk_key (&kv, e->sw_if_index, &e->ip4_address);
+  kv.value = e - am->ip4_entry_pool;
 
-  return (e);
+  clib_bihash_add_del_8_8 (&am->arp_db, &kv, 1);
+  am->ethernet_arp_by_sw_if_index[e->sw_if_index].n_entries++;
+}
+
+static void
+arp_db_remove (ethernet_arp_ip4_entry_t * e)
+{
+  ethernet_arp_main_t *am = &ethernet_arp_main;
+  clib_bihash_kv_8_8_t kv;
+
+  arp_db_mk_key (&kv, e->sw_if_index, &e->ip4_address);
+
+  clib_bihash_add_del_8_8 (&am->arp_db, &kv, 0);
+  am->ethernet_arp_by_sw_if_index[e->sw_if_index].n_entries--;
 }
 
 static adj_walk_rc_t
@@ -445,15 +537,13 @@ void
 arp_update_adjacency (vnet_main_t * vnm, u32 sw_if_index, u32 ai)
 {
   ethernet_arp_main_t *am = &ethernet_arp_main;
-  ethernet_arp_interface_t *arp_int;
   ethernet_arp_ip4_entry_t *e;
   ip_adjacency_t *adj;
 
   adj = adj_get (ai);
 
   vec_validate (am->ethernet_arp_by_sw_if_index, sw_if_index);
-  arp_int = &am->ethernet_arp_by_sw_if_index[sw_if_index];
-  e = arp_entry_find (arp_int, &adj->sub_type.nbr.next_hop.ip4);
+  e = arp_entry_find (sw_if_index, &adj->sub_type.nbr.next_hop.ip4);
 
   switch (adj->lookup_next_index)
     {
@@ -593,9 +683,8 @@ force_reuse_arp_entry (void)
   while (e->flags & ETHERNET_ARP_IP4_ENTRY_FLAG_STATIC);
 
   /* Remove ARP entry from its interface and update fib */
-  hash_unset
-    (am->ethernet_arp_by_sw_if_index[e->sw_if_index].arp_entries,
-     e->ip4_address.as_u32);
+  arp_db_remove (e);
+  am->counters.n_recycled++;
   arp_adj_fib_remove
     (e, ip4_fib_table_get_index_for_sw_if_index (e->sw_if_index));
   adj_nbr_walk_nh4 (e->sw_if_index,
@@ -615,33 +704,26 @@ vnet_arp_set_ip4_over_ethernet_internal (vnet_main_t * vnm,
   int make_new_arp_cache_entry = 1;
   uword *p;
   pending_resolution_t *pr, *mc;
-  ethernet_arp_interface_t *arp_int;
   int is_static = args->is_static;
   u32 sw_if_index = args->sw_if_index;
   int is_no_fib_entry = args->is_no_fib_entry;
 
   vec_validate (am->ethernet_arp_by_sw_if_index, sw_if_index);
 
-  arp_int = &am->ethernet_arp_by_sw_if_index[sw_if_index];
+  e = arp_entry_find (sw_if_index, &a->ip4);
 
-  if (NULL != arp_int->arp_entries)
+  if (NULL != e)
     {
-      p = hash_get (arp_int->arp_entries, a->ip4.as_u32);
-      if (p)
+      /* Refuse to over-write static arp. */
+      if (!is_static && (e->flags & ETHERNET_ARP_IP4_ENTRY_FLAG_STATIC))
 	{
-	  e = pool_elt_at_index (am->ip4_entry_pool, p[0]);
-
-	  /* Refuse to over-write static arp. */
-	  if (!is_static && (e->flags & ETHERNET_ARP_IP4_ENTRY_FLAG_STATIC))
-	    {
-	      /* if MAC address match, still check to send event */
-	      if (0 == memcmp (e->ethernet_address,
-			       a->ethernet, sizeof (e->ethernet_address)))
-		goto check_customers;
-	      return -2;
-	    }
-	  make_new_arp_cache_entry = 0;
+	  /* if MAC address match, still check to send event */
+	  if (0 == memcmp (e->ethernet_address,
+			   a->ethernet, sizeof (e->ethernet_address)))
+	    goto check_customers;
+	  return -2;
 	}
+      make_new_arp_cache_entry = 0;
     }
 
   if (make_new_arp_cache_entry)
@@ -651,19 +733,20 @@ vnet_arp_set_ip4_over_ethernet_internal (vnet_main_t * vnm,
 	{
 	  e = force_reuse_arp_entry ();
 	  if (NULL == e)
-	    return -2;
+	    {
+	      am->counters.n_limit_drops++;
+	      return -2;
+	    }
 	}
       else
 	pool_get (am->ip4_entry_pool, e);
 
-      if (NULL == arp_int->arp_entries)
-	arp_int->arp_entries = hash_create (0, sizeof (u32));
-
-      hash_set (arp_int->arp_entries, a->ip4.as_u32, e - am->ip4_entry_pool);
-
       e->sw_if_index = sw_if_index;
       e->ip4_address = a->ip4;
       e->fib_entry_index = FIB_NODE_INDEX_INVALID;
+      e->flags = 0;
+      arp_db_add (e);
+      am->counters.n_added++;
       clib_memcpy (e->ethernet_address,
 		   a->ethernet, sizeof (e->ethernet_address));
 
@@ -917,14 +1000,105 @@ arp_unnumbered (vlib_buffer_t * p0,
   return !0;
 }
 
+static void
+arp_rpc_batch_callback (arp_rpc_batch_t * batch)
+{
+  u32 i;
+
+  for (i = 0; i < batch->n_args; i++)
+    set_ip4_over_ethernet_rpc_callback (&batch->args[i]);
+}
+
+/**
+ * @brief Send a vector of RPC args to the main thread, to be applied
+ * under one barrier sync.
+ */
+static void
+arp_rpc_batch (vnet_arp_set_ip4_over_ethernet_rpc_args_t * args)
+{
+  arp_rpc_batch_t *batch;
+  u8 *data = 0;
+
+  if (0 == vec_len (args))
+    return;
+
+  vec_validate (data, sizeof (*batch) + vec_len (args) * sizeof (args[0]) - 1);
+  batch = (arp_rpc_batch_t *) data;
+  batch->n_args = vec_len (args);
+  clib_memcpy (batch->args, args, vec_len (args) * sizeof (args[0]));
+
+  vl_api_rpc_call_main_thread (arp_rpc_batch_callback, data, vec_len (data));
+  vec_free (data);
+}
+
+static void
+arp_learn_batch_callback (arp_rpc_batch_t * batch)
+{
+  ethernet_arp_main_t *am = &ethernet_arp_main;
+
+  am->counters.n_learns += batch->n_args;
+  am->counters.n_learn_batches++;
+
+  arp_rpc_batch_callback (batch);
+}
+
 static u32
 arp_learn (vnet_main_t * vnm,
 	   ethernet_arp_main_t * am, u32 sw_if_index, void *addr)
 {
-  vnet_arp_set_ip4_over_ethernet (vnm, sw_if_index, addr, 0, 0);
+  vnet_arp_set_ip4_over_ethernet_rpc_args_t *args;
+  u8 **batch_data;
+  u32 n_args;
+
+  /*
+   * add the address to this thread's batch. the batch is sent to the main
+   * thread when the frame is done.
+   */
+  batch_data = &am->learn_batch_by_thread[vlib_get_thread_index ()];
+
+  if (0 == vec_len (*batch_data))
+    vec_validate (*batch_data, sizeof (arp_rpc_batch_t) - 1);
+
+  n_args = ((arp_rpc_batch_t *) * batch_data)->n_args;
+
+  if (n_args)
+    {
+      /* a host that sends a burst is learned once */
+      args = &((arp_rpc_batch_t *) * batch_data)->args[n_args - 1];
+      if (args->sw_if_index == sw_if_index &&
+	  !memcmp (&args->a, addr, sizeof (args->a)))
+	return (ETHERNET_ARP_ERROR_l3_src_address_learned);
+    }
+
+  vec_resize (*batch_data, sizeof (*args));
+  args = &((arp_rpc_batch_t *) * batch_data)->args[n_args];
+
+  memset (args, 0, sizeof (*args));
+  args->sw_if_index = sw_if_index;
+  clib_memcpy (&args->a, addr, sizeof (args->a));
+  ((arp_rpc_batch_t *) * batch_data)->n_args++;
+
   return (ETHERNET_ARP_ERROR_l3_src_address_learned);
 }
 
+static void
+arp_learn_flush (ethernet_arp_main_t * am, u32 thread_index)
+{
+  u8 *batch_data = am->learn_batch_by_thread[thread_index];
+  arp_rpc_batch_t *batch;
+
+  if (0 == vec_len (batch_data))
+    return;
+
+  batch = (arp_rpc_batch_t *) batch_data;
+
+  if (batch->n_args)
+    vl_api_rpc_call_main_thread (arp_learn_batch_callback,
+				 batch_data, vec_len (batch_data));
+
+  vec_reset_length (am->learn_batch_by_thread[thread_index]);
+}
+
 static uword
 arp_input (vlib_main_t * vm, vlib_node_runtime_t * node, vlib_frame_t * frame)
 {
@@ -1326,6 +1500,9 @@ arp_input (vlib_main_t * vm, vlib_node_runtime_t * node, vlib_frame_t * frame)
   vlib_error_count (vm, node->node_index,
 		    ETHERNET_ARP_ERROR_proxy_arp_replies_sent,
 		    n_proxy_arp_replies_sent);
+
+  arp_learn_flush (am, vm->thread_index);
+
   return frame->n_vectors;
 }
 
@@ -1454,6 +1631,45 @@ VLIB_CLI_COMMAND (show_ip4_arp_command, static) = {
   .path = "show ip arp",
   .function = show_ip4_arp,
   .short_help = "show ip arp",
+  /* the entries are only changed on the main thread */
+  .is_mp_safe = 1,
+};
+/* *INDENT-ON* */
+
+static clib_error_t *
+show_ip4_arp_summary (vlib_main_t * vm,
+		      unformat_input_t * input, vlib_cli_command_t * cmd)
+{
+  ethernet_arp_main_t *am = &ethernet_arp_main;
+  ethernet_arp_counters_t *c = &am->counters;
+
+  vlib_cli_output (vm, "entries: %d, limit: %d, age: %d secs",
+		   pool_elts (am->ip4_entry_pool),
+		   am->limit_arp_cache_size, am->arp_age);
+  vlib_cli_output (vm, "added: %lld, recycled: %lld, limit drops: %lld, "
+		   "aged: %lld", c->n_added, c->n_recycled,
+		   c->n_limit_drops, c->n_aged);
+  vlib_cli_output (vm, "learned: %lld in %lld batches",
+		   c->n_learns, c->n_learn_batches);
+  vlib_cli_output (vm, "%U", format_bihash_8_8, &am->arp_db, 0);
+
+  return (NULL);
+}
+
+/*?
+ * Display the size, limit and age of the IPv4 ARP table, and the counts
+ * of the entries added, learned from the data-plane, recycled at the
+ * limit and aged out.
+ *
+ * @cliexpar
+ * @cliexcmd{show ip arp summary}
+ ?*/
+/* *INDENT-OFF* */
+VLIB_CLI_COMMAND (show_ip4_arp_summary_command, static) = {
+  .path = "show ip arp summary",
+  .function = show_ip4_arp_summary,
+  .short_help = "show ip arp summary",
+  .is_mp_safe = 1,
 };
 /* *INDENT-ON* */
 
@@ -1532,62 +1748,137 @@ ip4_set_arp_limit (u32 arp_limit)
 }
 
 /**
- * @brief Control Plane hook to remove an ARP entry
+ * @brief Visit the next slice of the entry pool and flush the dynamic
+ * entries that have not been refreshed within the age. The slice is
+ * sized so the whole pool is visited once per age.
  */
-int
-vnet_arp_unset_ip4_over_ethernet (vnet_main_t * vnm,
-				  u32 sw_if_index, void *a_arg)
+static void
+arp_age_scan (vlib_main_t * vm)
 {
-  ethernet_arp_ip4_over_ethernet_address_t *a = a_arg;
-  vnet_arp_set_ip4_over_ethernet_rpc_args_t args;
+  ethernet_arp_main_t *am = &ethernet_arp_main;
+  vnet_arp_set_ip4_over_ethernet_rpc_args_t *args, *to_flush = 0;
+  ethernet_arp_ip4_entry_t *e;
+  u32 index, n_visit;
+  f64 now;
 
-  args.sw_if_index = sw_if_index;
-  args.flags = ETHERNET_ARP_ARGS_REMOVE;
-  clib_memcpy (&args.a, a, sizeof (*a));
+  if (0 == pool_elts (am->ip4_entry_pool))
+    return;
 
-  vl_api_rpc_call_main_thread (set_ip4_over_ethernet_rpc_callback,
-			       (u8 *) & args, sizeof (args));
-  return 0;
+  now = vlib_time_now (vm);
+  n_visit = clib_max (ARP_AGE_SCAN_MIN,
+		      (pool_len (am->ip4_entry_pool) *
+		       ARP_AGE_SCAN_INTERVAL / am->arp_age) + 1);
+  n_visit = clib_min (n_visit, pool_len (am->ip4_entry_pool));
+  index = am->arp_age_rotor;
+
+  while (n_visit--)
+    {
+      index = pool_next_index (am->ip4_entry_pool, index);
+      if (~0 == index)
+	/* wrap */
+	index = pool_next_index (am->ip4_entry_pool, index);
+
+      e = pool_elt_at_index (am->ip4_entry_pool, index);
+
+      if ((e->flags & ETHERNET_ARP_IP4_ENTRY_FLAG_DYNAMIC) &&
+	  e->time_last_updated + am->arp_age < now)
+	{
+	  vec_add2 (to_flush, args, 1);
+	  memset (args, 0, sizeof (*args));
+	  args->sw_if_index = e->sw_if_index;
+	  args->flags = ETHERNET_ARP_ARGS_FLUSH;
+	  clib_memcpy (&args->a.ethernet, e->ethernet_address, 6);
+	  args->a.ip4.as_u32 = e->ip4_address.as_u32;
+	}
+    }
+  am->arp_age_rotor = index;
+
+  am->counters.n_aged += vec_len (to_flush);
+  arp_rpc_batch (to_flush);
+  vec_free (to_flush);
 }
 
-/**
- * @brief Internally generated event to flush the ARP cache on an
- * interface state change event.
- * A flush will remove dynamic ARP entries, and for statics remove the MAC
- * address from the corresponding adjacencies.
- */
-static int
-vnet_arp_flush_ip4_over_ethernet (vnet_main_t * vnm,
-				  u32 sw_if_index, void *a_arg)
+static uword
+arp_age_process (vlib_main_t * vm, vlib_node_runtime_t * rt, vlib_frame_t * f)
 {
-  ethernet_arp_ip4_over_ethernet_address_t *a = a_arg;
-  vnet_arp_set_ip4_over_ethernet_rpc_args_t args;
+  ethernet_arp_main_t *am = &ethernet_arp_main;
 
-  args.sw_if_index = sw_if_index;
-  args.flags = ETHERNET_ARP_ARGS_FLUSH;
-  clib_memcpy (&args.a, a, sizeof (*a));
+  while (1)
+    {
+      if (am->arp_age)
+	vlib_process_wait_for_event_or_clock (vm, ARP_AGE_SCAN_INTERVAL);
+      else
+	vlib_process_wait_for_event (vm);
 
-  vl_api_rpc_call_main_thread (set_ip4_over_ethernet_rpc_callback,
-			       (u8 *) & args, sizeof (args));
+      vlib_process_get_events (vm, NULL);
+
+      if (am->arp_age)
+	arp_age_scan (vm);
+    }
   return 0;
 }
 
-/**
- * @brief Internally generated event to populate the ARP cache on an
- * interface state change event.
- * For static entries this will re-source the adjacencies.
+/* *INDENT-OFF* */
+VLIB_REGISTER_NODE (arp_age_process_node, static) = {
+  .function = arp_age_process,
+  .type = VLIB_NODE_TYPE_PROCESS,
+  .name = "arp-age-process",
+};
+/* *INDENT-ON* */
+
+clib_error_t *
+ip4_set_arp_age (u32 arp_age)
+{
+  ethernet_arp_main_t *am = &ethernet_arp_main;
+
+  am->arp_age = arp_age;
+  vlib_process_signal_event (vlib_get_main (), arp_age_process_node.index,
+			     0, 0);
+  return 0;
+}
+
+static clib_error_t *
+set_ip_arp_age_command_fn (vlib_main_t * vm,
+			   unformat_input_t * input, vlib_cli_command_t * cmd)
+{
+  u32 arp_age;
+
+  if (!unformat (input, "%d", &arp_age))
+    return clib_error_return (0, "expected age in seconds, got `%U'",
+			      format_unformat_error, input);
+
+  return (ip4_set_arp_age (arp_age));
+}
+
+/*?
+ * Set the number of seconds after which a dynamic ARP entry that has not
+ * been refreshed is removed. Zero, the default, disables aging. The
+ * table is scanned a slice at a time, so an entry is removed between one
+ * and two ages after it was last refreshed.
  *
- * @param sw_if_index The interface on which the ARP entires are acted
+ * @cliexpar
+ * @cliexcmd{set ip arp age 600}
+ ?*/
+/* *INDENT-OFF* */
+VLIB_CLI_COMMAND (set_ip_arp_age_command, static) = {
+  .path = "set ip arp age",
+  .short_help = "set ip arp age <seconds>",
+  .function = set_ip_arp_age_command_fn,
+};
+/* *INDENT-ON* */
+
+/**
+ * @brief Control Plane hook to remove an ARP entry
  */
-static int
-vnet_arp_populate_ip4_over_ethernet (vnet_main_t * vnm,
-				     u32 sw_if_index, void *a_arg)
+int
+vnet_arp_unset_ip4_over_ethernet (vnet_main_t * vnm,
+				  u32 sw_if_index, void *a_arg)
 {
   ethernet_arp_ip4_over_ethernet_address_t *a = a_arg;
   vnet_arp_set_ip4_over_ethernet_rpc_args_t args;
 
   args.sw_if_index = sw_if_index;
-  args.flags = ETHERNET_ARP_ARGS_POPULATE;
+  args.flags = ETHERNET_ARP_ARGS_REMOVE;
   clib_memcpy (&args.a, a, sizeof (*a));
 
   vl_api_rpc_call_main_thread (set_ip4_over_ethernet_rpc_callback,
@@ -1666,38 +1957,30 @@ arp_add_del_interface_address (ip4_main_t * im,
 
   if (is_del)
     {
-      ethernet_arp_interface_t *eai;
-      u32 i, *to_delete = 0;
-      hash_pair_t *pair;
+      vnet_arp_set_ip4_over_ethernet_rpc_args_t *args, *to_flush = 0;
 
-      eai = &am->ethernet_arp_by_sw_if_index[sw_if_index];
+      if (0 == am->ethernet_arp_by_sw_if_index[sw_if_index].n_entries)
+	return;
 
       /* *INDENT-OFF* */
-      hash_foreach_pair (pair, eai->arp_entries,
+      pool_foreach (e, am->ip4_entry_pool,
       ({
-	e = pool_elt_at_index(am->ip4_entry_pool,
-			      pair->value[0]);
-	if (ip4_destination_matches_route (im, &e->ip4_address,
+	if (e->sw_if_index == sw_if_index &&
+	    ip4_destination_matches_route (im, &e->ip4_address,
 					   address, address_length))
 	  {
-	    vec_add1 (to_delete, e - am->ip4_entry_pool);
+	    vec_add2 (to_flush, args, 1);
+	    memset (args, 0, sizeof (*args));
+	    args->sw_if_index = e->sw_if_index;
+	    args->flags = ETHERNET_ARP_ARGS_FLUSH;
+	    clib_memcpy (&args->a.ethernet, e->ethernet_address, 6);
+	    args->a.ip4.as_u32 = e->ip4_address.as_u32;
 	  }
       }));
       /* *INDENT-ON* */
 
-      for (i = 0; i < vec_len (to_delete); i++)
-	{
-	  ethernet_arp_ip4_over_ethernet_address_t delme;
-	  e = pool_elt_at_index (am->ip4_entry_pool, to_delete[i]);
-
-	  clib_memcpy (&delme.ethernet, e->ethernet_address, 6);
-	  delme.ip4.as_u32 = e->ip4_address.as_u32;
-
-	  vnet_arp_flush_ip4_over_ethernet (vnet_get_main (),
-					    e->sw_if_index, &delme);
-	}
-
-      vec_free (to_delete);
+      arp_rpc_batch (to_flush);
+      vec_free (to_flush);
     }
 }
 
@@ -1707,9 +1990,7 @@ arp_table_bind (ip4_main_t * im,
 		u32 sw_if_index, u32 new_fib_index, u32 old_fib_index)
 {
   ethernet_arp_main_t *am = &ethernet_arp_main;
-  ethernet_arp_interface_t *eai;
   ethernet_arp_ip4_entry_t *e;
-  hash_pair_t *pair;
 
   /*
    * the IP table that the interface is bound to has changed.
@@ -1719,13 +2000,14 @@ arp_table_bind (ip4_main_t * im,
   if (vec_len (am->ethernet_arp_by_sw_if_index) <= sw_if_index)
     return;
 
-  eai = &am->ethernet_arp_by_sw_if_index[sw_if_index];
+  if (0 == am->ethernet_arp_by_sw_if_index[sw_if_index].n_entries)
+    return;
 
   /* *INDENT-OFF* */
-  hash_foreach_pair (pair, eai->arp_entries,
+  pool_foreach (e, am->ip4_entry_pool,
   ({
-    e = pool_elt_at_index(am->ip4_entry_pool,
-                          pair->value[0]);
+    if (e->sw_if_index != sw_if_index)
+      continue;
     /*
      * remove the adj-fib from the old table and add to the new
      */
@@ -1760,6 +2042,11 @@ ethernet_arp_init (vlib_main_t * vm)
   /* $$$ configurable */
   am->limit_arp_cache_size = 50000;
 
+  clib_bihash_init_8_8 (&am->arp_db, "arp-db",
+			ARP_DB_N_BUCKETS, ARP_DB_MEMORY_SIZE);
+  vec_validate (am->learn_batch_by_thread, vlib_num_workers ());
+  am->arp_age_rotor = ~0;
+
   am->pending_resolutions_by_address = hash_create (0, sizeof (uword));
   am->mac_changes_by_address = hash_create (0, sizeof (uword));
   am->wc_ip4_arp_publisher_node = (uword) ~ 0;
@@ -1793,13 +2080,13 @@ ethernet_arp_init (vlib_main_t * vm)
 VLIB_INIT_FUNCTION (ethernet_arp_init);
 
 static void
-arp_entry_free (ethernet_arp_interface_t * eai, ethernet_arp_ip4_entry_t * e)
+arp_entry_free (ethernet_arp_ip4_entry_t * e)
 {
   ethernet_arp_main_t *am = &ethernet_arp_main;
 
   arp_adj_fib_remove
     (e, ip4_fib_table_get_index_for_sw_if_index (e->sw_if_index));
-  hash_unset (eai->arp_entries, e->ip4_address.as_u32);
+  arp_db_remove (e);
   pool_put (am->ip4_entry_pool, e);
 }
 
@@ -1810,20 +2097,17 @@ vnet_arp_unset_ip4_over_ethernet_internal (vnet_main_t * vnm,
 {
   ethernet_arp_main_t *am = &ethernet_arp_main;
   ethernet_arp_ip4_entry_t *e;
-  ethernet_arp_interface_t *eai;
 
   if (vec_len (am->ethernet_arp_by_sw_if_index) <= args->sw_if_index)
     return 0;
 
-  eai = &am->ethernet_arp_by_sw_if_index[args->sw_if_index];
-
-  e = arp_entry_find (eai, &args->a.ip4);
+  e = arp_entry_find (args->sw_if_index, &args->a.ip4);
 
   if (NULL != e)
     {
       adj_nbr_walk_nh4 (e->sw_if_index,
 			&e->ip4_address, arp_mk_incomplete_walk, NULL);
-      arp_entry_free (eai, e);
+      arp_entry_free (e);
     }
 
   return 0;
@@ -1836,14 +2120,11 @@ vnet_arp_flush_ip4_over_ethernet_internal (vnet_main_t * vnm,
 {
   ethernet_arp_main_t *am = &ethernet_arp_main;
   ethernet_arp_ip4_entry_t *e;
-  ethernet_arp_interface_t *eai;
 
   if (vec_len (am->ethernet_arp_by_sw_if_index) <= args->sw_if_index)
     return 0;
 
-  eai = &am->ethernet_arp_by_sw_if_index[args->sw_if_index];
-
-  e = arp_entry_find (eai, &args->a.ip4);
+  e = arp_entry_find (args->sw_if_index, &args->a.ip4);
 
   if (NULL != e)
     {
@@ -1863,7 +2144,7 @@ vnet_arp_flush_ip4_over_ethernet_internal (vnet_main_t * vnm,
 	}
       else if (e->flags & ETHERNET_ARP_IP4_ENTRY_FLAG_DYNAMIC)
 	{
-	  arp_entry_free (eai, e);
+	  arp_entry_free (e);
 	}
     }
   return (0);
@@ -1876,12 +2157,10 @@ vnet_arp_populate_ip4_over_ethernet_internal (vnet_main_t * vnm,
 {
   ethernet_arp_main_t *am = &ethernet_arp_main;
   ethernet_arp_ip4_entry_t *e;
-  ethernet_arp_interface_t *eai;
 
   vec_validate (am->ethernet_arp_by_sw_if_index, args->sw_if_index);
-  eai = &am->ethernet_arp_by_sw_if_index[args->sw_if_index];
 
-  e = arp_entry_find (eai, &args->a.ip4);
+  e = arp_entry_find (args->sw_if_index, &args->a.ip4);
 
   if (NULL != e)
     {
@@ -1918,37 +2197,35 @@ ethernet_arp_sw_interface_up_down (vnet_main_t * vnm,
 				   u32 sw_if_index, u32 flags)
 {
   ethernet_arp_main_t *am = &ethernet_arp_main;
+  vnet_arp_set_ip4_over_ethernet_rpc_args_t *args, *to_update = 0;
   ethernet_arp_ip4_entry_t *e;
-  u32 i, *to_delete = 0;
 
+  if (vec_len (am->ethernet_arp_by_sw_if_index) <= sw_if_index ||
+      0 == am->ethernet_arp_by_sw_if_index[sw_if_index].n_entries)
+    return 0;
+
+  /*
+   * populate or flush all of the interface's entries in one batch
+   */
   /* *INDENT-OFF* */
   pool_foreach (e, am->ip4_entry_pool,
   ({
-    if (e->sw_if_index == sw_if_index)
-      vec_add1 (to_delete,
-		e - am->ip4_entry_pool);
+    if (e->sw_if_index != sw_if_index)
+      continue;
+
+    vec_add2 (to_update, args, 1);
+    memset (args, 0, sizeof (*args));
+    args->sw_if_index = e->sw_if_index;
+    args->flags = ((flags & VNET_SW_INTERFACE_FLAG_ADMIN_UP) ?
+		   ETHERNET_ARP_ARGS_POPULATE :
+		   ETHERNET_ARP_ARGS_FLUSH);
+    clib_memcpy (&args->a.ethernet, e->ethernet_address, 6);
+    args->a.ip4.as_u32 = e->ip4_address.as_u32;
   }));
   /* *INDENT-ON* */
 
-  for (i = 0; i < vec_len (to_delete); i++)
-    {
-      ethernet_arp_ip4_over_ethernet_address_t delme;
-      e = pool_elt_at_index (am->ip4_entry_pool, to_delete[i]);
-
-      clib_memcpy (&delme.ethernet, e->ethernet_address, 6);
-      delme.ip4.as_u32 = e->ip4_address.as_u32;
-
-      if (flags & VNET_SW_INTERFACE_FLAG_ADMIN_UP)
-	{
-	  vnet_arp_populate_ip4_over_ethernet (vnm, e->sw_if_index, &delme);
-	}
-      else
-	{
-	  vnet_arp_flush_ip4_over_ethernet (vnm, e->sw_if_index, &delme);
-	}
-
-    }
-  vec_free (to_delete);
+  arp_rpc_batch (to_update);
+  vec_free (to_update);
 
   return 0;
 }
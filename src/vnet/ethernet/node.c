@@ -286,6 +286,245 @@ determine_next_node (ethernet_main_t * em,
     }
 }
 
+/* The 8 bytes following the source address of a packet */
+typedef union
+{
+  struct
+  {
+    u16 type;
+    u16 outer_tci;
+    u16 inner_type;
+    u16 inner_tci;
+  };
+  u64 as_u64;
+} eth_input_tags_t;
+
+/*
+ * Classify the packets of a frame by tag layout. If they all came in on
+ * the same interface with no tag, or all with the same tags, return the
+ * number of tags, 0, 1 or 2, with the tags and the interface, and the
+ * ethertype following the tags of each packet, in network byte order.
+ * Else return -1.
+ */
+static_always_inline int
+eth_input_frame_classify (vlib_main_t * vm, u32 * from, u32 n_packets,
+			  u16 * types, eth_input_tags_t * tags0,
+			  u32 * sw_if_index0)
+{
+  u32 sw_if_indices[VLIB_FRAME_SIZE];
+  eth_input_tags_t tags[VLIB_FRAME_SIZE], mask;
+  vlib_buffer_t *b;
+  u8 *data;
+  u32 i, n, type_offset;
+  int n_tags;
+
+  b = vlib_get_buffer (vm, from[0]);
+  data = vlib_buffer_get_current (b);
+  clib_memcpy (tags0, data + STRUCT_OFFSET_OF (ethernet_header_t, type),
+	       sizeof (tags0[0]));
+  *sw_if_index0 = vnet_buffer (b)->sw_if_index[VLIB_RX];
+
+  /* mask the tags with what is compared: the tag protocol ids and the
+     VLAN ids */
+  mask.as_u64 = 0;
+  if (!ethernet_frame_is_tagged (clib_net_to_host_u16 (tags0->type)))
+    n_tags = 0;
+  else
+    {
+      mask.type = 0xffff;
+      mask.outer_tci = clib_host_to_net_u16 (0xfff);
+      n_tags = 1;
+      if (tags0->inner_type == clib_host_to_net_u16 (ETHERNET_TYPE_VLAN))
+	{
+	  mask.inner_type = 0xffff;
+	  mask.inner_tci = clib_host_to_net_u16 (0xfff);
+	  n_tags = 2;
+	}
+    }
+  tags0->as_u64 &= mask.as_u64;
+  type_offset = STRUCT_OFFSET_OF (ethernet_header_t, type) +
+    n_tags * sizeof (ethernet_vlan_header_t);
+
+  for (i = 0; i < n_packets; i++)
+    {
+      if (i + 4 < n_packets)
+	{
+	  vlib_buffer_t *p = vlib_get_buffer (vm, from[i + 4]);
+	  vlib_prefetch_buffer_header (p, STORE);
+	  CLIB_PREFETCH (p->data, CLIB_CACHE_LINE_BYTES, LOAD);
+	}
+
+      b = vlib_get_buffer (vm, from[i]);
+      data = vlib_buffer_get_current (b);
+      clib_memcpy (&tags[i], data + STRUCT_OFFSET_OF (ethernet_header_t,
+						      type),
+		   sizeof (tags[i]));
+      types[i] = *(u16 *) (data + type_offset);
+      sw_if_indices[i] = vnet_buffer (b)->sw_if_index[VLIB_RX];
+    }
+
+  /* pad to a whole number of vectors with copies of the first packet */
+  n = round_pow2 (n_packets, 8);
+  for (i = n_packets; i < n; i++)
+    {
+      tags[i] = tags[0];
+      types[i] = types[0];
+      sw_if_indices[i] = sw_if_indices[0];
+    }
+
+#ifdef CLIB_HAVE_VEC128
+  {
+    u16x8 tagged = { 0 };
+    u64x2 tags_diff = { 0 };
+    u32x4 sw_if_index_diff = { 0 };
+    u16x8 vlan = u16x8_splat (clib_host_to_net_u16 (ETHERNET_TYPE_VLAN));
+    u16x8 dot1ad = u16x8_splat (clib_host_to_net_u16 (ETHERNET_TYPE_DOT1AD));
+    u16x8 vlan_9100 =
+      u16x8_splat (clib_host_to_net_u16 (ETHERNET_TYPE_VLAN_9100));
+    u16x8 vlan_9200 =
+      u16x8_splat (clib_host_to_net_u16 (ETHERNET_TYPE_VLAN_9200));
+    u64x2 mask2 = u64x2_splat (mask.as_u64);
+    u64x2 tags2 = u64x2_splat (tags0->as_u64);
+    u32x4 sw_if_index4 = u32x4_splat (*sw_if_index0);
+
+    for (i = 0; i < n; i += 8)
+      {
+	u16x8 t = u16x8_load_unaligned (types + i);
+	tagged |= (u16x8) ((t == vlan) | (t == dot1ad) |
+			   (t == vlan_9100) | (t == vlan_9200));
+
+	tags_diff |= (u64x2_load_unaligned (tags + i) & mask2) ^ tags2;
+	tags_diff |= (u64x2_load_unaligned (tags + i + 2) & mask2) ^ tags2;
+	tags_diff |= (u64x2_load_unaligned (tags + i + 4) & mask2) ^ tags2;
+	tags_diff |= (u64x2_load_unaligned (tags + i + 6) & mask2) ^ tags2;
+
+	sw_if_index_diff |=
+	  u32x4_load_unaligned (sw_if_indices + i) ^ sw_if_index4;
+	sw_if_index_diff |=
+	  u32x4_load_unaligned (sw_if_indices + i + 4) ^ sw_if_index4;
+      }
+
+    if (!u16x8_is_all_zero (tagged) || !u64x2_is_all_zero (tags_diff) ||
+	!u32x4_is_all_zero (sw_if_index_diff))
+      return -1;
+  }
+#else
+  for (i = 0; i < n_packets; i++)
+    if (ethernet_frame_is_tagged (clib_net_to_host_u16 (types[i])) ||
+	(tags[i].as_u64 & mask.as_u64) != tags0->as_u64 ||
+	sw_if_indices[i] != *sw_if_index0)
+      return -1;
+#endif
+
+  return n_tags;
+}
+
+/*
+ * Process a frame whose packets all came in on the same interface with
+ * no tag, or all with the same tags: their subinterface is looked up
+ * once. Return 0, having done nothing, if the frame is not like that.
+ */
+static_always_inline int
+eth_input_process_frame (vlib_main_t * vm, vlib_node_runtime_t * node,
+			 u32 * from, u32 n_packets)
+{
+  vnet_main_t *vnm = vnet_get_main ();
+  ethernet_main_t *em = &ethernet_main;
+  u16 types[VLIB_FRAME_SIZE], nexts[VLIB_FRAME_SIZE];
+  eth_input_tags_t tags0;
+  vnet_hw_interface_t *hi;
+  main_intf_t *main_intf;
+  vlan_intf_t *vlan_intf;
+  qinq_intf_t *qinq_intf;
+  u32 sw_if_index, new_sw_if_index, is_l2, n_bytes = 0, i;
+  u32 l2_hdr_sz;
+  u8 error = ETHERNET_ERROR_NONE;
+  int n_tags;
+
+  n_tags = eth_input_frame_classify (vm, from, n_packets, types, &tags0,
+				     &sw_if_index);
+  if (n_tags < 0)
+    return 0;
+
+  if (n_tags == 0)
+    {
+      hi = vnet_get_sup_hw_interface (vnm, sw_if_index);
+      main_intf = vec_elt_at_index (em->main_intfs, hi->hw_if_index);
+      is_l2 = main_intf->untagged_subint.flags & SUBINT_CONFIG_L2;
+      new_sw_if_index = sw_if_index;
+    }
+  else
+    {
+      u16 outer_id = clib_net_to_host_u16 (tags0.outer_tci);
+      u16 inner_id = clib_net_to_host_u16 (tags0.inner_tci);
+      u32 match_flags;
+
+      if (n_tags == 1)
+	match_flags = SUBINT_CONFIG_VALID |
+	  (outer_id ? SUBINT_CONFIG_MATCH_1_TAG : 0);
+      else
+	match_flags = SUBINT_CONFIG_VALID | SUBINT_CONFIG_MATCH_2_TAG;
+
+      eth_vlan_table_lookups (em, vnm, sw_if_index,
+			      clib_net_to_host_u16 (tags0.type),
+			      outer_id, inner_id, &hi, &main_intf,
+			      &vlan_intf, &qinq_intf);
+      if (eth_identify_subint (hi, vlib_get_buffer (vm, from[0]),
+			       match_flags, main_intf, vlan_intf, qinq_intf,
+			       &new_sw_if_index, &error, &is_l2)
+	  && new_sw_if_index == ~0)
+	error = ETHERNET_ERROR_DOWN;
+    }
+
+  l2_hdr_sz = sizeof (ethernet_header_t) +
+    n_tags * sizeof (ethernet_vlan_header_t);
+
+  for (i = 0; i < n_packets; i++)
+    {
+      vlib_buffer_t *b = vlib_get_buffer (vm, from[i]);
+      ethernet_header_t *e = vlib_buffer_get_current (b);
+      u8 error0 = error, next0;
+
+      vnet_buffer (b)->l2_hdr_offset = b->current_data;
+      vnet_buffer (b)->l3_hdr_offset = b->current_data + l2_hdr_sz;
+      b->flags |= VNET_BUFFER_F_L2_HDR_OFFSET_VALID |
+	VNET_BUFFER_F_L3_HDR_OFFSET_VALID;
+      ethernet_buffer_set_vlan_count (b, n_tags);
+
+      // L3 my-mac filter, as in identify_subint()
+      if (!is_l2 && error0 == ETHERNET_ERROR_NONE &&
+	  !ethernet_address_cast (e->dst_address) &&
+	  (hi->hw_address != 0) && !eth_mac_equal ((u8 *) e, hi->hw_address))
+	error0 = ETHERNET_ERROR_L3_MAC_MISMATCH;
+
+      if (error0 == ETHERNET_ERROR_NONE)
+	vnet_buffer (b)->sw_if_index[VLIB_RX] = new_sw_if_index;
+
+      vlib_buffer_advance (b, l2_hdr_sz);
+      determine_next_node (em, ETHERNET_INPUT_VARIANT_ETHERNET, is_l2,
+			   clib_net_to_host_u16 (types[i]), b, &error0,
+			   &next0);
+
+      if (new_sw_if_index != sw_if_index && new_sw_if_index != ~0)
+	n_bytes += vlib_buffer_length_in_chain (vm, b) + b->current_data -
+	  vnet_buffer (b)->l2_hdr_offset;
+
+      b->error = node->errors[error0];
+      nexts[i] = next0;
+    }
+
+  // Subinterface stats, see the per packet path below
+  if (n_bytes)
+    vlib_increment_combined_counter
+      (vnm->interface_main.combined_sw_if_counters
+       + VNET_INTERFACE_COUNTER_RX,
+       vm->thread_index, new_sw_if_index, n_packets, n_bytes);
+
+  vlib_buffer_enqueue_to_next (vm, node, from, nexts, n_packets);
+
+  return 1;
+}
+
 static_always_inline uword
 ethernet_input_inline (vlib_main_t * vm,
 		       vlib_node_runtime_t * node,
@@ -317,6 +556,11 @@ ethernet_input_inline (vlib_main_t * vm,
 				   sizeof (from[0]),
 				   sizeof (ethernet_input_trace_t));
 
+  /* Whole frames of untagged or same tagged packets go the fast way */
+  if (variant == ETHERNET_INPUT_VARIANT_ETHERNET &&
+      eth_input_process_frame (vm, node, from, n_left_from))
+    return from_frame->n_vectors;
+
   next_index = node->cached_next_index;
   stats_sw_if_index = node->runtime_data[0];
   stats_n_packets = stats_n_bytes = 0;
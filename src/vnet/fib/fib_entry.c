@@ -226,8 +226,7 @@ fib_entry_last_lock_gone (fib_node_t *node)
 
     fib_node_deinit(&fib_entry->fe_node);
 
-    ASSERT(0 == vec_len(fib_entry->fe_delegates));
-    vec_free(fib_entry->fe_delegates);
+    ASSERT(INDEX_INVALID == fib_entry->fe_delegates);
     vec_free(fib_entry->fe_srcs);
     pool_put(fib_entry_pool, fib_entry);
 }
@@ -330,7 +329,7 @@ fib_entry_back_walk_notify (fib_node_t *node,
 static void
 fib_entry_show_memory (void)
 {
-    u32 n_srcs = 0, n_exts = 0;
+    u32 n_srcs = 0, n_srcs_allocd = 0, n_exts = 0;
     fib_entry_src_t *esrc;
     fib_entry_t *entry;
 
@@ -342,6 +341,7 @@ fib_entry_show_memory (void)
     pool_foreach(entry, fib_entry_pool,
     ({
 	n_srcs += vec_len(entry->fe_srcs);
+	n_srcs_allocd += vec_max_len(entry->fe_srcs);
 	vec_foreach(esrc, entry->fe_srcs)
 	{
 	    n_exts += fib_path_ext_list_length(&esrc->fes_path_exts);
@@ -349,10 +349,11 @@ fib_entry_show_memory (void)
     }));
 
     fib_show_memory_usage("Entry Source",
-			  n_srcs, n_srcs, sizeof(fib_entry_src_t));
+			  n_srcs, n_srcs_allocd, sizeof(fib_entry_src_t));
     fib_show_memory_usage("Entry Path-Extensions",
 			  n_exts, n_exts,
 			  sizeof(fib_path_ext_t));
+    fib_entry_delegate_memory_show();
 }
 
 /*
@@ -572,13 +573,17 @@ fib_entry_alloc (u32 fib_index,
     fib_entry_t *fib_entry;
     fib_prefix_t *fep;
 
-    pool_get(fib_entry_pool, fib_entry);
+    /*
+     * an entry is sized to fit a cache line, so align it to one too
+     */
+    pool_get_aligned(fib_entry_pool, fib_entry, CLIB_CACHE_LINE_BYTES);
     memset(fib_entry, 0, sizeof(*fib_entry));
 
     fib_node_init(&fib_entry->fe_node,
 		  FIB_NODE_TYPE_ENTRY);
 
     fib_entry->fe_fib_index = fib_index;
+    fib_entry->fe_delegates = INDEX_INVALID;
 
     /*
      * the one time we need to update the const prefix is when
@@ -1638,6 +1643,18 @@ fib_entry_pool_size (void)
     return (pool_elts(fib_entry_pool));
 }
 
+int
+fib_entry_pool_is_valid_index (fib_node_index_t index)
+{
+    return (!pool_is_free_index(fib_entry_pool, index));
+}
+
+fib_node_index_t
+fib_entry_pool_next_index (fib_node_index_t index)
+{
+    return (pool_next_index(fib_entry_pool, index));
+}
+
 static clib_error_t *
 show_fib_entry_command (vlib_main_t * vm,
 			unformat_input_t * input,
@@ -453,6 +453,8 @@ typedef struct fib_entry_src_t_ {
 typedef struct fib_entry_t_ {
     /**
      * Base class. The entry's node representation in the graph.
+     * This links the entry to its children, fe_parent and fe_sibling
+     * link it to its path-list; the two do not duplicate each other.
      */
     fib_node_t fe_node;
     /**
@@ -464,6 +466,11 @@ typedef struct fib_entry_t_ {
      * The index of the FIB table this entry is in
      */
     u32 fe_fib_index;
+    /**
+     * the path-list for which this entry is a child. This is also the path-list
+     * that is contributing forwarding for this entry.
+     */
+    fib_node_index_t fe_parent;
     /**
      * The load-balance used for forwarding.
      *
@@ -481,13 +488,11 @@ typedef struct fib_entry_t_ {
      * Vector of source infos.
      * Most entries will only have 1 source. So we optimise for memory usage,
      * which is preferable since we have many entries.
+     * The sources are not inlined in the entry since the source actions hold
+     * a pointer to the source across operations that can realloc the pool
+     * of entries, whereas a vector does not move.
      */
     fib_entry_src_t *fe_srcs;
-    /**
-     * the path-list for which this entry is a child. This is also the path-list
-     * that is contributing forwarding for this entry.
-     */
-    fib_node_index_t fe_parent;
     /**
      * index of this entry in the parent's child list.
      * This is set when this entry is added as a child, but can also
@@ -496,11 +501,16 @@ typedef struct fib_entry_t_ {
     u32 fe_sibling;
 
     /**
-     * A vector of delegates.
+     * Index of the entry's vector of delegates in the pool thereof, or
+     * INDEX_INVALID. Most entries have none, so rather than pay for a
+     * vector pointer in each, the entry is kept to a cache line.
      */
-    fib_entry_delegate_t *fe_delegates;
+    index_t fe_delegates;
 } fib_entry_t;
 
+STATIC_ASSERT(sizeof(fib_entry_t) <= CLIB_CACHE_LINE_BYTES,
+              "FIB entry is larger than a cache line");
+
 #define FOR_EACH_FIB_ENTRY_FLAG(_item) \
     for (_item = FIB_ENTRY_FLAG_FIRST; _item < FIB_ENTRY_FLAG_MAX; _item++)
 
@@ -610,6 +620,8 @@ extern fib_entry_flag_t fib_entry_get_flags_for_source(
 extern fib_source_t fib_entry_get_best_source(fib_node_index_t fib_entry_index);
 extern int fib_entry_is_sourced(fib_node_index_t fib_entry_index,
                                 fib_source_t source);
+extern int fib_entry_has_path_extensions(fib_node_index_t fib_entry_index,
+                                         fib_source_t source);
 
 extern fib_node_index_t fib_entry_get_path_list(fib_node_index_t fib_entry_index);
 extern int fib_entry_is_resolved(fib_node_index_t fib_entry_index);
@@ -630,4 +642,11 @@ extern fib_entry_t * fib_entry_get(fib_node_index_t fib_entry_index);
  */
 extern u32 fib_entry_pool_size(void);
 
+/*
+ * Iteration over all entries, in pool order, for paged API dumps.
+ * next returns ~0 after the last entry.
+ */
+extern int fib_entry_pool_is_valid_index(fib_node_index_t index);
+extern fib_node_index_t fib_entry_pool_next_index(fib_node_index_t index);
+
 #endif
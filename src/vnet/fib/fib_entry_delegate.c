@@ -17,16 +17,39 @@
 #include <vnet/fib/fib_entry.h>
 #include <vnet/fib/fib_attached_export.h>
 
+/**
+ * Pool of the entries' vectors of delegates
+ */
+static fib_entry_delegate_t **fib_entry_delegate_vec_pool;
+
+static fib_entry_delegate_t **
+fib_entry_delegate_vec_get (const fib_entry_t *fib_entry)
+{
+    if (INDEX_INVALID == fib_entry->fe_delegates)
+    {
+        return (NULL);
+    }
+    return (pool_elt_at_index(fib_entry_delegate_vec_pool,
+                              fib_entry->fe_delegates));
+}
+
 static fib_entry_delegate_t *
 fib_entry_delegate_find_i (const fib_entry_t *fib_entry,
                            fib_entry_delegate_type_t type,
                            u32 *index)
 {
-    fib_entry_delegate_t *delegate;
+    fib_entry_delegate_t *delegate, **fdv;
     int ii;
 
+    fdv = fib_entry_delegate_vec_get(fib_entry);
+
+    if (NULL == fdv)
+    {
+        return (NULL);
+    }
+
     ii = 0;
-    vec_foreach(delegate, fib_entry->fe_delegates)
+    vec_foreach(delegate, *fdv)
     {
 	if (delegate->fd_type == type)
 	{
@@ -55,14 +78,22 @@ void
 fib_entry_delegate_remove (fib_entry_t *fib_entry,
                            fib_entry_delegate_type_t type)
 {
-    fib_entry_delegate_t *fed;
+    fib_entry_delegate_t *fed, **fdv;
     u32 index = ~0;
 
     fed = fib_entry_delegate_find_i(fib_entry, type, &index);
 
     ASSERT(NULL != fed);
 
-    vec_del1(fib_entry->fe_delegates, index);
+    fdv = fib_entry_delegate_vec_get(fib_entry);
+    vec_del1(*fdv, index);
+
+    if (0 == vec_len(*fdv))
+    {
+        vec_free(*fdv);
+        pool_put(fib_entry_delegate_vec_pool, fdv);
+        fib_entry->fe_delegates = INDEX_INVALID;
+    }
 }
 
 static int
@@ -83,12 +114,41 @@ fib_entry_delegate_init (fib_entry_t *fib_entry,
 	.fd_entry_index = fib_entry_get_index(fib_entry),
 	.fd_type = type,
     };
+    fib_entry_delegate_t **fdv;
+
+    fdv = fib_entry_delegate_vec_get(fib_entry);
+
+    if (NULL == fdv)
+    {
+        pool_get(fib_entry_delegate_vec_pool, fdv);
+        *fdv = NULL;
+        fib_entry->fe_delegates = fdv - fib_entry_delegate_vec_pool;
+    }
 
-    vec_add1(fib_entry->fe_delegates, delegate);
-    vec_sort_with_function(fib_entry->fe_delegates,
+    vec_add1(*fdv, delegate);
+    vec_sort_with_function(*fdv,
 			   fib_entry_delegate_cmp_for_sort);
 }
 
+void
+fib_entry_delegate_memory_show (void)
+{
+    fib_entry_delegate_t **fdv;
+    u32 n_in_use, n_allocd;
+
+    n_in_use = n_allocd = 0;
+
+    pool_foreach(fdv, fib_entry_delegate_vec_pool,
+    ({
+        n_in_use += vec_len(*fdv);
+        n_allocd += vec_max_len(*fdv);
+    }));
+
+    fib_show_memory_usage("Entry Delegate",
+                          n_in_use, n_allocd,
+                          sizeof(fib_entry_delegate_t));
+}
+
 fib_entry_delegate_t *
 fib_entry_delegate_find_or_add (fib_entry_t *fib_entry,
                                 fib_entry_delegate_type_t fdt)
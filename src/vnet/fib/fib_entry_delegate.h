@@ -155,4 +155,6 @@ extern fib_entry_delegate_type_t fib_entry_chain_type_to_delegate_type(
 
 extern u8 *format_fib_entry_deletegate(u8 * s, va_list * args);
 
+extern void fib_entry_delegate_memory_show(void);
+
 #endif
@@ -140,6 +140,20 @@ fib_entry_is_sourced (fib_node_index_t fib_entry_index,
     return (NULL != fib_entry_src_find(fib_entry, source));
 }
 
+int
+fib_entry_has_path_extensions (fib_node_index_t fib_entry_index,
+                               fib_source_t source)
+{
+    fib_entry_t *fib_entry;
+    fib_entry_src_t *esrc;
+
+    fib_entry = fib_entry_get(fib_entry_index);
+    esrc = fib_entry_src_find(fib_entry, source);
+
+    return (NULL != esrc &&
+            0 != fib_path_ext_list_length(&esrc->fes_path_exts));
+}
+
 static fib_entry_src_t *
 fib_entry_src_find_or_create (fib_entry_t *fib_entry,
 			      fib_source_t source,
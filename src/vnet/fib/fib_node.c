@@ -149,6 +149,22 @@ fib_node_get_n_children (fib_node_type_t parent_type,
     return (fib_node_list_get_size(parent->fn_children));
 }
 
+/**
+ * @brief Get the child at the front of the parent's dependency list,
+ * i.e. the one added most recently. Returns 0 if there are no children.
+ */
+int
+fib_node_get_first_child (fib_node_type_t parent_type,
+                          fib_node_index_t parent_index,
+                          fib_node_ptr_t *child)
+{
+    fib_node_t *parent;
+
+    parent = fn_vfts[parent_type].fnv_get(parent_index);
+
+    return (fib_node_list_get_front(parent->fn_children, child));
+}
+
 
 fib_node_back_walk_rc_t
 fib_node_back_walk_one (fib_node_ptr_t *ptr,
@@ -216,6 +232,12 @@ fib_node_unlock (fib_node_t *node)
     }
 }
 
+/**
+ * The bytes in-use and allocated by all the object types shown so far
+ */
+static u64 fib_memory_in_use_bytes;
+static u64 fib_memory_allocd_bytes;
+
 void
 fib_show_memory_usage (const char *name,
 		       u32 in_use_elts,
@@ -226,6 +248,9 @@ fib_show_memory_usage (const char *name,
 		     name, size_elt,
 		     in_use_elts, allocd_elts,
 		     in_use_elts*size_elt, allocd_elts*size_elt);
+
+    fib_memory_in_use_bytes += (u64) in_use_elts * size_elt;
+    fib_memory_allocd_bytes += (u64) allocd_elts * size_elt;
 }
 
 static clib_error_t *
@@ -244,6 +269,8 @@ fib_memory_show (vlib_main_t * vm,
     vlib_cli_output (vm, "%=30s %=5s %=8s/%=9s   totals",
 		     "Name","Size", "in-use", "allocated");
 
+    fib_memory_in_use_bytes = fib_memory_allocd_bytes = 0;
+
     vec_foreach(vft, fn_vfts)
     {
 	if (NULL != vft->fnv_mem_show)
@@ -252,13 +279,21 @@ fib_memory_show (vlib_main_t * vm,
 
     fib_node_list_memory_show();
 
+    vlib_cli_output (vm, "%=30s %=5s %=8s %=9s   %lld/%lld",
+		     "Total", "", "", "",
+		     fib_memory_in_use_bytes, fib_memory_allocd_bytes);
+    if (fib_entry_pool_size())
+	vlib_cli_output (vm, "  %lld in-use bytes per entry",
+			 fib_memory_in_use_bytes / fib_entry_pool_size());
+
     return (NULL);
 }
 
 /* *INDENT-OFF* */
 /*?
  * The '<em>sh fib memory </em>' command displays the memory usage for each
- * FIB object type.
+ * FIB object type, followed by the total over all types and that total
+ * divided by the number of FIB entries.
  *
  * @cliexpar
  * @cliexstart{show fib memory}
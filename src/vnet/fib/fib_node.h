@@ -357,6 +357,9 @@ extern void fib_node_unlock(fib_node_t *node);
 
 extern u32 fib_node_get_n_children(fib_node_type_t parent_type,
                                    fib_node_index_t parent_index);
+extern int fib_node_get_first_child(fib_node_type_t parent_type,
+                                    fib_node_index_t parent_index,
+                                    fib_node_ptr_t *child);
 extern u32 fib_node_child_add(fib_node_type_t parent_type,
 			      fib_node_index_t parent_index,
 			      fib_node_type_t child_type,
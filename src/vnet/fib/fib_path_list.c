@@ -82,6 +82,26 @@ static fib_path_list_t * fib_path_list_pool;
  */
 static uword *fib_path_list_db;
 
+/*
+ * A memo of the path-lists created while a batch of updates is in progress.
+ * Large route loads (e.g. a BGP full table) use a small number of distinct
+ * path sets for a very large number of prefixes. Remembering the path-list
+ * that a given set of route-paths resolved to saves the construction, sort,
+ * DB lookup and destruction of a temporary path-list for each prefix.
+ * The memo holds a lock on each path-list it refers to, so an entry can
+ * not become stale until the batch ends.
+ */
+typedef struct fib_path_list_batch_entry_t_ {
+    fib_path_list_flags_t fplbe_flags;
+    fib_route_path_t *fplbe_rpaths;
+    fib_node_index_t fplbe_path_list;
+} fib_path_list_batch_entry_t;
+
+static u32 fib_path_list_batch_depth;
+static fib_path_list_batch_entry_t *fib_path_list_batch_entries;
+static uword *fib_path_list_batch_db;
+static u32 fib_path_list_batch_n_hits;
+
 /*
  * Debug macro
  */
@@ -657,15 +677,212 @@ fib_path_list_flags_fixup (fib_path_list_flags_t flags)
     return (flags);
 }
 
+static int
+fib_path_list_batch_is_memoable (fib_path_list_flags_t flags,
+                                 const fib_route_path_t *rpaths)
+{
+    const fib_route_path_t *rpath;
+
+    if (!fib_path_list_batch_depth || !(flags & FIB_PATH_LIST_FLAG_SHARED))
+        return (0);
+
+    /*
+     * the BIER path descriptions are unions over the IP next-hop fields
+     * so cannot be compared as such.
+     */
+    vec_foreach(rpath, rpaths)
+    {
+        if (DPO_PROTO_BIER == rpath->frp_proto ||
+            rpath->frp_flags & (FIB_ROUTE_PATH_BIER_FMASK |
+                                FIB_ROUTE_PATH_BIER_TABLE |
+                                FIB_ROUTE_PATH_BIER_IMP))
+            return (0);
+    }
+
+    return (1);
+}
+
+static uword
+fib_path_list_batch_hash (fib_path_list_flags_t flags,
+                          const fib_route_path_t *rpaths)
+{
+    const fib_route_path_t *rpath;
+    uword hash;
+
+    hash = flags;
+
+    vec_foreach(rpath, rpaths)
+    {
+        hash = hash * 31 + rpath->frp_addr.as_u64[0];
+        hash = hash * 31 + rpath->frp_addr.as_u64[1];
+        hash = hash * 31 + rpath->frp_sw_if_index;
+        hash = hash * 31 + rpath->frp_fib_index;
+        hash = hash * 31 + ((rpath->frp_weight << 8) |
+                            rpath->frp_preference);
+        hash = hash * 31 + ((rpath->frp_flags << 8) |
+                            rpath->frp_proto);
+        hash = hash * 31 + vec_len(rpath->frp_label_stack);
+    }
+
+    return (hash);
+}
+
+static int
+fib_path_list_batch_rpaths_equal (const fib_route_path_t *rpaths1,
+                                  const fib_route_path_t *rpaths2)
+{
+    const fib_route_path_t *rp1, *rp2;
+    u32 ii;
+
+    if (vec_len(rpaths1) != vec_len(rpaths2))
+        return (0);
+
+    for (ii = 0; ii < vec_len(rpaths1); ii++)
+    {
+        rp1 = &rpaths1[ii];
+        rp2 = &rpaths2[ii];
+
+        if (rp1->frp_proto != rp2->frp_proto ||
+            !ip46_address_is_equal(&rp1->frp_addr, &rp2->frp_addr) ||
+            rp1->frp_sw_if_index != rp2->frp_sw_if_index ||
+            rp1->frp_fib_index != rp2->frp_fib_index ||
+            rp1->frp_weight != rp2->frp_weight ||
+            rp1->frp_preference != rp2->frp_preference ||
+            rp1->frp_flags != rp2->frp_flags ||
+            vec_len(rp1->frp_label_stack) != vec_len(rp2->frp_label_stack))
+            return (0);
+
+        if (vec_len(rp1->frp_label_stack) &&
+            memcmp(rp1->frp_label_stack, rp2->frp_label_stack,
+                   vec_bytes(rp1->frp_label_stack)))
+            return (0);
+    }
+
+    return (1);
+}
+
+static fib_node_index_t
+fib_path_list_batch_find (fib_path_list_flags_t flags,
+                          const fib_route_path_t *rpaths)
+{
+    fib_path_list_batch_entry_t *fplbe;
+    uword *p;
+
+    p = hash_get(fib_path_list_batch_db,
+                 fib_path_list_batch_hash(flags, rpaths));
+
+    if (NULL == p)
+        return (FIB_NODE_INDEX_INVALID);
+
+    fplbe = vec_elt_at_index(fib_path_list_batch_entries, p[0]);
+
+    if (fplbe->fplbe_flags != flags ||
+        !fib_path_list_batch_rpaths_equal(fplbe->fplbe_rpaths, rpaths))
+        return (FIB_NODE_INDEX_INVALID);
+
+    fib_path_list_batch_n_hits++;
+
+    return (fplbe->fplbe_path_list);
+}
+
+static void
+fib_path_list_batch_add (fib_path_list_flags_t flags,
+                         const fib_route_path_t *rpaths,
+                         fib_node_index_t path_list_index)
+{
+    fib_path_list_batch_entry_t *fplbe;
+    fib_route_path_t *rpath;
+    uword hash;
+
+    hash = fib_path_list_batch_hash(flags, rpaths);
+
+    /*
+     * on a hash collision the first set of paths keeps the slot
+     */
+    if (NULL != hash_get(fib_path_list_batch_db, hash))
+        return;
+
+    vec_add2(fib_path_list_batch_entries, fplbe, 1);
+    fplbe->fplbe_flags = flags;
+    fplbe->fplbe_rpaths = vec_dup((fib_route_path_t*)rpaths);
+    vec_foreach(rpath, fplbe->fplbe_rpaths)
+    {
+        rpath->frp_label_stack = vec_dup(rpath->frp_label_stack);
+    }
+    fplbe->fplbe_path_list = path_list_index;
+    fib_path_list_lock(path_list_index);
+
+    hash_set(fib_path_list_batch_db, hash,
+             fplbe - fib_path_list_batch_entries);
+}
+
+/**
+ * @brief Start a batch of path-list creations.
+ * Batches may nest; the memo is flushed when the outermost batch ends.
+ */
+void
+fib_path_list_batch_begin (void)
+{
+    if (0 == fib_path_list_batch_depth++)
+    {
+        fib_path_list_batch_n_hits = 0;
+    }
+}
+
+void
+fib_path_list_batch_end (void)
+{
+    fib_path_list_batch_entry_t *fplbe;
+    fib_route_path_t *rpath;
+
+    ASSERT(fib_path_list_batch_depth > 0);
+
+    if (0 != --fib_path_list_batch_depth)
+        return;
+
+    vec_foreach(fplbe, fib_path_list_batch_entries)
+    {
+        vec_foreach(rpath, fplbe->fplbe_rpaths)
+        {
+            vec_free(rpath->frp_label_stack);
+        }
+        vec_free(fplbe->fplbe_rpaths);
+        fib_path_list_unlock(fplbe->fplbe_path_list);
+    }
+    vec_reset_length(fib_path_list_batch_entries);
+    hash_free(fib_path_list_batch_db);
+}
+
+/**
+ * @brief The number of path-list creations satisfied from the memo
+ * during the current, or last, batch.
+ */
+u32
+fib_path_list_batch_n_hits_get (void)
+{
+    return (fib_path_list_batch_n_hits);
+}
+
 fib_node_index_t
 fib_path_list_create (fib_path_list_flags_t flags,
 		      const fib_route_path_t *rpaths)
 {
     fib_node_index_t path_list_index, old_path_list_index;
     fib_path_list_t *path_list;
-    int i;
+    int i, memoable;
 
     flags = fib_path_list_flags_fixup(flags);
+
+    memoable = fib_path_list_batch_is_memoable(flags, rpaths);
+
+    if (memoable)
+    {
+        path_list_index = fib_path_list_batch_find(flags, rpaths);
+
+        if (FIB_NODE_INDEX_INVALID != path_list_index)
+            return (path_list_index);
+    }
+
     path_list = fib_path_list_alloc(&path_list_index);
     path_list->fpl_flags = flags;
 
@@ -715,6 +932,11 @@ fib_path_list_create (fib_path_list_flags_t flags,
 	    fib_path_list_db_insert(path_list_index);
 	    path_list = fib_path_list_resolve(path_list);
 	}
+
+        if (memoable)
+        {
+            fib_path_list_batch_add(flags, rpaths, path_list_index);
+        }
     }
     else
     {
@@ -153,6 +153,9 @@ extern void fib_path_list_child_remove(fib_node_index_t pl_index,
 				       fib_node_index_t sibling_index);
 extern void fib_path_list_back_walk(fib_node_index_t pl_index,
 				    fib_node_back_walk_ctx_t *ctx);
+extern void fib_path_list_batch_begin(void);
+extern void fib_path_list_batch_end(void);
+extern u32 fib_path_list_batch_n_hits_get(void);
 extern void fib_path_list_lock(fib_node_index_t pl_index);
 extern void fib_path_list_unlock(fib_node_index_t pl_index);
 extern int fib_path_list_recursive_loop_detect(fib_node_index_t path_list_index,
@@ -0,0 +1,869 @@
+/*
+ * Copyright (c) 2018 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vppinfra/serialize.h>
+
+#include <vnet/fib/fib_snapshot.h>
+#include <vnet/fib/fib_table.h>
+#include <vnet/fib/fib_entry.h>
+#include <vnet/ip/ip.h>
+#include <vnet/dpo/ip_null_dpo.h>
+#include <vnet/dpo/receive_dpo.h>
+
+#define FIB_SNAPSHOT_MAGIC "vpp-fib-snapshot"
+#define FIB_SNAPSHOT_VERSION 1
+
+/**
+ * The only route and path flags a snapshot records; a snapshot with any
+ * other is refused, they are the FIB's own.
+ */
+#define FIB_SNAPSHOT_ROUTE_FLAGS (FIB_ENTRY_FLAG_MULTICAST)
+#define FIB_SNAPSHOT_PATH_FLAGS (FIB_ROUTE_PATH_LOCAL |  \
+                                 FIB_ROUTE_PATH_DROP |   \
+                                 FIB_ROUTE_PATH_DVR)
+
+/**
+ * The types of route in a snapshot
+ */
+typedef enum fib_snapshot_route_type_t_ {
+    /**
+     * A route with paths
+     */
+    FIB_SNAPSHOT_ROUTE_PATHS,
+    /**
+     * The API's drop, unreachable and prohibit routes
+     */
+    FIB_SNAPSHOT_ROUTE_NULL,
+    /**
+     * The API's local routes
+     */
+    FIB_SNAPSHOT_ROUTE_LOCAL,
+} __attribute__ ((packed)) fib_snapshot_route_type_t;
+
+/**
+ * A path as it is stored in a snapshot
+ */
+typedef struct fib_snapshot_path_t_ {
+    /**
+     * The path. The interface and table indices are not meaningful
+     * across a restart.
+     */
+    fib_route_path_t fsp_rpath;
+    /**
+     * The name of the path's interface, a C-string, or NULL
+     */
+    u8 *fsp_intf;
+    /**
+     * The ID of the table in which a path with no interface resolves
+     */
+    u32 fsp_table_id;
+} fib_snapshot_path_t;
+
+/**
+ * A route as it is stored in a snapshot
+ */
+typedef struct fib_snapshot_route_t_ {
+    fib_prefix_t fsr_prefix;
+    fib_snapshot_route_type_t fsr_type;
+    ip_null_dpo_action_t fsr_action;
+    fib_entry_flag_t fsr_flags;
+    fib_snapshot_path_t *fsr_paths;
+} fib_snapshot_route_t;
+
+/**
+ * A table as it is stored in a snapshot
+ */
+typedef struct fib_snapshot_table_t_ {
+    fib_protocol_t fst_proto;
+    u32 fst_table_id;
+    /**
+     * The table's description, a C-string
+     */
+    u8 *fst_name;
+    fib_snapshot_route_t *fst_routes;
+} fib_snapshot_table_t;
+
+static void
+fib_snapshot_route_free (fib_snapshot_route_t *route)
+{
+    fib_snapshot_path_t *path;
+
+    vec_foreach(path, route->fsr_paths)
+    {
+        vec_free(path->fsp_intf);
+    }
+    vec_free(route->fsr_paths);
+}
+
+static void
+fib_snapshot_tables_free (fib_snapshot_table_t *tables)
+{
+    fib_snapshot_route_t *route;
+    fib_snapshot_table_t *table;
+
+    vec_foreach(table, tables)
+    {
+        vec_foreach(route, table->fst_routes)
+        {
+            fib_snapshot_route_free(route);
+        }
+        vec_free(table->fst_routes);
+        vec_free(table->fst_name);
+    }
+    vec_free(tables);
+}
+
+static fib_table_walk_rc_t
+fib_snapshot_collect (fib_node_index_t fei,
+                      void *arg)
+{
+    fib_node_index_t **feis = arg;
+
+    if (FIB_SOURCE_API == fib_entry_get_best_source(fei))
+    {
+        vec_add1(*feis, fei);
+    }
+    return (FIB_TABLE_WALK_CONTINUE);
+}
+
+/**
+ * Build the snapshot of an entry's API source.
+ * @return 0 if the route can be saved.
+ */
+static int
+fib_snapshot_route_build (fib_node_index_t fei,
+                          u8 ***intf_names,
+                          fib_snapshot_route_t *route)
+{
+    fib_route_path_encode_t *api_rpaths, *api_rpath;
+    fib_snapshot_path_t *path;
+    fib_route_path_t *rpath;
+    int rv;
+
+    memset(route, 0, sizeof(*route));
+    api_rpaths = NULL;
+    rv = 0;
+
+    fib_entry_get_prefix(fei, &route->fsr_prefix);
+    route->fsr_flags = fib_entry_get_flags_for_source(fei, FIB_SOURCE_API);
+
+    /*
+     * the out-going labels are in the source's path extensions, not
+     * in the paths
+     */
+    if (fib_entry_has_path_extensions(fei, FIB_SOURCE_API))
+    {
+        return (-1);
+    }
+
+    fib_entry_encode(fei, &api_rpaths);
+
+    if (route->fsr_flags & FIB_ENTRY_FLAG_EXCLUSIVE)
+    {
+        /*
+         * the API's special routes; as in the API's dump, they are known
+         * by their DPO
+         */
+        if (1 != vec_len(api_rpaths))
+        {
+            rv = -1;
+        }
+        else if (DPO_IP_NULL == api_rpaths[0].dpo.dpoi_type)
+        {
+            route->fsr_type = FIB_SNAPSHOT_ROUTE_NULL;
+            route->fsr_action =
+                ip_null_dpo_get_action(api_rpaths[0].dpo.dpoi_index);
+        }
+        else if (DPO_RECEIVE == api_rpaths[0].dpo.dpoi_type)
+        {
+            route->fsr_type = FIB_SNAPSHOT_ROUTE_LOCAL;
+        }
+        else
+        {
+            rv = -1;
+        }
+        goto done;
+    }
+
+    route->fsr_type = FIB_SNAPSHOT_ROUTE_PATHS;
+    route->fsr_flags &= FIB_SNAPSHOT_ROUTE_FLAGS;
+
+    vec_foreach(api_rpath, api_rpaths)
+    {
+        if (api_rpath->rpath.frp_flags & FIB_ROUTE_PATH_UDP_ENCAP)
+        {
+            rv = -1;
+            break;
+        }
+
+        vec_add2(route->fsr_paths, path, 1);
+        path->fsp_rpath = api_rpath->rpath;
+        rpath = &path->fsp_rpath;
+        rpath->frp_label_stack = NULL;
+
+        if (DPO_RECEIVE == api_rpath->dpo.dpoi_type)
+        {
+            rpath->frp_flags |= FIB_ROUTE_PATH_LOCAL;
+        }
+        else if (DPO_DROP == api_rpath->dpo.dpoi_type &&
+                 ~0 == rpath->frp_sw_if_index &&
+                 ip46_address_is_zero(&rpath->frp_addr))
+        {
+            rpath->frp_flags |= FIB_ROUTE_PATH_DROP;
+        }
+        rpath->frp_flags &= FIB_SNAPSHOT_PATH_FLAGS;
+
+        if (~0 != rpath->frp_sw_if_index)
+        {
+            vec_validate(*intf_names, rpath->frp_sw_if_index);
+
+            if (NULL == (*intf_names)[rpath->frp_sw_if_index])
+            {
+                (*intf_names)[rpath->frp_sw_if_index] =
+                    format(NULL, "%U%c",
+                           format_vnet_sw_if_index_name, vnet_get_main(),
+                           rpath->frp_sw_if_index, 0);
+            }
+            path->fsp_intf = vec_dup((*intf_names)[rpath->frp_sw_if_index]);
+        }
+        else if ((DPO_PROTO_IP4 == rpath->frp_proto ||
+                  DPO_PROTO_IP6 == rpath->frp_proto ||
+                  DPO_PROTO_MPLS == rpath->frp_proto) &&
+                 !(rpath->frp_flags & (FIB_ROUTE_PATH_LOCAL |
+                                       FIB_ROUTE_PATH_DROP)))
+        {
+            /*
+             * recursive and lookup paths encode the index of the table
+             * they resolve in
+             */
+            path->fsp_table_id =
+                fib_table_get_table_id(rpath->frp_fib_index,
+                                       dpo_proto_to_fib(rpath->frp_proto));
+        }
+    }
+
+done:
+    vec_free(api_rpaths);
+
+    if (rv)
+    {
+        fib_snapshot_route_free(route);
+    }
+    return (rv);
+}
+
+static void
+fib_snapshot_table_build (fib_table_t *fib_table,
+                          u8 ***intf_names,
+                          fib_snapshot_table_t **tables,
+                          fib_snapshot_stats_t *stats)
+{
+    fib_node_index_t *feis, *fei;
+    fib_snapshot_table_t *table;
+    fib_snapshot_route_t route;
+
+    feis = NULL;
+    fib_table_walk(fib_table->ft_index, fib_table->ft_proto,
+                   fib_snapshot_collect, &feis);
+
+    /*
+     * the tables the API created, and those it added routes to
+     */
+    if (0 == vec_len(feis) &&
+        (0 == fib_table->ft_table_id ||
+         0 == fib_table->ft_locks[FIB_SOURCE_API]))
+    {
+        return;
+    }
+
+    vec_add2(*tables, table, 1);
+    table->fst_proto = fib_table->ft_proto;
+    table->fst_table_id = fib_table->ft_table_id;
+    table->fst_name = format(NULL, "%v%c", fib_table->ft_desc, 0);
+
+    vec_foreach(fei, feis)
+    {
+        if (fib_snapshot_route_build(*fei, intf_names, &route))
+        {
+            stats->fss_n_skipped++;
+        }
+        else
+        {
+            vec_add1(table->fst_routes, route);
+            stats->fss_n_routes++;
+        }
+    }
+    stats->fss_n_tables++;
+
+    vec_free(feis);
+}
+
+static void
+fib_snapshot_address_serialize (serialize_main_t *sm,
+                                fib_protocol_t proto,
+                                const ip46_address_t *addr)
+{
+    if (FIB_PROTOCOL_IP4 == proto)
+    {
+        clib_memcpy(serialize_get(sm, sizeof(addr->ip4)),
+                    &addr->ip4, sizeof(addr->ip4));
+    }
+    else
+    {
+        clib_memcpy(serialize_get(sm, sizeof(addr->ip6)),
+                    &addr->ip6, sizeof(addr->ip6));
+    }
+}
+
+static void
+fib_snapshot_address_unserialize (serialize_main_t *sm,
+                                  fib_protocol_t proto,
+                                  ip46_address_t *addr)
+{
+    memset(addr, 0, sizeof(*addr));
+
+    if (FIB_PROTOCOL_IP4 == proto)
+    {
+        clib_memcpy(&addr->ip4, unserialize_get(sm, sizeof(addr->ip4)),
+                    sizeof(addr->ip4));
+    }
+    else
+    {
+        clib_memcpy(&addr->ip6, unserialize_get(sm, sizeof(addr->ip6)),
+                    sizeof(addr->ip6));
+    }
+}
+
+static void
+fib_snapshot_serialize (serialize_main_t *sm, va_list *args)
+{
+    fib_snapshot_table_t *tables = va_arg(*args, fib_snapshot_table_t *);
+    fib_snapshot_route_t *route;
+    fib_snapshot_table_t *table;
+    fib_snapshot_path_t *path;
+
+    serialize_magic(sm, FIB_SNAPSHOT_MAGIC, strlen(FIB_SNAPSHOT_MAGIC));
+    serialize_integer(sm, FIB_SNAPSHOT_VERSION, sizeof(u32));
+    serialize_likely_small_unsigned_integer(sm, vec_len(tables));
+
+    vec_foreach(table, tables)
+    {
+        serialize_integer(sm, table->fst_proto, sizeof(u8));
+        serialize_integer(sm, table->fst_table_id, sizeof(u32));
+        serialize_cstring(sm, (char *) table->fst_name);
+        serialize_integer(sm, vec_len(table->fst_routes), sizeof(u32));
+
+        vec_foreach(route, table->fst_routes)
+        {
+            serialize_integer(sm, route->fsr_prefix.fp_len, sizeof(u8));
+            fib_snapshot_address_serialize(sm, table->fst_proto,
+                                           &route->fsr_prefix.fp_addr);
+            serialize_integer(sm, route->fsr_type, sizeof(u8));
+
+            switch (route->fsr_type)
+            {
+            case FIB_SNAPSHOT_ROUTE_NULL:
+                serialize_integer(sm, route->fsr_action, sizeof(u8));
+                break;
+            case FIB_SNAPSHOT_ROUTE_LOCAL:
+                break;
+            case FIB_SNAPSHOT_ROUTE_PATHS:
+                serialize_likely_small_unsigned_integer(sm, route->fsr_flags);
+                serialize_likely_small_unsigned_integer(
+                    sm, vec_len(route->fsr_paths));
+
+                vec_foreach(path, route->fsr_paths)
+                {
+                    serialize_integer(sm, path->fsp_rpath.frp_proto,
+                                      sizeof(u8));
+                    clib_memcpy(serialize_get(sm, sizeof(ip46_address_t)),
+                                &path->fsp_rpath.frp_addr,
+                                sizeof(ip46_address_t));
+                    serialize_cstring(sm, (char *) path->fsp_intf);
+                    serialize_integer(sm, path->fsp_table_id, sizeof(u32));
+                    serialize_integer(sm, path->fsp_rpath.frp_weight,
+                                      sizeof(u8));
+                    serialize_integer(sm, path->fsp_rpath.frp_preference,
+                                      sizeof(u8));
+                    serialize_likely_small_unsigned_integer(
+                        sm, path->fsp_rpath.frp_flags);
+                }
+                break;
+            }
+        }
+    }
+}
+
+static void
+fib_snapshot_unserialize (serialize_main_t *sm, va_list *args)
+{
+    fib_snapshot_table_t **tables = va_arg(*args, fib_snapshot_table_t **);
+    u32 version, n_tables, n_routes, n_paths, ii, jj, kk, max_len;
+    fib_snapshot_route_t *route;
+    fib_snapshot_table_t *table;
+    fib_snapshot_path_t *path;
+    u8 val;
+
+    unserialize_check_magic(sm, FIB_SNAPSHOT_MAGIC,
+                            strlen(FIB_SNAPSHOT_MAGIC));
+    unserialize_integer(sm, &version, sizeof(u32));
+    if (FIB_SNAPSHOT_VERSION != version)
+    {
+        serialize_error_return(sm, "unsupported snapshot version %d",
+                               version);
+    }
+
+    n_tables = unserialize_likely_small_unsigned_integer(sm);
+
+    for (ii = 0; ii < n_tables; ii++)
+    {
+        vec_add2(*tables, table, 1);
+
+        unserialize_integer(sm, &val, sizeof(u8));
+        if (FIB_PROTOCOL_IP4 != val && FIB_PROTOCOL_IP6 != val)
+        {
+            serialize_error_return(sm, "bad table protocol %d", val);
+        }
+        table->fst_proto = val;
+        max_len = (FIB_PROTOCOL_IP4 == val ? 32 : 128);
+
+        unserialize_integer(sm, &table->fst_table_id, sizeof(u32));
+        unserialize_cstring(sm, (char **) &table->fst_name);
+        unserialize_integer(sm, &n_routes, sizeof(u32));
+
+        for (jj = 0; jj < n_routes; jj++)
+        {
+            vec_add2(table->fst_routes, route, 1);
+
+            route->fsr_prefix.fp_proto = table->fst_proto;
+            unserialize_integer(sm, &val, sizeof(u8));
+            if (val > max_len)
+            {
+                serialize_error_return(sm, "bad prefix length %d", val);
+            }
+            route->fsr_prefix.fp_len = val;
+            fib_snapshot_address_unserialize(sm, table->fst_proto,
+                                             &route->fsr_prefix.fp_addr);
+
+            unserialize_integer(sm, &val, sizeof(u8));
+            route->fsr_type = val;
+
+            switch (route->fsr_type)
+            {
+            case FIB_SNAPSHOT_ROUTE_NULL:
+                unserialize_integer(sm, &val, sizeof(u8));
+                if (val >= IP_NULL_DPO_ACTION_NUM)
+                {
+                    serialize_error_return(sm, "bad null action %d", val);
+                }
+                route->fsr_action = val;
+                break;
+            case FIB_SNAPSHOT_ROUTE_LOCAL:
+                break;
+            case FIB_SNAPSHOT_ROUTE_PATHS:
+                route->fsr_flags =
+                    unserialize_likely_small_unsigned_integer(sm);
+                if (route->fsr_flags & ~FIB_SNAPSHOT_ROUTE_FLAGS)
+                {
+                    serialize_error_return(sm, "bad route flags 0x%x",
+                                           route->fsr_flags);
+                }
+                n_paths = unserialize_likely_small_unsigned_integer(sm);
+
+                for (kk = 0; kk < n_paths; kk++)
+                {
+                    vec_add2(route->fsr_paths, path, 1);
+
+                    unserialize_integer(sm, &val, sizeof(u8));
+                    if (val >= DPO_PROTO_NUM)
+                    {
+                        serialize_error_return(sm, "bad path protocol %d",
+                                               val);
+                    }
+                    path->fsp_rpath.frp_proto = val;
+                    clib_memcpy(&path->fsp_rpath.frp_addr,
+                                unserialize_get(sm, sizeof(ip46_address_t)),
+                                sizeof(ip46_address_t));
+                    unserialize_cstring(sm, (char **) &path->fsp_intf);
+                    unserialize_integer(sm, &path->fsp_table_id,
+                                        sizeof(u32));
+                    unserialize_integer(sm, &path->fsp_rpath.frp_weight,
+                                        sizeof(u8));
+                    unserialize_integer(sm, &path->fsp_rpath.frp_preference,
+                                        sizeof(u8));
+                    path->fsp_rpath.frp_flags =
+                        unserialize_likely_small_unsigned_integer(sm);
+                    if (path->fsp_rpath.frp_flags & ~FIB_SNAPSHOT_PATH_FLAGS)
+                    {
+                        serialize_error_return(sm, "bad path flags 0x%x",
+                                               path->fsp_rpath.frp_flags);
+                    }
+                }
+                break;
+            default:
+                serialize_error_return(sm, "bad route type %d", val);
+            }
+        }
+    }
+}
+
+static void
+fib_snapshot_intf_names_free (u8 **intf_names)
+{
+    u8 **name;
+
+    vec_foreach(name, intf_names)
+    {
+        vec_free(*name);
+    }
+    vec_free(intf_names);
+}
+
+clib_error_t *
+fib_snapshot_save (const char *file,
+                   fib_snapshot_stats_t *stats)
+{
+    fib_snapshot_table_t *tables;
+    serialize_main_t _sm, *sm = &_sm;
+    fib_table_t *fib_table;
+    clib_error_t *error;
+    u8 **intf_names;
+    f64 start;
+
+    memset(stats, 0, sizeof(*stats));
+    start = vlib_time_now(vlib_get_main());
+    intf_names = NULL;
+    tables = NULL;
+
+    pool_foreach(fib_table, ip4_main.fibs,
+    ({
+        fib_snapshot_table_build(fib_table, &intf_names, &tables, stats);
+    }));
+    pool_foreach(fib_table, ip6_main.fibs,
+    ({
+        fib_snapshot_table_build(fib_table, &intf_names, &tables, stats);
+    }));
+
+    error = serialize_open_clib_file(sm, (char *) file);
+
+    if (NULL == error)
+    {
+        error = serialize(sm, fib_snapshot_serialize, tables);
+        serialize_close(sm);
+    }
+
+    fib_snapshot_tables_free(tables);
+    fib_snapshot_intf_names_free(intf_names);
+
+    stats->fss_time = vlib_time_now(vlib_get_main()) - start;
+
+    return (error);
+}
+
+static u32
+fib_snapshot_intf_find (uword **intf_by_name,
+                        u8 *name)
+{
+    unformat_input_t input;
+    u32 sw_if_index;
+    uword *p;
+
+    p = hash_get_mem(*intf_by_name, name);
+
+    if (NULL != p)
+    {
+        return (p[0]);
+    }
+
+    sw_if_index = ~0;
+    unformat_init_string(&input, (char *) name, strlen((char *) name));
+    if (!unformat(&input, "%U",
+                  unformat_vnet_sw_interface, vnet_get_main(),
+                  &sw_if_index))
+    {
+        sw_if_index = ~0;
+    }
+    unformat_free(&input);
+
+    hash_set_mem(*intf_by_name, vec_dup(name), sw_if_index);
+
+    return (sw_if_index);
+}
+
+/**
+ * Translate the snapshot's paths into this instance's interface and table
+ * indices.
+ * @return 0 if all the interfaces and tables are present.
+ */
+static int
+fib_snapshot_route_rpaths (const fib_snapshot_route_t *route,
+                           uword **intf_by_name,
+                           fib_route_path_t **rpaths)
+{
+    fib_snapshot_path_t *path;
+    fib_route_path_t *rpath;
+
+    vec_foreach(path, route->fsr_paths)
+    {
+        vec_add2(*rpaths, rpath, 1);
+        *rpath = path->fsp_rpath;
+
+        if (NULL != path->fsp_intf)
+        {
+            rpath->frp_sw_if_index =
+                fib_snapshot_intf_find(intf_by_name, path->fsp_intf);
+            rpath->frp_fib_index = ~0;
+
+            if (~0 == rpath->frp_sw_if_index)
+            {
+                return (-1);
+            }
+        }
+        else
+        {
+            rpath->frp_sw_if_index = ~0;
+            rpath->frp_fib_index = 0;
+
+            if ((DPO_PROTO_IP4 == rpath->frp_proto ||
+                 DPO_PROTO_IP6 == rpath->frp_proto ||
+                 DPO_PROTO_MPLS == rpath->frp_proto) &&
+                !(rpath->frp_flags & (FIB_ROUTE_PATH_LOCAL |
+                                      FIB_ROUTE_PATH_DROP)))
+            {
+                rpath->frp_fib_index =
+                    fib_table_find(dpo_proto_to_fib(rpath->frp_proto),
+                                   path->fsp_table_id);
+
+                if (~0 == rpath->frp_fib_index)
+                {
+                    return (-1);
+                }
+            }
+        }
+    }
+
+    return (0);
+}
+
+static int
+fib_snapshot_route_restore (u32 fib_index,
+                            const fib_snapshot_route_t *route,
+                            uword **intf_by_name)
+{
+    dpo_proto_t dproto;
+    fib_route_path_t *rpaths;
+    dpo_id_t dpo = DPO_INVALID;
+    int rv;
+
+    dproto = fib_proto_to_dpo(route->fsr_prefix.fp_proto);
+    rpaths = NULL;
+    rv = 0;
+
+    switch (route->fsr_type)
+    {
+    case FIB_SNAPSHOT_ROUTE_NULL:
+        ip_null_dpo_add_and_lock(dproto, route->fsr_action, &dpo);
+        break;
+    case FIB_SNAPSHOT_ROUTE_LOCAL:
+        receive_dpo_add_or_lock(dproto, ~0, NULL, &dpo);
+        break;
+    case FIB_SNAPSHOT_ROUTE_PATHS:
+        rv = fib_snapshot_route_rpaths(route, intf_by_name, &rpaths);
+
+        if (0 == rv)
+        {
+            fib_table_entry_update(fib_index,
+                                   &route->fsr_prefix,
+                                   FIB_SOURCE_API,
+                                   route->fsr_flags,
+                                   rpaths);
+        }
+        vec_free(rpaths);
+        return (rv);
+    }
+
+    fib_table_entry_special_dpo_update(fib_index,
+                                       &route->fsr_prefix,
+                                       FIB_SOURCE_API,
+                                       FIB_ENTRY_FLAG_EXCLUSIVE,
+                                       &dpo);
+    dpo_reset(&dpo);
+
+    return (rv);
+}
+
+clib_error_t *
+fib_snapshot_restore (const char *file,
+                      fib_snapshot_stats_t *stats)
+{
+    serialize_main_t _sm, *sm = &_sm;
+    fib_snapshot_table_t *tables, *table;
+    fib_snapshot_route_t *route;
+    clib_error_t *error;
+    uword *intf_by_name;
+    u32 fib_index;
+    f64 start;
+
+    memset(stats, 0, sizeof(*stats));
+    start = vlib_time_now(vlib_get_main());
+    tables = NULL;
+
+    error = unserialize_open_clib_file(sm, (char *) file);
+
+    if (NULL != error)
+    {
+        return (error);
+    }
+
+    error = unserialize(sm, fib_snapshot_unserialize, &tables);
+    unserialize_close(sm);
+
+    if (NULL != error)
+    {
+        fib_snapshot_tables_free(tables);
+        return (error);
+    }
+
+    /*
+     * all the tables first, since recursive paths can resolve in any
+     * of them
+     */
+    vec_foreach(table, tables)
+    {
+        ip_table_create(table->fst_proto, table->fst_table_id,
+                        1, table->fst_name);
+    }
+
+    intf_by_name = hash_create_vec(0, sizeof(u8), sizeof(uword));
+
+    fib_table_batch_begin();
+
+    vec_foreach(table, tables)
+    {
+        fib_index = fib_table_find(table->fst_proto, table->fst_table_id);
+
+        if (~0 == fib_index)
+        {
+            stats->fss_n_skipped += vec_len(table->fst_routes);
+            continue;
+        }
+
+        vec_foreach(route, table->fst_routes)
+        {
+            if (fib_snapshot_route_restore(fib_index, route, &intf_by_name))
+            {
+                stats->fss_n_skipped++;
+            }
+            else
+            {
+                stats->fss_n_routes++;
+            }
+        }
+        stats->fss_n_tables++;
+    }
+
+    fib_table_batch_end();
+
+    {
+        u8 *name;
+        uword val;
+
+        /* *INDENT-OFF* */
+        hash_foreach_mem(name, val, intf_by_name,
+        ({
+            vec_free(name);
+        }));
+        /* *INDENT-ON* */
+        hash_free(intf_by_name);
+    }
+    fib_snapshot_tables_free(tables);
+
+    stats->fss_time = vlib_time_now(vlib_get_main()) - start;
+
+    return (NULL);
+}
+
+static clib_error_t *
+fib_snapshot_cli (vlib_main_t * vm,
+                  unformat_input_t * input,
+                  vlib_cli_command_t * cmd)
+{
+    fib_snapshot_stats_t stats;
+    clib_error_t *error;
+    u8 *file;
+    int save;
+
+    file = NULL;
+    save = -1;
+
+    while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+        if (unformat (input, "save %s", &file))
+            save = 1;
+        else if (unformat (input, "restore %s", &file))
+            save = 0;
+        else
+        {
+            error = unformat_parse_error (input);
+            goto done;
+        }
+    }
+
+    if (-1 == save)
+    {
+        error = clib_error_return (0, "save or restore <file> required");
+        goto done;
+    }
+
+    vec_add1(file, 0);
+
+    if (save)
+        error = fib_snapshot_save((char *) file, &stats);
+    else
+        error = fib_snapshot_restore((char *) file, &stats);
+
+    if (NULL == error)
+    {
+        vlib_cli_output (vm, "%s %d routes in %d tables in %.3f secs, "
+                         "%d skipped",
+                         (save ? "saved" : "restored"),
+                         stats.fss_n_routes, stats.fss_n_tables,
+                         stats.fss_time, stats.fss_n_skipped);
+    }
+
+done:
+    vec_free(file);
+    return (error);
+}
+
+/*?
+ * Save the IP routes added by the control plane, and the tables they are
+ * in, to a file; or restore them from one. Restoring the snapshot
+ * from the startup-config's exec file brings the data-plane back
+ * forwarding after a restart before the control plane has re-programmed
+ * it. Interfaces are matched by name, so they must exist, with the
+ * same names, before the restore.
+ *
+ * @cliexpar
+ * @cliexcmd{fib snapshot save /tmp/fib.snap}
+ * @cliexcmd{fib snapshot restore /tmp/fib.snap}
+ ?*/
+/* *INDENT-OFF* */
+VLIB_CLI_COMMAND (fib_snapshot_command, static) = {
+  .path = "fib snapshot",
+  .function = fib_snapshot_cli,
+  .short_help = "fib snapshot [save|restore] <file>",
+};
+/* *INDENT-ON* */
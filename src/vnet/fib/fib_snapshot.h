@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2018 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __FIB_SNAPSHOT_H__
+#define __FIB_SNAPSHOT_H__
+
+#include <vnet/fib/fib_types.h>
+
+/**
+ * A FIB snapshot is a file holding the IP tables and the routes in them
+ * that were added by the control plane (i.e. FIB_SOURCE_API), so that a
+ * restarted VPP can restore them in one batch and forward while the
+ * control plane reconciles. Interfaces are recorded by name and tables
+ * by ID, so neither needs the same index after the restart. Adjacencies
+ * are not saved; they are re-created by the paths that use them and the
+ * neighbours re-resolved.
+ * Not saved, and so counted as skipped, are routes whose paths carry
+ * out-going labels, UDP encaps or classify tables.
+ */
+typedef struct fib_snapshot_stats_t_
+{
+    /**
+     * Number of tables saved/restored
+     */
+    u32 fss_n_tables;
+    /**
+     * Number of routes saved/restored
+     */
+    u32 fss_n_routes;
+    /**
+     * Number of routes not saved/restored
+     */
+    u32 fss_n_skipped;
+    /**
+     * Time taken, in seconds
+     */
+    f64 fss_time;
+} fib_snapshot_stats_t;
+
+/**
+ * @brief Write a snapshot of the IP FIBs to the file
+ */
+extern clib_error_t *fib_snapshot_save(const char *file,
+                                       fib_snapshot_stats_t *stats);
+
+/**
+ * @brief Restore the IP FIBs from the snapshot in the file.
+ * The whole file is read before any table is changed, so a bad file has
+ * no effect. Routes that are already present are updated, not
+ * duplicated, so a restore can follow or precede the control plane's
+ * own re-programming.
+ */
+extern clib_error_t *fib_snapshot_restore(const char *file,
+                                          fib_snapshot_stats_t *stats);
+
+#endif
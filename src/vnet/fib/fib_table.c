@@ -19,6 +19,7 @@
 #include <vnet/fib/fib_table.h>
 #include <vnet/fib/fib_entry_cover.h>
 #include <vnet/fib/fib_internal.h>
+#include <vnet/fib/fib_path_list.h>
 #include <vnet/fib/ip4_fib.h>
 #include <vnet/fib/ip6_fib.h>
 #include <vnet/fib/mpls_fib.h>
@@ -1345,6 +1346,18 @@ fib_table_flush (u32 fib_index,
     vec_free(ctx.ftf_entries);
 }
 
+void
+fib_table_batch_begin (void)
+{
+    fib_path_list_batch_begin();
+}
+
+void
+fib_table_batch_end (void)
+{
+    fib_path_list_batch_end();
+}
+
 u8 *
 format_fib_table_memory (u8 *s, va_list *args)
 {
@@ -611,6 +611,23 @@ extern void fib_table_flush(u32 fib_index,
 			    fib_protocol_t proto,
 			    fib_source_t source);
 
+/**
+ * @brief
+ *  Start a batch of updates to one or more tables.
+ *  Whilst a batch is open the path-lists the updates resolve to are
+ *  remembered, so that subsequent updates with the same paths, which is
+ *  the common case for a large route load, reuse them without further
+ *  construction or DB lookups. Batches may nest. Each call to begin must
+ *  be matched with a call to end.
+ */
+extern void fib_table_batch_begin(void);
+
+/**
+ * @brief
+ *  End a batch of updates started with fib_table_batch_begin
+ */
+extern void fib_table_batch_end(void);
+
 /**
  * @brief
  *  Get the index of the FIB bound to the interface
@@ -40,6 +40,8 @@
 #include <vnet/fib/fib_walk.h>
 #include <vnet/fib/fib_node_list.h>
 #include <vnet/fib/fib_urpf_list.h>
+#include <vnet/fib/fib_snapshot.h>
+#include <vnet/mfib/mfib_table.h>
 
 #include <vlib/unix/plugin.h>
 
@@ -7403,19 +7405,28 @@ static const fib_node_vft_t fib_test_child_vft = {
 f64 fib_walk_process_queues(vlib_main_t * vm,
                             const f64 quota);
 u32 fib_walk_queue_get_size(fib_walk_priority_t prio);
+extern u32 fib_walk_batch_size;
 
 static int
 fib_test_walk (void)
 {
     fib_node_back_walk_ctx_t high_ctx = {}, low_ctx = {};
+    const fib_walk_convergence_stats_t *fwcs;
+    u32 ii, res, n_visited, old_batch_size;
     fib_node_test_t *tc;
     vlib_main_t *vm;
-    u32 ii, res;
+    u64 n_convergences;
 
     res = 0;
     vm = vlib_get_main();
     fib_node_register_type(FIB_NODE_TYPE_TEST, &fib_test_child_vft);
 
+    /*
+     * the zero quanta tests expect one child visited per-quanta
+     */
+    old_batch_size = fib_walk_batch_size;
+    fib_walk_batch_size = 1;
+
     /*
      * init a fake node on which we will add children
      */
@@ -7561,6 +7572,70 @@ fib_test_walk (void)
              "Parent has %d children post no-merge walk",
              fib_node_list_get_size(PARENT()->fn_children));
 
+    /*
+     * schedule 2 walks of the same priority back to back. the second is
+     * coalesced into the first while it is still queued, so there is
+     * only one walk object. The drained queue completes a convergence.
+     */
+    high_ctx.fnbw_reason = FIB_NODE_BW_REASON_FLAG_RESOLVE;
+    low_ctx.fnbw_reason  = FIB_NODE_BW_REASON_FLAG_RESOLVE;
+    fwcs = fib_walk_get_convergence_stats();
+    n_convergences = fwcs->fwcs_n_convergences;
+
+    fib_walk_async(FIB_NODE_TYPE_TEST, PARENT_INDEX,
+                   FIB_WALK_PRIORITY_HIGH, &high_ctx);
+    fib_walk_async(FIB_NODE_TYPE_TEST, PARENT_INDEX,
+                   FIB_WALK_PRIORITY_HIGH, &low_ctx);
+
+    FIB_TEST(1 == fib_walk_queue_get_size(FIB_WALK_PRIORITY_HIGH),
+             "Coalesced walks are one in the queue");
+    FIB_TEST(N_TEST_CHILDREN+1 == fib_node_list_get_size(PARENT()->fn_children),
+             "Parent has %d children pre coalesced walk",
+             fib_node_list_get_size(PARENT()->fn_children));
+
+    fib_walk_process_queues(vm, 1);
+
+    FOR_EACH_TEST_CHILD(tc)
+    {
+        FIB_TEST(1 == vec_len(tc->ctxs),
+                 "%d child visitsed %d times during coalesced walk",
+                 ii, vec_len(tc->ctxs));
+        vec_free(tc->ctxs);
+    }
+    FIB_TEST(n_convergences + 1 == fwcs->fwcs_n_convergences,
+             "Convergence counted");
+    FIB_TEST(N_TEST_CHILDREN == fwcs->fwcs_last_n_visits,
+             "Convergence visited %d children",
+             fwcs->fwcs_last_n_visits);
+
+    /*
+     * with a batch of 2 a zero quanta walk makes two children progress
+     */
+    fib_walk_batch_size = 2;
+    fib_walk_async(FIB_NODE_TYPE_TEST, PARENT_INDEX,
+                   FIB_WALK_PRIORITY_HIGH, &high_ctx);
+    fib_walk_process_queues(vm, 0);
+
+    n_visited = 0;
+    FOR_EACH_TEST_CHILD(tc)
+    {
+        n_visited += vec_len(tc->ctxs);
+    }
+    FIB_TEST(2 == n_visited,
+             "%d children visited in batched zero quanta walk", n_visited);
+
+    fib_walk_process_queues(vm, 1);
+    FOR_EACH_TEST_CHILD(tc)
+    {
+        FIB_TEST(1 == vec_len(tc->ctxs),
+                 "%d child visitsed %d times during batched walk",
+                 ii, vec_len(tc->ctxs));
+        vec_free(tc->ctxs);
+    }
+    FIB_TEST(0 == fib_walk_queue_get_size(FIB_WALK_PRIORITY_HIGH),
+             "Queue is empty post batched walk");
+    fib_walk_batch_size = 1;
+
     /*
      * schedule a walk that makes one one child progress.
      * we do this by giving the queue draining process zero
@@ -7805,6 +7880,8 @@ fib_test_walk (void)
     FIB_TEST((1 == fib_test_nodes[PARENT_INDEX].destroyed),
              "Parent was destroyed");
 
+    fib_walk_batch_size = old_batch_size;
+
     return (res);
 }
 
@@ -10119,14 +10196,568 @@ fib_test_inherit (void)
     return (res);
 }
 
+/*
+ * Load, then remove, a large number of routes, as a routing protocol
+ * would on learning / losing a full table. Most prefixes share one of a
+ * handful of path sets.
+ */
+#define FIB_TEST_BULK_N_PATH_SETS 4
+
+static int
+fib_test_bulk_load (fib_prefix_t *pfxs,
+                    fib_route_path_t **path_sets,
+                    u32 fib_index,
+                    int batch,
+                    f64 *add_time,
+                    f64 *del_time)
+{
+    u32 n_feis, n_pls, n_entries, ii;
+    fib_route_path_t *rpaths;
+    int res;
+    f64 t0;
+
+    res = 0;
+    n_feis = fib_entry_pool_size();
+    n_pls = fib_path_list_pool_size();
+    n_entries = fib_table_get_num_entries(fib_index,
+                                          pfxs[0].fp_proto,
+                                          FIB_SOURCE_API);
+
+    t0 = vlib_time_now(vlib_get_main());
+    if (batch)
+        fib_table_batch_begin();
+
+    for (ii = 0; ii < vec_len(pfxs); ii++)
+    {
+        /*
+         * the FIB sorts the paths it is given, so pass a copy
+         */
+        rpaths = vec_dup(path_sets[ii % FIB_TEST_BULK_N_PATH_SETS]);
+        fib_table_entry_update(fib_index, &pfxs[ii],
+                               FIB_SOURCE_API,
+                               FIB_ENTRY_FLAG_NONE,
+                               rpaths);
+        vec_free(rpaths);
+    }
+
+    if (batch)
+    {
+        FIB_TEST((fib_path_list_batch_n_hits_get() >=
+                  vec_len(pfxs) - FIB_TEST_BULK_N_PATH_SETS),
+                 "%d path-lists reused from the batch",
+                 fib_path_list_batch_n_hits_get());
+        fib_table_batch_end();
+    }
+    *add_time = vlib_time_now(vlib_get_main()) - t0;
+
+    FIB_TEST((fib_table_get_num_entries(fib_index,
+                                        pfxs[0].fp_proto,
+                                        FIB_SOURCE_API) > n_entries),
+             "%U routes added",
+             format_fib_protocol, pfxs[0].fp_proto);
+    FIB_TEST((n_pls + FIB_TEST_BULK_N_PATH_SETS == fib_path_list_pool_size()),
+             "%d path-lists for %d routes",
+             fib_path_list_pool_size() - n_pls, vec_len(pfxs));
+
+    /*
+     * more specifics first, so no covered entry is re-resolved
+     */
+    t0 = vlib_time_now(vlib_get_main());
+    if (batch)
+        fib_table_batch_begin();
+
+    for (ii = vec_len(pfxs); ii > 0; ii--)
+    {
+        fib_table_entry_delete(fib_index, &pfxs[ii - 1], FIB_SOURCE_API);
+    }
+
+    if (batch)
+        fib_table_batch_end();
+    *del_time = vlib_time_now(vlib_get_main()) - t0;
+
+    FIB_TEST((n_feis == fib_entry_pool_size()), "Entries gone");
+    FIB_TEST((n_pls == fib_path_list_pool_size()), "Path-lists gone");
+
+    return (res);
+}
+
+static int
+fib_test_bulk_prefix_cmp_for_sort (void *v1, void *v2)
+{
+    fib_prefix_t *p1 = v1, *p2 = v2;
+
+    return (p1->fp_len - p2->fp_len);
+}
+
+static int
+fib_test_bulk (u32 n_routes)
+{
+    fib_route_path_t *path_sets[FIB_TEST_BULK_N_PATH_SETS] = { NULL };
+    fib_route_path_t *rpath;
+    fib_prefix_t *pfxs, *pfx;
+    f64 add_time, del_time;
+    fib_protocol_t proto;
+    u32 fib_index, seed;
+    test_main_t *tm;
+    int ii, res;
+    u8 len;
+
+    res = 0;
+    seed = 0xdeaddabe;
+    tm = &test_main;
+
+    FOR_EACH_FIB_IP_PROTOCOL(proto)
+    {
+        fib_index = fib_table_find_or_create_and_lock(proto, 12,
+                                                      FIB_SOURCE_API);
+        /*
+         * path sets: via nh1, via nh2, ECMP nh1 & nh2, and UCMP nh1 & nh2
+         */
+        for (ii = 0; ii < FIB_TEST_BULK_N_PATH_SETS; ii++)
+        {
+            int n_paths = (ii < 2 ? 1 : 2), jj;
+
+            for (jj = 0; jj < n_paths; jj++)
+            {
+                vec_add2(path_sets[ii], rpath, 1);
+                memset(rpath, 0, sizeof(*rpath));
+                rpath->frp_proto = fib_proto_to_dpo(proto);
+                rpath->frp_sw_if_index = tm->hw[0]->sw_if_index;
+                rpath->frp_fib_index = ~0;
+                rpath->frp_weight = (3 == ii ? jj + 1 : 1);
+                if (FIB_PROTOCOL_IP4 == proto)
+                    rpath->frp_addr.ip4.as_u32 =
+                        clib_host_to_net_u32(0x0a0a0a01 + ((ii + jj) & 1));
+                else
+                {
+                    rpath->frp_addr.ip6.as_u64[0] =
+                        clib_host_to_net_u64(0x2001000000000000);
+                    rpath->frp_addr.ip6.as_u64[1] =
+                        clib_host_to_net_u64(1 + ((ii + jj) & 1));
+                }
+            }
+        }
+
+        /*
+         * random prefixes with the distribution of lengths seen in the
+         * DFZ, i.e. mostly /24 or /48, sorted shortest first.
+         */
+        pfxs = NULL;
+        vec_validate(pfxs, n_routes - 1);
+        vec_foreach(pfx, pfxs)
+        {
+            memset(pfx, 0, sizeof(*pfx));
+            pfx->fp_proto = proto;
+
+            if (FIB_PROTOCOL_IP4 == proto)
+            {
+                len = (random_u32(&seed) & 1 ? 24 :
+                       16 + random_u32(&seed) % 17);
+                pfx->fp_len = len;
+                pfx->fp_addr.ip4.as_u32 =
+                    (clib_host_to_net_u32(random_u32(&seed) | 0x01000000) &
+                     ip4_main.fib_masks[len]);
+            }
+            else
+            {
+                len = (random_u32(&seed) & 1 ? 48 :
+                       29 + random_u32(&seed) % 36);
+                pfx->fp_len = len;
+                pfx->fp_addr.ip6.as_u32[0] =
+                    clib_host_to_net_u32(0x20000000 |
+                                         (random_u32(&seed) & 0x0fffffff));
+                pfx->fp_addr.ip6.as_u32[1] = random_u32(&seed);
+                ip6_address_mask(&pfx->fp_addr.ip6,
+                                 &ip6_main.fib_masks[len]);
+            }
+        }
+        vec_sort_with_function(pfxs, fib_test_bulk_prefix_cmp_for_sort);
+
+        FIB_TEST(!fib_test_bulk_load(pfxs, path_sets, fib_index, 0,
+                                     &add_time, &del_time),
+                 "%U bulk load without batch",
+                 format_fib_protocol, proto);
+        fformat(stdout, "%U: %d routes: add %.2f routes/sec, "
+                "del %.2f routes/sec\n",
+                format_fib_protocol, proto, n_routes,
+                n_routes / add_time, n_routes / del_time);
+
+        FIB_TEST(!fib_test_bulk_load(pfxs, path_sets, fib_index, 1,
+                                     &add_time, &del_time),
+                 "%U bulk load in a batch",
+                 format_fib_protocol, proto);
+        fformat(stdout, "%U: %d routes batched: add %.2f routes/sec, "
+                "del %.2f routes/sec\n",
+                format_fib_protocol, proto, n_routes,
+                n_routes / add_time, n_routes / del_time);
+
+        for (ii = 0; ii < FIB_TEST_BULK_N_PATH_SETS; ii++)
+        {
+            vec_free(path_sets[ii]);
+        }
+        vec_free(pfxs);
+        fib_table_unlock(fib_index, proto, FIB_SOURCE_API);
+    }
+
+    FIB_TEST(0 == adj_nbr_db_size(), "All adjacencies removed");
+
+    return (res);
+}
+
+/*
+ * The memory cost of a route. Load a large table, all of whose routes
+ * share one path-list, as most routes in a full table do, and bound the
+ * heap used per route: the entry, its source, its load-balance and
+ * counters, its element in the path-list's list of children and its
+ * slot in the table's hash. Then remove and reload it; the reload must
+ * cost no more than the first load did, or routes are leaking.
+ */
+#define FIB_TEST_MEM_MAX_BYTES_PER_ROUTE 512
+#define FIB_TEST_MEM_RELOAD_SLACK_PER_ROUTE 8
+
+static void
+fib_test_mem_load (const fib_prefix_t *pfxs,
+                   u32 first, u32 last,
+                   fib_route_path_t *rpaths,
+                   u32 fib_index)
+{
+    fib_route_path_t *rpaths_copy;
+    u32 ii;
+
+    for (ii = first; ii <= last; ii++)
+    {
+        /*
+         * the FIB sorts the paths it is given, so pass a copy
+         */
+        rpaths_copy = vec_dup(rpaths);
+        fib_table_entry_update(fib_index, &pfxs[ii],
+                               FIB_SOURCE_API,
+                               FIB_ENTRY_FLAG_NONE,
+                               rpaths_copy);
+        vec_free(rpaths_copy);
+    }
+}
+
+static void
+fib_test_mem_unload (const fib_prefix_t *pfxs,
+                     u32 fib_index)
+{
+    u32 ii;
+
+    for (ii = 0; ii < vec_len(pfxs); ii++)
+    {
+        fib_table_entry_delete(fib_index, &pfxs[ii], FIB_SOURCE_API);
+    }
+}
+
+static int
+fib_test_mem (u32 n_routes)
+{
+    clib_mem_usage_t before, loaded, reloaded;
+    fib_route_path_t *rpaths, *rpath;
+    u64 bytes_per_route, n_bytes;
+    fib_prefix_t *pfxs, *pfx;
+    u32 fib_index, n_feis, ii;
+    fib_protocol_t proto;
+    test_main_t *tm;
+    int res;
+
+    res = 0;
+    tm = &test_main;
+
+    /*
+     * one to create the shared path-list and adjacency, the rest to measure
+     */
+    if (n_routes < 2)
+        n_routes = 2;
+
+    FOR_EACH_FIB_IP_PROTOCOL(proto)
+    {
+        fib_index = fib_table_find_or_create_and_lock(proto, 13,
+                                                      FIB_SOURCE_API);
+
+        rpaths = NULL;
+        vec_add2(rpaths, rpath, 1);
+        memset(rpath, 0, sizeof(*rpath));
+        rpath->frp_proto = fib_proto_to_dpo(proto);
+        rpath->frp_sw_if_index = tm->hw[0]->sw_if_index;
+        rpath->frp_fib_index = ~0;
+        rpath->frp_weight = 1;
+        if (FIB_PROTOCOL_IP4 == proto)
+            rpath->frp_addr.ip4.as_u32 = clib_host_to_net_u32(0x0a0a0a01);
+        else
+        {
+            rpath->frp_addr.ip6.as_u64[0] =
+                clib_host_to_net_u64(0x2001000000000000);
+            rpath->frp_addr.ip6.as_u64[1] = clib_host_to_net_u64(1);
+        }
+
+        /*
+         * consecutive /24s or /48s, so all are distinct
+         */
+        pfxs = NULL;
+        vec_validate(pfxs, n_routes - 1);
+        ii = 0;
+        vec_foreach(pfx, pfxs)
+        {
+            memset(pfx, 0, sizeof(*pfx));
+            pfx->fp_proto = proto;
+
+            if (FIB_PROTOCOL_IP4 == proto)
+            {
+                pfx->fp_len = 24;
+                pfx->fp_addr.ip4.as_u32 =
+                    clib_host_to_net_u32(0x01000000 + (ii << 8));
+            }
+            else
+            {
+                pfx->fp_len = 48;
+                pfx->fp_addr.ip6.as_u64[0] =
+                    clib_host_to_net_u64(0x2002000000000000 +
+                                         ((u64) ii << 16));
+            }
+            ii++;
+        }
+
+        n_feis = fib_entry_pool_size();
+
+        fib_test_mem_load(pfxs, 0, 0, rpaths, fib_index);
+        clib_mem_usage(&before);
+        fib_test_mem_load(pfxs, 1, n_routes - 1, rpaths, fib_index);
+        clib_mem_usage(&loaded);
+
+        FIB_TEST((n_feis + n_routes == fib_entry_pool_size()),
+                 "%U: %d routes added",
+                 format_fib_protocol, proto, n_routes);
+
+        n_bytes = loaded.bytes_used - before.bytes_used;
+        bytes_per_route = n_bytes / (n_routes - 1);
+        fformat(stdout, "%U: %d routes: %lld bytes per route\n",
+                format_fib_protocol, proto, n_routes, bytes_per_route);
+        FIB_TEST((bytes_per_route <= FIB_TEST_MEM_MAX_BYTES_PER_ROUTE),
+                 "%U: %lld bytes per route, no more than %d",
+                 format_fib_protocol, proto, bytes_per_route,
+                 FIB_TEST_MEM_MAX_BYTES_PER_ROUTE);
+
+        fib_test_mem_unload(pfxs, fib_index);
+        FIB_TEST((n_feis == fib_entry_pool_size()), "Entries gone");
+
+        fib_test_mem_load(pfxs, 0, n_routes - 1, rpaths, fib_index);
+        clib_mem_usage(&reloaded);
+        FIB_TEST((reloaded.bytes_used <=
+                  (loaded.bytes_used +
+                   (u64) n_routes * FIB_TEST_MEM_RELOAD_SLACK_PER_ROUTE)),
+                 "%U: reload uses %lld bytes, the first load %lld",
+                 format_fib_protocol, proto,
+                 reloaded.bytes_used - before.bytes_used, n_bytes);
+
+        fib_test_mem_unload(pfxs, fib_index);
+        FIB_TEST((n_feis == fib_entry_pool_size()), "Entries gone");
+
+        vec_free(rpaths);
+        vec_free(pfxs);
+        fib_table_unlock(fib_index, proto, FIB_SOURCE_API);
+    }
+
+    FIB_TEST(0 == adj_nbr_db_size(), "All adjacencies removed");
+
+    return (res);
+}
+
+/*
+ * Save the API's routes to a snapshot, remove them and their table, then
+ * restore them and check they are back, in their table, the same.
+ */
+#define FIB_TEST_SNAPSHOT_FILE "/tmp/fib-test.snapshot"
+
+static int
+fib_test_snapshot (u32 n_routes)
+{
+    fib_route_path_t *rpaths, *rpath;
+    fib_route_path_encode_t *api_rpaths;
+    fib_snapshot_stats_t stats;
+    fib_prefix_t *pfxs, *pfx;
+    dpo_id_t dpo = DPO_INVALID;
+    u32 fib_index, n_feis, ii;
+    fib_node_index_t fei;
+    clib_error_t *error;
+    fib_protocol_t proto;
+    test_main_t *tm;
+    int res;
+
+    res = 0;
+    tm = &test_main;
+
+    if (n_routes < 1)
+        n_routes = 1;
+
+    FOR_EACH_FIB_IP_PROTOCOL(proto)
+    {
+        n_feis = fib_entry_pool_size();
+        fib_index = fib_table_find_or_create_and_lock(proto, 14,
+                                                      FIB_SOURCE_API);
+
+        rpaths = NULL;
+        vec_add2(rpaths, rpath, 1);
+        memset(rpath, 0, sizeof(*rpath));
+        rpath->frp_proto = fib_proto_to_dpo(proto);
+        rpath->frp_sw_if_index = tm->hw[0]->sw_if_index;
+        rpath->frp_fib_index = ~0;
+        rpath->frp_weight = 1;
+        if (FIB_PROTOCOL_IP4 == proto)
+            rpath->frp_addr.ip4.as_u32 = clib_host_to_net_u32(0x0a0a0a01);
+        else
+        {
+            rpath->frp_addr.ip6.as_u64[0] =
+                clib_host_to_net_u64(0x2001000000000000);
+            rpath->frp_addr.ip6.as_u64[1] = clib_host_to_net_u64(1);
+        }
+
+        /*
+         * n routes with paths, and, the last prefix, one unreachable
+         */
+        pfxs = NULL;
+        vec_validate(pfxs, n_routes);
+        ii = 0;
+        vec_foreach(pfx, pfxs)
+        {
+            memset(pfx, 0, sizeof(*pfx));
+            pfx->fp_proto = proto;
+
+            if (FIB_PROTOCOL_IP4 == proto)
+            {
+                pfx->fp_len = 24;
+                pfx->fp_addr.ip4.as_u32 =
+                    clib_host_to_net_u32(0x01000000 + (ii << 8));
+            }
+            else
+            {
+                pfx->fp_len = 48;
+                pfx->fp_addr.ip6.as_u64[0] =
+                    clib_host_to_net_u64(0x2002000000000000 +
+                                         ((u64) ii << 16));
+            }
+            ii++;
+        }
+
+        fib_test_mem_load(pfxs, 0, n_routes - 1, rpaths, fib_index);
+        ip_null_dpo_add_and_lock(fib_proto_to_dpo(proto),
+                                 IP_NULL_ACTION_SEND_ICMP_UNREACH,
+                                 &dpo);
+        fib_table_entry_special_dpo_add(fib_index, &pfxs[n_routes],
+                                        FIB_SOURCE_API,
+                                        FIB_ENTRY_FLAG_EXCLUSIVE,
+                                        &dpo);
+        dpo_reset(&dpo);
+
+        error = fib_snapshot_save(FIB_TEST_SNAPSHOT_FILE, &stats);
+        FIB_TEST((NULL == error), "%U: snapshot saved: %U",
+                 format_fib_protocol, proto,
+                 format_clib_error, error);
+        FIB_TEST((stats.fss_n_routes >= n_routes + 1),
+                 "%U: %d routes saved",
+                 format_fib_protocol, proto, stats.fss_n_routes);
+
+        /*
+         * remove the routes and, with its last lock, the table
+         */
+        fib_test_mem_unload(pfxs, fib_index);
+        fib_table_unlock(fib_index, proto, FIB_SOURCE_API);
+        FIB_TEST((~0 == fib_table_find(proto, 14)),
+                 "%U: table removed", format_fib_protocol, proto);
+        FIB_TEST((n_feis == fib_entry_pool_size()), "Entries gone");
+
+        error = fib_snapshot_restore(FIB_TEST_SNAPSHOT_FILE, &stats);
+        FIB_TEST((NULL == error), "%U: snapshot restored: %U",
+                 format_fib_protocol, proto,
+                 format_clib_error, error);
+        fformat(stdout, "%U: restored %d routes in %.3f secs, "
+                "%.2f routes/sec\n",
+                format_fib_protocol, proto, stats.fss_n_routes,
+                stats.fss_time, stats.fss_n_routes / stats.fss_time);
+
+        fib_index = fib_table_find(proto, 14);
+        FIB_TEST((~0 != fib_index),
+                 "%U: table restored", format_fib_protocol, proto);
+        FIB_TEST((n_routes + 1 ==
+                  fib_table_get_num_entries(fib_index, proto,
+                                            FIB_SOURCE_API)),
+                 "%U: %d routes restored",
+                 format_fib_protocol, proto, n_routes + 1);
+
+        fei = fib_table_lookup_exact_match(fib_index, &pfxs[0]);
+        FIB_TEST(fib_entry_is_sourced(fei, FIB_SOURCE_API),
+                 "%U restored", format_fib_prefix, &pfxs[0]);
+        api_rpaths = NULL;
+        fib_entry_encode(fei, &api_rpaths);
+        FIB_TEST((1 == vec_len(api_rpaths) &&
+                  tm->hw[0]->sw_if_index ==
+                  api_rpaths[0].rpath.frp_sw_if_index &&
+                  ip46_address_is_equal(&rpaths[0].frp_addr,
+                                        &api_rpaths[0].rpath.frp_addr)),
+                 "%U restored via the same path",
+                 format_fib_prefix, &pfxs[0]);
+        vec_free(api_rpaths);
+
+        fei = fib_table_lookup_exact_match(fib_index, &pfxs[n_routes]);
+        FIB_TEST((FIB_ENTRY_FLAG_EXCLUSIVE &
+                  fib_entry_get_flags_for_source(fei, FIB_SOURCE_API)),
+                 "%U restored exclusive",
+                 format_fib_prefix, &pfxs[n_routes]);
+        dpo_copy(&dpo, fib_entry_contribute_ip_forwarding(fei));
+        dpo_copy(&dpo, load_balance_get_bucket(dpo.dpoi_index, 0));
+        FIB_TEST((DPO_IP_NULL == dpo.dpoi_type &&
+                  IP_NULL_ACTION_SEND_ICMP_UNREACH ==
+                  ip_null_dpo_get_action(dpo.dpoi_index)),
+                 "%U restored unreachable",
+                 format_fib_prefix, &pfxs[n_routes]);
+        dpo_reset(&dpo);
+
+        /*
+         * restoring again changes nothing
+         */
+        error = fib_snapshot_restore(FIB_TEST_SNAPSHOT_FILE, &stats);
+        FIB_TEST((NULL == error), "%U: snapshot restored again",
+                 format_fib_protocol, proto);
+        FIB_TEST((n_routes + 1 ==
+                  fib_table_get_num_entries(fib_index, proto,
+                                            FIB_SOURCE_API)),
+                 "%U: still %d routes",
+                 format_fib_protocol, proto, n_routes + 1);
+
+        /*
+         * the restore created and locked the table, and its multicast
+         * twin, as the API would
+         */
+        fib_test_mem_unload(pfxs, fib_index);
+        fib_table_unlock(fib_index, proto, FIB_SOURCE_API);
+        FIB_TEST((~0 != mfib_table_find(proto, 14)),
+                 "%U: mfib table restored", format_fib_protocol, proto);
+        mfib_table_unlock(mfib_table_find(proto, 14), proto, MFIB_SOURCE_API);
+        FIB_TEST((~0 == mfib_table_find(proto, 14)),
+                 "%U: mfib table removed", format_fib_protocol, proto);
+        FIB_TEST((n_feis == fib_entry_pool_size()), "Entries gone");
+
+        vec_free(rpaths);
+        vec_free(pfxs);
+        unlink(FIB_TEST_SNAPSHOT_FILE);
+    }
+
+    FIB_TEST(0 == adj_nbr_db_size(), "All adjacencies removed");
+
+    return (res);
+}
+
 static clib_error_t *
 fib_test (vlib_main_t * vm,
           unformat_input_t * input,
           vlib_cli_command_t * cmd_arg)
 {
+    u32 n_routes;
     int res;
 
     res = 0;
+    n_routes = 100000;
 
     fib_test_mk_intf(4);
 
@@ -10176,6 +10807,30 @@ fib_test (vlib_main_t * vm,
     {
         res += fib_test_inherit();
     }
+    else if (unformat (input, "bulk %d", &n_routes) ||
+             unformat (input, "bulk"))
+    {
+        res += fib_test_bulk(n_routes);
+    }
+    else if (unformat (input, "mem %d", &n_routes))
+    {
+        res += fib_test_mem(n_routes);
+    }
+    else if (unformat (input, "mem"))
+    {
+        /*
+         * a full table's worth
+         */
+        res += fib_test_mem(1 << 20);
+    }
+    else if (unformat (input, "snapshot %d", &n_routes))
+    {
+        res += fib_test_snapshot(n_routes);
+    }
+    else if (unformat (input, "snapshot"))
+    {
+        res += fib_test_snapshot(1 << 20);
+    }
     else
     {
         res += fib_test_v4();
@@ -10185,6 +10840,9 @@ fib_test (vlib_main_t * vm,
         res += fib_test_pref();
         res += fib_test_label();
         res += fib_test_inherit();
+        res += fib_test_bulk(10000);
+        res += fib_test_mem(10000);
+        res += fib_test_snapshot(10000);
         res += lfib_test();
 
         /*
@@ -57,6 +57,11 @@ typedef struct fib_walk_t_
      */
     fib_walk_flags_t fw_flags;
 
+    /**
+     * The priority queue an async walk is on
+     */
+    fib_walk_priority_t fw_prio;
+
     /**
      * Sibling index in the dependency list
      */
@@ -102,12 +107,14 @@ typedef enum fib_walk_queue_stats_t_
 {
     FIB_WALK_SCHEDULED,
     FIB_WALK_COMPLETED,
+    FIB_WALK_COALESCED,
 } fib_walk_queue_stats_t;
-#define FIB_WALK_QUEUE_STATS_NUM ((fib_walk_queue_stats_t)(FIB_WALK_COMPLETED+1))
+#define FIB_WALK_QUEUE_STATS_NUM ((fib_walk_queue_stats_t)(FIB_WALK_COALESCED+1))
 
 #define FIB_WALK_QUEUE_STATS {           \
     [FIB_WALK_SCHEDULED] = "scheduled",  \
     [FIB_WALK_COMPLETED] = "completed",  \
+    [FIB_WALK_COALESCED] = "coalesced",  \
 }
 
 #define FOR_EACH_FIB_WALK_QUEUE_STATS(_wqs)   \
@@ -184,6 +191,14 @@ typedef struct fib_walk_history_t_ {
 } fib_walk_history_t;
 static fib_walk_history_t fib_walk_history[HISTORY_N_WALKS];
 
+/**
+ * @brief Convergence statistics, and the start time and number of visits
+ * of the one in progress. A start time of 0 means none is.
+ */
+static fib_walk_convergence_stats_t fib_walk_convergence_stats;
+static f64 fib_walk_convergence_start;
+static u64 fib_walk_convergence_n_visits;
+
 u8*
 format_fib_walk_priority (u8 *s, va_list *ap)
 {
@@ -419,6 +434,14 @@ static f64 fib_walk_sleep_duration[] = {
  */
 static f64 quota = 1e-4;
 
+/**
+ * @brief The number of children visited between checks of the time quota.
+ * Reading the clock for every child is a good part of the cost of
+ * visiting one whose back-walk does little.
+ * Not static so it can be set by the unit tests.
+ */
+u32 fib_walk_batch_size = 32;
+
 /**
  * Histogram on the amount of work done (in msecs) in each walk
  */
@@ -471,13 +494,21 @@ fib_walk_process_queues (vlib_main_t * vm,
 	    fwalk = fib_walk_get(fwi);
 	    fwalk->fw_flags |= FIB_WALK_FLAG_EXECUTING;
 
+	    /*
+	     * the quota is checked only at batch boundaries, when the
+	     * consumed time has just been read.
+	     */
 	    do
 	    {
 		rc = fib_walk_advance(fwi);
 		n_elts++;
-		consumed_time = (vlib_time_now(vm) - start_time);
-	    } while ((consumed_time < quota) &&
-		     (FIB_WALK_ADVANCE_MORE == rc));
+		if (0 == (n_elts % fib_walk_batch_size))
+		{
+		    consumed_time = (vlib_time_now(vm) - start_time);
+		    if (consumed_time >= quota)
+			break;
+		}
+	    } while (FIB_WALK_ADVANCE_MORE == rc);
 
 	    /*
 	     * if this walk has no more work then pop it from the queue
@@ -506,6 +537,7 @@ fib_walk_process_queues (vlib_main_t * vm,
     sleep = FIB_WALK_LONG_SLEEP;
 
 that_will_do_for_now:
+    consumed_time = (vlib_time_now(vm) - start_time);
 
     /*
      * collect the stats:
@@ -525,6 +557,22 @@ that_will_do_for_now:
 
     ++fib_walk_sleep_lengths[sleep];
 
+    /*
+     * the queues are empty, so the convergence in progress is complete
+     */
+    fib_walk_convergence_n_visits += n_elts;
+    if (FIB_WALK_LONG_SLEEP == sleep && 0 != fib_walk_convergence_start)
+    {
+        fib_walk_convergence_stats_t *fwcs = &fib_walk_convergence_stats;
+
+        fwcs->fwcs_last = vlib_time_now(vm) - fib_walk_convergence_start;
+        fwcs->fwcs_max = clib_max(fwcs->fwcs_max, fwcs->fwcs_last);
+        fwcs->fwcs_last_n_visits = fib_walk_convergence_n_visits;
+        fwcs->fwcs_n_convergences++;
+
+        fib_walk_convergence_start = 0;
+    }
+
     return (fib_walk_sleep_duration[sleep]);
 }
 
@@ -655,6 +703,13 @@ fib_walk_prio_queue_enquue (fib_walk_priority_t prio,
 				       FIB_NODE_TYPE_WALK,
 				       fib_walk_get_index(fwalk));
     fib_walk_queues.fwqs_queues[prio].fwq_stats[FIB_WALK_SCHEDULED]++;
+    fwalk->fw_prio = prio;
+
+    if (0 == fib_walk_convergence_start)
+    {
+        fib_walk_convergence_start = vlib_time_now(vlib_get_main());
+        fib_walk_convergence_n_visits = 0;
+    }
 
     /*
      * poke the fib-walk process to perform the async walk.
@@ -669,6 +724,48 @@ fib_walk_prio_queue_enquue (fib_walk_priority_t prio,
     return (sibling);
 }
 
+static fib_node_back_walk_rc_t fib_walk_back_walk_notify(
+    fib_node_t *node,
+    fib_node_back_walk_ctx_t *ctx);
+
+/**
+ * @brief If the walk at the front of the parent's dependency list is
+ * queued at the same priority and has not yet visited a child, there is
+ * no need for another; merge the new walk's context into it.
+ * Many changes to one parent, e.g. a flapping next-hop, then cost the
+ * children one visit.
+ */
+static int
+fib_walk_coalesce (fib_node_type_t parent_type,
+                   fib_node_index_t parent_index,
+                   fib_walk_priority_t prio,
+                   fib_node_back_walk_ctx_t *ctx)
+{
+    fib_node_ptr_t first;
+    fib_walk_t *fwalk;
+
+    if (!fib_node_get_first_child(parent_type, parent_index, &first) ||
+        FIB_NODE_TYPE_WALK != first.fnp_type)
+    {
+        return (0);
+    }
+
+    fwalk = fib_walk_get(first.fnp_index);
+
+    if (!(fwalk->fw_flags & FIB_WALK_FLAG_ASYNC) ||
+        (fwalk->fw_flags & FIB_WALK_FLAG_EXECUTING) ||
+        0 != fwalk->fw_n_visits ||
+        prio != fwalk->fw_prio)
+    {
+        return (0);
+    }
+
+    fib_walk_back_walk_notify(&fwalk->fw_node, ctx);
+    fib_walk_queues.fwqs_queues[prio].fwq_stats[FIB_WALK_COALESCED]++;
+
+    return (1);
+}
+
 void
 fib_walk_async (fib_node_type_t parent_type,
 		fib_node_index_t parent_index,
@@ -701,7 +798,10 @@ fib_walk_async (fib_node_type_t parent_type,
          */
         return (fib_walk_sync(parent_type, parent_index, ctx));
     }
-
+    if (fib_walk_coalesce(parent_type, parent_index, prio, ctx))
+    {
+        return;
+    }
 
     fwalk = fib_walk_alloc(parent_type,
 			   parent_index,
@@ -956,6 +1056,13 @@ fib_walk_show (vlib_main_t * vm,
 
 #define USEC 1000000
     vlib_cli_output(vm, "FIB Walk Quota = %.2fusec:", quota * USEC);
+    vlib_cli_output(vm, "FIB Walk Batch = %d children", fib_walk_batch_size);
+    vlib_cli_output(vm, "FIB Walk Convergence:");
+    vlib_cli_output(vm, "  count:%ld last:%.2fusec max:%.2fusec last-visits:%ld",
+                    fib_walk_convergence_stats.fwcs_n_convergences,
+                    fib_walk_convergence_stats.fwcs_last * USEC,
+                    fib_walk_convergence_stats.fwcs_max * USEC,
+                    fib_walk_convergence_stats.fwcs_last_n_visits);
     vlib_cli_output(vm, "FIB Walk queues:");
 
     FOR_EACH_FIB_WALK_PRIORITY(prio)
@@ -1114,6 +1221,38 @@ VLIB_CLI_COMMAND (fib_walk_set_quota_command, static) = {
     .function = fib_walk_set_quota,
 };
 
+static clib_error_t *
+fib_walk_set_batch (vlib_main_t * vm,
+                    unformat_input_t * input,
+                    vlib_cli_command_t * cmd)
+{
+    clib_error_t * error = NULL;
+    u32 new;
+
+    if (unformat (input, "%d", &new) && 0 != new)
+    {
+	fib_walk_batch_size = new;
+    }
+    else
+    {
+	error = clib_error_return(0 , "Pass a non-zero int value");
+    }
+
+    return (error);
+}
+
+VLIB_CLI_COMMAND (fib_walk_set_batch_command, static) = {
+    .path = "set fib walk batch",
+    .short_help = "set fib walk batch <n-children>",
+    .function = fib_walk_set_batch,
+};
+
+const fib_walk_convergence_stats_t *
+fib_walk_get_convergence_stats (void)
+{
+    return (&fib_walk_convergence_stats);
+}
+
 static clib_error_t *
 fib_walk_set_histogram_elements_size (vlib_main_t * vm,
 				      unformat_input_t * input,
@@ -1150,6 +1289,7 @@ fib_walk_clear (vlib_main_t * vm,
     memset(fib_walk_work_time_taken, 0, sizeof(fib_walk_work_time_taken));
     memset(fib_walk_work_nodes_visited, 0, sizeof(fib_walk_work_nodes_visited));
     memset(fib_walk_sleep_lengths, 0, sizeof(fib_walk_sleep_lengths));
+    memset(&fib_walk_convergence_stats, 0, sizeof(fib_walk_convergence_stats));
 
     return (NULL);
 }
@@ -54,6 +54,33 @@ extern void fib_walk_sync(fib_node_type_t parent_type,
 
 extern u8* format_fib_walk_priority(u8 *s, va_list *ap);
 
+/**
+ * @brief Convergence statistics.
+ * A convergence starts when an async walk is queued while none are
+ * outstanding and ends when the last outstanding walk has visited its
+ * last child.
+ */
+typedef struct fib_walk_convergence_stats_t_
+{
+    /**
+     * Duration, in seconds, of the last and of the longest convergence
+     */
+    f64 fwcs_last;
+    f64 fwcs_max;
+
+    /**
+     * Number of convergences
+     */
+    u64 fwcs_n_convergences;
+
+    /**
+     * Number of children visited during the last convergence
+     */
+    u64 fwcs_last_n_visits;
+} fib_walk_convergence_stats_t;
+
+extern const fib_walk_convergence_stats_t *fib_walk_get_convergence_stats(void);
+
 extern void fib_walk_process_enable(void);
 extern void fib_walk_process_disable(void);
 
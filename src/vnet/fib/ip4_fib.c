@@ -16,6 +16,7 @@
 #include <vnet/fib/fib_table.h>
 #include <vnet/fib/fib_entry.h>
 #include <vnet/fib/ip4_fib.h>
+#include <vnet/ip/ip_flow_cache.h>
 
 /*
  * A table of pefixes to be added to tables and the sources for them
@@ -382,6 +383,7 @@ ip4_fib_table_fwding_dpo_update (ip4_fib_t *fib,
 				 const dpo_id_t *dpo)
 {
     ip4_fib_mtrie_route_add(&fib->mtrie, addr, len, dpo->dpoi_index);
+    ip_flow_cache_invalidate();
 }
 
 void
@@ -408,6 +410,7 @@ ip4_fib_table_fwding_dpo_remove (ip4_fib_t *fib,
                             addr, len, dpo->dpoi_index,
                             cover_prefix.fp_len,
                             cover_dpo->dpoi_index);
+    ip_flow_cache_invalidate();
 }
 
 void
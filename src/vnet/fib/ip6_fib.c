@@ -14,6 +14,7 @@
  */
 
 #include <vnet/fib/ip6_fib.h>
+#include <vnet/ip/ip_flow_cache.h>
 #include <vnet/fib/fib_table.h>
 #include <vnet/dpo/ip6_ll_dpo.h>
 
@@ -161,6 +162,7 @@ ip6_fib_table_destroy (u32 fib_index)
     {
 	hash_unset (ip6_main.fib_index_by_table_id, fib_table->ft_table_id);
     }
+    ip6_fib_table_set_mtrie(fib_table->ft_index, 0);
     pool_put_index(ip6_main.v6_fibs, fib_table->ft_index);
     pool_put(ip6_main.fibs, fib_table);
 }
@@ -361,6 +363,54 @@ ip6_fib_table_fwding_dpo_update (u32 fib_index,
         clib_bitmap_set (table->non_empty_dst_address_length_bitmap, 
 			 128 - len, 1);
     compute_prefix_lengths_in_search_order (table);
+
+    if (NULL != ip6_fib_get(fib_index)->mtrie)
+    {
+        ip6_fib_mtrie_route_add(ip6_fib_get(fib_index)->mtrie,
+                                addr, len, dpo->dpoi_index);
+    }
+    ip_flow_cache_invalidate();
+}
+
+/**
+ * @brief Remove a prefix from the table's mtrie.
+ * The mtrie needs the LB index and length of the covering prefix, so it
+ * can fill the slots the removed prefix occupied.
+ */
+static void
+ip6_fib_mtrie_remove (u32 fib_index,
+                      const ip6_address_t *addr,
+                      u32 len,
+                      const dpo_id_t *dpo)
+{
+    fib_prefix_t pfx = {
+        .fp_proto = FIB_PROTOCOL_IP6,
+        .fp_len = len,
+        .fp_addr = {
+            .ip6 = *addr,
+        },
+    };
+    fib_prefix_t cover_prefix = {
+        .fp_len = 0,
+    };
+    fib_node_index_t cover_index;
+    u32 cover_lbi = 0;
+
+    cover_index = fib_table_get_less_specific(fib_index, &pfx);
+
+    /*
+     * the default route is its own cover, when that goes the slots
+     * return to empty.
+     */
+    if (FIB_NODE_INDEX_INVALID != cover_index && 0 != len)
+    {
+        fib_entry_get_prefix(cover_index, &cover_prefix);
+        cover_lbi = fib_entry_contribute_ip_forwarding(cover_index)->dpoi_index;
+    }
+
+    ip6_fib_mtrie_route_del(ip6_fib_get(fib_index)->mtrie,
+                            addr, len, dpo->dpoi_index,
+                            cover_prefix.fp_len, cover_lbi);
 }
 
 void
@@ -394,6 +444,119 @@ ip6_fib_table_fwding_dpo_remove (u32 fib_index,
                              128 - len, 0);
 	compute_prefix_lengths_in_search_order (table);
     }
+
+    if (NULL != ip6_fib_get(fib_index)->mtrie)
+    {
+        ip6_fib_mtrie_remove(fib_index, addr, len, dpo);
+    }
+    ip_flow_cache_invalidate();
+}
+
+/**
+ * @brief A forwarding entry collected from the shared hash
+ */
+typedef struct ip6_fib_fwding_entry_t_
+{
+    ip6_address_t addr;
+    u32 len;
+    index_t lbi;
+} ip6_fib_fwding_entry_t;
+
+typedef struct ip6_fib_fwding_collect_ctx_t_
+{
+    u32 fib_index;
+    ip6_fib_fwding_entry_t *entries;
+} ip6_fib_fwding_collect_ctx_t;
+
+static void
+ip6_fib_fwding_collect_cb (BVT(clib_bihash_kv) * kvp,
+                           void *arg)
+{
+    ip6_fib_fwding_collect_ctx_t *ctx = arg;
+    ip6_fib_fwding_entry_t *e;
+
+    if ((kvp->key[2] >> 32) != ctx->fib_index)
+        return;
+
+    vec_add2(ctx->entries, e, 1);
+    e->addr.as_u64[0] = kvp->key[0];
+    e->addr.as_u64[1] = kvp->key[1];
+    e->len = kvp->key[2] & 0xFF;
+    e->lbi = kvp->value;
+}
+
+static int
+ip6_fib_fwding_entry_cmp (void *a1, void *a2)
+{
+    ip6_fib_fwding_entry_t *e1 = a1, *e2 = a2;
+
+    return ((int) e1->len - (int) e2->len);
+}
+
+/**
+ * @brief The table's forwarding entries, shortest prefixes first
+ */
+static ip6_fib_fwding_entry_t *
+ip6_fib_table_fwding_entries (u32 fib_index)
+{
+    ip6_fib_fwding_collect_ctx_t ctx = {
+        .fib_index = fib_index,
+    };
+
+    BV(clib_bihash_foreach_key_value_pair)(
+        &ip6_main.ip6_table[IP6_FIB_TABLE_FWDING].ip6_hash,
+        ip6_fib_fwding_collect_cb,
+        &ctx);
+
+    vec_sort_with_function(ctx.entries, ip6_fib_fwding_entry_cmp);
+
+    return (ctx.entries);
+}
+
+static ip6_fib_mtrie_t *
+ip6_fib_mtrie_build (ip6_fib_fwding_entry_t *entries)
+{
+    ip6_fib_fwding_entry_t *e;
+    ip6_fib_mtrie_t *mtrie;
+
+    mtrie = ip6_mtrie_alloc();
+
+    vec_foreach(e, entries)
+    {
+        ip6_fib_mtrie_route_add(mtrie, &e->addr, e->len, e->lbi);
+    }
+
+    return (mtrie);
+}
+
+void
+ip6_fib_table_set_mtrie (u32 fib_index,
+                         int is_enable)
+{
+    ip6_fib_fwding_entry_t *entries;
+    ip6_fib_mtrie_t *mtrie;
+    ip6_fib_t *fib;
+
+    fib = ip6_fib_get(fib_index);
+
+    if (is_enable && NULL == fib->mtrie)
+    {
+        /*
+         * the hash stays populated, so the mtrie is built from its
+         * forwarding entries and the two are kept in step from here on.
+         */
+        entries = ip6_fib_table_fwding_entries(fib_index);
+        mtrie = ip6_fib_mtrie_build(entries);
+        vec_free(entries);
+
+        fib->mtrie = mtrie;
+    }
+    else if (!is_enable && NULL != fib->mtrie)
+    {
+        mtrie = fib->mtrie;
+        fib->mtrie = NULL;
+        ip6_mtrie_free(mtrie);
+    }
 }
 
 /**
@@ -569,6 +732,7 @@ u8 *
 format_ip6_fib_table_memory (u8 * s, va_list * args)
 {
     uword bytes_inuse;
+    ip6_fib_t *fib;
 
     bytes_inuse = 
         ip6_main.ip6_table[IP6_FIB_TABLE_NON_FWDING].ip6_hash.alloc_arena_next
@@ -578,6 +742,12 @@ format_ip6_fib_table_memory (u8 * s, va_list * args)
         ip6_main.ip6_table[IP6_FIB_TABLE_FWDING].ip6_hash.alloc_arena_next
         - ip6_main.ip6_table[IP6_FIB_TABLE_FWDING].ip6_hash.alloc_arena;
 
+    pool_foreach (fib, ip6_main.v6_fibs,
+    ({
+        if (NULL != fib->mtrie)
+            bytes_inuse += ip6_fib_mtrie_memory_usage(fib->mtrie);
+    }));
+
     s = format(s, "%=30s %=6d %=8ld\n",
                "IPv6 unicast",
                pool_elts(ip6_main.fibs),
@@ -662,12 +832,13 @@ ip6_show_fib (vlib_main_t * vm,
         if (fib_table->ft_flags & FIB_TABLE_FLAG_IP6_LL)
             continue;
 
-	s = format(s, "%U, fib_index:%d, flow hash:[%U] locks:[",
+	s = format(s, "%U, fib_index:%d, flow hash:[%U] lookup:%s locks:[",
                    format_fib_table_name, fib->index,
                    FIB_PROTOCOL_IP6,
                    fib->index,
                    format_ip_flow_hash_config,
-                   fib_table->ft_flow_hash_config);
+                   fib_table->ft_flow_hash_config,
+                   (NULL != fib->mtrie ? "mtrie" : "hash"));
 	FOR_EACH_FIB_SOURCE(source)
         {
             if (0 != fib_table->ft_locks[source])
@@ -701,6 +872,9 @@ ip6_show_fib (vlib_main_t * vm,
 		    vlib_cli_output (vm, "%=20d%=16lld", 
 				     len, ca->count_by_prefix_length[len]);
             }
+            if (NULL != fib->mtrie)
+                vlib_cli_output (vm, "mtrie: %U",
+                                 format_ip6_fib_mtrie, fib->mtrie);
 	    continue;
 	}
 
@@ -818,3 +992,257 @@ VLIB_CLI_COMMAND (ip6_show_fib_command, static) = {
     .function = ip6_show_fib,
 };
 /* *INDENT-ON* */
+
+static clib_error_t *
+ip6_fib_set_lookup (vlib_main_t * vm,
+                    unformat_input_t * input,
+                    vlib_cli_command_t * cmd)
+{
+    u32 table_id = 0, fib_index;
+    int is_enable = -1;
+
+    while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+	if (unformat (input, "table %d", &table_id))
+	    ;
+	else if (unformat (input, "mtrie"))
+	    is_enable = 1;
+	else if (unformat (input, "hash"))
+	    is_enable = 0;
+	else
+	    return (clib_error_return (0, "unknown input `%U'",
+                                       format_unformat_error, input));
+    }
+
+    if (-1 == is_enable)
+	return (clib_error_return (0, "specify mtrie or hash"));
+
+    fib_index = ip6_fib_index_from_table_id(table_id);
+
+    if (~0 == fib_index)
+	return (clib_error_return (0, "no such table %d", table_id));
+
+    ip6_fib_table_set_mtrie(fib_index, is_enable);
+
+    return (NULL);
+}
+
+/*?
+ * Choose how forwarding lookups are done in an IPv6 table. By default
+ * all tables share one hash, probed once for each prefix length present.
+ * An mtrie costs at most 15 memory accesses per lookup whatever the
+ * prefix lengths, at the price of more memory; use 'show ip6 fib summary'
+ * and 'test ip6 fib lookup' to compare.
+ *
+ * @cliexpar
+ * @cliexcmd{set ip6 fib-lookup table 0 mtrie}
+ ?*/
+/* *INDENT-OFF* */
+VLIB_CLI_COMMAND (ip6_fib_set_lookup_command, static) = {
+    .path = "set ip6 fib-lookup",
+    .short_help = "set ip6 fib-lookup [table <table-id>] mtrie|hash",
+    .function = ip6_fib_set_lookup,
+};
+/* *INDENT-ON* */
+
+static clib_error_t *
+ip6_fib_test_lookup (vlib_main_t * vm,
+                     unformat_input_t * input,
+                     vlib_cli_command_t * cmd)
+{
+    ip6_fib_fwding_entry_t *entries, *e;
+    ip6_fib_mtrie_t *mtrie, **mtries;
+    u32 table_id = 0, fib_index, seed, n_lookups, batch, i, j;
+    ip6_address_t *dsts, *mask;
+    u32 *ref, *lbis;
+    clib_error_t *error = NULL;
+    ip6_fib_t *fib;
+    uword hash_bytes;
+    u64 t0, dt;
+
+    seed = 0xdeaddabe;
+    n_lookups = 1 << 22;
+    batch = VLIB_FRAME_SIZE;
+
+    while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+	if (unformat (input, "table %d", &table_id))
+	    ;
+	else if (unformat (input, "lookups %d", &n_lookups))
+	    ;
+	else if (unformat (input, "batch %d", &batch))
+	    ;
+	else if (unformat (input, "seed %d", &seed))
+	    ;
+	else
+	    return (clib_error_return (0, "unknown input `%U'",
+                                       format_unformat_error, input));
+    }
+
+    fib_index = ip6_fib_index_from_table_id(table_id);
+
+    if (~0 == fib_index)
+	return (clib_error_return (0, "no such table %d", table_id));
+    if (0 == batch || batch > n_lookups)
+	return (clib_error_return (0, "bad lookups / batch"));
+
+    fib = ip6_fib_get(fib_index);
+    entries = ip6_fib_table_fwding_entries(fib_index);
+
+    /*
+     * compare against a private mtrie, so the table's own lookup is not
+     * switched under the data-plane
+     */
+    mtrie = ip6_fib_mtrie_build(entries);
+
+    /* destinations within random routes, so all the plies are visited */
+    dsts = NULL;
+    ref = lbis = NULL;
+    mtries = NULL;
+    vec_validate(dsts, batch - 1);
+    vec_validate(ref, batch - 1);
+    vec_validate(lbis, batch - 1);
+    vec_validate(mtries, batch - 1);
+
+    for (i = 0; i < batch; i++)
+    {
+        e = vec_elt_at_index(entries, random_u32(&seed) % vec_len(entries));
+        mask = &ip6_main.fib_masks[e->len];
+
+        for (j = 0; j < ARRAY_LEN(dsts[i].as_u32); j++)
+        {
+            dsts[i].as_u32[j] = (e->addr.as_u32[j] |
+                                 (random_u32(&seed) & ~mask->as_u32[j]));
+        }
+        ref[i] = ip6_fib_table_fwding_lookup_hash(&ip6_main, fib_index,
+                                                  &dsts[i]);
+        mtries[i] = mtrie;
+    }
+
+    for (i = 0; i < batch; i++)
+    {
+        if (ip6_fib_mtrie_lookup(mtrie, &dsts[i]) != ref[i])
+        {
+            error = clib_error_return (0, "mtrie lookup of %U disagrees "
+                                       "with hash", format_ip6_address,
+                                       &dsts[i]);
+            goto done;
+        }
+    }
+    ip6_fib_mtrie_lookup_batch(mtries, dsts, lbis, batch);
+    if (memcmp(lbis, ref, batch * sizeof(ref[0])))
+    {
+        error = clib_error_return (0, "batched mtrie lookup disagrees "
+                                   "with hash");
+        goto done;
+    }
+
+    /*
+     * the table's own mtrie, kept in step as routes come and go, must
+     * agree too: check within each route and within its sibling, where
+     * the slots of removed more specifics are refilled from the cover.
+     */
+    if (NULL != fib->mtrie)
+    {
+        vec_foreach(e, entries)
+        {
+            ip6_address_t dst;
+
+            for (i = 0; i < 2; i++)
+            {
+                if (1 == i && 0 == e->len)
+                    break;
+
+                mask = &ip6_main.fib_masks[e->len];
+                for (j = 0; j < ARRAY_LEN(dst.as_u32); j++)
+                {
+                    dst.as_u32[j] = (e->addr.as_u32[j] |
+                                     (random_u32(&seed) & ~mask->as_u32[j]));
+                }
+                if (1 == i)
+                    dst.as_u8[(e->len - 1) / 8] ^= 0x80 >> ((e->len - 1) % 8);
+
+                if (ip6_fib_mtrie_lookup(fib->mtrie, &dst) !=
+                    ip6_fib_table_fwding_lookup_hash(&ip6_main, fib_index,
+                                                     &dst))
+                {
+                    error = clib_error_return (0, "table mtrie lookup of %U "
+                                               "disagrees with hash",
+                                               format_ip6_address, &dst);
+                    goto done;
+                }
+            }
+        }
+    }
+
+    hash_bytes =
+        (ip6_main.ip6_table[IP6_FIB_TABLE_FWDING].ip6_hash.alloc_arena_next -
+         ip6_main.ip6_table[IP6_FIB_TABLE_FWDING].ip6_hash.alloc_arena);
+
+    vlib_cli_output(vm, "%U: %d forwarding entries, lookup:%s",
+                    format_fib_table_name, fib_index, FIB_PROTOCOL_IP6,
+                    vec_len(entries),
+                    (NULL != fib->mtrie ? "mtrie" : "hash"));
+    vlib_cli_output(vm, "hash: %d prefix lengths to probe, "
+                    "memory usage %U (all tables)",
+                    vec_len(ip6_main.ip6_table[IP6_FIB_TABLE_FWDING].
+                            prefix_lengths_in_search_order),
+                    format_memory_size, hash_bytes);
+    vlib_cli_output(vm, "mtrie: %U", format_ip6_fib_mtrie, mtrie);
+
+    vlib_cli_output(vm, "%-14s%12s%12s", "Lookup", "Clocks/addr",
+                    "Mlookups/s");
+
+#define _(_name, _body)                                                 \
+    {                                                                   \
+        t0 = clib_cpu_time_now();                                       \
+        for (i = 0; i + batch <= n_lookups; i += batch)                 \
+        {                                                               \
+            _body;                                                      \
+        }                                                               \
+        dt = clib_cpu_time_now() - t0;                                  \
+        vlib_cli_output(vm, "%-14s%12.2f%12.2f", _name, (f64) dt / i,   \
+                        (f64) i / (dt * vm->clib_time.seconds_per_clock) \
+                        * 1e-6);                                        \
+    }
+    _("hash",
+      for (j = 0; j < batch; j++)
+          lbis[j] = ip6_fib_table_fwding_lookup_hash(&ip6_main, fib_index,
+                                                     &dsts[j]));
+    _("mtrie",
+      for (j = 0; j < batch; j++)
+          lbis[j] = ip6_fib_mtrie_lookup(mtrie, &dsts[j]));
+    _("mtrie-batch",
+      ip6_fib_mtrie_lookup_batch(mtries, dsts, lbis, batch));
+#undef _
+
+done:
+    ip6_mtrie_free(mtrie);
+    vec_free(entries);
+    vec_free(dsts);
+    vec_free(ref);
+    vec_free(lbis);
+    vec_free(mtries);
+
+    return (error);
+}
+
+/*?
+ * Measure the forwarding lookup rate of a table's routes in the shared
+ * hash against an mtrie built from them, one address at a time and in
+ * batches, and show the memory each uses. If the table looks up through
+ * its own mtrie, that is first checked against the hash, within and
+ * beside each route. The destinations are random
+ * addresses within random routes of the table; load it with the table
+ * of interest (e.g. the full IPv6 table) first.
+ *
+ * @cliexpar
+ * @cliexcmd{test ip6 fib lookup table 0 lookups 1000000}
+ ?*/
+/* *INDENT-OFF* */
+VLIB_CLI_COMMAND (ip6_fib_test_lookup_command, static) = {
+    .path = "test ip6 fib lookup",
+    .short_help = "test ip6 fib lookup [table <table-id>] [lookups <n>] [batch <n>] [seed <n>]",
+    .function = ip6_fib_test_lookup,
+};
+/* *INDENT-ON* */
@@ -21,6 +21,7 @@
 #include <vnet/fib/fib_entry.h>
 #include <vnet/fib/fib_table.h>
 #include <vnet/ip/lookup.h>
+#include <vnet/ip/ip6_mtrie.h>
 #include <vnet/dpo/load_balance.h>
 
 extern fib_node_index_t ip6_fib_table_lookup(u32 fib_index,
@@ -63,10 +64,21 @@ extern void ip6_fib_table_walk(u32 fib_index,
                                fib_table_walk_fn_t fn,
                                void *ctx);
 
+/**
+ * @brief Switch a table's forwarding lookups between the shared hash
+ * (probed once per prefix length present) and a per-table mtrie
+ * (a bounded number of ply accesses whatever the prefix lengths).
+ */
+extern void ip6_fib_table_set_mtrie(u32 fib_index,
+                                    int is_enable);
+
+/**
+ * @brief Forwarding lookup in the shared hash, whatever the table uses
+ */
 always_inline u32
-ip6_fib_table_fwding_lookup (ip6_main_t * im,
-                             u32 fib_index,
-                             const ip6_address_t * dst)
+ip6_fib_table_fwding_lookup_hash (ip6_main_t * im,
+                                  u32 fib_index,
+                                  const ip6_address_t * dst)
 {
     ip6_fib_table_instance_t *table;
     int i, len;
@@ -102,6 +114,21 @@ ip6_fib_table_fwding_lookup (ip6_main_t * im,
     return 0;
 }
 
+always_inline u32
+ip6_fib_table_fwding_lookup (ip6_main_t * im,
+                             u32 fib_index,
+                             const ip6_address_t * dst)
+{
+    ip6_fib_mtrie_t *mtrie;
+
+    mtrie = ip6_main.v6_fibs[fib_index].mtrie;
+
+    if (NULL != mtrie)
+        return (ip6_fib_mtrie_lookup(mtrie, dst));
+
+    return (ip6_fib_table_fwding_lookup_hash(im, fib_index, dst));
+}
+
 /**
  * @brief Walk all entries in a sub-tree of the FIB table
  * N.B: This is NOT safe to deletes. If you need to delete walk the whole
@@ -245,7 +245,6 @@ geneve_encap_inline (vlib_main_t * vm,
 	    }
 	  else			/* ipv6 */
 	    {
-	      int bogus = 0;
 
 	      u8 ip6_geneve_base_header_len =
 		sizeof (ip6_header_t) + sizeof (udp_header_t) +
@@ -293,18 +292,8 @@ geneve_encap_inline (vlib_main_t * vm,
 	      udp1->src_port = flow_hash1;
 
 	      /* IPv6 UDP checksum is mandatory */
-	      udp0->checksum = ip6_tcp_udp_icmp_compute_checksum (vm, b0,
-								  ip6_0,
-								  &bogus);
-	      ASSERT (bogus == 0);
-	      if (udp0->checksum == 0)
-		udp0->checksum = 0xffff;
-	      udp1->checksum = ip6_tcp_udp_icmp_compute_checksum (vm, b1,
-								  ip6_1,
-								  &bogus);
-	      ASSERT (bogus == 0);
-	      if (udp1->checksum == 0)
-		udp1->checksum = 0xffff;
+	      ip6_udp_encap_checksum (vm, b0, ip6_0, udp0);
+	      ip6_udp_encap_checksum (vm, b1, ip6_1, udp1);
 	    }
 
 	  pkts_encapsulated += 2;
@@ -449,7 +438,6 @@ geneve_encap_inline (vlib_main_t * vm,
 
 	  else			/* ip6 path */
 	    {
-	      int bogus = 0;
 
 	      u8 ip6_geneve_base_header_len =
 		sizeof (ip6_header_t) + sizeof (udp_header_t) +
@@ -480,12 +468,7 @@ geneve_encap_inline (vlib_main_t * vm,
 	      udp0->src_port = flow_hash0;
 
 	      /* IPv6 UDP checksum is mandatory */
-	      udp0->checksum = ip6_tcp_udp_icmp_compute_checksum (vm, b0,
-								  ip6_0,
-								  &bogus);
-	      ASSERT (bogus == 0);
-	      if (udp0->checksum == 0)
-		udp0->checksum = 0xffff;
+	      ip6_udp_encap_checksum (vm, b0, ip6_0, udp0);
 	    }
 
 	  pkts_encapsulated++;
@@ -0,0 +1,809 @@
+/*
+ * Copyright (c) 2018 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vlib/vlib.h>
+#include <vnet/vnet.h>
+#include <vnet/gro.h>
+#include <vnet/feature/feature.h>
+#include <vnet/ethernet/ethernet.h>
+#include <vnet/ip/ip.h>
+#include <vnet/tcp/tcp_packet.h>
+
+gro_main_t gro_main;
+
+#define foreach_gro_error                               \
+_(SEGMENTS, "segments coalesced into a previous one")   \
+_(PACKETS, "packets sent from held segments")           \
+_(TIMEOUT, "packets sent on timeout")                   \
+_(BAD_CHECKSUM, "segments with bad checksum not coalesced")
+
+typedef enum
+{
+#define _(sym,str) GRO_ERROR_##sym,
+  foreach_gro_error
+#undef _
+    GRO_N_ERROR,
+} gro_error_t;
+
+static char *gro_error_strings[] = {
+#define _(sym,string) string,
+  foreach_gro_error
+#undef _
+};
+
+typedef enum
+{
+  GRO_TRACE_PASSED,
+  GRO_TRACE_HELD,
+  GRO_TRACE_COALESCED,
+} gro_trace_action_t;
+
+typedef struct
+{
+  u32 sw_if_index;
+  u32 action;
+  u32 n_segs;
+} gro_trace_t;
+
+static u8 *
+format_gro_trace (u8 * s, va_list * args)
+{
+  CLIB_UNUSED (vlib_main_t * vm) = va_arg (*args, vlib_main_t *);
+  CLIB_UNUSED (vlib_node_t * node) = va_arg (*args, vlib_node_t *);
+  gro_trace_t *t = va_arg (*args, gro_trace_t *);
+
+  s = format (s, "sw_if_index %d ", t->sw_if_index);
+  switch (t->action)
+    {
+    case GRO_TRACE_PASSED:
+      s = format (s, "passed");
+      break;
+    case GRO_TRACE_HELD:
+      s = format (s, "held as first segment");
+      break;
+    case GRO_TRACE_COALESCED:
+      s = format (s, "coalesced as segment %d", t->n_segs);
+      break;
+    }
+  return s;
+}
+
+/*
+ * Find the TCP segment in a frame received on an ethernet interface
+ * and fill in its flow key and offsets. Only unfragmented TCP over
+ * untagged IPv4 (without options) or IPv6 (without extension headers)
+ * in a single buffer is coalesced.
+ */
+static_always_inline int
+gro_parse (vlib_buffer_t * b, gro_flow_key_t * key, u8 * is_ip6,
+	   tcp_header_t ** th, u16 * payload_len)
+{
+  ethernet_header_t *eth = vlib_buffer_get_current (b);
+  u16 l3_hdr_sz, l3_len, tcp_hdr_sz;
+
+  if (b->flags & (VLIB_BUFFER_NEXT_PRESENT | VNET_BUFFER_F_GSO))
+    return 0;
+
+  if (b->current_length < sizeof (ethernet_header_t) +
+      sizeof (ip6_header_t) + sizeof (tcp_header_t))
+    return 0;
+
+  if (eth->type == clib_host_to_net_u16 (ETHERNET_TYPE_IP4))
+    {
+      ip4_header_t *ip4 = (ip4_header_t *) (eth + 1);
+
+      if (ip4->ip_version_and_header_length != 0x45 ||
+	  ip4->protocol != IP_PROTOCOL_TCP || ip4_is_fragment (ip4))
+	return 0;
+      l3_hdr_sz = sizeof (ip4_header_t);
+      l3_len = clib_net_to_host_u16 (ip4->length);
+      ip46_address_set_ip4 (&key->src_address, &ip4->src_address);
+      ip46_address_set_ip4 (&key->dst_address, &ip4->dst_address);
+      *is_ip6 = 0;
+    }
+  else if (eth->type == clib_host_to_net_u16 (ETHERNET_TYPE_IP6))
+    {
+      ip6_header_t *ip6 = (ip6_header_t *) (eth + 1);
+
+      if (ip6->protocol != IP_PROTOCOL_TCP)
+	return 0;
+      l3_hdr_sz = sizeof (ip6_header_t);
+      l3_len = clib_net_to_host_u16 (ip6->payload_length) + l3_hdr_sz;
+      key->src_address.ip6 = ip6->src_address;
+      key->dst_address.ip6 = ip6->dst_address;
+      *is_ip6 = 1;
+    }
+  else
+    return 0;
+
+  *th = (tcp_header_t *) ((u8 *) (eth + 1) + l3_hdr_sz);
+  tcp_hdr_sz = tcp_header_bytes (*th);
+  if (tcp_hdr_sz < sizeof (tcp_header_t) ||
+      l3_len < l3_hdr_sz + tcp_hdr_sz ||
+      sizeof (ethernet_header_t) + l3_len > b->current_length)
+    return 0;
+
+  *payload_len = l3_len - l3_hdr_sz - tcp_hdr_sz;
+  key->sw_if_index = vnet_buffer (b)->sw_if_index[VLIB_RX];
+  key->src_port = (*th)->src_port;
+  key->dst_port = (*th)->dst_port;
+
+  vnet_buffer (b)->l3_hdr_offset = b->current_data +
+    sizeof (ethernet_header_t);
+  vnet_buffer (b)->l4_hdr_offset = vnet_buffer (b)->l3_hdr_offset +
+    l3_hdr_sz;
+  b->flags |= (VNET_BUFFER_F_L3_HDR_OFFSET_VALID |
+	       VNET_BUFFER_F_L4_HDR_OFFSET_VALID |
+	       (*is_ip6 ? VNET_BUFFER_F_IS_IP6 : VNET_BUFFER_F_IS_IP4));
+
+  return 1;
+}
+
+/*
+ * The IP header of a coalesced packet is rewritten and its TCP checksum
+ * left to the output, so only segments known to be intact can be
+ * coalesced. A checksum computed here is kept on the buffer, sparing
+ * ip4/6-local from doing it again.
+ */
+static_always_inline int
+gro_checksums_ok (vlib_main_t * vm, vlib_buffer_t * b, u8 is_ip6)
+{
+  i16 l3_adv;
+
+  if (!is_ip6 && !ip4_header_checksum_is_valid ((ip4_header_t *)
+						(b->data +
+						 vnet_buffer (b)->
+						 l3_hdr_offset)))
+    return 0;
+
+  if (b->flags & VNET_BUFFER_F_OFFLOAD_TCP_CKSUM)
+    return 1;
+
+  if (!(b->flags & VNET_BUFFER_F_L4_CHECKSUM_COMPUTED))
+    {
+      l3_adv = vnet_buffer (b)->l3_hdr_offset - b->current_data;
+      vlib_buffer_advance (b, l3_adv);
+      if (is_ip6)
+	ip6_tcp_udp_icmp_validate_checksum (vm, b);
+      else
+	ip4_tcp_udp_validate_checksum (vm, b);
+      vlib_buffer_advance (b, -l3_adv);
+      ip_sw_csum_count (vm, IP_SW_CSUM_GRO, 1);
+    }
+
+  return (b->flags & VNET_BUFFER_F_L4_CHECKSUM_CORRECT) != 0;
+}
+
+static_always_inline gro_flow_t *
+gro_flow_find (gro_per_thread_data_t * ptd, gro_flow_key_t * key, u8 is_ip6)
+{
+  gro_flow_t *f;
+  u32 i;
+
+  for (i = 0; i < ptd->n_flows; i++)
+    {
+      f = &ptd->flows[i];
+      if (f->key.as_u64[0] == key->as_u64[0] &&
+	  f->key.as_u64[1] == key->as_u64[1] &&
+	  f->key.as_u64[2] == key->as_u64[2] &&
+	  f->key.as_u64[3] == key->as_u64[3] &&
+	  f->key.as_u64[4] == key->as_u64[4] && f->is_ip6 == is_ip6)
+	return f;
+    }
+  return 0;
+}
+
+/*
+ * Whether a segment continues the packet being coalesced: the next in
+ * sequence, no bigger than the first, with nothing but ACK/PSH set and
+ * the same IP and TCP headers otherwise.
+ */
+static_always_inline int
+gro_flow_can_coalesce (gro_flow_t * f, vlib_buffer_t * h, vlib_buffer_t * b,
+		       tcp_header_t * th, u16 payload_len)
+{
+  tcp_header_t *h_th = (tcp_header_t *) (h->data +
+					 vnet_buffer (h)->l4_hdr_offset);
+
+  if (th->seq_number != clib_host_to_net_u32 (f->next_seq) ||
+      payload_len == 0 || payload_len > f->gso_size ||
+      (th->flags & ~TCP_FLAG_PSH) != TCP_FLAG_ACK ||
+      th->ack_number != h_th->ack_number ||
+      th->window != h_th->window ||
+      th->data_offset_and_reserved != h_th->data_offset_and_reserved ||
+      th->urgent_pointer != h_th->urgent_pointer)
+    return 0;
+
+  if (f->n_segs >= GRO_MAX_SEGMENTS || f->l3_len + payload_len > 0xffff)
+    return 0;
+
+  if (memcmp (th + 1, h_th + 1, tcp_header_bytes (th) -
+	      sizeof (tcp_header_t)))
+    return 0;
+
+  if (f->is_ip6)
+    {
+      ip6_header_t *ip6 = (ip6_header_t *) (b->data +
+					    vnet_buffer (b)->l3_hdr_offset);
+      ip6_header_t *h_ip6 = (ip6_header_t *) (h->data +
+					      vnet_buffer (h)->l3_hdr_offset);
+      return (ip6->ip_version_traffic_class_and_flow_label ==
+	      h_ip6->ip_version_traffic_class_and_flow_label &&
+	      ip6->hop_limit == h_ip6->hop_limit);
+    }
+  else
+    {
+      ip4_header_t *ip4 = (ip4_header_t *) (b->data +
+					    vnet_buffer (b)->l3_hdr_offset);
+      ip4_header_t *h_ip4 = (ip4_header_t *) (h->data +
+					      vnet_buffer (h)->l3_hdr_offset);
+      return (ip4->tos == h_ip4->tos && ip4->ttl == h_ip4->ttl &&
+	      ip4->flags_and_fragment_offset ==
+	      h_ip4->flags_and_fragment_offset);
+    }
+}
+
+static_always_inline void
+gro_flow_coalesce (vlib_main_t * vm, gro_flow_t * f, vlib_buffer_t * h,
+		   u32 bi, vlib_buffer_t * b, tcp_header_t * th,
+		   u16 payload_len)
+{
+  vlib_buffer_t *tail = vlib_get_buffer (vm, f->tail_bi);
+
+  /* keep the payload only, dropping any ethernet padding */
+  vlib_buffer_advance (b, vnet_buffer (b)->l4_hdr_offset +
+		       tcp_header_bytes (th) - b->current_data);
+  b->current_length = payload_len;
+
+  tail->next_buffer = bi;
+  tail->flags |= VLIB_BUFFER_NEXT_PRESENT;
+  h->total_length_not_including_first_buffer += payload_len;
+  f->tail_bi = bi;
+
+  if (tcp_psh (th))
+    ((tcp_header_t *) (h->data + vnet_buffer (h)->l4_hdr_offset))->flags |=
+      TCP_FLAG_PSH;
+
+  f->next_seq += payload_len;
+  f->l3_len += payload_len;
+  f->n_segs++;
+}
+
+static_always_inline gro_flow_t *
+gro_flow_start (vlib_buffer_t * b, gro_per_thread_data_t * ptd,
+		gro_flow_key_t * key, u8 is_ip6, u32 bi, u32 next_index,
+		tcp_header_t * th, u16 payload_len, f64 now)
+{
+  gro_flow_t *f = &ptd->flows[ptd->n_flows++];
+
+  f->key = *key;
+  f->is_ip6 = is_ip6;
+  f->n_segs = 1;
+  f->gso_size = payload_len;
+  f->l3_len = vnet_buffer (b)->l4_hdr_offset - vnet_buffer (b)->l3_hdr_offset
+    + tcp_header_bytes (th) + payload_len;
+  f->next_seq = clib_net_to_host_u32 (th->seq_number) + payload_len;
+  f->head_bi = f->tail_bi = bi;
+  f->next_index = next_index;
+  f->start_time = now;
+
+  /* segments get appended right after the payload */
+  b->current_length = vnet_buffer (b)->l3_hdr_offset - b->current_data +
+    f->l3_len;
+  b->total_length_not_including_first_buffer = 0;
+  b->flags |= VLIB_BUFFER_TOTAL_LENGTH_VALID;
+
+  return f;
+}
+
+/*
+ * Finish the packet of a flow, fixing up its headers if segments were
+ * coalesced into it, and queue it to its next node.
+ */
+static_always_inline void
+gro_flow_flush (vlib_main_t * vm, gro_per_thread_data_t * ptd, u32 flow_index,
+		u32 * to, u16 * nexts, u32 * n_out, f64 now)
+{
+  gro_flow_t *f = &ptd->flows[flow_index];
+  vlib_buffer_t *h = vlib_get_buffer (vm, f->head_bi);
+  tcp_header_t *th;
+
+  if (f->n_segs > 1)
+    {
+      th = (tcp_header_t *) (h->data + vnet_buffer (h)->l4_hdr_offset);
+      if (f->is_ip6)
+	{
+	  ip6_header_t *ip6 = (ip6_header_t *) (h->data +
+						vnet_buffer (h)->
+						l3_hdr_offset);
+	  ip6->payload_length =
+	    clib_host_to_net_u16 (f->l3_len - sizeof (ip6_header_t));
+	}
+      else
+	{
+	  ip4_header_t *ip4 = (ip4_header_t *) (h->data +
+						vnet_buffer (h)->
+						l3_hdr_offset);
+	  ip4->length = clib_host_to_net_u16 (f->l3_len);
+	  ip4->checksum = ip4_header_checksum (ip4);
+	}
+      th->checksum = 0;
+      vnet_buffer2 (h)->gso_size = f->gso_size;
+      vnet_buffer2 (h)->gso_l4_hdr_sz = tcp_header_bytes (th);
+      h->flags |= VNET_BUFFER_F_GSO | VNET_BUFFER_F_OFFLOAD_TCP_CKSUM;
+    }
+
+  to[*n_out] = f->head_bi;
+  nexts[*n_out] = f->next_index;
+  *n_out += 1;
+
+  ptd->n_packets_out++;
+  if (now - f->start_time > ptd->max_hold_time)
+    ptd->max_hold_time = now - f->start_time;
+
+  /* keep the flows packed */
+  ptd->n_flows--;
+  if (flow_index != ptd->n_flows)
+    *f = ptd->flows[ptd->n_flows];
+}
+
+/* Flush the flows held longer than the timeout, or all of them */
+static_always_inline u32
+gro_flush_expired (vlib_main_t * vm, gro_per_thread_data_t * ptd,
+		   u32 * to, u16 * nexts, u32 * n_out, f64 now, int all)
+{
+  gro_main_t *gm = &gro_main;
+  u32 n_flushed = 0;
+  int i;
+
+  for (i = ptd->n_flows - 1; i >= 0; i--)
+    if (all || now - ptd->flows[i].start_time >= gm->timeout)
+      {
+	gro_flow_flush (vm, ptd, i, to, nexts, n_out, now);
+	n_flushed++;
+      }
+  return n_flushed;
+}
+
+/* Flush the flow held the longest, to make room for a new one */
+static_always_inline void
+gro_flush_oldest (vlib_main_t * vm, gro_per_thread_data_t * ptd,
+		  u32 * to, u16 * nexts, u32 * n_out, f64 now)
+{
+  u32 i, oldest = 0;
+
+  for (i = 1; i < ptd->n_flows; i++)
+    if (ptd->flows[i].start_time < ptd->flows[oldest].start_time)
+      oldest = i;
+  gro_flow_flush (vm, ptd, oldest, to, nexts, n_out, now);
+}
+
+static uword
+gro_node_fn (vlib_main_t * vm, vlib_node_runtime_t * node,
+	     vlib_frame_t * frame)
+{
+  gro_main_t *gm = &gro_main;
+  gro_per_thread_data_t *ptd = vec_elt_at_index (gm->per_thread_data,
+						 vm->thread_index);
+  u32 to[VLIB_FRAME_SIZE + GRO_MAX_FLOWS];
+  /* vlib_buffer_enqueue_to_next () reads ahead */
+  u16 nexts[VLIB_FRAME_SIZE + GRO_MAX_FLOWS + 32];
+  u32 n_left, *from, n_out = 0;
+  u32 n_coalesced = 0, n_bad_checksum = 0, n_packets_out;
+  f64 now = vlib_time_now (vm);
+
+  from = vlib_frame_vector_args (frame);
+  n_left = frame->n_vectors;
+  n_packets_out = ptd->n_packets_out;
+
+  while (n_left > 0)
+    {
+      u32 bi0 = from[0];
+      vlib_buffer_t *b0 = vlib_get_buffer (vm, bi0);
+      u32 next0, action0 = GRO_TRACE_PASSED, n_segs0 = 1;
+      gro_flow_key_t key0;
+      gro_flow_t *f0 = 0;
+      tcp_header_t *th0;
+      u16 payload_len0;
+      u8 is_ip6;
+
+      if (n_left > 1)
+	vlib_prefetch_buffer_with_index (vm, from[1], LOAD);
+
+      vnet_feature_next (vnet_buffer (b0)->sw_if_index[VLIB_RX], &next0, b0);
+
+      if (!gro_parse (b0, &key0, &is_ip6, &th0, &payload_len0))
+	goto pass;
+
+      f0 = gro_flow_find (ptd, &key0, is_ip6);
+
+      if (f0)
+	{
+	  vlib_buffer_t *h0 = vlib_get_buffer (vm, f0->head_bi);
+
+	  if (gro_flow_can_coalesce (f0, h0, b0, th0, payload_len0))
+	    {
+	      if (PREDICT_FALSE (!gro_checksums_ok (vm, b0, is_ip6)))
+		{
+		  n_bad_checksum++;
+		  goto flush_and_pass;
+		}
+	      gro_flow_coalesce (vm, f0, h0, bi0, b0, th0, payload_len0);
+	      ptd->n_segments_in++;
+	      n_coalesced++;
+	      action0 = GRO_TRACE_COALESCED;
+	      n_segs0 = f0->n_segs;
+
+	      /* a short or pushed segment ends the packet */
+	      if (payload_len0 < f0->gso_size || tcp_psh (th0))
+		gro_flow_flush (vm, ptd, f0 - ptd->flows, to, nexts, &n_out,
+				now);
+	      goto trace;
+	    }
+	  gro_flow_flush (vm, ptd, f0 - ptd->flows, to, nexts, &n_out, now);
+	}
+
+      /* only a full, pure ACK segment is worth holding */
+      if (th0->flags != TCP_FLAG_ACK || payload_len0 == 0)
+	goto pass;
+
+      if (PREDICT_FALSE (!gro_checksums_ok (vm, b0, is_ip6)))
+	{
+	  n_bad_checksum++;
+	  goto pass;
+	}
+
+      if (ptd->n_flows >= gm->max_flows)
+	gro_flush_oldest (vm, ptd, to, nexts, &n_out, now);
+
+      f0 = gro_flow_start (b0, ptd, &key0, is_ip6, bi0, next0, th0,
+			   payload_len0, now);
+      ptd->n_segments_in++;
+      action0 = GRO_TRACE_HELD;
+      goto trace;
+
+    flush_and_pass:
+      gro_flow_flush (vm, ptd, f0 - ptd->flows, to, nexts, &n_out, now);
+
+    pass:
+      to[n_out] = bi0;
+      nexts[n_out] = next0;
+      n_out++;
+
+    trace:
+      if (PREDICT_FALSE (b0->flags & VLIB_BUFFER_IS_TRACED))
+	{
+	  gro_trace_t *t = vlib_add_trace (vm, node, b0, sizeof (*t));
+	  t->sw_if_index = vnet_buffer (b0)->sw_if_index[VLIB_RX];
+	  t->action = action0;
+	  t->n_segs = n_segs0;
+	}
+
+      from += 1;
+      n_left -= 1;
+    }
+
+  if (ptd->n_flows)
+    {
+      u32 n_timeout;
+
+      n_timeout = gro_flush_expired (vm, ptd, to, nexts, &n_out, now,
+				     gm->timeout == 0);
+      if (gm->timeout != 0)
+	{
+	  ptd->n_timeout_flushes += n_timeout;
+	  vlib_node_increment_counter (vm, node->node_index,
+				       GRO_ERROR_TIMEOUT, n_timeout);
+	}
+
+      /* let the flush node wake up to send what is still held */
+      if (ptd->n_flows &&
+	  vlib_node_get_state (vm, gm->gro_flush_node_index) !=
+	  VLIB_NODE_STATE_POLLING)
+	vlib_node_set_state (vm, gm->gro_flush_node_index,
+			     VLIB_NODE_STATE_POLLING);
+    }
+
+  if (n_out)
+    vlib_buffer_enqueue_to_next (vm, node, to, nexts, n_out);
+
+  vlib_node_increment_counter (vm, node->node_index, GRO_ERROR_SEGMENTS,
+			       n_coalesced);
+  vlib_node_increment_counter (vm, node->node_index, GRO_ERROR_PACKETS,
+			       ptd->n_packets_out - n_packets_out);
+  vlib_node_increment_counter (vm, node->node_index, GRO_ERROR_BAD_CHECKSUM,
+			       n_bad_checksum);
+
+  return frame->n_vectors;
+}
+
+/* *INDENT-OFF* */
+VLIB_REGISTER_NODE (gro_node) =
+{
+  .function = gro_node_fn,
+  .name = "gro",
+  .vector_size = sizeof (u32),
+  .format_trace = format_gro_trace,
+  .type = VLIB_NODE_TYPE_INTERNAL,
+  .n_errors = GRO_N_ERROR,
+  .error_strings = gro_error_strings,
+};
+
+VLIB_NODE_FUNCTION_MULTIARCH (gro_node, gro_node_fn);
+
+VNET_FEATURE_INIT (gro_node_feature, static) =
+{
+  .arc_name = "device-input",
+  .node_name = "gro",
+  .runs_before = VNET_FEATURES ("ethernet-input"),
+};
+/* *INDENT-ON* */
+
+/*
+ * Sends the packets held by the gro node once their timeout expires. It
+ * polls only while the thread holds any, and shares the next nodes of
+ * the gro node so that the flows' next indices are valid here too.
+ */
+static uword
+gro_flush_node_fn (vlib_main_t * vm, vlib_node_runtime_t * node,
+		   vlib_frame_t * frame)
+{
+  gro_main_t *gm = &gro_main;
+  gro_per_thread_data_t *ptd = vec_elt_at_index (gm->per_thread_data,
+						 vm->thread_index);
+  u32 to[GRO_MAX_FLOWS];
+  u16 nexts[GRO_MAX_FLOWS + 32];
+  u32 n_out = 0, n_timeout;
+  f64 now = vlib_time_now (vm);
+
+  n_timeout = gro_flush_expired (vm, ptd, to, nexts, &n_out, now,
+				 gm->timeout == 0);
+  ptd->n_timeout_flushes += n_timeout;
+
+  if (n_out)
+    {
+      vlib_buffer_enqueue_to_next (vm, node, to, nexts, n_out);
+      vlib_node_increment_counter (vm, gro_node.index, GRO_ERROR_TIMEOUT,
+				   n_timeout);
+      vlib_node_increment_counter (vm, gro_node.index, GRO_ERROR_PACKETS,
+				   n_out);
+    }
+
+  if (ptd->n_flows == 0)
+    vlib_node_set_state (vm, node->node_index, VLIB_NODE_STATE_DISABLED);
+
+  return n_out;
+}
+
+/* *INDENT-OFF* */
+VLIB_REGISTER_NODE (gro_flush_node) =
+{
+  .function = gro_flush_node_fn,
+  .name = "gro-flush",
+  .type = VLIB_NODE_TYPE_INPUT,
+  .state = VLIB_NODE_STATE_DISABLED,
+  .sibling_of = "gro",
+};
+/* *INDENT-ON* */
+
+int
+vnet_gro_enable_disable (u32 sw_if_index, u8 enable)
+{
+  vnet_main_t *vnm = vnet_get_main ();
+  vnet_sw_interface_t *si;
+
+  if (pool_is_free_index (vnm->interface_main.sw_interfaces, sw_if_index))
+    return VNET_API_ERROR_INVALID_SW_IF_INDEX;
+
+  si = vnet_get_sw_interface (vnm, sw_if_index);
+
+  /* the device-input arc only runs on hardware interfaces */
+  if (si->type != VNET_SW_INTERFACE_TYPE_HARDWARE ||
+      !ethernet_get_interface (&ethernet_main, si->hw_if_index))
+    return VNET_API_ERROR_INVALID_VALUE;
+
+  return vnet_feature_enable_disable ("device-input", "gro", sw_if_index,
+				      enable, 0, 0);
+}
+
+int
+vnet_gro_set_config (u32 max_flows, u32 timeout_us)
+{
+  gro_main_t *gm = &gro_main;
+
+  if (max_flows == 0 || max_flows > GRO_MAX_FLOWS)
+    return VNET_API_ERROR_INVALID_VALUE;
+
+  /* Threads holding more flows drain them as they expire */
+  gm->max_flows = max_flows;
+  gm->timeout = timeout_us * 1e-6;
+  return 0;
+}
+
+static clib_error_t *
+set_interface_gro_command_fn (vlib_main_t * vm, unformat_input_t * input,
+			      vlib_cli_command_t * cmd)
+{
+  vnet_main_t *vnm = vnet_get_main ();
+  u32 sw_if_index = ~0;
+  u8 enable = 1;
+  int rv;
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "%U", unformat_vnet_sw_interface, vnm,
+		    &sw_if_index))
+	;
+      else if (unformat (input, "disable"))
+	enable = 0;
+      else
+	return clib_error_return (0, "unknown input `%U'",
+				  format_unformat_error, input);
+    }
+
+  if (sw_if_index == ~0)
+    return clib_error_return (0, "interface required");
+
+  rv = vnet_gro_enable_disable (sw_if_index, enable);
+  if (rv == VNET_API_ERROR_INVALID_VALUE)
+    return clib_error_return (0, "GRO is supported on ethernet "
+			      "interfaces only");
+  else if (rv)
+    return clib_error_return (0, "vnet_gro_enable_disable returned %d",
+			      rv);
+  return 0;
+}
+
+/*?
+ * Coalesce in-order TCP segments received on an interface into larger
+ * packets before they are processed further, which mostly benefits
+ * traffic terminated locally. Meant for virtual interfaces (af_packet,
+ * tap, vhost-user) which deliver one MTU sized packet at a time.
+ *
+ * @cliexpar
+ * @cliexcmd{set interface gro host-vpp0}
+ * @cliexcmd{set interface gro host-vpp0 disable}
+?*/
+/* *INDENT-OFF* */
+VLIB_CLI_COMMAND (set_interface_gro_command, static) =
+{
+  .path = "set interface gro",
+  .short_help = "set interface gro <interface> [disable]",
+  .function = set_interface_gro_command_fn,
+};
+/* *INDENT-ON* */
+
+static clib_error_t *
+set_gro_command_fn (vlib_main_t * vm, unformat_input_t * input,
+		    vlib_cli_command_t * cmd)
+{
+  gro_main_t *gm = &gro_main;
+  u32 max_flows = gm->max_flows;
+  u32 timeout_us = gm->timeout * 1e6;
+  int rv;
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "flows %u", &max_flows))
+	;
+      else if (unformat (input, "timeout %u", &timeout_us))
+	;
+      else
+	return clib_error_return (0, "unknown input `%U'",
+				  format_unformat_error, input);
+    }
+
+  rv = vnet_gro_set_config (max_flows, timeout_us);
+  if (rv)
+    return clib_error_return (0, "flows must be between 1 and %d",
+			      GRO_MAX_FLOWS);
+  return 0;
+}
+
+/*?
+ * Configure GRO. <b>flows</b> is how many flows each thread coalesces
+ * at once, the one held the longest is sent when another one starts.
+ * <b>timeout</b>, in microseconds, is how long a flow may be held
+ * waiting for more segments once the frame it started in is processed;
+ * this bounds the latency GRO adds. It is 0 by default, only segments
+ * received together are coalesced.
+ *
+ * @cliexpar
+ * @cliexcmd{set gro flows 32 timeout 50}
+?*/
+/* *INDENT-OFF* */
+VLIB_CLI_COMMAND (set_gro_command, static) =
+{
+  .path = "set gro",
+  .short_help = "set gro [flows <n>] [timeout <usec>]",
+  .function = set_gro_command_fn,
+};
+/* *INDENT-ON* */
+
+static clib_error_t *
+show_gro_command_fn (vlib_main_t * vm, unformat_input_t * input,
+		     vlib_cli_command_t * cmd)
+{
+  gro_main_t *gm = &gro_main;
+  gro_per_thread_data_t *ptd;
+  u64 n_in = 0, n_out = 0, n_timeout = 0;
+  f64 max_hold_time = 0;
+  u32 n_flows = 0;
+
+  vec_foreach (ptd, gm->per_thread_data)
+  {
+    n_in += ptd->n_segments_in;
+    n_out += ptd->n_packets_out;
+    n_timeout += ptd->n_timeout_flushes;
+    n_flows += ptd->n_flows;
+    if (ptd->max_hold_time > max_hold_time)
+      max_hold_time = ptd->max_hold_time;
+  }
+
+  vlib_cli_output (vm, "flows per thread %u, timeout %.0f us",
+		   gm->max_flows, gm->timeout * 1e6);
+  vlib_cli_output (vm, "segments %llu, packets %llu, ratio %.2f",
+		   n_in, n_out, n_out ? (f64) n_in / n_out : 0.0);
+  vlib_cli_output (vm, "sent on timeout %llu, flows held %u, "
+		   "max hold time %.2f us", n_timeout, n_flows,
+		   max_hold_time * 1e6);
+  return 0;
+}
+
+/*?
+ * Show the GRO configuration and statistics: the TCP segments taken
+ * in, the packets sent in their place and the resulting coalescing
+ * ratio, and the longest time a segment was held.
+ *
+ * @cliexpar
+ * @cliexstart{show gro}
+ * flows per thread 16, timeout 0 us
+ * segments 20480, packets 1393, ratio 14.70
+ * sent on timeout 0, flows held 0, max hold time 3.42 us
+ * @cliexend
+?*/
+/* *INDENT-OFF* */
+VLIB_CLI_COMMAND (show_gro_command, static) =
+{
+  .path = "show gro",
+  .short_help = "show gro",
+  .function = show_gro_command_fn,
+};
+/* *INDENT-ON* */
+
+static clib_error_t *
+gro_init (vlib_main_t * vm)
+{
+  gro_main_t *gm = &gro_main;
+  vlib_thread_main_t *tm = vlib_get_thread_main ();
+
+  gm->max_flows = GRO_DEFAULT_FLOWS;
+  gm->timeout = 0;
+  gm->gro_flush_node_index = gro_flush_node.index;
+  vec_validate_aligned (gm->per_thread_data, tm->n_vlib_mains - 1,
+			CLIB_CACHE_LINE_BYTES);
+
+  return 0;
+}
+
+VLIB_INIT_FUNCTION (gro_init);
+
+/*
+ * fd.io coding-style-patch-verification: ON
+ *
+ * Local Variables:
+ * eval: (c-set-style "gnu")
+ * End:
+ */
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2018 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file
+ * @brief Generic receive offload.
+ *
+ * The "gro" device-input feature coalesces in-order TCP segments of a
+ * flow into one chained packet, flagged as GSO so that it is segmented
+ * again should it leave through an interface which does not support
+ * GSO. Segments are coalesced within a frame and, if a timeout is
+ * configured, held across frames for at most that long.
+ */
+
+#ifndef __included_vnet_gro_h__
+#define __included_vnet_gro_h__
+
+#include <vnet/vnet.h>
+#include <vnet/ip/ip6_packet.h>
+
+/** Upper bound of the number of flows held per thread */
+#define GRO_MAX_FLOWS 64
+#define GRO_DEFAULT_FLOWS 16
+/** Most segments coalesced into one packet */
+#define GRO_MAX_SEGMENTS 64
+
+typedef struct
+{
+  union
+  {
+    struct
+    {
+      ip46_address_t src_address;
+      ip46_address_t dst_address;
+      u32 sw_if_index;
+      u16 src_port;
+      u16 dst_port;
+    };
+    u64 as_u64[5];
+  };
+} gro_flow_key_t;
+
+typedef struct
+{
+  gro_flow_key_t key;
+  u8 is_ip6;
+  /** Segments coalesced so far */
+  u16 n_segs;
+  /** Payload size of the first segment, all but the last are that big */
+  u16 gso_size;
+  /** IP length of the coalesced packet */
+  u32 l3_len;
+  /** TCP sequence number expected next, host byte order */
+  u32 next_seq;
+  u32 head_bi;
+  u32 tail_bi;
+  /** Next node of the coalesced packet */
+  u32 next_index;
+  f64 start_time;
+} gro_flow_t;
+
+typedef struct
+{
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
+  /** Flows being coalesced, n_flows of them */
+  gro_flow_t flows[GRO_MAX_FLOWS];
+  u32 n_flows;
+
+  /* Statistics */
+  u64 n_segments_in;
+  u64 n_packets_out;
+  u64 n_timeout_flushes;
+  f64 max_hold_time;
+} gro_per_thread_data_t;
+
+typedef struct
+{
+  gro_per_thread_data_t *per_thread_data;
+
+  /** Flows held per thread */
+  u32 max_flows;
+
+  /** How long a flow may be held across frames, 0 for not at all */
+  f64 timeout;
+
+  u32 gro_flush_node_index;
+} gro_main_t;
+
+extern gro_main_t gro_main;
+
+int vnet_gro_enable_disable (u32 sw_if_index, u8 enable);
+int vnet_gro_set_config (u32 max_flows, u32 timeout_us);
+
+#endif /* __included_vnet_gro_h__ */
+
+/*
+ * fd.io coding-style-patch-verification: ON
+ *
+ * Local Variables:
+ * eval: (c-set-style "gnu")
+ * End:
+ */
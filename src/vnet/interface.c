@@ -912,6 +912,8 @@ vnet_register_interface (vnet_main_t * vnm,
 	static char *e[] = {
 	  "interface is down",
 	  "interface is deleted",
+	  "no buffers to segment GSO",
+	  "bad GSO size or headers",
 	};
 
 	r.n_errors = ARRAY_LEN (e);
@@ -1317,6 +1319,10 @@ vnet_interface_init (vlib_main_t * vm)
 						   CLIB_CACHE_LINE_BYTES);
   im->sw_if_counter_lock[0] = 1;	/* should be no need */
 
+  vec_validate_aligned (im->per_thread_data,
+			vlib_get_thread_main ()->n_vlib_mains - 1,
+			CLIB_CACHE_LINE_BYTES);
+
   vec_validate (im->sw_if_counters, VNET_N_SIMPLE_INTERFACE_COUNTER - 1);
 #define _(E,n,p)							\
   im->sw_if_counters[VNET_INTERFACE_COUNTER_##E].name = #n;		\
@@ -498,6 +498,9 @@ typedef struct vnet_hw_interface_t
   /* tx checksum offload */
 #define VNET_HW_INTERFACE_FLAG_SUPPORTS_TX_L4_CKSUM_OFFLOAD (1 << 17)
 
+  /* tx segmentation offload, see VNET_BUFFER_F_GSO */
+#define VNET_HW_INTERFACE_FLAG_SUPPORTS_GSO (1 << 18)
+
   /* Hardware address as vector.  Zero (e.g. zero-length vector) if no
      address for this class (e.g. PPP). */
   u8 *hw_address;
@@ -782,6 +785,14 @@ typedef struct
   u32 tx_node_index;
 } vnet_hw_interface_nodes_t;
 
+typedef struct
+{
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
+
+  /* Segments of the GSO packet being cut up by interface-output. */
+  u32 *split_buffers;
+} vnet_interface_per_thread_data_t;
+
 typedef struct
 {
   /* Hardware interfaces. */
@@ -822,6 +833,9 @@ typedef struct
 
   /* feature_arc_index */
   u8 output_feature_arc_index;
+
+  /* Per-thread scratch of the interface output nodes. */
+  vnet_interface_per_thread_data_t *per_thread_data;
 } vnet_interface_main_t;
 
 static inline void
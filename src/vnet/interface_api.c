@@ -54,6 +54,7 @@ _(HW_INTERFACE_SET_MTU, hw_interface_set_mtu)                   \
 _(SW_INTERFACE_SET_MTU, sw_interface_set_mtu)                   \
 _(WANT_INTERFACE_EVENTS, want_interface_events)                 \
 _(SW_INTERFACE_DUMP, sw_interface_dump)                         \
+_(SW_INTERFACE_GET, sw_interface_get)                           \
 _(SW_INTERFACE_ADD_DEL_ADDRESS, sw_interface_add_del_address)   \
 _(SW_INTERFACE_SET_RX_MODE, sw_interface_set_rx_mode)           \
 _(SW_INTERFACE_SET_TABLE, sw_interface_set_table)               \
@@ -312,6 +313,47 @@ vl_api_sw_interface_dump_t_handler (vl_api_sw_interface_dump_t * mp)
   vec_free (filter);
 }
 
+static void
+vl_api_sw_interface_get_t_handler (vl_api_sw_interface_get_t * mp)
+{
+  vpe_api_main_t *am = &vpe_api_main;
+  vnet_interface_main_t *im = &am->vnet_main->interface_main;
+  vl_api_sw_interface_get_reply_t *rmp;
+  vnet_sw_interface_t *swif;
+  u8 *filter = 0, *name = 0;
+  int rv = 0;
+
+  if (!vl_api_client_index_to_registration (mp->client_index))
+    return;
+
+  if (mp->name_filter_valid)
+    {
+      mp->name_filter[ARRAY_LEN (mp->name_filter) - 1] = 0;
+      filter = format (0, "%s%c", mp->name_filter, 0);
+    }
+
+  char *strcasestr (char *, char *);	/* lnx hdr file botch */
+  /* *INDENT-OFF* */
+  REPLY_AND_DETAILS_MACRO (VL_API_SW_INTERFACE_GET_REPLY, im->sw_interfaces,
+  ({
+    swif = pool_elt_at_index (im->sw_interfaces, cursor);
+    if (!vnet_swif_is_api_visible (swif))
+      continue;
+    vec_reset_length (name);
+    name = format (name, "%U%c", format_vnet_sw_interface_name,
+                   am->vnet_main, swif, 0);
+
+    if (filter && !strcasestr ((char *) name, (char *) filter))
+      continue;
+
+    send_sw_interface_details (am, rp, swif, name, mp->context);
+  }));
+  /* *INDENT-ON* */
+
+  vec_free (name);
+  vec_free (filter);
+}
+
 static void
   vl_api_sw_interface_add_del_address_t_handler
   (vl_api_sw_interface_add_del_address_t * mp)
@@ -1223,6 +1265,13 @@ interface_api_hookup (vlib_main_t * vm)
   foreach_vpe_api_msg;
 #undef _
 
+  /*
+   * May be served by the read-only API thread. Only the paged get, the
+   * dump would hold the reader lock, and so the main thread, for as long
+   * as it takes to walk every interface.
+   */
+  vl_msg_api_set_readonly (VL_API_SW_INTERFACE_GET, 1);
+
   /*
    * Set up the (msg_name, crc, message-id) table
    */
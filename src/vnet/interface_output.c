@@ -39,8 +39,7 @@
 
 #include <vnet/vnet.h>
 #include <vnet/ip/icmp46_packet.h>
-#include <vnet/ip/ip4.h>
-#include <vnet/ip/ip6.h>
+#include <vnet/ip/ip.h>
 #include <vnet/udp/udp_packet.h>
 #include <vnet/feature/feature.h>
 
@@ -157,6 +156,12 @@ vnet_interface_output_trace (vlib_main_t * vm,
     }
 }
 
+/*
+ * Compute the checksums the buffer flags leave to an interface which
+ * does not offload them. The L4 checksum field of such a packet is
+ * don't-care, e.g. it may have been updated incrementally on the way, so
+ * it is zeroed first.
+ */
 static_always_inline void
 calc_checksums (vlib_main_t * vm, vlib_buffer_t * b)
 {
@@ -181,17 +186,39 @@ calc_checksums (vlib_main_t * vm, vlib_buffer_t * b)
       if (b->flags & VNET_BUFFER_F_OFFLOAD_IP_CKSUM)
 	ip4->checksum = ip4_header_checksum (ip4);
       if (b->flags & VNET_BUFFER_F_OFFLOAD_TCP_CKSUM)
-	th->checksum = ip4_tcp_udp_compute_checksum (vm, b, ip4);
+	{
+	  th->checksum = 0;
+	  th->checksum = ip4_tcp_udp_compute_checksum (vm, b, ip4);
+	  ip_sw_csum_count (vm, IP_SW_CSUM_INTERFACE_OUTPUT, 1);
+	}
       if (b->flags & VNET_BUFFER_F_OFFLOAD_UDP_CKSUM)
-	uh->checksum = ip4_tcp_udp_compute_checksum (vm, b, ip4);
+	{
+	  uh->checksum = 0;
+	  uh->checksum = ip4_tcp_udp_compute_checksum (vm, b, ip4);
+	  if (uh->checksum == 0)
+	    uh->checksum = 0xffff;
+	  ip_sw_csum_count (vm, IP_SW_CSUM_INTERFACE_OUTPUT, 1);
+	}
     }
   if (is_ip6)
     {
       int bogus;
       if (b->flags & VNET_BUFFER_F_OFFLOAD_TCP_CKSUM)
-	th->checksum = ip6_tcp_udp_icmp_compute_checksum (vm, b, ip6, &bogus);
+	{
+	  th->checksum = 0;
+	  th->checksum =
+	    ip6_tcp_udp_icmp_compute_checksum (vm, b, ip6, &bogus);
+	  ip_sw_csum_count (vm, IP_SW_CSUM_INTERFACE_OUTPUT, 1);
+	}
       if (b->flags & VNET_BUFFER_F_OFFLOAD_UDP_CKSUM)
-	uh->checksum = ip6_tcp_udp_icmp_compute_checksum (vm, b, ip6, &bogus);
+	{
+	  uh->checksum = 0;
+	  uh->checksum =
+	    ip6_tcp_udp_icmp_compute_checksum (vm, b, ip6, &bogus);
+	  if (uh->checksum == 0)
+	    uh->checksum = 0xffff;
+	  ip_sw_csum_count (vm, IP_SW_CSUM_INTERFACE_OUTPUT, 1);
+	}
     }
 
   b->flags &= ~VNET_BUFFER_F_OFFLOAD_TCP_CKSUM;
@@ -199,12 +226,197 @@ calc_checksums (vlib_main_t * vm, vlib_buffer_t * b)
   b->flags &= ~VNET_BUFFER_F_OFFLOAD_IP_CKSUM;
 }
 
+/*
+ * Copy n bytes from the chain at *sb, offset *s_off, to the end of the
+ * segment whose last buffer is *tail, adding buffers to the segment as
+ * it fills up.
+ */
+static_always_inline int
+gso_copy_payload (vlib_main_t * vm, vlib_buffer_t * seg,
+		  vlib_buffer_t ** tail, vlib_buffer_t ** sb, u32 * s_off,
+		  u32 n)
+{
+  vlib_buffer_t *t = *tail, *s = *sb;
+  u32 room, n_copy, bi;
+
+  while (n)
+    {
+      if (*s_off == s->current_length)
+	{
+	  ASSERT (s->flags & VLIB_BUFFER_NEXT_PRESENT);
+	  s = vlib_get_buffer (vm, s->next_buffer);
+	  *s_off = 0;
+	  continue;
+	}
+
+      room = VLIB_BUFFER_DATA_SIZE - t->current_data - t->current_length;
+      if (0 == room)
+	{
+	  if (vlib_buffer_alloc (vm, &bi, 1) != 1)
+	    return -1;
+	  t->next_buffer = bi;
+	  t->flags |= VLIB_BUFFER_NEXT_PRESENT;
+	  t = vlib_get_buffer (vm, bi);
+	  t->flags = 0;
+	  t->current_data = 0;
+	  t->current_length = 0;
+	  seg->flags |= VLIB_BUFFER_TOTAL_LENGTH_VALID;
+	  continue;
+	}
+
+      n_copy = clib_min (n, room);
+      n_copy = clib_min (n_copy, s->current_length - *s_off);
+      clib_memcpy (vlib_buffer_get_current (t) + t->current_length,
+		   vlib_buffer_get_current (s) + *s_off, n_copy);
+      t->current_length += n_copy;
+      if (t != seg)
+	seg->total_length_not_including_first_buffer += n_copy;
+      *s_off += n_copy;
+      n -= n_copy;
+    }
+
+  *tail = t;
+  *sb = s;
+  return 0;
+}
+
+/*
+ * Cut a TCP GSO packet into segments of gso_size bytes of payload, each
+ * with a copy of the L2-L4 headers with the lengths, IP id, sequence
+ * number, flags and checksums fixed up. The segments are left in
+ * ptd->split_buffers and the packet is freed. Returns the number of
+ * segments, 0 if out of buffers, in which case the packet is left as it
+ * is. The checksums are left to the interface if it offloads them, i.e.
+ * unless do_tx_offloads. The packet must pass gso_is_valid.
+ */
+static_always_inline u32
+gso_segment_buffer (vlib_main_t * vm, vnet_interface_per_thread_data_t * ptd,
+		    u32 bi0, vlib_buffer_t * b0, int do_tx_offloads)
+{
+  u16 gso_size = vnet_buffer2 (b0)->gso_size;
+  u16 l4_hdr_sz = vnet_buffer2 (b0)->gso_l4_hdr_sz;
+  i16 l3_hdr_offset = vnet_buffer (b0)->l3_hdr_offset;
+  i16 l4_hdr_offset = vnet_buffer (b0)->l4_hdr_offset;
+  u16 hdr_sz = l4_hdr_offset + l4_hdr_sz - b0->current_data;
+  int is_ip6 = (b0->flags & VNET_BUFFER_F_IS_IP6) != 0;
+  tcp_header_t *tcp0 = (tcp_header_t *) (b0->data + l4_hdr_offset);
+  u32 seq0 = clib_net_to_host_u32 (tcp0->seq_number);
+  u8 tcp_flags0 = tcp0->flags;
+  ip4_header_t *ip4;
+  ip6_header_t *ip6;
+  tcp_header_t *tcp;
+  vlib_buffer_t *sb, *seg, *tail;
+  u32 n_bytes, n_segs, n_alloc, s_off, len, i;
+  u16 ip_id0 = 0;
+  u32 offload_flags = 0;
+  int bogus;
+
+  n_bytes = vlib_buffer_length_in_chain (vm, b0) - hdr_sz;
+  n_segs = (n_bytes + gso_size - 1) / gso_size;
+
+  vec_validate (ptd->split_buffers, n_segs - 1);
+  n_alloc = vlib_buffer_alloc (vm, ptd->split_buffers, n_segs);
+  if (n_alloc != n_segs)
+    {
+      vlib_buffer_free (vm, ptd->split_buffers, n_alloc);
+      return 0;
+    }
+
+  if (!is_ip6)
+    ip_id0 = clib_net_to_host_u16 (((ip4_header_t *)
+				    (b0->data + l3_hdr_offset))->fragment_id);
+
+  if (!do_tx_offloads)
+    offload_flags = VNET_BUFFER_F_OFFLOAD_TCP_CKSUM |
+      (is_ip6 ? 0 : VNET_BUFFER_F_OFFLOAD_IP_CKSUM);
+
+  /* the payload starts right after the headers, in the first buffer */
+  sb = b0;
+  s_off = hdr_sz;
+
+  for (i = 0; i < n_segs; i++)
+    {
+      seg = tail = vlib_get_buffer (vm, ptd->split_buffers[i]);
+      len = clib_min (gso_size, n_bytes);
+
+      clib_memcpy (seg->opaque, b0->opaque, sizeof (seg->opaque));
+      clib_memcpy (seg->opaque2, b0->opaque2, sizeof (seg->opaque2));
+      seg->flags = b0->flags & ~(VLIB_BUFFER_NON_DEFAULT_FREELIST |
+				 VLIB_BUFFER_NEXT_PRESENT |
+				 VLIB_BUFFER_IS_RECYCLED |
+				 VLIB_BUFFER_TOTAL_LENGTH_VALID |
+				 VLIB_BUFFER_RECYCLE |
+				 VLIB_BUFFER_EXT_HDR_VALID |
+				 VNET_BUFFER_F_GSO |
+				 VNET_BUFFER_F_OFFLOAD_IP_CKSUM |
+				 VNET_BUFFER_F_OFFLOAD_TCP_CKSUM);
+      seg->flags |= offload_flags;
+      seg->error = b0->error;
+      seg->trace_index = b0->trace_index;
+      seg->current_config_index = b0->current_config_index;
+      seg->current_data = b0->current_data;
+      seg->current_length = hdr_sz;
+      seg->total_length_not_including_first_buffer = 0;
+      clib_memcpy (vlib_buffer_get_current (seg),
+		   vlib_buffer_get_current (b0), hdr_sz);
+
+      if (gso_copy_payload (vm, seg, &tail, &sb, &s_off, len))
+	{
+	  tail->flags &= ~VLIB_BUFFER_NEXT_PRESENT;
+	  vlib_buffer_free (vm, ptd->split_buffers, n_segs);
+	  return 0;
+	}
+
+      tcp = (tcp_header_t *) (seg->data + l4_hdr_offset);
+      tcp->seq_number = clib_host_to_net_u32 (seq0 + i * gso_size);
+      tcp->flags = tcp_flags0;
+      if (i)
+	tcp->flags &= ~TCP_FLAG_CWR;
+      if (i != n_segs - 1)
+	tcp->flags &= ~(TCP_FLAG_FIN | TCP_FLAG_PSH);
+      tcp->checksum = 0;
+
+      if (is_ip6)
+	{
+	  ip6 = (ip6_header_t *) (seg->data + l3_hdr_offset);
+	  ip6->payload_length =
+	    clib_host_to_net_u16 (l4_hdr_offset - l3_hdr_offset -
+				  sizeof (*ip6) + l4_hdr_sz + len);
+	  if (do_tx_offloads)
+	    tcp->checksum =
+	      ip6_tcp_udp_icmp_compute_checksum (vm, seg, ip6, &bogus);
+	}
+      else
+	{
+	  ip4 = (ip4_header_t *) (seg->data + l3_hdr_offset);
+	  ip4->length =
+	    clib_host_to_net_u16 (l4_hdr_offset - l3_hdr_offset +
+				  l4_hdr_sz + len);
+	  ip4->fragment_id = clib_host_to_net_u16 (ip_id0 + i);
+	  ip4->checksum = 0;
+	  if (do_tx_offloads)
+	    {
+	      ip4->checksum = ip4_header_checksum (ip4);
+	      tcp->checksum = ip4_tcp_udp_compute_checksum (vm, seg, ip4);
+	    }
+	}
+
+      n_bytes -= len;
+    }
+
+  if (do_tx_offloads)
+    ip_sw_csum_count (vm, IP_SW_CSUM_INTERFACE_OUTPUT, n_segs);
+
+  vlib_buffer_free (vm, &bi0, 1);
+  return n_segs;
+}
+
 static_always_inline uword
 vnet_interface_output_node_inline (vlib_main_t * vm,
 				   vlib_node_runtime_t * node,
 				   vlib_frame_t * frame, vnet_main_t * vnm,
 				   vnet_hw_interface_t * hi,
-				   int do_tx_offloads)
+				   int do_tx_offloads, int do_segmentation)
 {
   vnet_interface_output_runtime_t *rt = (void *) node->runtime_data;
   vnet_sw_interface_t *si;
@@ -216,6 +428,8 @@ vnet_interface_output_node_inline (vlib_main_t * vm,
   u32 next_index = VNET_INTERFACE_OUTPUT_NEXT_TX;
   u32 current_config_index = ~0;
   u8 arc = im->output_feature_arc_index;
+  vnet_interface_per_thread_data_t *ptd =
+    vec_elt_at_index (im->per_thread_data, thread_index);
 
   n_buffers = frame->n_vectors;
 
@@ -293,6 +507,18 @@ vnet_interface_output_node_inline (vlib_main_t * vm,
 	  bi1 = from[1];
 	  bi2 = from[2];
 	  bi3 = from[3];
+
+	  b0 = vlib_get_buffer (vm, bi0);
+	  b1 = vlib_get_buffer (vm, bi1);
+	  b2 = vlib_get_buffer (vm, bi2);
+	  b3 = vlib_get_buffer (vm, bi3);
+
+	  or_flags = b0->flags | b1->flags | b2->flags | b3->flags;
+
+	  /* GSO packets are segmented in the one at a time loop */
+	  if (do_segmentation && (or_flags & VNET_BUFFER_F_GSO))
+	    break;
+
 	  to_tx[0] = bi0;
 	  to_tx[1] = bi1;
 	  to_tx[2] = bi2;
@@ -301,11 +527,6 @@ vnet_interface_output_node_inline (vlib_main_t * vm,
 	  to_tx += 4;
 	  n_left_to_tx -= 4;
 
-	  b0 = vlib_get_buffer (vm, bi0);
-	  b1 = vlib_get_buffer (vm, bi1);
-	  b2 = vlib_get_buffer (vm, bi2);
-	  b3 = vlib_get_buffer (vm, bi3);
-
 	  /* Be grumpy about zero length buffers for benefit of
 	     driver tx function. */
 	  ASSERT (b0->current_length > 0);
@@ -373,8 +594,6 @@ vnet_interface_output_node_inline (vlib_main_t * vm,
 					       n_bytes_b3);
 	    }
 
-	  or_flags = b0->flags | b1->flags | b2->flags | b3->flags;
-
 	  if (do_tx_offloads)
 	    {
 	      if (or_flags &
@@ -397,13 +616,77 @@ vnet_interface_output_node_inline (vlib_main_t * vm,
 	  u32 tx_swif0;
 
 	  bi0 = from[0];
+	  b0 = vlib_get_buffer (vm, bi0);
+
+	  if (do_segmentation && (b0->flags & VNET_BUFFER_F_GSO) &&
+	      vlib_buffer_length_in_chain (vm, b0) >
+	      vnet_buffer (b0)->l3_hdr_offset - b0->current_data +
+	      gso_mtu_sz (b0))
+	    {
+	      u32 n_segs, i;
+
+	      from += 1;
+	      if (PREDICT_FALSE (!gso_is_valid (b0)))
+		{
+		  vlib_error_drop_buffers (vm, node, &bi0,
+					   /* buffer stride */ 1, 1,
+					   VNET_INTERFACE_OUTPUT_NEXT_DROP,
+					   node->node_index,
+					   VNET_INTERFACE_OUTPUT_ERROR_BAD_GSO);
+		  continue;
+		}
+	      n_segs = gso_segment_buffer (vm, ptd, bi0, b0, do_tx_offloads);
+	      if (PREDICT_FALSE (0 == n_segs))
+		{
+		  vlib_error_drop_buffers (vm, node, &bi0,
+					   /* buffer stride */ 1, 1,
+					   VNET_INTERFACE_OUTPUT_NEXT_DROP,
+					   node->node_index,
+					   VNET_INTERFACE_OUTPUT_ERROR_NO_BUFFERS_FOR_GSO);
+		  continue;
+		}
+
+	      for (i = 0; i < n_segs; i++)
+		{
+		  if (0 == n_left_to_tx)
+		    {
+		      vlib_put_next_frame (vm, node, next_index, 0);
+		      vlib_get_new_next_frame (vm, node, next_index, to_tx,
+					       n_left_to_tx);
+		    }
+		  bi0 = ptd->split_buffers[i];
+		  b0 = vlib_get_buffer (vm, bi0);
+		  to_tx[0] = bi0;
+		  to_tx += 1;
+		  n_left_to_tx -= 1;
+
+		  n_bytes_b0 = vlib_buffer_length_in_chain (vm, b0);
+		  tx_swif0 = vnet_buffer (b0)->sw_if_index[VLIB_TX];
+		  n_bytes += n_bytes_b0;
+		  n_packets += 1;
+
+		  if (PREDICT_FALSE (current_config_index != ~0))
+		    {
+		      vnet_buffer (b0)->feature_arc_index = arc;
+		      b0->current_config_index = current_config_index;
+		    }
+
+		  if (PREDICT_FALSE (tx_swif0 != rt->sw_if_index))
+		    vlib_increment_combined_counter
+		      (im->combined_sw_if_counters +
+		       VNET_INTERFACE_COUNTER_TX, thread_index, tx_swif0, 1,
+		       n_bytes_b0);
+		}
+	      continue;
+	    }
+	  else if (do_segmentation)
+	    b0->flags &= ~VNET_BUFFER_F_GSO;
+
 	  to_tx[0] = bi0;
 	  from += 1;
 	  to_tx += 1;
 	  n_left_to_tx -= 1;
 
-	  b0 = vlib_get_buffer (vm, bi0);
-
 	  /* Be grumpy about zero length buffers for benefit of
 	     driver tx function. */
 	  ASSERT (b0->current_length > 0);
@@ -452,12 +735,18 @@ vnet_interface_output_node (vlib_main_t * vm, vlib_node_runtime_t * node,
   vnet_interface_output_runtime_t *rt = (void *) node->runtime_data;
   hi = vnet_get_sup_hw_interface (vnm, rt->sw_if_index);
 
-  if (hi->flags & VNET_HW_INTERFACE_FLAG_SUPPORTS_TX_L4_CKSUM_OFFLOAD)
+  if (hi->flags & VNET_HW_INTERFACE_FLAG_SUPPORTS_GSO)
+    return vnet_interface_output_node_inline (vm, node, frame, vnm, hi,
+					      /* do_tx_offloads */ 0,
+					      /* do_segmentation */ 0);
+  else if (hi->flags & VNET_HW_INTERFACE_FLAG_SUPPORTS_TX_L4_CKSUM_OFFLOAD)
     return vnet_interface_output_node_inline (vm, node, frame, vnm, hi,
-					      /* do_tx_offloads */ 0);
+					      /* do_tx_offloads */ 0,
+					      /* do_segmentation */ 1);
   else
     return vnet_interface_output_node_inline (vm, node, frame, vnm, hi,
-					      /* do_tx_offloads */ 1);
+					      /* do_tx_offloads */ 1,
+					      /* do_segmentation */ 1);
 }
 
 VLIB_NODE_FUNCTION_MULTIARCH_CLONE (vnet_interface_output_node);
@@ -90,6 +90,27 @@ typedef struct
   unformat_function_t *unformat_pg_edit;
 } ip_protocol_info_t;
 
+/*
+ * The nodes which still compute L4 checksums in software, because the
+ * packet was not received with a verified one or is sent through an
+ * interface without checksum offload.
+ */
+#define foreach_ip_sw_csum_counter                      \
+  _(INTERFACE_OUTPUT, "interface-output")               \
+  _(IP4_LOCAL, "ip4-local")                             \
+  _(IP6_LOCAL, "ip6-local")                             \
+  _(GRO, "gro")                                         \
+  _(IPSEC_OUTPUT, "ipsec-output")                       \
+  _(UDP_ENCAP, "udp-encap")
+
+typedef enum
+{
+#define _(sym,str) IP_SW_CSUM_##sym,
+  foreach_ip_sw_csum_counter
+#undef _
+    IP_N_SW_CSUM,
+} ip_sw_csum_counter_t;
+
 /* Per TCP/UDP port info. */
 typedef struct
 {
@@ -126,10 +147,20 @@ typedef struct
 
   /* Hash table mapping TCP/UDP name to port info index. */
   uword *port_info_by_name;
+
+  /* L4 checksums computed in software, by ip_sw_csum_counter_t */
+  vlib_simple_counter_main_t sw_csum_counters;
 } ip_main_t;
 
 extern ip_main_t ip_main;
 
+always_inline void
+ip_sw_csum_count (vlib_main_t * vm, ip_sw_csum_counter_t counter, u32 n)
+{
+  vlib_increment_simple_counter (&ip_main.sw_csum_counters,
+				 vm->thread_index, counter, n);
+}
+
 clib_error_t *ip_main_init (vlib_main_t * vm);
 
 static inline ip_protocol_info_t *
@@ -254,6 +254,7 @@ clib_error_t *ip4_probe_neighbor (vlib_main_t * vm, ip4_address_t * dst,
 				  u32 sw_if_index, u8 refresh);
 
 clib_error_t *ip4_set_arp_limit (u32 arp_limit);
+clib_error_t *ip4_set_arp_age (u32 arp_age);
 
 uword
 ip4_udp_register_listener (vlib_main_t * vm,
@@ -302,6 +302,71 @@ VLIB_CLI_COMMAND (set_reassembly_command, static) = {
 };
 /* *INDENT-ON* */
 
+static clib_error_t *
+show_ip_sw_checksum_command_fn (vlib_main_t * vm,
+				unformat_input_t * input,
+				vlib_cli_command_t * cmd)
+{
+  ip_main_t *im = &ip_main;
+  u64 count;
+
+  vlib_cli_output (vm, "%-20s%=20s", "Node", "Software checksums");
+#define _(sym,str)                                                      \
+  count = vlib_get_simple_counter (&im->sw_csum_counters,               \
+                                   IP_SW_CSUM_##sym);                   \
+  vlib_cli_output (vm, "%-20s%=20llu", str, count);
+  foreach_ip_sw_csum_counter
+#undef _
+    return 0;
+}
+
+/*?
+ * Display how many TCP and UDP checksums were computed or verified in
+ * software, by node. Checksums verified by the NIC on input or left to
+ * it on output are not counted; a large count from "interface-output"
+ * usually means that packets leave through an interface lacking
+ * checksum offload.
+ *
+ * @cliexpar
+ * @cliexstart{show ip sw-checksum}
+ * Node                 Software checksums
+ * interface-output             1024
+ * ip4-local                      12
+ * ip6-local                       0
+ * gro                             0
+ * ipsec-output                    0
+ * udp-encap                       0
+ * @cliexend
+?*/
+/* *INDENT-OFF* */
+VLIB_CLI_COMMAND (show_ip_sw_checksum_command, static) = {
+  .path = "show ip sw-checksum",
+  .short_help = "show ip sw-checksum",
+  .function = show_ip_sw_checksum_command_fn,
+};
+/* *INDENT-ON* */
+
+static clib_error_t *
+clear_ip_sw_checksum_command_fn (vlib_main_t * vm,
+				 unformat_input_t * input,
+				 vlib_cli_command_t * cmd)
+{
+  ip_main_t *im = &ip_main;
+  int i;
+
+  for (i = 0; i < IP_N_SW_CSUM; i++)
+    vlib_zero_simple_counter (&im->sw_csum_counters, i);
+  return 0;
+}
+
+/* *INDENT-OFF* */
+VLIB_CLI_COMMAND (clear_ip_sw_checksum_command, static) = {
+  .path = "clear ip sw-checksum",
+  .short_help = "clear ip sw-checksum",
+  .function = clear_ip_sw_checksum_command_fn,
+};
+/* *INDENT-ON* */
+
 /* Dummy init function to get us linked in. */
 static clib_error_t *
 ip4_cli_init (vlib_main_t * vm)
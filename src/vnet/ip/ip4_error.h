@@ -86,7 +86,14 @@
   /* Errors signalled by ip4-reassembly */                              \
   _ (REASS_DUPLICATE_FRAGMENT, "duplicate/overlapping fragments")       \
   _ (REASS_LIMIT_REACHED, "drops due to concurrent reassemblies limit") \
-  _ (REASS_TIMEOUT, "fragments dropped due to reassembly timeout")
+  _ (REASS_TIMEOUT, "fragments dropped due to reassembly timeout")      \
+  _ (REASS_HANDOFF, "fragments handed off to the owning thread")        \
+  _ (REASS_CONGESTION_DROP, "fragments dropped, handoff queue full")    \
+                                                                        \
+  /* Errors signalled by ip4-sv-reassembly */                           \
+  _ (SV_REASS_TOO_MANY_FRAGMENTS, "too many fragments before first")    \
+  _ (SV_REASS_TINY_FRAGMENT, "first fragment without the L4 header")    \
+  _ (SV_REASS_EVICTED, "fragments dropped, reassembly evicted")
 
 typedef enum
 {
@@ -1150,6 +1150,7 @@ ip4_local_l4_csum_validate (vlib_main_t * vm, vlib_buffer_t * p,
 {
   u32 flags0;
   flags0 = ip4_tcp_udp_validate_checksum (vm, p);
+  ip_sw_csum_count (vm, IP_SW_CSUM_IP4_LOCAL, 1);
   *good_tcp_udp = (flags0 & VNET_BUFFER_F_L4_CHECKSUM_CORRECT) != 0;
   if (is_udp)
     {
@@ -2047,6 +2048,10 @@ always_inline void
 ip4_mtu_check (vlib_buffer_t * b, u16 packet_len,
 	       u16 adj_packet_bytes, bool df, u32 * next, u32 * error)
 {
+  /* a GSO packet is checked by the size of its segments */
+  if (PREDICT_FALSE (b->flags & VNET_BUFFER_F_GSO))
+    packet_len = gso_mtu_sz (b);
+
   if (packet_len > adj_packet_bytes)
     {
       *error = IP4_ERROR_MTU_EXCEEDED;
@@ -42,6 +42,7 @@
 
 #include <vnet/fib/ip4_fib.h>
 #include <vnet/dpo/load_balance_map.h>
+#include <vnet/ip/ip_flow_cache.h>
 
 /**
  * @file
@@ -50,6 +51,45 @@
  * This file contains the source code for IPv4 forwarding.
  */
 
+/**
+ * Look up the destinations of a frame's packets in one batch, so the
+ * mtrie walk can use the CPU's gather lookup; sets each buffer's FIB
+ * index on the way.
+ */
+always_inline void
+ip4_lookup_batch (vlib_main_t * vm, u32 * from, u32 n_left,
+		  u32 * lb_indices)
+{
+  ip4_main_t *im = &ip4_main;
+  ip4_fib_mtrie_t *mtries[VLIB_FRAME_SIZE];
+  u32 dst_addresses[VLIB_FRAME_SIZE];
+  vlib_buffer_t *p0;
+  ip4_header_t *ip0;
+  u32 i;
+
+  ASSERT (n_left <= VLIB_FRAME_SIZE);
+
+  for (i = 0; i < n_left; i++)
+    {
+      if (i + 4 < n_left)
+	{
+	  vlib_buffer_t *p4 = vlib_get_buffer (vm, from[i + 4]);
+
+	  vlib_prefetch_buffer_header (p4, LOAD);
+	  CLIB_PREFETCH (p4->data, sizeof (ip0[0]), LOAD);
+	}
+
+      p0 = vlib_get_buffer (vm, from[i]);
+      ip0 = vlib_buffer_get_current (p0);
+      ip_lookup_set_buffer_fib_index (im->fib_index_by_sw_if_index, p0);
+
+      mtries[i] = &ip4_fib_get (vnet_buffer (p0)->ip.fib_index)->mtrie;
+      dst_addresses[i] = ip0->dst_address.as_u32;
+    }
+
+  ip4_fib_mtrie_lookup_batch_fn (mtries, dst_addresses, lb_indices, n_left);
+}
+
 always_inline uword
 ip4_lookup_inline (vlib_main_t * vm,
 		   vlib_node_runtime_t * node,
@@ -59,6 +99,7 @@ ip4_lookup_inline (vlib_main_t * vm,
   ip4_main_t *im = &ip4_main;
   vlib_combined_counter_main_t *cm = &load_balance_main.lbm_to_counters;
   u32 n_left_from, n_left_to_next, *from, *to_next;
+  u32 lb_indices[VLIB_FRAME_SIZE], *lbi = lb_indices;
   ip_lookup_next_t next;
   u32 thread_index = vm->thread_index;
 
@@ -66,6 +107,9 @@ ip4_lookup_inline (vlib_main_t * vm,
   n_left_from = frame->n_vectors;
   next = node->cached_next_index;
 
+  if (!lookup_for_responses_to_locally_received_packets)
+    ip4_lookup_batch (vm, from, n_left_from, lb_indices);
+
   while (n_left_from > 0)
     {
       vlib_get_next_frame (vm, node, next, to_next, n_left_to_next);
@@ -76,9 +120,6 @@ ip4_lookup_inline (vlib_main_t * vm,
 	  ip4_header_t *ip0, *ip1, *ip2, *ip3;
 	  ip_lookup_next_t next0, next1, next2, next3;
 	  const load_balance_t *lb0, *lb1, *lb2, *lb3;
-	  ip4_fib_mtrie_t *mtrie0, *mtrie1, *mtrie2, *mtrie3;
-	  ip4_fib_mtrie_leaf_t leaf0, leaf1, leaf2, leaf3;
-	  ip4_address_t *dst_addr0, *dst_addr1, *dst_addr2, *dst_addr3;
 	  u32 pi0, pi1, pi2, pi3, lb_index0, lb_index1, lb_index2, lb_index3;
 	  flow_hash_config_t flow_hash_config0, flow_hash_config1;
 	  flow_hash_config_t flow_hash_config2, flow_hash_config3;
@@ -125,47 +166,17 @@ ip4_lookup_inline (vlib_main_t * vm,
 	  ip2 = vlib_buffer_get_current (p2);
 	  ip3 = vlib_buffer_get_current (p3);
 
-	  dst_addr0 = &ip0->dst_address;
-	  dst_addr1 = &ip1->dst_address;
-	  dst_addr2 = &ip2->dst_address;
-	  dst_addr3 = &ip3->dst_address;
-
-	  ip_lookup_set_buffer_fib_index (im->fib_index_by_sw_if_index, p0);
-	  ip_lookup_set_buffer_fib_index (im->fib_index_by_sw_if_index, p1);
-	  ip_lookup_set_buffer_fib_index (im->fib_index_by_sw_if_index, p2);
-	  ip_lookup_set_buffer_fib_index (im->fib_index_by_sw_if_index, p3);
-
-	  if (!lookup_for_responses_to_locally_received_packets)
-	    {
-	      mtrie0 = &ip4_fib_get (vnet_buffer (p0)->ip.fib_index)->mtrie;
-	      mtrie1 = &ip4_fib_get (vnet_buffer (p1)->ip.fib_index)->mtrie;
-	      mtrie2 = &ip4_fib_get (vnet_buffer (p2)->ip.fib_index)->mtrie;
-	      mtrie3 = &ip4_fib_get (vnet_buffer (p3)->ip.fib_index)->mtrie;
-
-	      leaf0 = ip4_fib_mtrie_lookup_step_one (mtrie0, dst_addr0);
-	      leaf1 = ip4_fib_mtrie_lookup_step_one (mtrie1, dst_addr1);
-	      leaf2 = ip4_fib_mtrie_lookup_step_one (mtrie2, dst_addr2);
-	      leaf3 = ip4_fib_mtrie_lookup_step_one (mtrie3, dst_addr3);
-	    }
-
-	  if (!lookup_for_responses_to_locally_received_packets)
-	    {
-	      leaf0 = ip4_fib_mtrie_lookup_step (mtrie0, leaf0, dst_addr0, 2);
-	      leaf1 = ip4_fib_mtrie_lookup_step (mtrie1, leaf1, dst_addr1, 2);
-	      leaf2 = ip4_fib_mtrie_lookup_step (mtrie2, leaf2, dst_addr2, 2);
-	      leaf3 = ip4_fib_mtrie_lookup_step (mtrie3, leaf3, dst_addr3, 2);
-	    }
-
-	  if (!lookup_for_responses_to_locally_received_packets)
-	    {
-	      leaf0 = ip4_fib_mtrie_lookup_step (mtrie0, leaf0, dst_addr0, 3);
-	      leaf1 = ip4_fib_mtrie_lookup_step (mtrie1, leaf1, dst_addr1, 3);
-	      leaf2 = ip4_fib_mtrie_lookup_step (mtrie2, leaf2, dst_addr2, 3);
-	      leaf3 = ip4_fib_mtrie_lookup_step (mtrie3, leaf3, dst_addr3, 3);
-	    }
-
 	  if (lookup_for_responses_to_locally_received_packets)
 	    {
+	      ip_lookup_set_buffer_fib_index (im->fib_index_by_sw_if_index,
+					      p0);
+	      ip_lookup_set_buffer_fib_index (im->fib_index_by_sw_if_index,
+					      p1);
+	      ip_lookup_set_buffer_fib_index (im->fib_index_by_sw_if_index,
+					      p2);
+	      ip_lookup_set_buffer_fib_index (im->fib_index_by_sw_if_index,
+					      p3);
+
 	      lb_index0 = vnet_buffer (p0)->ip.adj_index[VLIB_RX];
 	      lb_index1 = vnet_buffer (p1)->ip.adj_index[VLIB_RX];
 	      lb_index2 = vnet_buffer (p2)->ip.adj_index[VLIB_RX];
@@ -173,10 +184,12 @@ ip4_lookup_inline (vlib_main_t * vm,
 	    }
 	  else
 	    {
-	      lb_index0 = ip4_fib_mtrie_leaf_get_adj_index (leaf0);
-	      lb_index1 = ip4_fib_mtrie_leaf_get_adj_index (leaf1);
-	      lb_index2 = ip4_fib_mtrie_leaf_get_adj_index (leaf2);
-	      lb_index3 = ip4_fib_mtrie_leaf_get_adj_index (leaf3);
+	      /* looked up in ip4_lookup_batch */
+	      lb_index0 = lbi[0];
+	      lb_index1 = lbi[1];
+	      lb_index2 = lbi[2];
+	      lb_index3 = lbi[3];
+	      lbi += 4;
 	    }
 
 	  ASSERT (lb_index0 && lb_index1 && lb_index2 && lb_index3);
@@ -290,9 +303,6 @@ ip4_lookup_inline (vlib_main_t * vm,
 	  ip4_header_t *ip0;
 	  ip_lookup_next_t next0;
 	  const load_balance_t *lb0;
-	  ip4_fib_mtrie_t *mtrie0;
-	  ip4_fib_mtrie_leaf_t leaf0;
-	  ip4_address_t *dst_addr0;
 	  u32 pi0, lbi0;
 	  flow_hash_config_t flow_hash_config0;
 	  const dpo_id_t *dpo0;
@@ -303,28 +313,15 @@ ip4_lookup_inline (vlib_main_t * vm,
 
 	  p0 = vlib_get_buffer (vm, pi0);
 	  ip0 = vlib_buffer_get_current (p0);
-	  dst_addr0 = &ip0->dst_address;
-	  ip_lookup_set_buffer_fib_index (im->fib_index_by_sw_if_index, p0);
-
-	  if (!lookup_for_responses_to_locally_received_packets)
-	    {
-	      mtrie0 = &ip4_fib_get (vnet_buffer (p0)->ip.fib_index)->mtrie;
-	      leaf0 = ip4_fib_mtrie_lookup_step_one (mtrie0, dst_addr0);
-	    }
-
-	  if (!lookup_for_responses_to_locally_received_packets)
-	    leaf0 = ip4_fib_mtrie_lookup_step (mtrie0, leaf0, dst_addr0, 2);
-
-	  if (!lookup_for_responses_to_locally_received_packets)
-	    leaf0 = ip4_fib_mtrie_lookup_step (mtrie0, leaf0, dst_addr0, 3);
 
 	  if (lookup_for_responses_to_locally_received_packets)
-	    lbi0 = vnet_buffer (p0)->ip.adj_index[VLIB_RX];
-	  else
 	    {
-	      /* Handle default route. */
-	      lbi0 = ip4_fib_mtrie_leaf_get_adj_index (leaf0);
+	      ip_lookup_set_buffer_fib_index (im->fib_index_by_sw_if_index,
+					      p0);
+	      lbi0 = vnet_buffer (p0)->ip.adj_index[VLIB_RX];
 	    }
+	  else
+	    lbi0 = *lbi++;
 
 	  ASSERT (lbi0);
 	  lb0 = load_balance_get (lbi0);
@@ -380,6 +377,11 @@ ip4_lookup_inline (vlib_main_t * vm,
   if (node->flags & VLIB_NODE_FLAG_TRACE)
     ip4_forward_next_trace (vm, node, frame, VLIB_TX);
 
+  if (!lookup_for_responses_to_locally_received_packets &&
+      PREDICT_FALSE (ip_flow_cache_is_learning (thread_index)))
+    ip4_flow_cache_learn (vm, vlib_frame_vector_args (frame),
+			  frame->n_vectors);
+
   return frame->n_vectors;
 }
 
@@ -77,6 +77,63 @@ check_ver_opt_csum (ip4_header_t * ip, u8 * error, int verify_checksum)
     *error = IP4_ERROR_BAD_CHECKSUM;
 }
 
+#if defined (CLIB_HAVE_VEC128) && defined (__SSE4_2__)
+/*
+ * Check four headers at once, lane i of each vector holding a word of
+ * header i: version 4 without options, TTL not 0, fragment offset not
+ * 1, length within bounds and, if verify_checksum, the checksum.
+ * Returns non-zero if all four are good; any other case is left to the
+ * scalar checks, which find out what is wrong with which.
+ */
+static_always_inline int
+ip4_input_check_fast_x4 (vlib_main_t * vm, vlib_buffer_t ** p,
+			 ip4_header_t ** ip, int verify_checksum)
+{
+  u32x4 w0, w1, w2, w3, w4, ip_len, cur_len, bad, sum;
+  u32x4 lo16 = u32x4_splat (0xffff);
+
+  w0 = u32x4_load_unaligned (ip[0]);
+  w1 = u32x4_load_unaligned (ip[1]);
+  w2 = u32x4_load_unaligned (ip[2]);
+  w3 = u32x4_load_unaligned (ip[3]);
+  u32x4_transpose (w0, w1, w2, w3);
+
+  /* w0: version and header length, tos, length */
+  bad = (w0 & u32x4_splat (0xff)) ^ u32x4_splat (0x45);
+  /* w1: fragment id, flags and fragment offset */
+  bad |= (u32x4) ((w1 & u32x4_splat (0xff1f0000)) ==
+		  u32x4_splat (0x01000000));
+  /* w2: ttl, protocol, checksum */
+  bad |= (u32x4) ((w2 & u32x4_splat (0xff)) == u32x4_splat (0));
+
+  ip_len = ((w0 >> 24) | ((w0 >> 8) & u32x4_splat (0xff00)));
+  cur_len[0] = vlib_buffer_length_in_chain (vm, p[0]);
+  cur_len[1] = vlib_buffer_length_in_chain (vm, p[1]);
+  cur_len[2] = vlib_buffer_length_in_chain (vm, p[2]);
+  cur_len[3] = vlib_buffer_length_in_chain (vm, p[3]);
+  bad |= (u32x4) (ip_len < u32x4_splat (sizeof (ip4_header_t)));
+  bad |= (u32x4) (ip_len > cur_len);
+
+  if (verify_checksum)
+    {
+      /* w4: destination address, the fifth and last word */
+      w4[0] = ip[0]->dst_address.as_u32;
+      w4[1] = ip[1]->dst_address.as_u32;
+      w4[2] = ip[2]->dst_address.as_u32;
+      w4[3] = ip[3]->dst_address.as_u32;
+
+      sum = (w0 & lo16) + (w0 >> 16) + (w1 & lo16) + (w1 >> 16);
+      sum += (w2 & lo16) + (w2 >> 16) + (w3 & lo16) + (w3 >> 16);
+      sum += (w4 & lo16) + (w4 >> 16);
+      sum = (sum & lo16) + (sum >> 16);
+      sum = (sum & lo16) + (sum >> 16);
+      bad |= sum ^ lo16;
+    }
+
+  return u32x4_is_all_zero (bad);
+}
+#endif
+
 always_inline void
 ip4_input_check_x4 (vlib_main_t * vm,
 		    vlib_node_runtime_t * error_node,
@@ -90,6 +147,11 @@ ip4_input_check_x4 (vlib_main_t * vm,
   u32 ip_len3, cur_len3;
   i32 len_diff0, len_diff1, len_diff2, len_diff3;
 
+#if defined (CLIB_HAVE_VEC128) && defined (__SSE4_2__)
+  if (PREDICT_TRUE (ip4_input_check_fast_x4 (vm, p, ip, verify_checksum)))
+    return;
+#endif
+
   error0 = error1 = error2 = error3 = IP4_ERROR_NONE;
 
   check_ver_opt_csum (ip[0], &error0, verify_checksum);
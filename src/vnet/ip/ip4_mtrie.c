@@ -799,6 +799,457 @@ format_ip4_fib_mtrie (u8 * s, va_list * va)
   return s;
 }
 
+/*
+ * Batched lookups.
+ *
+ * The scalar version walks each address down the plies in turn. The
+ * gather versions resolve 8 (AVX2) or 16 (AVX512) addresses at once
+ * when they share an mtrie, which is the common case since a frame's
+ * packets mostly come from the same table: one gather reads the root
+ * ply leaves, then masked gathers follow the non-terminal leaves into
+ * the 8 bit plies. The gathers index the ply pool with signed 32 bit
+ * offsets, so the scalar version is used once the pool grows past that.
+ */
+
+/** Distance between the first leaves of consecutive plies, in leaves */
+#define IP4_MTRIE_PLY_8_STRIDE \
+  (sizeof (ip4_fib_mtrie_8_ply_t) / sizeof (ip4_fib_mtrie_leaf_t))
+
+/** Most plies the gather lookups can address */
+#define IP4_MTRIE_GATHER_MAX_PLIES \
+  ((1ULL << 31) / sizeof (ip4_fib_mtrie_8_ply_t))
+
+STATIC_ASSERT (0 == sizeof (ip4_fib_mtrie_8_ply_t) %
+	       sizeof (ip4_fib_mtrie_leaf_t), "IP4 Mtrie ply stride");
+
+ip4_fib_mtrie_lookup_batch_fn_t *ip4_fib_mtrie_lookup_batch_fn;
+
+static void
+ip4_fib_mtrie_lookup_batch_scalar (ip4_fib_mtrie_t ** mtries,
+				   const u32 * dst_addresses,
+				   u32 * lb_indices, u32 n)
+{
+  const ip4_address_t *dst;
+  ip4_fib_mtrie_leaf_t leaf;
+  u32 i;
+
+  for (i = 0; i < n; i++)
+    {
+      dst = (const ip4_address_t *) (dst_addresses + i);
+      leaf = ip4_fib_mtrie_lookup_step_one (mtries[i], dst);
+      leaf = ip4_fib_mtrie_lookup_step (mtries[i], leaf, dst, 2);
+      leaf = ip4_fib_mtrie_lookup_step (mtries[i], leaf, dst, 3);
+      lb_indices[i] = ip4_fib_mtrie_leaf_get_adj_index (leaf);
+    }
+}
+
+always_inline int
+ip4_fib_mtrie_batch_is_one_mtrie (ip4_fib_mtrie_t ** mtries, u32 n)
+{
+  u32 i;
+
+  for (i = 1; i < n; i++)
+    if (mtries[i] != mtries[0])
+      return 0;
+  return 1;
+}
+
+#ifdef __x86_64__
+static void __attribute__ ((target ("avx2")))
+ip4_fib_mtrie_lookup_batch_avx2 (ip4_fib_mtrie_t ** mtries,
+				 const u32 * dst_addresses,
+				 u32 * lb_indices, u32 n)
+{
+  const __m256i one = _mm256_set1_epi32 (1);
+  const __m256i byte_mask = _mm256_set1_epi32 (0xff);
+  const __m256i stride = _mm256_set1_epi32 (IP4_MTRIE_PLY_8_STRIDE);
+  __m256i addr, idx, leaf, non_terminal;
+  int byte;
+
+  if (PREDICT_FALSE (pool_len (ip4_ply_pool) >= IP4_MTRIE_GATHER_MAX_PLIES))
+    n = 0;
+
+  while (n >= 8)
+    {
+      if (PREDICT_FALSE (!ip4_fib_mtrie_batch_is_one_mtrie (mtries, 8)))
+	{
+	  ip4_fib_mtrie_lookup_batch_scalar (mtries, dst_addresses,
+					     lb_indices, 8);
+	  goto next;
+	}
+
+      /* the first two address bytes index the root ply */
+      addr = _mm256_loadu_si256 ((__m256i *) dst_addresses);
+      idx = _mm256_and_si256 (addr, _mm256_set1_epi32 (0xffff));
+      leaf = _mm256_i32gather_epi32 ((int *) mtries[0]->root_ply.leaves,
+				     idx, sizeof (ip4_fib_mtrie_leaf_t));
+
+      /* then one byte per 8 bit ply, for the leaves that point at one */
+      for (byte = 2; byte < 4; byte++)
+	{
+	  non_terminal = _mm256_cmpeq_epi32 (_mm256_and_si256 (leaf, one),
+					     _mm256_setzero_si256 ());
+	  if (_mm256_testz_si256 (non_terminal, non_terminal))
+	    break;
+	  idx = _mm256_add_epi32
+	    (_mm256_mullo_epi32 (_mm256_srli_epi32 (leaf, 1), stride),
+	     _mm256_and_si256 (_mm256_srli_epi32 (addr, 8 * byte),
+			       byte_mask));
+	  leaf = _mm256_mask_i32gather_epi32 (leaf, (int *) ip4_ply_pool,
+					      idx, non_terminal,
+					      sizeof (ip4_fib_mtrie_leaf_t));
+	}
+
+      _mm256_storeu_si256 ((__m256i *) lb_indices,
+			   _mm256_srli_epi32 (leaf, 1));
+    next:
+      mtries += 8;
+      dst_addresses += 8;
+      lb_indices += 8;
+      n -= 8;
+    }
+
+  ip4_fib_mtrie_lookup_batch_scalar (mtries, dst_addresses, lb_indices, n);
+}
+
+static void __attribute__ ((target ("avx512f")))
+ip4_fib_mtrie_lookup_batch_avx512 (ip4_fib_mtrie_t ** mtries,
+				   const u32 * dst_addresses,
+				   u32 * lb_indices, u32 n)
+{
+  const __m512i one = _mm512_set1_epi32 (1);
+  const __m512i byte_mask = _mm512_set1_epi32 (0xff);
+  const __m512i stride = _mm512_set1_epi32 (IP4_MTRIE_PLY_8_STRIDE);
+  __m512i addr, idx, leaf;
+  __mmask16 non_terminal;
+  int byte;
+
+  if (PREDICT_FALSE (pool_len (ip4_ply_pool) >= IP4_MTRIE_GATHER_MAX_PLIES))
+    n = 0;
+
+  while (n >= 16)
+    {
+      if (PREDICT_FALSE (!ip4_fib_mtrie_batch_is_one_mtrie (mtries, 16)))
+	{
+	  ip4_fib_mtrie_lookup_batch_scalar (mtries, dst_addresses,
+					     lb_indices, 16);
+	  goto next;
+	}
+
+      addr = _mm512_loadu_si512 (dst_addresses);
+      idx = _mm512_and_si512 (addr, _mm512_set1_epi32 (0xffff));
+      leaf = _mm512_i32gather_epi32 (idx, mtries[0]->root_ply.leaves,
+				     sizeof (ip4_fib_mtrie_leaf_t));
+
+      for (byte = 2; byte < 4; byte++)
+	{
+	  non_terminal = _mm512_testn_epi32_mask (leaf, one);
+	  if (!non_terminal)
+	    break;
+	  idx = _mm512_add_epi32
+	    (_mm512_mullo_epi32 (_mm512_srli_epi32 (leaf, 1), stride),
+	     _mm512_and_si512 (_mm512_srli_epi32 (addr, 8 * byte),
+			       byte_mask));
+	  leaf = _mm512_mask_i32gather_epi32 (leaf, non_terminal, idx,
+					      ip4_ply_pool,
+					      sizeof (ip4_fib_mtrie_leaf_t));
+	}
+
+      _mm512_storeu_si512 (lb_indices, _mm512_srli_epi32 (leaf, 1));
+    next:
+      mtries += 16;
+      dst_addresses += 16;
+      lb_indices += 16;
+      n -= 16;
+    }
+
+  ip4_fib_mtrie_lookup_batch_avx2 (mtries, dst_addresses, lb_indices, n);
+}
+#endif
+
+#define foreach_ip4_fib_mtrie_lookup_variant	\
+  _(scalar, 1)					\
+  _(avx2, clib_cpu_supports_avx2 ())		\
+  _(avx512, clib_cpu_supports_avx512f ())
+
+typedef struct
+{
+  const char *name;
+  ip4_fib_mtrie_lookup_batch_fn_t *fn;
+  int supported;
+} ip4_fib_mtrie_lookup_variant_t;
+
+static ip4_fib_mtrie_lookup_variant_t *
+ip4_fib_mtrie_lookup_variants (void)
+{
+  static ip4_fib_mtrie_lookup_variant_t *variants;
+  ip4_fib_mtrie_lookup_variant_t *v;
+
+  if (variants)
+    return variants;
+
+#ifdef __x86_64__
+#define _(n, s)							\
+  vec_add2 (variants, v, 1);					\
+  v->name = #n;							\
+  v->fn = ip4_fib_mtrie_lookup_batch_##n;			\
+  v->supported = s;
+  foreach_ip4_fib_mtrie_lookup_variant;
+#undef _
+#else
+  vec_add2 (variants, v, 1);
+  v->name = "scalar";
+  v->fn = ip4_fib_mtrie_lookup_batch_scalar;
+  v->supported = 1;
+#endif
+
+  return variants;
+}
+
+/* the last supported variant is the widest */
+static ip4_fib_mtrie_lookup_variant_t *
+ip4_fib_mtrie_lookup_variant_best (void)
+{
+  ip4_fib_mtrie_lookup_variant_t *v, *best = 0;
+
+  vec_foreach (v, ip4_fib_mtrie_lookup_variants ())
+    if (v->supported)
+    best = v;
+
+  return best;
+}
+
+static clib_error_t *
+ip4_mtrie_set_lookup_command_fn (vlib_main_t * vm,
+				 unformat_input_t * input,
+				 vlib_cli_command_t * cmd)
+{
+  ip4_fib_mtrie_lookup_variant_t *v, *sel = 0;
+
+  if (unformat (input, "auto"))
+    sel = ip4_fib_mtrie_lookup_variant_best ();
+  else
+    vec_foreach (v, ip4_fib_mtrie_lookup_variants ())
+      if (unformat (input, v->name))
+      {
+	if (!v->supported)
+	  return clib_error_return (0, "%s not supported by this CPU",
+				    v->name);
+	sel = v;
+	break;
+      }
+
+  if (sel)
+    ip4_fib_mtrie_lookup_batch_fn = sel->fn;
+
+  vec_foreach (v, ip4_fib_mtrie_lookup_variants ())
+    if (v->fn == ip4_fib_mtrie_lookup_batch_fn)
+    vlib_cli_output (vm, "ip4 mtrie lookup: %s", v->name);
+
+  return 0;
+}
+
+/*?
+ * Select the batched IPv4 mtrie lookup used by ip4-lookup. By default
+ * the widest the CPU supports is used; this is meant for comparing them.
+ *
+ * @cliexpar
+ * @cliexstart{set ip mtrie lookup scalar}
+ * ip4 mtrie lookup: scalar
+ * @cliexend
+?*/
+/* *INDENT-OFF* */
+VLIB_CLI_COMMAND (ip4_mtrie_set_lookup_command, static) =
+{
+  .path = "set ip mtrie lookup",
+  .short_help = "set ip mtrie lookup [auto|scalar|avx2|avx512]",
+  .function = ip4_mtrie_set_lookup_command_fn,
+};
+/* *INDENT-ON* */
+
+/*
+ * Lookup micro-benchmark over a synthetic full table
+ */
+
+/* share of the routes per prefix length, per mille, roughly a full
+ * Internet table */
+static const u16 ip4_mtrie_perf_len_distribution[33] = {
+  [8] = 1,[12] = 2,[13] = 3,[14] = 5,[15] = 8,[16] = 20,[17] = 7,
+  [18] = 15,[19] = 25,[20] = 45,[21] = 55,[22] = 130,[23] = 100,
+  [24] = 580,[25] = 1,[26] = 1,[27] = 1,[28] = 1,
+};
+
+static u32
+ip4_mtrie_perf_random_len (u32 * seed)
+{
+  u32 r = random_u32 (seed) % 1000, len, sum = 0;
+
+  for (len = 0; len < ARRAY_LEN (ip4_mtrie_perf_len_distribution); len++)
+    {
+      sum += ip4_mtrie_perf_len_distribution[len];
+      if (r < sum)
+	return len;
+    }
+  return 24;
+}
+
+static void
+ip4_mtrie_perf_ply_free (ip4_fib_mtrie_8_ply_t * p)
+{
+  uword i;
+
+  for (i = 0; i < ARRAY_LEN (p->leaves); i++)
+    if (ip4_fib_mtrie_leaf_is_next_ply (p->leaves[i]))
+      ip4_mtrie_perf_ply_free (get_next_ply_for_leaf (0, p->leaves[i]));
+  pool_put (ip4_ply_pool, p);
+}
+
+static clib_error_t *
+ip4_mtrie_perf_command_fn (vlib_main_t * vm,
+			   unformat_input_t * input, vlib_cli_command_t * cmd)
+{
+  ip4_fib_mtrie_lookup_variant_t *v, *variants;
+  u32 n_routes = 100000, n_lookups = 1 << 20, batch = VLIB_FRAME_SIZE;
+  u32 i, j, seed = 0xdeadbeef, *dsts = 0, *lbis = 0, *ref = 0;
+  ip4_fib_mtrie_t **mtries = 0, *m;
+  clib_error_t *error = 0;
+  ip4_address_t *routes = 0, a;
+  u8 *lens = 0;
+  clib_mem_usage_t usage;
+  void *old_heap;
+  u64 t0, dt;
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "routes %u", &n_routes))
+	;
+      else if (unformat (input, "lookups %u", &n_lookups))
+	;
+      else if (unformat (input, "batch %u", &batch))
+	;
+      else if (unformat (input, "seed %u", &seed))
+	;
+      else
+	return clib_error_return (0, "unknown input `%U'",
+				  format_unformat_error, input);
+    }
+  if (batch == 0 || n_routes == 0 || n_lookups < batch)
+    return clib_error_return (0, "bad routes / lookups / batch");
+
+  m = clib_mem_alloc_aligned (sizeof (*m), CLIB_CACHE_LINE_BYTES);
+  ip4_mtrie_init (m);
+
+  /* The ply pool is shared with the workers' lookups */
+  vlib_worker_thread_barrier_sync (vm);
+
+  for (i = 0; i < n_routes; i++)
+    {
+      /* stop short of exhausting the mtrie heap */
+      if ((i & 255) == 0)
+	{
+	  mheap_usage (ip4_main.mtrie_mheap, &usage);
+	  if (usage.bytes_total - usage.bytes_used <
+	      512 * sizeof (ip4_fib_mtrie_8_ply_t))
+	    {
+	      vlib_cli_output (vm, "mtrie heap full after %u routes, "
+			       "see ip { heap-size }", i);
+	      break;
+	    }
+	}
+      /* unicast space only, so lookups can miss */
+      do
+	a.as_u32 = random_u32 (&seed);
+      while (a.as_u8[0] == 0 || a.as_u8[0] >= 224);
+      vec_add1 (lens, ip4_mtrie_perf_random_len (&seed));
+      a.as_u32 &= ip4_main.fib_masks[lens[i]];
+      vec_add1 (routes, a);
+      ip4_fib_mtrie_route_add (m, &a, lens[i], i + 1);
+    }
+
+  vlib_worker_thread_barrier_release (vm);
+
+  vlib_cli_output (vm, "%u routes, mtrie %U", vec_len (routes),
+		   format_memory_size, ip4_fib_mtrie_memory_usage (m));
+
+  /* destinations within random routes, the lookup sees the deep plies */
+  vec_validate (dsts, batch - 1);
+  vec_validate (mtries, batch - 1);
+  vec_validate (lbis, batch - 1);
+  vec_validate (ref, batch - 1);
+  for (i = 0; i < batch; i++)
+    {
+      j = random_u32 (&seed) % vec_len (routes);
+      a.as_u32 = routes[j].as_u32 |
+	(random_u32 (&seed) & ~ip4_main.fib_masks[lens[j]]);
+      dsts[i] = a.as_u32;
+      mtries[i] = m;
+    }
+
+  variants = ip4_fib_mtrie_lookup_variants ();
+  ip4_fib_mtrie_lookup_batch_scalar (mtries, dsts, ref, batch);
+
+  vlib_cli_output (vm, "%-10s%12s%12s", "Lookup", "Clocks/addr", "Mlookups/s");
+  vec_foreach (v, variants)
+  {
+    if (!v->supported)
+      continue;
+
+    v->fn (mtries, dsts, lbis, batch);
+    if (memcmp (lbis, ref, batch * sizeof (ref[0])))
+      {
+	error = clib_error_return (0, "%s lookup disagrees with scalar",
+				   v->name);
+	break;
+      }
+
+    t0 = clib_cpu_time_now ();
+    for (i = 0; i + batch <= n_lookups; i += batch)
+      v->fn (mtries, dsts, lbis, batch);
+    dt = clib_cpu_time_now () - t0;
+
+    vlib_cli_output (vm, "%-10s%12.2f%12.2f", v->name, (f64) dt / i,
+		     (f64) i / (dt * vm->clib_time.seconds_per_clock) * 1e-6);
+  }
+
+  vlib_worker_thread_barrier_sync (vm);
+  old_heap = clib_mem_set_heap (ip4_main.mtrie_mheap);
+  for (i = 0; i < ARRAY_LEN (m->root_ply.leaves); i++)
+    if (ip4_fib_mtrie_leaf_is_next_ply (m->root_ply.leaves[i]))
+      ip4_mtrie_perf_ply_free (get_next_ply_for_leaf
+			       (m, m->root_ply.leaves[i]));
+  clib_mem_set_heap (old_heap);
+  vlib_worker_thread_barrier_release (vm);
+
+  clib_mem_free (m);
+  vec_free (routes);
+  vec_free (lens);
+  vec_free (dsts);
+  vec_free (mtries);
+  vec_free (lbis);
+  vec_free (ref);
+
+  return error;
+}
+
+/*?
+ * Micro-benchmark of the batched IPv4 mtrie lookups, over a private
+ * mtrie filled with random routes following a full Internet table's
+ * prefix length distribution. Each variant the CPU supports is checked
+ * against the scalar one, then timed.
+ *
+ * @cliexpar
+ * @cliexcmd{test ip mtrie lookup routes 700000 lookups 10000000}
+?*/
+/* *INDENT-OFF* */
+VLIB_CLI_COMMAND (ip4_mtrie_perf_command, static) =
+{
+  .path = "test ip mtrie lookup",
+  .short_help = "test ip mtrie lookup [routes <n>] [lookups <n>] "
+      "[batch <n>] [seed <n>]",
+  .function = ip4_mtrie_perf_command_fn,
+};
+/* *INDENT-ON* */
+
 /** Default heap size for the IPv4 mtries */
 #define IP4_FIB_DEFAULT_MTRIE_HEAP_SIZE (32<<20)
 
@@ -819,6 +1270,8 @@ ip4_mtrie_module_init (vlib_main_t * vm)
   pool_get (ip4_ply_pool, p);
   clib_mem_set_heap (old_heap);
 
+  ip4_fib_mtrie_lookup_batch_fn = ip4_fib_mtrie_lookup_variant_best ()->fn;
+
   return (error);
 }
 
@@ -231,6 +231,20 @@ ip4_fib_mtrie_lookup_step_one (const ip4_fib_mtrie_t * m,
   return next_leaf;
 }
 
+/**
+ * Batched lookup: the load-balance index for each of n destination
+ * addresses (network byte order), each looked up in its own mtrie.
+ */
+typedef void (ip4_fib_mtrie_lookup_batch_fn_t) (ip4_fib_mtrie_t ** mtries,
+						const u32 * dst_addresses,
+						u32 * lb_indices, u32 n);
+
+/**
+ * The batched lookup implementation for this CPU; the AVX512 or AVX2
+ * gather based one where the CPU has it, otherwise the scalar one.
+ */
+extern ip4_fib_mtrie_lookup_batch_fn_t *ip4_fib_mtrie_lookup_batch_fn;
+
 #endif /* included_ip_ip4_fib_h */
 
 /*
@@ -0,0 +1,1280 @@
+/*
+ * Copyright (c) 2018 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file
+ * @brief IPv4 Shallow Virtual Reassembly.
+ *
+ * This file contains the source code for IPv4 shallow virtual reassembly.
+ */
+
+#include <vppinfra/vec.h>
+#include <vnet/vnet.h>
+#include <vnet/ip/ip.h>
+#include <vnet/tcp/tcp_packet.h>
+#include <vnet/udp/udp_packet.h>
+#include <vppinfra/bihash_16_8.h>
+#include <vnet/ip/ip4_sv_reass.h>
+
+#define MSEC_PER_SEC 1000
+#define IP4_SV_REASS_TIMEOUT_DEFAULT_MS 100
+#define IP4_SV_REASS_EXPIRE_WALK_INTERVAL_DEFAULT_MS 10000	// 10 seconds default
+#define IP4_SV_REASS_MAX_REASSEMBLIES_DEFAULT 1024
+#define IP4_SV_REASS_MAX_REASSEMBLY_LENGTH_DEFAULT 3
+#define IP4_SV_REASS_HT_LOAD_FACTOR (0.75)
+#define IP4_SV_REASS_FQ_NELTS 64
+
+static vlib_node_registration_t ip4_sv_reass_node_feature;
+
+typedef struct
+{
+  union
+  {
+    struct
+    {
+      u32 xx_id;
+      ip4_address_t src;
+      ip4_address_t dst;
+      u16 frag_id;
+      u8 proto;
+      u8 unused;
+    };
+    u64 as_u64[2];
+  };
+} ip4_sv_reass_key_t;
+
+typedef struct
+{
+  // hash table key
+  ip4_sv_reass_key_t key;
+  // time when last packet was received
+  f64 last_heard;
+  // internal id of this reassembly
+  u64 id;
+  // set once the first fragment has been seen, the L4 info is then valid
+  u8 is_complete;
+  // L4 info of the first fragment
+  u8 ip_proto;
+  u8 icmp_type_or_tcp_flags;
+  u16 l4_src_port;
+  u16 l4_dst_port;
+  // fragments which arrived before the first one
+  u32 *cached_buffers;
+  // LRU list, the least recently heard from is evicted when the pool is full
+  u32 lru_prev;
+  u32 lru_next;
+} ip4_sv_reass_t;
+
+/*
+ * As for full reassembly, a fragment is handled by the thread owning its
+ * key, so only that thread's data path touches the per-thread data; the
+ * expire walk and the CLI do so with the workers stopped at the barrier.
+ */
+typedef struct
+{
+  clib_bihash_16_8_t hash;
+  ip4_sv_reass_t *pool;
+  u32 reass_n;
+  u32 buffers_n;
+  u32 id_counter;
+  u32 lru_first;
+  u32 lru_last;
+  // buffers and their nexts, built up over a frame
+  u32 *buffers;
+  u16 *nexts;
+} ip4_sv_reass_per_thread_t;
+
+typedef struct
+{
+  // IPv4 config
+  u32 timeout_ms;
+  f64 timeout;
+  u32 expire_walk_interval_ms;
+  u32 max_reass_n;
+  u32 max_reass_len;
+
+  // per-thread data
+  ip4_sv_reass_per_thread_t *per_thread_data;
+
+  // fragments are handled by the workers
+  u32 first_worker_index;
+  u32 num_workers;
+  // frame queue to hand fragments off to the owning thread
+  u32 fq_feature_index;
+
+  // convenience
+  vlib_main_t *vlib_main;
+  vnet_main_t *vnet_main;
+
+  // node index of ip4-drop node
+  u32 ip4_drop_idx;
+  u32 ip4_sv_reass_expire_node_idx;
+
+  // interfaces the feature is enabled on
+  uword *enabled_by_sw_if_index;
+} ip4_sv_reass_main_t;
+
+ip4_sv_reass_main_t ip4_sv_reass_main;
+
+typedef enum
+{
+  IP4_SV_REASSEMBLY_NEXT_DROP,
+  IP4_SV_REASSEMBLY_NEXT_HANDOFF,
+  IP4_SV_REASSEMBLY_N_NEXT,
+} ip4_sv_reass_next_t;
+
+typedef enum
+{
+  REASS_PASSTHROUGH,
+  REASS_FRAGMENT_CACHED,
+  REASS_FRAGMENT_FORWARDED,
+} ip4_sv_reass_trace_operation_e;
+
+typedef struct
+{
+  ip4_sv_reass_trace_operation_e action;
+  u32 reass_id;
+  u8 ip_proto;
+  u8 is_non_first_fragment;
+  u16 l4_src_port;
+  u16 l4_dst_port;
+} ip4_sv_reass_trace_t;
+
+static u8 *
+format_ip4_sv_reass_trace (u8 * s, va_list * args)
+{
+  CLIB_UNUSED (vlib_main_t * vm) = va_arg (*args, vlib_main_t *);
+  CLIB_UNUSED (vlib_node_t * node) = va_arg (*args, vlib_node_t *);
+  ip4_sv_reass_trace_t *t = va_arg (*args, ip4_sv_reass_trace_t *);
+
+  switch (t->action)
+    {
+    case REASS_PASSTHROUGH:
+      s = format (s, "[not-fragmented]");
+      break;
+    case REASS_FRAGMENT_CACHED:
+      s = format (s, "[cached] reass id: %u", t->reass_id);
+      return s;
+    case REASS_FRAGMENT_FORWARDED:
+      s = format (s, "[forwarded] reass id: %u, %s fragment", t->reass_id,
+		  t->is_non_first_fragment ? "non-first" : "first");
+      break;
+    }
+  s = format (s, " proto: %U, src port: %u, dst port: %u",
+	      format_ip_protocol, t->ip_proto,
+	      clib_net_to_host_u16 (t->l4_src_port),
+	      clib_net_to_host_u16 (t->l4_dst_port));
+  return s;
+}
+
+static void
+ip4_sv_reass_add_trace (vlib_main_t * vm, vlib_node_runtime_t * node,
+			ip4_sv_reass_t * reass, vlib_buffer_t * b,
+			ip4_sv_reass_trace_operation_e action)
+{
+  ip4_sv_reass_trace_t *t = vlib_add_trace (vm, node, b, sizeof (*t));
+  vnet_buffer_opaque_t *vnb = vnet_buffer (b);
+
+  t->action = action;
+  t->reass_id = reass ? reass->id : ~0;
+  t->ip_proto = vnb->ip.reass.ip_proto;
+  t->is_non_first_fragment = vnb->ip.reass.is_non_first_fragment;
+  t->l4_src_port = vnb->ip.reass.l4_src_port;
+  t->l4_dst_port = vnb->ip.reass.l4_dst_port;
+}
+
+/**
+ * The size of the L4 header the info is read from, or 0 for a protocol
+ * with no ports.
+ */
+always_inline u16
+ip4_sv_reass_l4_header_bytes (u8 ip_proto)
+{
+  switch (ip_proto)
+    {
+    case IP_PROTOCOL_TCP:
+      return sizeof (tcp_header_t);
+    case IP_PROTOCOL_UDP:
+      return sizeof (udp_header_t);
+    case IP_PROTOCOL_ICMP:
+      return sizeof (icmp46_header_t) + sizeof (u16);
+    }
+  return 0;
+}
+
+/**
+ * Does the packet, bounded by both the buffer and the IP length, hold
+ * the whole L4 header?
+ */
+always_inline int
+ip4_sv_reass_has_l4_header (vlib_buffer_t * b, ip4_header_t * ip)
+{
+  u32 len = clib_min (clib_net_to_host_u16 (ip->length),
+		      b->current_length);
+
+  return (len >= ip4_header_bytes (ip) +
+	  ip4_sv_reass_l4_header_bytes (ip->protocol));
+}
+
+/**
+ * The L4 info of a packet, or of its first fragment. Anything but TCP,
+ * UDP and ICMP (whose echo identifier is used as the source port) has
+ * zero ports, as has a packet too short to hold its L4 header.
+ */
+always_inline void
+ip4_sv_reass_get_l4_info (vlib_buffer_t * b, ip4_header_t * ip,
+			  u8 * icmp_type_or_tcp_flags,
+			  u16 * l4_src_port, u16 * l4_dst_port)
+{
+  void *l4 = ip4_next_header (ip);
+
+  *icmp_type_or_tcp_flags = 0;
+  *l4_src_port = *l4_dst_port = 0;
+
+  if (PREDICT_FALSE (!ip4_sv_reass_has_l4_header (b, ip)))
+    return;
+
+  switch (ip->protocol)
+    {
+    case IP_PROTOCOL_TCP:
+      *icmp_type_or_tcp_flags = ((tcp_header_t *) l4)->flags;
+      *l4_src_port = ((tcp_header_t *) l4)->src_port;
+      *l4_dst_port = ((tcp_header_t *) l4)->dst_port;
+      break;
+    case IP_PROTOCOL_UDP:
+      *l4_src_port = ((udp_header_t *) l4)->src_port;
+      *l4_dst_port = ((udp_header_t *) l4)->dst_port;
+      break;
+    case IP_PROTOCOL_ICMP:
+      *icmp_type_or_tcp_flags = ((icmp46_header_t *) l4)->type;
+      *l4_src_port = ((u16 *) ((icmp46_header_t *) l4 + 1))[0];
+      break;
+    }
+}
+
+always_inline void
+ip4_sv_reass_annotate (vlib_buffer_t * b, ip4_sv_reass_t * reass,
+		       u8 is_non_first_fragment)
+{
+  vnet_buffer_opaque_t *vnb = vnet_buffer (b);
+
+  vnb->ip.reass.ip_proto = reass->ip_proto;
+  vnb->ip.reass.icmp_type_or_tcp_flags = reass->icmp_type_or_tcp_flags;
+  vnb->ip.reass.is_non_first_fragment = is_non_first_fragment;
+  vnb->ip.reass.l4_src_port = reass->l4_src_port;
+  vnb->ip.reass.l4_dst_port = reass->l4_dst_port;
+}
+
+always_inline void
+ip4_sv_reass_lru_remove (ip4_sv_reass_per_thread_t * rt,
+			 ip4_sv_reass_t * reass)
+{
+  if (~0 != reass->lru_prev)
+    pool_elt_at_index (rt->pool, reass->lru_prev)->lru_next = reass->lru_next;
+  else
+    rt->lru_first = reass->lru_next;
+  if (~0 != reass->lru_next)
+    pool_elt_at_index (rt->pool, reass->lru_next)->lru_prev = reass->lru_prev;
+  else
+    rt->lru_last = reass->lru_prev;
+  reass->lru_prev = reass->lru_next = ~0;
+}
+
+always_inline void
+ip4_sv_reass_lru_append (ip4_sv_reass_per_thread_t * rt,
+			 ip4_sv_reass_t * reass)
+{
+  u32 index = reass - rt->pool;
+
+  reass->lru_next = ~0;
+  reass->lru_prev = rt->lru_last;
+  if (~0 != rt->lru_last)
+    pool_elt_at_index (rt->pool, rt->lru_last)->lru_next = index;
+  else
+    rt->lru_first = index;
+  rt->lru_last = index;
+}
+
+/**
+ * Free the reassembly, sending the fragments it still holds to drop
+ * with the given error.
+ */
+always_inline void
+ip4_sv_reass_free (vlib_node_runtime_t * node, ip4_sv_reass_per_thread_t * rt,
+		   ip4_sv_reass_t * reass, u32 error, u32 ** drop_buffers)
+{
+  vlib_main_t *vm = ip4_sv_reass_main.vlib_main;
+  clib_bihash_kv_16_8_t kv;
+  u32 *bi;
+
+  vec_foreach (bi, reass->cached_buffers)
+  {
+    vlib_get_buffer (vm, *bi)->error = node->errors[error];
+    vec_add1 (*drop_buffers, *bi);
+  }
+  ASSERT (rt->buffers_n >= vec_len (reass->cached_buffers));
+  rt->buffers_n -= vec_len (reass->cached_buffers);
+  vec_free (reass->cached_buffers);
+
+  kv.key[0] = reass->key.as_u64[0];
+  kv.key[1] = reass->key.as_u64[1];
+  clib_bihash_add_del_16_8 (&rt->hash, &kv, 0);
+  ip4_sv_reass_lru_remove (rt, reass);
+  pool_put (rt->pool, reass);
+  --rt->reass_n;
+}
+
+/**
+ * The thread which handles the fragments with this key: a hash of the
+ * key spread over the workers, or the main thread when there are none.
+ */
+always_inline u32
+ip4_sv_reass_get_owner_thread (ip4_sv_reass_main_t * rm,
+			       ip4_sv_reass_key_t * k)
+{
+  clib_bihash_kv_16_8_t kv;
+
+  if (PREDICT_FALSE (0 == rm->num_workers))
+    return 0;
+
+  kv.key[0] = k->as_u64[0];
+  kv.key[1] = k->as_u64[1];
+  return rm->first_worker_index +
+    (clib_bihash_hash_16_8 (&kv) >> 32) % rm->num_workers;
+}
+
+always_inline ip4_sv_reass_t *
+ip4_sv_reass_find_or_create (vlib_main_t * vm, vlib_node_runtime_t * node,
+			     ip4_sv_reass_main_t * rm,
+			     ip4_sv_reass_per_thread_t * rt,
+			     ip4_sv_reass_key_t * k, u32 ** drop_buffers)
+{
+  ip4_sv_reass_t *reass = NULL;
+  f64 now = vlib_time_now (vm);
+  clib_bihash_kv_16_8_t kv, value;
+  kv.key[0] = k->as_u64[0];
+  kv.key[1] = k->as_u64[1];
+
+  if (!clib_bihash_search_16_8 (&rt->hash, &kv, &value))
+    {
+      reass = pool_elt_at_index (rt->pool, value.value);
+      if (now > reass->last_heard + rm->timeout)
+	{
+	  ip4_sv_reass_free (node, rt, reass, IP4_ERROR_REASS_TIMEOUT,
+			     drop_buffers);
+	  reass = NULL;
+	}
+    }
+
+  if (reass)
+    {
+      reass->last_heard = now;
+      ip4_sv_reass_lru_remove (rt, reass);
+      ip4_sv_reass_lru_append (rt, reass);
+      return reass;
+    }
+
+  if (0 == rm->max_reass_n)
+    return NULL;
+
+  if (rt->reass_n >= rm->max_reass_n)
+    {
+      /* make room by evicting the least recently heard from */
+      reass = pool_elt_at_index (rt->pool, rt->lru_first);
+      ip4_sv_reass_free (node, rt, reass, IP4_ERROR_SV_REASS_EVICTED,
+			 drop_buffers);
+    }
+
+  pool_get (rt->pool, reass);
+  memset (reass, 0, sizeof (*reass));
+  reass->id = ((u64) vm->thread_index * 1000000000) + rt->id_counter;
+  ++rt->id_counter;
+  ++rt->reass_n;
+  ip4_sv_reass_lru_append (rt, reass);
+
+  reass->key.as_u64[0] = kv.key[0] = k->as_u64[0];
+  reass->key.as_u64[1] = kv.key[1] = k->as_u64[1];
+  kv.value = reass - rt->pool;
+  reass->last_heard = now;
+
+  if (clib_bihash_add_del_16_8 (&rt->hash, &kv, 1))
+    {
+      ip4_sv_reass_free (node, rt, reass, IP4_ERROR_NONE, drop_buffers);
+      reass = NULL;
+    }
+
+  return reass;
+}
+
+always_inline void
+ip4_sv_reass_enqueue (u32 bi, u32 next, ip4_sv_reass_per_thread_t * rt)
+{
+  vec_add1 (rt->buffers, bi);
+  vec_add1 (rt->nexts, next);
+}
+
+/**
+ * Pass the buffer on to the next feature on the arc
+ */
+always_inline void
+ip4_sv_reass_forward (vlib_buffer_t * b, u32 bi,
+		      ip4_sv_reass_per_thread_t * rt)
+{
+  u32 next;
+
+  vnet_feature_next (vnet_buffer (b)->sw_if_index[VLIB_RX], &next, b);
+  ip4_sv_reass_enqueue (bi, next, rt);
+}
+
+static uword
+ip4_sv_reass_feature (vlib_main_t * vm, vlib_node_runtime_t * node,
+		      vlib_frame_t * frame)
+{
+  u32 *from = vlib_frame_vector_args (frame);
+  u32 n_left_from = frame->n_vectors;
+  ip4_sv_reass_main_t *rm = &ip4_sv_reass_main;
+  u32 thread_index = vm->thread_index;
+  ip4_sv_reass_per_thread_t *rt = &rm->per_thread_data[thread_index];
+  static __thread u32 *drop_buffers;
+  u32 n_handoff = 0;
+  u32 *bi;
+
+  vec_reset_length (rt->buffers);
+  vec_reset_length (rt->nexts);
+  vec_reset_length (drop_buffers);
+
+  while (n_left_from > 0)
+    {
+      u32 bi0, error0 = IP4_ERROR_NONE;
+      vlib_buffer_t *b0;
+      ip4_header_t *ip0;
+      ip4_sv_reass_t *reass;
+      ip4_sv_reass_key_t k;
+      u32 owner0;
+
+      bi0 = from[0];
+      b0 = vlib_get_buffer (vm, bi0);
+      ip0 = vlib_buffer_get_current (b0);
+
+      if (!ip4_get_fragment_more (ip0) && !ip4_get_fragment_offset (ip0))
+	{
+	  // this is a whole packet - annotate it from its own header
+	  vnet_buffer_opaque_t *vnb = vnet_buffer (b0);
+	  vnb->ip.reass.ip_proto = ip0->protocol;
+	  vnb->ip.reass.is_non_first_fragment = 0;
+	  ip4_sv_reass_get_l4_info (b0, ip0,
+				    &vnb->ip.reass.icmp_type_or_tcp_flags,
+				    &vnb->ip.reass.l4_src_port,
+				    &vnb->ip.reass.l4_dst_port);
+	  if (PREDICT_FALSE (b0->flags & VLIB_BUFFER_IS_TRACED))
+	    ip4_sv_reass_add_trace (vm, node, NULL, b0, REASS_PASSTHROUGH);
+	  ip4_sv_reass_forward (b0, bi0, rt);
+	  goto next_packet;
+	}
+
+      k.as_u64[0] =
+	(u64) vnet_buffer (b0)->sw_if_index[VLIB_RX] << 32 | (u64)
+	ip0->src_address.as_u32;
+      k.as_u64[1] =
+	(u64) ip0->dst_address.as_u32 << 32 | (u64) ip0->fragment_id << 16 |
+	(u64) ip0->protocol << 8;
+
+      owner0 = ip4_sv_reass_get_owner_thread (rm, &k);
+      if (PREDICT_FALSE (owner0 != thread_index))
+	{
+	  vnet_buffer (b0)->ip.reass.owner_thread_index = owner0;
+	  ip4_sv_reass_enqueue (bi0, IP4_SV_REASSEMBLY_NEXT_HANDOFF, rt);
+	  ++n_handoff;
+	  goto next_packet;
+	}
+
+      reass = ip4_sv_reass_find_or_create (vm, node, rm, rt, &k,
+					   &drop_buffers);
+      if (PREDICT_FALSE (!reass))
+	{
+	  error0 = IP4_ERROR_REASS_LIMIT_REACHED;
+	  goto drop;
+	}
+
+      if (0 == ip4_get_fragment_offset (ip0))
+	{
+	  /* the first fragment must hold the L4 info (RFC 1858) */
+	  if (PREDICT_FALSE (!ip4_sv_reass_has_l4_header (b0, ip0)))
+	    {
+	      error0 = IP4_ERROR_SV_REASS_TINY_FRAGMENT;
+	      goto drop;
+	    }
+	  reass->ip_proto = ip0->protocol;
+	  ip4_sv_reass_get_l4_info (b0, ip0, &reass->icmp_type_or_tcp_flags,
+				    &reass->l4_src_port, &reass->l4_dst_port);
+	  reass->is_complete = 1;
+
+	  ip4_sv_reass_annotate (b0, reass, 0);
+	  if (PREDICT_FALSE (b0->flags & VLIB_BUFFER_IS_TRACED))
+	    ip4_sv_reass_add_trace (vm, node, reass, b0,
+				    REASS_FRAGMENT_FORWARDED);
+	  ip4_sv_reass_forward (b0, bi0, rt);
+
+	  // release the fragments which arrived before this one
+	  vec_foreach (bi, reass->cached_buffers)
+	  {
+	    vlib_buffer_t *b = vlib_get_buffer (vm, *bi);
+	    ip4_sv_reass_annotate (b, reass, 1);
+	    if (PREDICT_FALSE (b->flags & VLIB_BUFFER_IS_TRACED))
+	      ip4_sv_reass_add_trace (vm, node, reass, b,
+				      REASS_FRAGMENT_FORWARDED);
+	    ip4_sv_reass_forward (b, *bi, rt);
+	  }
+	  ASSERT (rt->buffers_n >= vec_len (reass->cached_buffers));
+	  rt->buffers_n -= vec_len (reass->cached_buffers);
+	  vec_reset_length (reass->cached_buffers);
+	}
+      else if (reass->is_complete)
+	{
+	  ip4_sv_reass_annotate (b0, reass, 1);
+	  if (PREDICT_FALSE (b0->flags & VLIB_BUFFER_IS_TRACED))
+	    ip4_sv_reass_add_trace (vm, node, reass, b0,
+				    REASS_FRAGMENT_FORWARDED);
+	  ip4_sv_reass_forward (b0, bi0, rt);
+	}
+      else if (vec_len (reass->cached_buffers) >= rm->max_reass_len)
+	{
+	  ip4_sv_reass_free (node, rt, reass,
+			     IP4_ERROR_SV_REASS_TOO_MANY_FRAGMENTS,
+			     &drop_buffers);
+	  error0 = IP4_ERROR_SV_REASS_TOO_MANY_FRAGMENTS;
+	  goto drop;
+	}
+      else
+	{
+	  if (PREDICT_FALSE (b0->flags & VLIB_BUFFER_IS_TRACED))
+	    ip4_sv_reass_add_trace (vm, node, reass, b0,
+				    REASS_FRAGMENT_CACHED);
+	  vec_add1 (reass->cached_buffers, bi0);
+	  ++rt->buffers_n;
+	}
+      goto next_packet;
+
+    drop:
+      b0->error = node->errors[error0];
+      ip4_sv_reass_enqueue (bi0, IP4_SV_REASSEMBLY_NEXT_DROP, rt);
+
+    next_packet:
+      from += 1;
+      n_left_from -= 1;
+    }
+
+  vec_foreach (bi, drop_buffers)
+    ip4_sv_reass_enqueue (*bi, IP4_SV_REASSEMBLY_NEXT_DROP, rt);
+
+  if (vec_len (rt->buffers))
+    {
+      u32 n_buffers = vec_len (rt->buffers);
+
+      /* vlib_buffer_enqueue_to_next reads a vector's worth past the end */
+      vec_validate (rt->nexts, n_buffers + 31);
+      vlib_buffer_enqueue_to_next (vm, node, rt->buffers, rt->nexts,
+				   n_buffers);
+    }
+
+  if (n_handoff)
+    vlib_node_increment_counter (vm, node->node_index,
+				 IP4_ERROR_REASS_HANDOFF, n_handoff);
+  return frame->n_vectors;
+}
+
+static char *ip4_sv_reass_error_strings[] = {
+#define _(sym, string) string,
+  foreach_ip4_error
+#undef _
+};
+
+/* *INDENT-OFF* */
+VLIB_REGISTER_NODE (ip4_sv_reass_node_feature, static) = {
+    .function = ip4_sv_reass_feature,
+    .name = "ip4-sv-reassembly-feature",
+    .vector_size = sizeof (u32),
+    .format_trace = format_ip4_sv_reass_trace,
+    .n_errors = ARRAY_LEN (ip4_sv_reass_error_strings),
+    .error_strings = ip4_sv_reass_error_strings,
+    .n_next_nodes = IP4_SV_REASSEMBLY_N_NEXT,
+    .next_nodes =
+        {
+                [IP4_SV_REASSEMBLY_NEXT_DROP] = "ip4-drop",
+                [IP4_SV_REASSEMBLY_NEXT_HANDOFF] = "ip4-sv-reassembly-feature-handoff",
+        },
+};
+/* *INDENT-ON* */
+
+VLIB_NODE_FUNCTION_MULTIARCH (ip4_sv_reass_node_feature,
+			      ip4_sv_reass_feature);
+
+/* *INDENT-OFF* */
+VNET_FEATURE_INIT (ip4_sv_reass_feature, static) = {
+    .arc_name = "ip4-unicast",
+    .node_name = "ip4-sv-reassembly-feature",
+    .runs_before = VNET_FEATURES ("ip4-flow-classify",
+                                  "ip4-inacl",
+                                  "ip4-policer-classify",
+                                  "ip4-source-and-port-range-check-rx",
+                                  "ip4-lookup"),
+    .runs_after = 0,
+};
+/* *INDENT-ON* */
+
+typedef struct
+{
+  u32 next_worker_index;
+} ip4_sv_reass_handoff_trace_t;
+
+static u8 *
+format_ip4_sv_reass_handoff_trace (u8 * s, va_list * args)
+{
+  CLIB_UNUSED (vlib_main_t * vm) = va_arg (*args, vlib_main_t *);
+  CLIB_UNUSED (vlib_node_t * node) = va_arg (*args, vlib_node_t *);
+  ip4_sv_reass_handoff_trace_t *t =
+    va_arg (*args, ip4_sv_reass_handoff_trace_t *);
+
+  s = format (s, "ip4-sv-reassembly-handoff: next-worker %d",
+	      t->next_worker_index);
+  return s;
+}
+
+/*
+ * Send the fragments to the thread that owns them, as set by
+ * ip4_sv_reass_feature, a frame queue element per worker. Fragments for
+ * a congested worker are dropped.
+ */
+static uword
+ip4_sv_reass_feature_handoff (vlib_main_t * vm, vlib_node_runtime_t * node,
+			      vlib_frame_t * frame)
+{
+  ip4_sv_reass_main_t *rm = &ip4_sv_reass_main;
+  vlib_thread_main_t *tm = vlib_get_thread_main ();
+  static __thread vlib_frame_queue_elt_t **handoff_queue_elt_by_worker_index;
+  static __thread vlib_frame_queue_t **congested_handoff_queue_by_worker_index
+    = 0;
+  vlib_frame_queue_elt_t *hf = 0;
+  vlib_frame_t *d = 0;
+  u32 n_left_from, *from, *to_next_drop = 0;
+  u32 n_left_to_next_worker = 0, *to_next_worker = 0;
+  u32 current_worker_index = ~0;
+  u32 fq_index = rm->fq_feature_index;
+  u32 n_congested = 0;
+  int i;
+
+  if (PREDICT_FALSE (handoff_queue_elt_by_worker_index == 0))
+    {
+      vec_validate (handoff_queue_elt_by_worker_index, tm->n_vlib_mains - 1);
+
+      vec_validate_init_empty (congested_handoff_queue_by_worker_index,
+			       tm->n_vlib_mains - 1,
+			       (vlib_frame_queue_t *) (~0));
+    }
+
+  from = vlib_frame_vector_args (frame);
+  n_left_from = frame->n_vectors;
+
+  while (n_left_from > 0)
+    {
+      u32 bi0, next_worker_index;
+      vlib_buffer_t *b0;
+
+      bi0 = from[0];
+      from += 1;
+      n_left_from -= 1;
+
+      b0 = vlib_get_buffer (vm, bi0);
+      next_worker_index = vnet_buffer (b0)->ip.reass.owner_thread_index;
+
+      if (next_worker_index != current_worker_index)
+	{
+	  if (is_vlib_frame_queue_congested
+	      (fq_index, next_worker_index, IP4_SV_REASS_FQ_NELTS - 2,
+	       congested_handoff_queue_by_worker_index))
+	    {
+	      if (!d)
+		{
+		  d = vlib_get_frame_to_node (vm, rm->ip4_drop_idx);
+		  to_next_drop = vlib_frame_vector_args (d);
+		}
+	      to_next_drop[0] = bi0;
+	      to_next_drop += 1;
+	      d->n_vectors++;
+	      b0->error = node->errors[IP4_ERROR_REASS_CONGESTION_DROP];
+	      ++n_congested;
+	      goto trace0;
+	    }
+
+	  if (hf)
+	    hf->n_vectors = VLIB_FRAME_SIZE - n_left_to_next_worker;
+
+	  hf = vlib_get_worker_handoff_queue_elt (fq_index,
+						  next_worker_index,
+						  handoff_queue_elt_by_worker_index);
+
+	  n_left_to_next_worker = VLIB_FRAME_SIZE - hf->n_vectors;
+	  to_next_worker = &hf->buffer_index[hf->n_vectors];
+	  current_worker_index = next_worker_index;
+	}
+
+      to_next_worker[0] = bi0;
+      to_next_worker++;
+      n_left_to_next_worker--;
+
+      if (n_left_to_next_worker == 0)
+	{
+	  hf->n_vectors = VLIB_FRAME_SIZE;
+	  vlib_put_frame_queue_elt (hf);
+	  current_worker_index = ~0;
+	  handoff_queue_elt_by_worker_index[next_worker_index] = 0;
+	  hf = 0;
+	}
+
+    trace0:
+      if (PREDICT_FALSE ((node->flags & VLIB_NODE_FLAG_TRACE)
+			 && (b0->flags & VLIB_BUFFER_IS_TRACED)))
+	{
+	  ip4_sv_reass_handoff_trace_t *t =
+	    vlib_add_trace (vm, node, b0, sizeof (*t));
+	  t->next_worker_index = next_worker_index;
+	}
+    }
+
+  if (d)
+    vlib_put_frame_to_node (vm, rm->ip4_drop_idx, d);
+
+  if (hf)
+    hf->n_vectors = VLIB_FRAME_SIZE - n_left_to_next_worker;
+
+  /* Ship frames to the owning threads */
+  for (i = 0; i < vec_len (handoff_queue_elt_by_worker_index); i++)
+    {
+      if (handoff_queue_elt_by_worker_index[i])
+	{
+	  vlib_put_frame_queue_elt (handoff_queue_elt_by_worker_index[i]);
+	  handoff_queue_elt_by_worker_index[i] = 0;
+	}
+      congested_handoff_queue_by_worker_index[i] =
+	(vlib_frame_queue_t *) (~0);
+    }
+
+  if (n_congested)
+    vlib_node_increment_counter (vm, node->node_index,
+				 IP4_ERROR_REASS_CONGESTION_DROP,
+				 n_congested);
+  return frame->n_vectors;
+}
+
+/* *INDENT-OFF* */
+VLIB_REGISTER_NODE (ip4_sv_reass_feature_handoff_node, static) = {
+    .function = ip4_sv_reass_feature_handoff,
+    .name = "ip4-sv-reassembly-feature-handoff",
+    .vector_size = sizeof (u32),
+    .format_trace = format_ip4_sv_reass_handoff_trace,
+    .n_errors = ARRAY_LEN (ip4_sv_reass_error_strings),
+    .error_strings = ip4_sv_reass_error_strings,
+    .n_next_nodes = 1,
+    .next_nodes =
+        {
+                [0] = "ip4-drop",
+        },
+};
+/* *INDENT-ON* */
+
+VLIB_NODE_FUNCTION_MULTIARCH (ip4_sv_reass_feature_handoff_node,
+			      ip4_sv_reass_feature_handoff);
+
+always_inline u32
+ip4_sv_reass_get_nbuckets ()
+{
+  ip4_sv_reass_main_t *rm = &ip4_sv_reass_main;
+  u32 nbuckets;
+  u8 i;
+
+  nbuckets = (u32) (rm->max_reass_n / IP4_SV_REASS_HT_LOAD_FACTOR);
+
+  for (i = 0; i < 31; i++)
+    if ((1 << i) >= nbuckets)
+      break;
+  nbuckets = 1 << i;
+
+  return nbuckets;
+}
+
+typedef enum
+{
+  IP4_SV_EVENT_CONFIG_CHANGED = 1,
+} ip4_sv_reass_event_t;
+
+typedef struct
+{
+  int failure;
+  clib_bihash_16_8_t *new_hash;
+} ip4_sv_rehash_cb_ctx;
+
+static void
+ip4_sv_rehash_cb (clib_bihash_kv_16_8_t * kv, void *_ctx)
+{
+  ip4_sv_rehash_cb_ctx *ctx = _ctx;
+  if (clib_bihash_add_del_16_8 (ctx->new_hash, kv, 1))
+    {
+      ctx->failure = 1;
+    }
+}
+
+static void
+ip4_sv_reass_set_params (u32 timeout_ms, u32 max_reassemblies,
+			 u32 max_reassembly_length,
+			 u32 expire_walk_interval_ms)
+{
+  ip4_sv_reass_main.timeout_ms = timeout_ms;
+  ip4_sv_reass_main.timeout = (f64) timeout_ms / (f64) MSEC_PER_SEC;
+  ip4_sv_reass_main.max_reass_n = max_reassemblies;
+  ip4_sv_reass_main.max_reass_len = max_reassembly_length;
+  ip4_sv_reass_main.expire_walk_interval_ms = expire_walk_interval_ms;
+}
+
+vnet_api_error_t
+ip4_sv_reass_set (u32 timeout_ms, u32 max_reassemblies,
+		  u32 max_reassembly_length, u32 expire_walk_interval_ms)
+{
+  u32 old_nbuckets = ip4_sv_reass_get_nbuckets ();
+  ip4_sv_reass_set_params (timeout_ms, max_reassemblies,
+			   max_reassembly_length, expire_walk_interval_ms);
+  vlib_process_signal_event (ip4_sv_reass_main.vlib_main,
+			     ip4_sv_reass_main.ip4_sv_reass_expire_node_idx,
+			     IP4_SV_EVENT_CONFIG_CHANGED, 0);
+  u32 new_nbuckets = ip4_sv_reass_get_nbuckets ();
+  ip4_sv_reass_per_thread_t *rt;
+  if (ip4_sv_reass_main.max_reass_n > 0 && new_nbuckets > old_nbuckets)
+    {
+      /* *INDENT-OFF* */
+      vec_foreach (rt, ip4_sv_reass_main.per_thread_data)
+      {
+        clib_bihash_16_8_t new_hash;
+        memset (&new_hash, 0, sizeof (new_hash));
+        ip4_sv_rehash_cb_ctx ctx;
+        ctx.failure = 0;
+        ctx.new_hash = &new_hash;
+        clib_bihash_init_16_8 (&new_hash, "ip4-sv-reass", new_nbuckets,
+                               new_nbuckets * 1024);
+        clib_bihash_foreach_key_value_pair_16_8 (&rt->hash, ip4_sv_rehash_cb,
+                                                 &ctx);
+        if (ctx.failure)
+          {
+            clib_bihash_free_16_8 (&new_hash);
+            return -1;
+          }
+        else
+          {
+            clib_bihash_free_16_8 (&rt->hash);
+            clib_memcpy (&rt->hash, &new_hash, sizeof (rt->hash));
+          }
+      }
+      /* *INDENT-ON* */
+    }
+  return 0;
+}
+
+vnet_api_error_t
+ip4_sv_reass_get (u32 * timeout_ms, u32 * max_reassemblies,
+		  u32 * max_reassembly_length, u32 * expire_walk_interval_ms)
+{
+  *timeout_ms = ip4_sv_reass_main.timeout_ms;
+  *max_reassemblies = ip4_sv_reass_main.max_reass_n;
+  *max_reassembly_length = ip4_sv_reass_main.max_reass_len;
+  *expire_walk_interval_ms = ip4_sv_reass_main.expire_walk_interval_ms;
+  return 0;
+}
+
+static clib_error_t *
+ip4_sv_reass_init_function (vlib_main_t * vm)
+{
+  ip4_sv_reass_main_t *rm = &ip4_sv_reass_main;
+  vlib_thread_main_t *tm = vlib_get_thread_main ();
+  vlib_thread_registration_t *tr;
+  clib_error_t *error = 0;
+  u32 nbuckets;
+  vlib_node_t *node;
+  uword *p;
+
+  if ((error = vlib_call_init_function (vm, threads_init)))
+    return error;
+
+  rm->vlib_main = vm;
+  rm->vnet_main = vnet_get_main ();
+
+  ip4_sv_reass_set_params (IP4_SV_REASS_TIMEOUT_DEFAULT_MS,
+			   IP4_SV_REASS_MAX_REASSEMBLIES_DEFAULT,
+			   IP4_SV_REASS_MAX_REASSEMBLY_LENGTH_DEFAULT,
+			   IP4_SV_REASS_EXPIRE_WALK_INTERVAL_DEFAULT_MS);
+
+  nbuckets = ip4_sv_reass_get_nbuckets ();
+  vec_validate (rm->per_thread_data, vlib_num_workers () + 1);
+  ip4_sv_reass_per_thread_t *rt;
+  vec_foreach (rt, rm->per_thread_data)
+  {
+    clib_bihash_init_16_8 (&rt->hash, "ip4-sv-reass", nbuckets,
+			   nbuckets * 1024);
+    pool_alloc (rt->pool, rm->max_reass_n);
+    rt->lru_first = rt->lru_last = ~0;
+  }
+
+  p = hash_get_mem (tm->thread_registrations_by_name, "workers");
+  if (p)
+    {
+      tr = (vlib_thread_registration_t *) p[0];
+      rm->num_workers = tr->count;
+      rm->first_worker_index = tr->first_index;
+    }
+  if (rm->num_workers)
+    rm->fq_feature_index =
+      vlib_frame_queue_main_init (ip4_sv_reass_node_feature.index,
+				  IP4_SV_REASS_FQ_NELTS);
+
+  node = vlib_get_node_by_name (vm, (u8 *) "ip4-sv-reassembly-expire-walk");
+  ASSERT (node);
+  rm->ip4_sv_reass_expire_node_idx = node->index;
+
+  node = vlib_get_node_by_name (vm, (u8 *) "ip4-drop");
+  ASSERT (node);
+  rm->ip4_drop_idx = node->index;
+
+  return error;
+}
+
+VLIB_INIT_FUNCTION (ip4_sv_reass_init_function);
+
+static uword
+ip4_sv_reass_walk_expired (vlib_main_t * vm,
+			   vlib_node_runtime_t * node, vlib_frame_t * f)
+{
+  ip4_sv_reass_main_t *rm = &ip4_sv_reass_main;
+  uword event_type, *event_data = 0;
+  u32 *drop_buffers = NULL;
+  int *pool_indexes_to_free = NULL;
+
+  while (true)
+    {
+      vlib_process_wait_for_event_or_clock (vm,
+					    (f64) rm->expire_walk_interval_ms
+					    / (f64) MSEC_PER_SEC);
+      event_type = vlib_process_get_events (vm, &event_data);
+
+      switch (event_type)
+	{
+	case ~0:		/* no events => timeout */
+	  /* nothing to do here */
+	  break;
+	case IP4_SV_EVENT_CONFIG_CHANGED:
+	  break;
+	default:
+	  clib_warning ("BUG: event type 0x%wx", event_type);
+	  break;
+	}
+      f64 now = vlib_time_now (vm);
+
+      ip4_sv_reass_t *reass;
+      uword thread_index = 0;
+      int index, *i;
+      const uword nthreads = os_get_nthreads ();
+      bool barrier = false;
+      for (thread_index = 0; thread_index < nthreads; ++thread_index)
+	{
+	  ip4_sv_reass_per_thread_t *rt = &rm->per_thread_data[thread_index];
+	  /* nothing to expire, leave the workers running */
+	  if (0 == rt->reass_n)
+	    continue;
+	  if (!barrier)
+	    {
+	      vlib_worker_thread_barrier_sync (vm);
+	      barrier = true;
+	    }
+
+	  vec_reset_length (pool_indexes_to_free);
+          /* *INDENT-OFF* */
+          pool_foreach_index (index, rt->pool, ({
+                                reass = pool_elt_at_index (rt->pool, index);
+                                if (now > reass->last_heard + rm->timeout)
+                                  {
+                                    vec_add1 (pool_indexes_to_free, index);
+                                  }
+                              }));
+          vec_foreach (i, pool_indexes_to_free)
+          {
+            reass = pool_elt_at_index (rt->pool, i[0]);
+            ip4_sv_reass_free (node, rt, reass, IP4_ERROR_REASS_TIMEOUT,
+                               &drop_buffers);
+          }
+          /* *INDENT-ON* */
+	}
+      if (barrier)
+	vlib_worker_thread_barrier_release (vm);
+
+      while (vec_len (drop_buffers) > 0)
+	{
+	  vlib_frame_t *f = vlib_get_frame_to_node (vm, rm->ip4_drop_idx);
+	  u32 *to_next = vlib_frame_vector_args (f);
+	  u32 n_left_to_next = VLIB_FRAME_SIZE - f->n_vectors;
+	  while (vec_len (drop_buffers) > 0 && n_left_to_next > 0)
+	    {
+	      to_next[0] = vec_pop (drop_buffers);
+	      ++f->n_vectors;
+	      to_next += 1;
+	      n_left_to_next -= 1;
+	    }
+	  vlib_put_frame_to_node (vm, rm->ip4_drop_idx, f);
+	}
+
+      if (event_data)
+	{
+	  _vec_len (event_data) = 0;
+	}
+    }
+
+  return 0;
+}
+
+static vlib_node_registration_t ip4_sv_reass_expire_node;
+
+/* *INDENT-OFF* */
+VLIB_REGISTER_NODE (ip4_sv_reass_expire_node, static) = {
+    .function = ip4_sv_reass_walk_expired,
+    .type = VLIB_NODE_TYPE_PROCESS,
+    .name = "ip4-sv-reassembly-expire-walk",
+    .format_trace = format_ip4_sv_reass_trace,
+    .n_errors = ARRAY_LEN (ip4_sv_reass_error_strings),
+    .error_strings = ip4_sv_reass_error_strings,
+};
+/* *INDENT-ON* */
+
+static u8 *
+format_ip4_sv_reass_key (u8 * s, va_list * args)
+{
+  ip4_sv_reass_key_t *key = va_arg (*args, ip4_sv_reass_key_t *);
+  s = format (s, "xx_id: %u, src: %U, dst: %U, frag_id: %u, proto: %u",
+	      key->xx_id, format_ip4_address, &key->src, format_ip4_address,
+	      &key->dst, clib_net_to_host_u16 (key->frag_id), key->proto);
+  return s;
+}
+
+static u8 *
+format_ip4_sv_reass (u8 * s, va_list * args)
+{
+  ip4_sv_reass_t *reass = va_arg (*args, ip4_sv_reass_t *);
+
+  s = format (s, "ID: %lu, key: %U\n  cached buffers: %u",
+	      reass->id, format_ip4_sv_reass_key, &reass->key,
+	      vec_len (reass->cached_buffers));
+  if (reass->is_complete)
+    s = format (s, ", proto: %U, src port: %u, dst port: %u",
+		format_ip_protocol, reass->ip_proto,
+		clib_net_to_host_u16 (reass->l4_src_port),
+		clib_net_to_host_u16 (reass->l4_dst_port));
+  return s;
+}
+
+static clib_error_t *
+show_ip4_sv_reass (vlib_main_t * vm, unformat_input_t * input,
+		   CLIB_UNUSED (vlib_cli_command_t * lmd))
+{
+  ip4_sv_reass_main_t *rm = &ip4_sv_reass_main;
+
+  vlib_cli_output (vm, "---------------------");
+  vlib_cli_output (vm, "IP4 shallow virtual reassembly status");
+  vlib_cli_output (vm, "---------------------");
+  bool details = false;
+  if (unformat (input, "details"))
+    {
+      details = true;
+    }
+
+  u32 sum_reass_n = 0;
+  u64 sum_buffers_n = 0;
+  ip4_sv_reass_t *reass;
+  uword thread_index;
+  const uword nthreads = os_get_nthreads ();
+  for (thread_index = 0; thread_index < nthreads; ++thread_index)
+    {
+      ip4_sv_reass_per_thread_t *rt = &rm->per_thread_data[thread_index];
+      if (details)
+	{
+          /* *INDENT-OFF* */
+          pool_foreach (reass, rt->pool, {
+            vlib_cli_output (vm, "%U", format_ip4_sv_reass, reass);
+          });
+          /* *INDENT-ON* */
+	}
+      sum_reass_n += rt->reass_n;
+      sum_buffers_n += rt->buffers_n;
+    }
+  vlib_cli_output (vm, "---------------------");
+  vlib_cli_output (vm, "Current IP4 reassemblies count: %lu\n",
+		   (long unsigned) sum_reass_n);
+  vlib_cli_output (vm,
+		   "Maximum configured concurrent IP4 reassemblies per worker-thread: %lu\n",
+		   (long unsigned) rm->max_reass_n);
+  vlib_cli_output (vm,
+		   "Maximum configured fragments cached per reassembly: %lu\n",
+		   (long unsigned) rm->max_reass_len);
+  vlib_cli_output (vm, "Buffers in use: %lu\n",
+		   (long unsigned) sum_buffers_n);
+  return 0;
+}
+
+/*?
+ * Show the shallow virtual reassemblies in progress and the
+ * configuration.
+ *
+ * @cliexpar
+ * @cliexcmd{show ip4-sv-reassembly details}
+?*/
+/* *INDENT-OFF* */
+VLIB_CLI_COMMAND (show_ip4_sv_reass_cmd, static) = {
+    .path = "show ip4-sv-reassembly",
+    .short_help = "show ip4-sv-reassembly [details]",
+    .function = show_ip4_sv_reass,
+};
+/* *INDENT-ON* */
+
+static clib_error_t *
+set_ip4_sv_reass (vlib_main_t * vm, unformat_input_t * input,
+		  CLIB_UNUSED (vlib_cli_command_t * lmd))
+{
+  ip4_sv_reass_main_t *rm = &ip4_sv_reass_main;
+  u32 timeout_ms = rm->timeout_ms;
+  u32 max_reass_n = rm->max_reass_n;
+  u32 max_reass_len = rm->max_reass_len;
+  u32 expire_walk_interval_ms = rm->expire_walk_interval_ms;
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "timeout %u", &timeout_ms))
+	;
+      else if (unformat (input, "max-reassemblies %u", &max_reass_n))
+	;
+      else if (unformat (input, "max-reassembly-length %u", &max_reass_len))
+	;
+      else if (unformat (input, "expire-walk-interval %u",
+			 &expire_walk_interval_ms))
+	;
+      else
+	return clib_error_return (0, "unknown input `%U'",
+				  format_unformat_error, input);
+    }
+
+  if (ip4_sv_reass_set (timeout_ms, max_reass_n, max_reass_len,
+			expire_walk_interval_ms))
+    return clib_error_return (0, "failed to resize the reassembly tables");
+  return 0;
+}
+
+/*?
+ * Configure shallow virtual reassembly: the time in milliseconds a
+ * reassembly is kept after its last fragment, the number of concurrent
+ * reassemblies per thread, the number of fragments cached per reassembly
+ * while waiting for the first one, and how often, in milliseconds, the
+ * reassemblies are scanned for expiry.
+ *
+ * @cliexpar
+ * @cliexcmd{set ip4-sv-reassembly timeout 200 max-reassembly-length 8}
+?*/
+/* *INDENT-OFF* */
+VLIB_CLI_COMMAND (set_ip4_sv_reass_cmd, static) = {
+    .path = "set ip4-sv-reassembly",
+    .short_help = "set ip4-sv-reassembly [timeout <ms>] "
+                  "[max-reassemblies <n>] [max-reassembly-length <n>] "
+                  "[expire-walk-interval <ms>]",
+    .function = set_ip4_sv_reass,
+};
+/* *INDENT-ON* */
+
+static clib_error_t *
+set_interface_ip4_sv_reass (vlib_main_t * vm, unformat_input_t * input,
+			    CLIB_UNUSED (vlib_cli_command_t * lmd))
+{
+  vnet_main_t *vnm = vnet_get_main ();
+  u32 sw_if_index = ~0;
+  u8 enable = 1;
+  int rv;
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "%U", unformat_vnet_sw_interface, vnm,
+		    &sw_if_index))
+	;
+      else if (unformat (input, "disable"))
+	enable = 0;
+      else
+	return clib_error_return (0, "unknown input `%U'",
+				  format_unformat_error, input);
+    }
+
+  if (~0 == sw_if_index)
+    return clib_error_return (0, "interface required");
+
+  rv = ip4_sv_reass_enable_disable (sw_if_index, enable);
+  if (rv)
+    return clib_error_return (0, "failed: %U", format_vnet_api_errno, rv);
+  return 0;
+}
+
+/*?
+ * Enable or disable shallow virtual reassembly of the IPv4 packets
+ * received on an interface. The features which run after it may then
+ * use the L4 info in the buffer metadata of every fragment.
+ *
+ * @cliexpar
+ * @cliexcmd{set interface ip4-sv-reassembly GigabitEthernet2/0/0}
+?*/
+/* *INDENT-OFF* */
+VLIB_CLI_COMMAND (set_interface_ip4_sv_reass_cmd, static) = {
+    .path = "set interface ip4-sv-reassembly",
+    .short_help = "set interface ip4-sv-reassembly <interface> [disable]",
+    .function = set_interface_ip4_sv_reass,
+};
+/* *INDENT-ON* */
+
+vnet_api_error_t
+ip4_sv_reass_enable_disable (u32 sw_if_index, u8 enable_disable)
+{
+  ip4_sv_reass_main_t *rm = &ip4_sv_reass_main;
+  int rv;
+
+  rv = vnet_feature_enable_disable ("ip4-unicast",
+				    "ip4-sv-reassembly-feature",
+				    sw_if_index, enable_disable, 0, 0);
+  if (0 == rv)
+    rm->enabled_by_sw_if_index =
+      clib_bitmap_set (rm->enabled_by_sw_if_index, sw_if_index,
+		       enable_disable);
+  return rv;
+}
+
+int
+ip4_sv_reass_is_enabled (u32 sw_if_index)
+{
+  return clib_bitmap_get (ip4_sv_reass_main.enabled_by_sw_if_index,
+			  sw_if_index);
+}
+
+/*
+ * fd.io coding-style-patch-verification: ON
+ *
+ * Local Variables:
+ * eval: (c-set-style "gnu")
+ * End:
+ */
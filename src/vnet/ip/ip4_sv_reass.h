@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2018 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file
+ * @brief IPv4 Shallow Virtual Reassembly.
+ *
+ * Shallow virtual reassembly does not reassemble. It remembers the L4
+ * info (protocol, ports, TCP flags/ICMP type) of the first fragment of a
+ * packet and writes it to the buffer metadata of each of its fragments,
+ * see vnet_buffer(b)->ip.reass, so that the features after it can treat
+ * non-first fragments like the first one. Fragments which arrive before
+ * the first are held, up to a configured number per packet.
+ */
+
+#ifndef __included_ip4_sv_reass_h__
+#define __included_ip4_sv_reass_h__
+
+#include <vnet/api_errno.h>
+#include <vnet/vnet.h>
+#include <vnet/buffer.h>
+#include <vnet/ip/ip4_packet.h>
+
+/**
+ * @brief set ip4 shallow virtual reassembly configuration
+ */
+vnet_api_error_t ip4_sv_reass_set (u32 timeout_ms, u32 max_reassemblies,
+				   u32 max_reassembly_length,
+				   u32 expire_walk_interval_ms);
+
+/**
+ * @brief get ip4 shallow virtual reassembly configuration
+ */
+vnet_api_error_t ip4_sv_reass_get (u32 * timeout_ms, u32 * max_reassemblies,
+				   u32 * max_reassembly_length,
+				   u32 * expire_walk_interval_ms);
+
+vnet_api_error_t ip4_sv_reass_enable_disable (u32 sw_if_index,
+					      u8 enable_disable);
+
+/**
+ * @brief is shallow virtual reassembly enabled on the interface
+ */
+int ip4_sv_reass_is_enabled (u32 sw_if_index);
+
+/**
+ * @brief The ports of the first fragment of a TCP or UDP non-first
+ * fragment, in network byte order: ports[0] is the source port and
+ * ports[1] the destination.
+ *
+ * Only for a packet received on the ip4-unicast arc, by the features
+ * which run after ip4-sv-reassembly-feature and before those that use
+ * the l2_classify metadata, which shares its space with the annotation.
+ * Returns 0 if the packet is not such a fragment, or was not annotated.
+ */
+always_inline int
+ip4_sv_reass_get_l4_ports (vlib_buffer_t * b, ip4_header_t * ip,
+			   u16 * ports)
+{
+  vnet_buffer_opaque_t *vnb = vnet_buffer (b);
+
+  if (PREDICT_TRUE (0 == ip4_get_fragment_offset (ip)))
+    return 0;
+  if (!vnb->ip.reass.is_non_first_fragment ||
+      vnb->ip.reass.ip_proto != ip->protocol ||
+      (IP_PROTOCOL_TCP != ip->protocol && IP_PROTOCOL_UDP != ip->protocol)
+      || !ip4_sv_reass_is_enabled (vnb->sw_if_index[VLIB_RX]))
+    return 0;
+
+  ports[0] = vnb->ip.reass.l4_src_port;
+  ports[1] = vnb->ip.reass.l4_dst_port;
+  return 1;
+}
+
+#endif /* __included_ip4_sv_reass_h__ */
+
+/*
+ * fd.io coding-style-patch-verification: ON
+ *
+ * Local Variables:
+ * eval: (c-set-style "gnu")
+ * End:
+ */
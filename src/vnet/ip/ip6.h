@@ -74,6 +74,12 @@ typedef struct
 
   /* Index into FIB vector. */
   u32 index;
+
+  /**
+   * The mtrie used for forwarding lookups instead of the shared hash,
+   * when the table has been switched to it; NULL otherwise.
+   */
+  struct ip6_fib_mtrie_t_ *mtrie;
 } ip6_fib_t;
 
 typedef struct ip6_mfib_t
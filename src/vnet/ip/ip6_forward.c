@@ -1173,6 +1173,7 @@ ip6_local_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 				  VNET_BUFFER_F_L4_CHECKSUM_COMPUTED)))
 	    {
 	      flags0 = ip6_tcp_udp_icmp_validate_checksum (vm, p0);
+	      ip_sw_csum_count (vm, IP_SW_CSUM_IP6_LOCAL, 1);
 	      good_l4_csum0 =
 		(flags0 & VNET_BUFFER_F_L4_CHECKSUM_CORRECT) != 0;
 	    }
@@ -1182,6 +1183,7 @@ ip6_local_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 				  VNET_BUFFER_F_L4_CHECKSUM_COMPUTED)))
 	    {
 	      flags1 = ip6_tcp_udp_icmp_validate_checksum (vm, p1);
+	      ip_sw_csum_count (vm, IP_SW_CSUM_IP6_LOCAL, 1);
 	      good_l4_csum1 =
 		(flags1 & VNET_BUFFER_F_L4_CHECKSUM_CORRECT) != 0;
 	    }
@@ -1315,6 +1317,7 @@ ip6_local_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 				  VNET_BUFFER_F_L4_CHECKSUM_COMPUTED)))
 	    {
 	      flags0 = ip6_tcp_udp_icmp_validate_checksum (vm, p0);
+	      ip_sw_csum_count (vm, IP_SW_CSUM_IP6_LOCAL, 1);
 	      good_l4_csum0 =
 		(flags0 & VNET_BUFFER_F_L4_CHECKSUM_CORRECT) != 0;
 	    }
@@ -1561,6 +1564,10 @@ ip6_mtu_check (vlib_buffer_t * b, u16 packet_bytes,
 	       u16 adj_packet_bytes, bool is_locally_generated,
 	       u32 * next, u32 * error)
 {
+  /* a GSO packet is checked by the size of its segments */
+  if (PREDICT_FALSE (b->flags & VNET_BUFFER_F_GSO))
+    packet_bytes = gso_mtu_sz (b);
+
   if (adj_packet_bytes >= 1280 && packet_bytes > adj_packet_bytes)
     {
       if (is_locally_generated)
@@ -42,6 +42,7 @@
 
 #include <vnet/fib/ip6_fib.h>
 #include <vnet/dpo/load_balance_map.h>
+#include <vnet/ip/ip_flow_cache.h>
 
 /**
  * @file
@@ -303,6 +304,10 @@ ip6_lookup_inline (vlib_main_t * vm,
   if (node->flags & VLIB_NODE_FLAG_TRACE)
     ip6_forward_next_trace (vm, node, frame, VLIB_TX);
 
+  if (PREDICT_FALSE (ip_flow_cache_is_learning (thread_index)))
+    ip6_flow_cache_learn (vm, vlib_frame_vector_args (frame),
+			  frame->n_vectors);
+
   return frame->n_vectors;
 }
 
@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2018 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef included_ip_ip6_mtrie_h
+#define included_ip_ip6_mtrie_h
+
+#include <vppinfra/cache.h>
+#include <vppinfra/vector.h>
+#include <vppinfra/pool.h>
+#include <vnet/ip/ip6_packet.h>	/* for ip6_address_t */
+
+/*
+ * ip6 fib leafs: a 16-8-8-...-8 mtrie, i.e. a 16 bit root ply and up to
+ * 14 8 bit plies below it, so a lookup is at most 15 memory accesses
+ * whatever the number of distinct prefix lengths in the table.
+ * The leaf encoding is the same as the ip4 mtrie's:
+ *   1 + 2*lb_index for terminal leaves.
+ *   0 + 2*next_ply_index for non-terminals, i.e. PLYs
+ *   1 => empty (load-balance index of zero is special miss).
+ */
+typedef u32 ip6_fib_mtrie_leaf_t;
+
+#define IP6_FIB_MTRIE_LEAF_EMPTY (1 + 2*0)
+
+/**
+ * @brief the 16 way stride that is the top PLY of the mtrie
+ */
+#define IP6_PLY_16_SIZE (1<<16)
+typedef struct ip6_fib_mtrie_16_ply_t_
+{
+  /**
+   * The leaves/slots/buckets to be filed with leafs
+   */
+  union
+  {
+    ip6_fib_mtrie_leaf_t leaves[IP6_PLY_16_SIZE];
+
+#ifdef CLIB_HAVE_VEC128
+    u32x4 leaves_as_u32x4[IP6_PLY_16_SIZE / 4];
+#endif
+  };
+
+  /**
+   * Prefix length for terminal leaves.
+   */
+  u8 dst_address_bits_of_leaves[IP6_PLY_16_SIZE];
+} ip6_fib_mtrie_16_ply_t;
+
+/**
+ * @brief One 8 bit ply of the mtrie.
+ */
+typedef struct ip6_fib_mtrie_8_ply_t_
+{
+  /**
+   * The leaves/slots/buckets to be filed with leafs
+   */
+  union
+  {
+    ip6_fib_mtrie_leaf_t leaves[256];
+
+#ifdef CLIB_HAVE_VEC128
+    u32x4 leaves_as_u32x4[256 / 4];
+#endif
+  };
+
+  /**
+   * Prefix length for leaves/ply.
+   */
+  u8 dst_address_bits_of_leaves[256];
+
+  /**
+   * Number of non-empty leafs (whether terminal or not).
+   */
+  i32 n_non_empty_leafs;
+
+  /**
+   * The length of the ply's covering prefix. Also a measure of its depth
+   * If a leaf in a slot has a mask length longer than this then it is
+   * 'non-empty'. Otherwise it is the value of the cover.
+   */
+  i32 dst_address_bits_base;
+
+  /* Pad to cache line boundary. */
+  u8 pad[CLIB_CACHE_LINE_BYTES - 2 * sizeof (i32)];
+}
+ip6_fib_mtrie_8_ply_t;
+
+STATIC_ASSERT (0 == sizeof (ip6_fib_mtrie_8_ply_t) % CLIB_CACHE_LINE_BYTES,
+	       "IP6 Mtrie ply cache line");
+
+/**
+ * @brief The mutiway-TRIE.
+ * Unlike the ip4 mtrie it is not embedded in the FIB, since it is only
+ * built for the tables that ask for it.
+ */
+typedef struct ip6_fib_mtrie_t_
+{
+  ip6_fib_mtrie_16_ply_t root_ply;
+} ip6_fib_mtrie_t;
+
+/**
+ * @brief Allocate and initialise an empty mtrie
+ */
+ip6_fib_mtrie_t *ip6_mtrie_alloc (void);
+
+/**
+ * @brief Free an mtrie and all the plies it still holds
+ */
+void ip6_mtrie_free (ip6_fib_mtrie_t * m);
+
+/**
+ * @brief Add a route/entry to the mtrie
+ */
+void ip6_fib_mtrie_route_add (ip6_fib_mtrie_t * m,
+			      const ip6_address_t * dst_address,
+			      u32 dst_address_length, u32 adj_index);
+/**
+ * @brief remove a route/entry from the mtrie
+ */
+void ip6_fib_mtrie_route_del (ip6_fib_mtrie_t * m,
+			      const ip6_address_t * dst_address,
+			      u32 dst_address_length,
+			      u32 adj_index,
+			      u32 cover_address_length, u32 cover_adj_index);
+
+/**
+ * @brief return the memory used by the table
+ */
+uword ip6_fib_mtrie_memory_usage (ip6_fib_mtrie_t * m);
+
+/**
+ * @brief Format/display the mtrie's size
+ */
+format_function_t format_ip6_fib_mtrie;
+
+/**
+ * @brief Batched lookup: the load-balance index for each of n
+ * destination addresses, each looked up in its own mtrie. The
+ * lookups proceed a ply at a time across the batch so the misses
+ * of different addresses overlap.
+ */
+void ip6_fib_mtrie_lookup_batch (ip6_fib_mtrie_t ** mtries,
+				 const ip6_address_t * dst_addresses,
+				 u32 * lb_indices, u32 n);
+
+/**
+ * @brief A global pool of 8bit stride plys
+ */
+extern ip6_fib_mtrie_8_ply_t *ip6_ply_pool;
+
+/**
+ * Is the leaf terminal (i.e. an LB index) or non-terminal (i.e. a PLY index)
+ */
+always_inline u32
+ip6_fib_mtrie_leaf_is_terminal (ip6_fib_mtrie_leaf_t n)
+{
+  return n & 1;
+}
+
+/**
+ * From the stored slot value extract the LB index value
+ */
+always_inline u32
+ip6_fib_mtrie_leaf_get_adj_index (ip6_fib_mtrie_leaf_t n)
+{
+  ASSERT (ip6_fib_mtrie_leaf_is_terminal (n));
+  return n >> 1;
+}
+
+/**
+ * @brief Lookup step.  Processes 1 byte of the 16 byte ip6 address.
+ */
+always_inline ip6_fib_mtrie_leaf_t
+ip6_fib_mtrie_lookup_step (ip6_fib_mtrie_leaf_t current_leaf,
+			   const ip6_address_t * dst_address,
+			   u32 dst_address_byte_index)
+{
+  ip6_fib_mtrie_8_ply_t *ply;
+
+  if (!ip6_fib_mtrie_leaf_is_terminal (current_leaf))
+    {
+      ply = ip6_ply_pool + (current_leaf >> 1);
+      return (ply->leaves[dst_address->as_u8[dst_address_byte_index]]);
+    }
+
+  return current_leaf;
+}
+
+/**
+ * @brief Lookup step number 1.  Processes 2 bytes of the ip6 address.
+ */
+always_inline ip6_fib_mtrie_leaf_t
+ip6_fib_mtrie_lookup_step_one (const ip6_fib_mtrie_t * m,
+			       const ip6_address_t * dst_address)
+{
+  return (m->root_ply.leaves[dst_address->as_u16[0]]);
+}
+
+/**
+ * @brief Longest prefix match of the address; returns the LB index
+ */
+always_inline u32
+ip6_fib_mtrie_lookup (const ip6_fib_mtrie_t * m,
+		      const ip6_address_t * dst_address)
+{
+  ip6_fib_mtrie_leaf_t leaf;
+  u32 i;
+
+  leaf = ip6_fib_mtrie_lookup_step_one (m, dst_address);
+
+  /* the last ply, byte 15, only holds terminal leaves */
+  for (i = 2; !ip6_fib_mtrie_leaf_is_terminal (leaf); i++)
+    leaf = ip6_fib_mtrie_lookup_step (leaf, dst_address, i);
+
+  return (ip6_fib_mtrie_leaf_get_adj_index (leaf));
+}
+
+#endif /* included_ip_ip6_mtrie_h */
+
+/*
+ * fd.io coding-style-patch-verification: ON
+ *
+ * Local Variables:
+ * eval: (c-set-style "gnu")
+ * End:
+ */
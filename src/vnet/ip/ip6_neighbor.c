@@ -19,6 +19,7 @@
 #include <vnet/ip/ip6_neighbor.h>
 #include <vnet/ethernet/ethernet.h>
 #include <vppinfra/mhash.h>
+#include <vppinfra/bihash_24_8.h>
 #include <vnet/adj/adj.h>
 #include <vnet/adj/adj_mcast.h>
 #include <vnet/fib/fib_table.h>
@@ -177,6 +178,24 @@ typedef struct
 } pending_resolution_t;
 
 
+/**
+ * @brief Neighbor table counters, shown by 'show ip6 neighbors summary'
+ */
+typedef struct ip6_neighbor_counters_t_
+{
+  /** Entries created */
+  u64 n_added;
+  /** Neighbors sent to the main thread to learn, and in how many batches */
+  u64 n_learns;
+  u64 n_learn_batches;
+  /** Dynamic entries removed to make room for new ones at the limit */
+  u64 n_recycled;
+  /** New entries refused at the limit, having found none to recycle */
+  u64 n_limit_drops;
+  /** Dynamic entries removed by the age scan */
+  u64 n_aged;
+} ip6_neighbor_counters_t;
+
 typedef struct
 {
   /* Hash tables mapping name to opcode. */
@@ -194,7 +213,10 @@ typedef struct
 
   ip6_neighbor_t *neighbor_pool;
 
-  mhash_t neighbor_index_by_key;
+  /**
+   * Indices of the neighbors keyed by ip6_neighbor_key_t
+   */
+  clib_bihash_24_8_t neighbor_db;
 
   u32 *if_radv_pool_index_by_sw_if_index;
 
@@ -204,6 +226,23 @@ typedef struct
   u32 limit_neighbor_cache_size;
   u32 neighbor_delete_rotor;
 
+  /**
+   * Dynamic entries not refreshed for this many seconds are removed.
+   * Zero disables aging.
+   */
+  u32 neighbor_age;
+
+  /** The age scan's position in the neighbor pool */
+  u32 neighbor_age_rotor;
+
+  /**
+   * Per-thread batch of neighbors learned by the ND nodes, sent to the
+   * main thread in one RPC at the end of each frame.
+   */
+  u8 **learn_batch_by_thread;
+
+  ip6_neighbor_counters_t counters;
+
   /* Wildcard nd report publisher */
   uword wc_ip6_nd_publisher_node;
   uword wc_ip6_nd_publisher_et;
@@ -407,6 +446,30 @@ typedef struct
   ip6_address_t addr;
 } ip6_neighbor_set_unset_rpc_args_t;
 
+/**
+ * @brief A batch of neighbor RPCs that the main thread applies under one
+ * barrier sync.
+ */
+typedef struct ip6_neighbor_rpc_batch_t_
+{
+  u32 n_args;
+  ip6_neighbor_set_unset_rpc_args_t args[0];
+} ip6_neighbor_rpc_batch_t;
+
+/**
+ * Number of seconds between age scans
+ */
+#define IP6_NEIGHBOR_AGE_SCAN_INTERVAL 1.0
+
+/**
+ * The least number of pool slots each age scan visits. More are visited
+ * when needed to scan the whole pool once per age period.
+ */
+#define IP6_NEIGHBOR_AGE_SCAN_MIN 1024
+
+#define IP6_NEIGHBOR_DB_N_BUCKETS (64 * 1024)
+#define IP6_NEIGHBOR_DB_MEMORY_SIZE (64 << 20)
+
 static void ip6_neighbor_set_unset_rpc_callback
   (ip6_neighbor_set_unset_rpc_args_t * a);
 
@@ -532,23 +595,62 @@ ip6_nd_mk_incomplete (adj_index_t ai)
     k.pad = 0;				     \
 }
 
+static inline void
+ip6_neighbor_db_mk_key (clib_bihash_kv_24_8_t * kv,
+			const ip6_neighbor_key_t * k)
+{
+  STATIC_ASSERT_SIZEOF (ip6_neighbor_key_t, sizeof (kv->key));
+
+  kv->key[0] = k->ip6_address.as_u64[0];
+  kv->key[1] = k->ip6_address.as_u64[1];
+  kv->key[2] = k->sw_if_index;
+}
+
 static ip6_neighbor_t *
-ip6_nd_find (u32 sw_if_index, const ip6_address_t * addr)
+ip6_neighbor_db_find (const ip6_neighbor_key_t * k)
 {
   ip6_neighbor_main_t *nm = &ip6_neighbor_main;
-  ip6_neighbor_t *n = NULL;
+  clib_bihash_kv_24_8_t kv;
+
+  ip6_neighbor_db_mk_key (&kv, k);
+
+  if (clib_bihash_search_24_8 (&nm->neighbor_db, &kv, &kv))
+    return (NULL);
+
+  return (pool_elt_at_index (nm->neighbor_pool, kv.value));
+}
+
+static void
+ip6_neighbor_db_add (ip6_neighbor_t * n)
+{
+  ip6_neighbor_main_t *nm = &ip6_neighbor_main;
+  clib_bihash_kv_24_8_t kv;
+
+  ip6_neighbor_db_mk_key (&kv, &n->key);
+  kv.value = n - nm->neighbor_pool;
+
+  clib_bihash_add_del_24_8 (&nm->neighbor_db, &kv, 1);
+}
+
+static void
+ip6_neighbor_db_remove (ip6_neighbor_t * n)
+{
+  ip6_neighbor_main_t *nm = &ip6_neighbor_main;
+  clib_bihash_kv_24_8_t kv;
+
+  ip6_neighbor_db_mk_key (&kv, &n->key);
+
+  clib_bihash_add_del_24_8 (&nm->neighbor_db, &kv, 0);
+}
+
+static ip6_neighbor_t *
+ip6_nd_find (u32 sw_if_index, const ip6_address_t * addr)
+{
   ip6_neighbor_key_t k;
-  uword *p;
 
   IP6_NBR_MK_KEY (k, sw_if_index, addr);
 
-  p = mhash_get (&nm->neighbor_index_by_key, &k);
-  if (p)
-    {
-      n = pool_elt_at_index (nm->neighbor_pool, p[0]);
-    }
-
-  return (n);
+  return (ip6_neighbor_db_find (&k));
 }
 
 static adj_walk_rc_t
@@ -606,7 +708,7 @@ ip6_neighbor_sw_interface_up_down (vnet_main_t * vnm,
 	  ip6_neighbor_adj_fib_remove (n,
 				       ip6_fib_table_get_index_for_sw_if_index
 				       (n->key.sw_if_index));
-	  mhash_unset (&nm->neighbor_index_by_key, &n->key, 0);
+	  ip6_neighbor_db_remove (n);
 	  pool_put (nm->neighbor_pool, n);
 	}
     }
@@ -755,7 +857,8 @@ force_reuse_neighbor_entry (void)
 		    &n->key.ip6_address, ip6_nd_mk_incomplete_walk, NULL);
   ip6_neighbor_adj_fib_remove
     (n, ip6_fib_table_get_index_for_sw_if_index (n->key.sw_if_index));
-  mhash_unset (&nm->neighbor_index_by_key, &n->key, 0);
+  ip6_neighbor_db_remove (n);
+  nm->counters.n_recycled++;
 
   return n;
 }
@@ -788,10 +891,9 @@ vnet_set_ip6_ethernet_neighbor (vlib_main_t * vm,
   k.ip6_address = a[0];
   k.pad = 0;
 
-  p = mhash_get (&nm->neighbor_index_by_key, &k);
-  if (p)
+  n = ip6_neighbor_db_find (&k);
+  if (n)
     {
-      n = pool_elt_at_index (nm->neighbor_pool, p[0]);
       /* Refuse to over-write static neighbor entry. */
       if (!is_static && (n->flags & IP6_NEIGHBOR_FLAG_STATIC))
 	{
@@ -811,15 +913,19 @@ vnet_set_ip6_ethernet_neighbor (vlib_main_t * vm,
 	{
 	  n = force_reuse_neighbor_entry ();
 	  if (NULL == n)
-	    return -2;
+	    {
+	      nm->counters.n_limit_drops++;
+	      return -2;
+	    }
 	}
       else
 	pool_get (nm->neighbor_pool, n);
 
-      mhash_set (&nm->neighbor_index_by_key, &k, n - nm->neighbor_pool,
-		 /* old value */ 0);
       n->key = k;
       n->fib_entry_index = FIB_NODE_INDEX_INVALID;
+      n->flags = 0;
+      ip6_neighbor_db_add (n);
+      nm->counters.n_added++;
 
       clib_memcpy (n->link_layer_address,
 		   link_layer_address, n_bytes_link_layer_address);
@@ -930,7 +1036,6 @@ vnet_unset_ip6_ethernet_neighbor (vlib_main_t * vm,
   ip6_neighbor_main_t *nm = &ip6_neighbor_main;
   ip6_neighbor_key_t k;
   ip6_neighbor_t *n;
-  uword *p;
   int rv = 0;
 
   if (vlib_get_thread_index ())
@@ -944,21 +1049,19 @@ vnet_unset_ip6_ethernet_neighbor (vlib_main_t * vm,
   k.ip6_address = a[0];
   k.pad = 0;
 
-  p = mhash_get (&nm->neighbor_index_by_key, &k);
-  if (p == 0)
+  n = ip6_neighbor_db_find (&k);
+  if (NULL == n)
     {
       rv = -1;
       goto out;
     }
 
-  n = pool_elt_at_index (nm->neighbor_pool, p[0]);
-
   adj_nbr_walk_nh6 (sw_if_index,
 		    &n->key.ip6_address, ip6_nd_mk_incomplete_walk, NULL);
   ip6_neighbor_adj_fib_remove
     (n, ip6_fib_table_get_index_for_sw_if_index (sw_if_index));
 
-  mhash_unset (&nm->neighbor_index_by_key, &n->key, 0);
+  ip6_neighbor_db_remove (n);
   pool_put (nm->neighbor_pool, n);
 
 out:
@@ -978,6 +1081,101 @@ static void ip6_neighbor_set_unset_rpc_callback
 				      a->link_layer_address, 6);
 }
 
+static void
+ip6_neighbor_rpc_batch_callback (ip6_neighbor_rpc_batch_t * batch)
+{
+  u32 i;
+
+  for (i = 0; i < batch->n_args; i++)
+    ip6_neighbor_set_unset_rpc_callback (&batch->args[i]);
+}
+
+static void
+ip6_neighbor_learn_batch_callback (ip6_neighbor_rpc_batch_t * batch)
+{
+  ip6_neighbor_main_t *nm = &ip6_neighbor_main;
+
+  nm->counters.n_learns += batch->n_args;
+  nm->counters.n_learn_batches++;
+
+  ip6_neighbor_rpc_batch_callback (batch);
+}
+
+/**
+ * @brief Learn a neighbor from the data-plane. On a worker the neighbor is
+ * added to the thread's batch, which ip6_neighbor_learn_flush sends to
+ * the main thread when the frame is done.
+ */
+static void
+ip6_neighbor_learn (vlib_main_t * vm,
+		    u32 sw_if_index,
+		    ip6_address_t * a, u8 * link_layer_address)
+{
+  ip6_neighbor_main_t *nm = &ip6_neighbor_main;
+  ip6_neighbor_set_unset_rpc_args_t *args;
+  ip6_neighbor_rpc_batch_t *batch;
+  u8 **batch_data;
+
+  if (0 == vm->thread_index)
+    {
+      vnet_set_ip6_ethernet_neighbor (vm, sw_if_index, a,
+				      link_layer_address,
+				      ETHER_MAC_ADDR_LEN, 0, 0);
+      return;
+    }
+
+  batch_data = &nm->learn_batch_by_thread[vm->thread_index];
+
+  if (0 == vec_len (*batch_data))
+    vec_validate (*batch_data, sizeof (*batch) - 1);
+
+  batch = (ip6_neighbor_rpc_batch_t *) * batch_data;
+
+  if (batch->n_args)
+    {
+      /* a host that sends a burst is learned once */
+      args = &batch->args[batch->n_args - 1];
+      if (args->sw_if_index == sw_if_index &&
+	  ip6_address_is_equal (&args->addr, a) &&
+	  !memcmp (args->link_layer_address, link_layer_address,
+		   ETHER_MAC_ADDR_LEN))
+	return;
+    }
+
+  vec_resize (*batch_data, sizeof (*args));
+  batch = (ip6_neighbor_rpc_batch_t *) * batch_data;
+  args = &batch->args[batch->n_args++];
+
+  memset (args, 0, sizeof (*args));
+  args->is_add = 1;
+  args->sw_if_index = sw_if_index;
+  args->addr = *a;
+  clib_memcpy (args->link_layer_address, link_layer_address,
+	       ETHER_MAC_ADDR_LEN);
+}
+
+static void
+ip6_neighbor_learn_flush (vlib_main_t * vm)
+{
+  ip6_neighbor_main_t *nm = &ip6_neighbor_main;
+  void vl_api_rpc_call_main_thread (void *fp, u8 * data, u32 data_length);
+  u8 *batch_data;
+
+  if (0 == vm->thread_index)
+    return;
+
+  batch_data = nm->learn_batch_by_thread[vm->thread_index];
+
+  if (0 == vec_len (batch_data))
+    return;
+
+  if (((ip6_neighbor_rpc_batch_t *) batch_data)->n_args)
+    vl_api_rpc_call_main_thread (ip6_neighbor_learn_batch_callback,
+				 batch_data, vec_len (batch_data));
+
+  vec_reset_length (nm->learn_batch_by_thread[vm->thread_index]);
+}
+
 static int
 ip6_neighbor_sort (void *a1, void *a2)
 {
@@ -1070,6 +1268,46 @@ VLIB_CLI_COMMAND (show_ip6_neighbors_command, static) = {
   .path = "show ip6 neighbors",
   .function = show_ip6_neighbors,
   .short_help = "show ip6 neighbors [<interface>]",
+  /* the entries are only changed on the main thread */
+  .is_mp_safe = 1,
+};
+/* *INDENT-ON* */
+
+static clib_error_t *
+show_ip6_neighbors_summary (vlib_main_t * vm,
+			    unformat_input_t * input,
+			    vlib_cli_command_t * cmd)
+{
+  ip6_neighbor_main_t *nm = &ip6_neighbor_main;
+  ip6_neighbor_counters_t *c = &nm->counters;
+
+  vlib_cli_output (vm, "entries: %d, limit: %d, age: %d secs",
+		   pool_elts (nm->neighbor_pool),
+		   nm->limit_neighbor_cache_size, nm->neighbor_age);
+  vlib_cli_output (vm, "added: %lld, recycled: %lld, limit drops: %lld, "
+		   "aged: %lld", c->n_added, c->n_recycled,
+		   c->n_limit_drops, c->n_aged);
+  vlib_cli_output (vm, "learned: %lld in %lld batches",
+		   c->n_learns, c->n_learn_batches);
+  vlib_cli_output (vm, "%U", format_bihash_24_8, &nm->neighbor_db, 0);
+
+  return (NULL);
+}
+
+/*?
+ * Display the size, limit and age of the IPv6 neighbor table, and the
+ * counts of the entries added, learned from the data-plane, recycled at
+ * the limit and aged out.
+ *
+ * @cliexpar
+ * @cliexcmd{show ip6 neighbors summary}
+ ?*/
+/* *INDENT-OFF* */
+VLIB_CLI_COMMAND (show_ip6_neighbors_summary_command, static) = {
+  .path = "show ip6 neighbors summary",
+  .function = show_ip6_neighbors_summary,
+  .short_help = "show ip6 neighbors summary",
+  .is_mp_safe = 1,
 };
 /* *INDENT-ON* */
 
@@ -1247,13 +1485,10 @@ icmp6_neighbor_solicitation_or_advertisement (vlib_main_t * vm,
 	  if (PREDICT_TRUE (error0 == ICMP6_ERROR_NONE && o0 != 0 &&
 			    !ip6_sadd_unspecified))
 	    {
-	      vnet_set_ip6_ethernet_neighbor (vm, sw_if_index0,
-					      is_solicitation ?
-					      &ip0->src_address :
-					      &h0->target_address,
-					      o0->ethernet_address,
-					      sizeof (o0->ethernet_address),
-					      0, 0);
+	      ip6_neighbor_learn (vm, sw_if_index0,
+				  is_solicitation ?
+				  &ip0->src_address :
+				  &h0->target_address, o0->ethernet_address);
 	    }
 
 	  if (is_solicitation && error0 == ICMP6_ERROR_NONE)
@@ -1399,6 +1634,8 @@ icmp6_neighbor_solicitation_or_advertisement (vlib_main_t * vm,
 		    ICMP6_ERROR_NEIGHBOR_ADVERTISEMENTS_TX,
 		    n_advertisements_sent);
 
+  ip6_neighbor_learn_flush (vm);
+
   return frame->n_vectors;
 }
 
@@ -1584,11 +1821,8 @@ icmp6_router_solicitation (vlib_main_t * vm,
 	  if (PREDICT_TRUE (error0 == ICMP6_ERROR_NONE && o0 != 0 &&
 			    !is_unspecified && !is_link_local))
 	    {
-	      vnet_set_ip6_ethernet_neighbor (vm, sw_if_index0,
-					      &ip0->src_address,
-					      o0->ethernet_address,
-					      sizeof (o0->ethernet_address),
-					      0, 0);
+	      ip6_neighbor_learn (vm, sw_if_index0,
+				  &ip0->src_address, o0->ethernet_address);
 	    }
 
 	  /* default is to drop */
@@ -1887,6 +2121,8 @@ icmp6_router_solicitation (vlib_main_t * vm,
 		    ICMP6_ERROR_ROUTER_ADVERTISEMENTS_TX,
 		    n_advertisements_sent);
 
+  ip6_neighbor_learn_flush (vm);
+
   return frame->n_vectors;
 }
 
@@ -4637,6 +4873,146 @@ ip6_set_neighbor_limit (u32 neighbor_limit)
   return 0;
 }
 
+/**
+ * @brief Visit the next slice of the neighbor pool and remove the dynamic
+ * entries that have not been refreshed within the age. The slice is
+ * sized so the whole pool is visited once per age.
+ */
+static void
+ip6_neighbor_age_scan (vlib_main_t * vm)
+{
+  ip6_neighbor_main_t *nm = &ip6_neighbor_main;
+  ip6_neighbor_set_unset_rpc_args_t *args, *to_remove = 0;
+  void vl_api_rpc_call_main_thread (void *fp, u8 * data, u32 data_length);
+  ip6_neighbor_rpc_batch_t *batch;
+  u32 index, n_visit;
+  ip6_neighbor_t *n;
+  u8 *data = 0;
+  f64 now;
+
+  if (0 == pool_elts (nm->neighbor_pool))
+    return;
+
+  now = vlib_time_now (vm);
+  n_visit = clib_max (IP6_NEIGHBOR_AGE_SCAN_MIN,
+		      (pool_len (nm->neighbor_pool) *
+		       IP6_NEIGHBOR_AGE_SCAN_INTERVAL / nm->neighbor_age) + 1);
+  n_visit = clib_min (n_visit, pool_len (nm->neighbor_pool));
+  index = nm->neighbor_age_rotor;
+
+  while (n_visit--)
+    {
+      index = pool_next_index (nm->neighbor_pool, index);
+      if (~0 == index)
+	/* wrap */
+	index = pool_next_index (nm->neighbor_pool, index);
+
+      n = pool_elt_at_index (nm->neighbor_pool, index);
+
+      if ((n->flags & IP6_NEIGHBOR_FLAG_DYNAMIC) &&
+	  n->time_last_updated + nm->neighbor_age < now)
+	{
+	  vec_add2 (to_remove, args, 1);
+	  memset (args, 0, sizeof (*args));
+	  args->sw_if_index = n->key.sw_if_index;
+	  args->addr = n->key.ip6_address;
+	}
+    }
+  nm->neighbor_age_rotor = index;
+
+  if (0 == vec_len (to_remove))
+    return;
+
+  nm->counters.n_aged += vec_len (to_remove);
+
+  /*
+   * remove them all under one barrier sync
+   */
+  vec_validate (data, (sizeof (*batch) +
+		       vec_len (to_remove) * sizeof (to_remove[0]) - 1));
+  batch = (ip6_neighbor_rpc_batch_t *) data;
+  batch->n_args = vec_len (to_remove);
+  clib_memcpy (batch->args, to_remove,
+	       vec_len (to_remove) * sizeof (to_remove[0]));
+
+  vl_api_rpc_call_main_thread (ip6_neighbor_rpc_batch_callback,
+			       data, vec_len (data));
+  vec_free (data);
+  vec_free (to_remove);
+}
+
+static uword
+ip6_neighbor_age_process (vlib_main_t * vm,
+			  vlib_node_runtime_t * rt, vlib_frame_t * f)
+{
+  ip6_neighbor_main_t *nm = &ip6_neighbor_main;
+
+  while (1)
+    {
+      if (nm->neighbor_age)
+	vlib_process_wait_for_event_or_clock (vm,
+					      IP6_NEIGHBOR_AGE_SCAN_INTERVAL);
+      else
+	vlib_process_wait_for_event (vm);
+
+      vlib_process_get_events (vm, NULL);
+
+      if (nm->neighbor_age)
+	ip6_neighbor_age_scan (vm);
+    }
+  return 0;
+}
+
+/* *INDENT-OFF* */
+VLIB_REGISTER_NODE (ip6_neighbor_age_process_node, static) = {
+  .function = ip6_neighbor_age_process,
+  .type = VLIB_NODE_TYPE_PROCESS,
+  .name = "ip6-neighbor-age-process",
+};
+/* *INDENT-ON* */
+
+clib_error_t *
+ip6_set_neighbor_age (u32 neighbor_age)
+{
+  ip6_neighbor_main_t *nm = &ip6_neighbor_main;
+
+  nm->neighbor_age = neighbor_age;
+  vlib_process_signal_event (vlib_get_main (),
+			     ip6_neighbor_age_process_node.index, 0, 0);
+  return 0;
+}
+
+static clib_error_t *
+set_ip6_neighbor_age_command_fn (vlib_main_t * vm,
+				 unformat_input_t * input,
+				 vlib_cli_command_t * cmd)
+{
+  u32 neighbor_age;
+
+  if (!unformat (input, "%d", &neighbor_age))
+    return clib_error_return (0, "expected age in seconds, got `%U'",
+			      format_unformat_error, input);
+
+  return (ip6_set_neighbor_age (neighbor_age));
+}
+
+/*?
+ * Set the number of seconds after which a dynamic IPv6 neighbor that has
+ * not been refreshed is removed. Zero, the default, disables aging. The
+ * table is scanned a slice at a time, so an entry is removed between one
+ * and two ages after it was last refreshed.
+ *
+ * @cliexpar
+ * @cliexcmd{set ip6 neighbor age 600}
+ ?*/
+/* *INDENT-OFF* */
+VLIB_CLI_COMMAND (set_ip6_neighbor_age_command, static) = {
+  .path = "set ip6 neighbor age",
+  .short_help = "set ip6 neighbor age <seconds>",
+  .function = set_ip6_neighbor_age_command_fn,
+};
+/* *INDENT-ON* */
+
 static void
 ip6_neighbor_table_bind (ip6_main_t * im,
 			 uword opaque,
@@ -4670,9 +5046,11 @@ ip6_neighbor_init (vlib_main_t * vm)
   ip6_neighbor_main_t *nm = &ip6_neighbor_main;
   ip6_main_t *im = &ip6_main;
 
-  mhash_init (&nm->neighbor_index_by_key,
-	      /* value size */ sizeof (uword),
-	      /* key size */ sizeof (ip6_neighbor_key_t));
+  clib_bihash_init_24_8 (&nm->neighbor_db, "ip6-neighbor-db",
+			 IP6_NEIGHBOR_DB_N_BUCKETS,
+			 IP6_NEIGHBOR_DB_MEMORY_SIZE);
+  vec_validate (nm->learn_batch_by_thread, vlib_num_workers ());
+  nm->neighbor_age_rotor = ~0;
 
   icmp6_register_type (vm, ICMP6_neighbor_solicitation,
 		       ip6_icmp_neighbor_solicitation_node.index);
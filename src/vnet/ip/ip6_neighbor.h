@@ -67,6 +67,8 @@ extern int ip6_neighbor_ra_prefix (vlib_main_t * vm, u32 sw_if_index,
 
 extern clib_error_t *ip6_set_neighbor_limit (u32 neighbor_limit);
 
+extern clib_error_t *ip6_set_neighbor_age (u32 neighbor_age);
+
 extern void vnet_register_ip6_neighbor_resolution_event (vnet_main_t * vnm,
 							 void *address_arg,
 							 uword node_index,
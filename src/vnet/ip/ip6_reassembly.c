@@ -31,8 +31,10 @@
 #define IP6_REASS_EXPIRE_WALK_INTERVAL_DEFAULT_MS 10000	// 10 seconds default
 #define IP6_REASS_MAX_REASSEMBLIES_DEFAULT 1024
 #define IP6_REASS_HT_LOAD_FACTOR (0.75)
+#define IP6_REASS_FQ_NELTS 64
 
 static vlib_node_registration_t ip6_reass_node;
+static vlib_node_registration_t ip6_reass_node_feature;
 
 typedef struct
 {
@@ -104,13 +106,19 @@ typedef struct
   u16 min_fragment_length;
 } ip6_reass_t;
 
+/*
+ * A fragment is reassembled on the thread that owns its key, see
+ * ip6_reass_get_owner_thread, and all others hand it off there. So only
+ * the owning thread's data path touches the per-thread data; the expire
+ * walk and the CLI do so with the workers stopped at the barrier.
+ */
 typedef struct
 {
+  clib_bihash_48_8_t hash;
   ip6_reass_t *pool;
   u32 reass_n;
   u32 buffers_n;
   u32 id_counter;
-  clib_spinlock_t lock;
 } ip6_reass_per_thread_t;
 
 typedef struct
@@ -122,11 +130,16 @@ typedef struct
   u32 max_reass_n;
 
   // IPv6 runtime
-  clib_bihash_48_8_t hash;
-
   // per-thread data
   ip6_reass_per_thread_t *per_thread_data;
 
+  // fragments are reassembled by the workers
+  u32 first_worker_index;
+  u32 num_workers;
+  // frame queues to hand fragments off to the owning thread
+  u32 fq_index;
+  u32 fq_feature_index;
+
   // convenience
   vlib_main_t *vlib_main;
   vnet_main_t *vnet_main;
@@ -145,6 +158,7 @@ typedef enum
   IP6_REASSEMBLY_NEXT_INPUT,
   IP6_REASSEMBLY_NEXT_DROP,
   IP6_REASSEMBLY_NEXT_ICMP_ERROR,
+  IP6_REASSEMBLY_NEXT_HANDOFF,
   IP6_REASSEMBLY_N_NEXT,
 } ip6_reass_next_t;
 
@@ -290,7 +304,7 @@ ip6_reass_free (ip6_reass_main_t * rm, ip6_reass_per_thread_t * rt,
   kv.key[3] = reass->key.as_u64[3];
   kv.key[4] = reass->key.as_u64[4];
   kv.key[5] = reass->key.as_u64[5];
-  clib_bihash_add_del_48_8 (&rm->hash, &kv, 0);
+  clib_bihash_add_del_48_8 (&rt->hash, &kv, 0);
   pool_put (rt->pool, reass);
   --rt->reass_n;
 }
@@ -361,6 +375,24 @@ ip6_reass_on_timeout (vlib_main_t * vm, vlib_node_runtime_t * node,
   ip6_reass_drop_all (vm, rm, reass, vec_timeout);
 }
 
+/**
+ * The thread which reassembles the fragments with this key: a hash of
+ * the key spread over the workers, or the main thread when there are
+ * none.
+ */
+always_inline u32
+ip6_reass_get_owner_thread (ip6_reass_main_t * rm, ip6_reass_key_t * k)
+{
+  clib_bihash_kv_48_8_t kv;
+
+  if (PREDICT_FALSE (0 == rm->num_workers))
+    return 0;
+
+  clib_memcpy (kv.key, k->as_u64, sizeof (kv.key));
+  return rm->first_worker_index +
+    (clib_bihash_hash_48_8 (&kv) >> 32) % rm->num_workers;
+}
+
 always_inline ip6_reass_t *
 ip6_reass_find_or_create (vlib_main_t * vm, vlib_node_runtime_t * node,
 			  ip6_reass_main_t * rm, ip6_reass_per_thread_t * rt,
@@ -377,7 +409,7 @@ ip6_reass_find_or_create (vlib_main_t * vm, vlib_node_runtime_t * node,
   kv.key[4] = k->as_u64[4];
   kv.key[5] = k->as_u64[5];
 
-  if (!clib_bihash_search_48_8 (&rm->hash, &kv, &value))
+  if (!clib_bihash_search_48_8 (&rt->hash, &kv, &value))
     {
       reass = pool_elt_at_index (rt->pool, value.value);
       if (now > reass->last_heard + rm->timeout)
@@ -421,7 +453,7 @@ ip6_reass_find_or_create (vlib_main_t * vm, vlib_node_runtime_t * node,
   kv.value = reass - rt->pool;
   reass->last_heard = now;
 
-  if (clib_bihash_add_del_48_8 (&rm->hash, &kv, 1))
+  if (clib_bihash_add_del_48_8 (&rt->hash, &kv, 1))
     {
       ip6_reass_free (rm, rt, reass);
       reass = NULL;
@@ -853,8 +885,9 @@ ip6_reassembly_inline (vlib_main_t * vm,
   u32 *from = vlib_frame_vector_args (frame);
   u32 n_left_from, n_left_to_next, *to_next, next_index;
   ip6_reass_main_t *rm = &ip6_reass_main;
-  ip6_reass_per_thread_t *rt = &rm->per_thread_data[os_get_thread_index ()];
-  clib_spinlock_lock (&rt->lock);
+  u32 thread_index = vm->thread_index;
+  ip6_reass_per_thread_t *rt = &rm->per_thread_data[thread_index];
+  u32 n_handoff = 0;
 
   n_left_from = frame->n_vectors;
   next_index = node->cached_next_index;
@@ -964,6 +997,16 @@ ip6_reassembly_inline (vlib_main_t * vm,
 	    (u64) vnet_buffer (b0)->
 	    sw_if_index[VLIB_RX] << 32 | frag_hdr->identification;
 	  k.as_u64[5] = ip0->protocol;
+
+	  u32 owner0 = ip6_reass_get_owner_thread (rm, &k);
+	  if (PREDICT_FALSE (owner0 != thread_index))
+	    {
+	      vnet_buffer (b0)->ip.reass.owner_thread_index = owner0;
+	      next0 = IP6_REASSEMBLY_NEXT_HANDOFF;
+	      ++n_handoff;
+	      goto skip_reass;
+	    }
+
 	  ip6_reass_t *reass =
 	    ip6_reass_find_or_create (vm, node, rm, rt, &k, &icmp_bi,
 				      &vec_timeout);
@@ -988,7 +1031,8 @@ ip6_reassembly_inline (vlib_main_t * vm,
 	      to_next[0] = bi0;
 	      to_next += 1;
 	      n_left_to_next -= 1;
-	      if (is_feature && IP6_ERROR_NONE == error0)
+	      if (is_feature && IP6_ERROR_NONE == error0 &&
+		  IP6_REASSEMBLY_NEXT_HANDOFF != next0)
 		{
 		  vnet_feature_next (vnet_buffer (b0)->sw_if_index[VLIB_RX],
 				     &next0, b0);
@@ -1014,7 +1058,9 @@ ip6_reassembly_inline (vlib_main_t * vm,
       vlib_put_next_frame (vm, node, next_index, n_left_to_next);
     }
 
-  clib_spinlock_unlock (&rt->lock);
+  if (n_handoff)
+    vlib_node_increment_counter (vm, node->node_index,
+				 IP6_ERROR_REASS_HANDOFF, n_handoff);
   return frame->n_vectors;
 }
 
@@ -1045,6 +1091,7 @@ VLIB_REGISTER_NODE (ip6_reass_node, static) = {
                 [IP6_REASSEMBLY_NEXT_INPUT] = "ip6-input",
                 [IP6_REASSEMBLY_NEXT_DROP] = "ip6-drop",
                 [IP6_REASSEMBLY_NEXT_ICMP_ERROR] = "ip6-icmp-error",
+                [IP6_REASSEMBLY_NEXT_HANDOFF] = "ip6-reassembly-handoff",
         },
 };
 /* *INDENT-ON* */
@@ -1072,6 +1119,7 @@ VLIB_REGISTER_NODE (ip6_reass_node_feature, static) = {
                 [IP6_REASSEMBLY_NEXT_INPUT] = "ip6-input",
                 [IP6_REASSEMBLY_NEXT_DROP] = "ip6-drop",
                 [IP6_REASSEMBLY_NEXT_ICMP_ERROR] = "ip6-icmp-error",
+                [IP6_REASSEMBLY_NEXT_HANDOFF] = "ip6-reassembly-feature-handoff",
         },
 };
 /* *INDENT-ON* */
@@ -1087,6 +1135,203 @@ VNET_FEATURE_INIT (ip6_reassembly_feature, static) = {
 };
 /* *INDENT-ON* */
 
+typedef struct
+{
+  u32 next_worker_index;
+} ip6_reass_handoff_trace_t;
+
+static u8 *
+format_ip6_reass_handoff_trace (u8 * s, va_list * args)
+{
+  CLIB_UNUSED (vlib_main_t * vm) = va_arg (*args, vlib_main_t *);
+  CLIB_UNUSED (vlib_node_t * node) = va_arg (*args, vlib_node_t *);
+  ip6_reass_handoff_trace_t *t = va_arg (*args, ip6_reass_handoff_trace_t *);
+
+  s = format (s, "ip6-reassembly-handoff: next-worker %d",
+	      t->next_worker_index);
+  return s;
+}
+
+/*
+ * Send the fragments to the reassembly node on the thread that owns them,
+ * as set by ip6_reassembly_inline, a frame queue element per worker.
+ * Fragments for a congested worker are dropped.
+ */
+always_inline uword
+ip6_reass_handoff_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
+			  vlib_frame_t * frame, bool is_feature)
+{
+  ip6_reass_main_t *rm = &ip6_reass_main;
+  vlib_thread_main_t *tm = vlib_get_thread_main ();
+  static __thread vlib_frame_queue_elt_t **handoff_queue_elt_by_worker_index;
+  static __thread vlib_frame_queue_t **congested_handoff_queue_by_worker_index
+    = 0;
+  vlib_frame_queue_elt_t *hf = 0;
+  vlib_frame_t *d = 0;
+  u32 n_left_from, *from, *to_next_drop = 0;
+  u32 n_left_to_next_worker = 0, *to_next_worker = 0;
+  u32 current_worker_index = ~0;
+  u32 n_congested = 0;
+  u32 fq_index;
+  int i;
+
+  fq_index = is_feature ? rm->fq_feature_index : rm->fq_index;
+
+  if (PREDICT_FALSE (handoff_queue_elt_by_worker_index == 0))
+    {
+      vec_validate (handoff_queue_elt_by_worker_index, tm->n_vlib_mains - 1);
+
+      vec_validate_init_empty (congested_handoff_queue_by_worker_index,
+			       tm->n_vlib_mains - 1,
+			       (vlib_frame_queue_t *) (~0));
+    }
+
+  from = vlib_frame_vector_args (frame);
+  n_left_from = frame->n_vectors;
+
+  while (n_left_from > 0)
+    {
+      u32 bi0, next_worker_index;
+      vlib_buffer_t *b0;
+
+      bi0 = from[0];
+      from += 1;
+      n_left_from -= 1;
+
+      b0 = vlib_get_buffer (vm, bi0);
+      next_worker_index = vnet_buffer (b0)->ip.reass.owner_thread_index;
+
+      if (next_worker_index != current_worker_index)
+	{
+	  if (is_vlib_frame_queue_congested
+	      (fq_index, next_worker_index, IP6_REASS_FQ_NELTS - 2,
+	       congested_handoff_queue_by_worker_index))
+	    {
+	      if (!d)
+		{
+		  d = vlib_get_frame_to_node (vm, rm->ip6_drop_idx);
+		  to_next_drop = vlib_frame_vector_args (d);
+		}
+	      to_next_drop[0] = bi0;
+	      to_next_drop += 1;
+	      d->n_vectors++;
+	      b0->error = node->errors[IP6_ERROR_REASS_CONGESTION_DROP];
+	      ++n_congested;
+	      goto trace0;
+	    }
+
+	  if (hf)
+	    hf->n_vectors = VLIB_FRAME_SIZE - n_left_to_next_worker;
+
+	  hf = vlib_get_worker_handoff_queue_elt (fq_index,
+						  next_worker_index,
+						  handoff_queue_elt_by_worker_index);
+
+	  n_left_to_next_worker = VLIB_FRAME_SIZE - hf->n_vectors;
+	  to_next_worker = &hf->buffer_index[hf->n_vectors];
+	  current_worker_index = next_worker_index;
+	}
+
+      to_next_worker[0] = bi0;
+      to_next_worker++;
+      n_left_to_next_worker--;
+
+      if (n_left_to_next_worker == 0)
+	{
+	  hf->n_vectors = VLIB_FRAME_SIZE;
+	  vlib_put_frame_queue_elt (hf);
+	  current_worker_index = ~0;
+	  handoff_queue_elt_by_worker_index[next_worker_index] = 0;
+	  hf = 0;
+	}
+
+    trace0:
+      if (PREDICT_FALSE ((node->flags & VLIB_NODE_FLAG_TRACE)
+			 && (b0->flags & VLIB_BUFFER_IS_TRACED)))
+	{
+	  ip6_reass_handoff_trace_t *t =
+	    vlib_add_trace (vm, node, b0, sizeof (*t));
+	  t->next_worker_index = next_worker_index;
+	}
+    }
+
+  if (d)
+    vlib_put_frame_to_node (vm, rm->ip6_drop_idx, d);
+
+  if (hf)
+    hf->n_vectors = VLIB_FRAME_SIZE - n_left_to_next_worker;
+
+  /* Ship frames to the owning threads */
+  for (i = 0; i < vec_len (handoff_queue_elt_by_worker_index); i++)
+    {
+      if (handoff_queue_elt_by_worker_index[i])
+	{
+	  vlib_put_frame_queue_elt (handoff_queue_elt_by_worker_index[i]);
+	  handoff_queue_elt_by_worker_index[i] = 0;
+	}
+      congested_handoff_queue_by_worker_index[i] =
+	(vlib_frame_queue_t *) (~0);
+    }
+
+  if (n_congested)
+    vlib_node_increment_counter (vm, node->node_index,
+				 IP6_ERROR_REASS_CONGESTION_DROP,
+				 n_congested);
+  return frame->n_vectors;
+}
+
+static uword
+ip6_reassembly_handoff (vlib_main_t * vm, vlib_node_runtime_t * node,
+			vlib_frame_t * frame)
+{
+  return ip6_reass_handoff_inline (vm, node, frame, false /* is_feature */ );
+}
+
+/* *INDENT-OFF* */
+VLIB_REGISTER_NODE (ip6_reass_handoff_node, static) = {
+    .function = ip6_reassembly_handoff,
+    .name = "ip6-reassembly-handoff",
+    .vector_size = sizeof (u32),
+    .format_trace = format_ip6_reass_handoff_trace,
+    .n_errors = ARRAY_LEN (ip6_reassembly_error_strings),
+    .error_strings = ip6_reassembly_error_strings,
+    .n_next_nodes = 1,
+    .next_nodes =
+        {
+                [0] = "ip6-drop",
+        },
+};
+/* *INDENT-ON* */
+
+VLIB_NODE_FUNCTION_MULTIARCH (ip6_reass_handoff_node, ip6_reassembly_handoff);
+
+static uword
+ip6_reassembly_feature_handoff (vlib_main_t * vm,
+				vlib_node_runtime_t * node,
+				vlib_frame_t * frame)
+{
+  return ip6_reass_handoff_inline (vm, node, frame, true /* is_feature */ );
+}
+
+/* *INDENT-OFF* */
+VLIB_REGISTER_NODE (ip6_reass_feature_handoff_node, static) = {
+    .function = ip6_reassembly_feature_handoff,
+    .name = "ip6-reassembly-feature-handoff",
+    .vector_size = sizeof (u32),
+    .format_trace = format_ip6_reass_handoff_trace,
+    .n_errors = ARRAY_LEN (ip6_reassembly_error_strings),
+    .error_strings = ip6_reassembly_error_strings,
+    .n_next_nodes = 1,
+    .next_nodes =
+        {
+                [0] = "ip6-drop",
+        },
+};
+/* *INDENT-ON* */
+
+VLIB_NODE_FUNCTION_MULTIARCH (ip6_reass_feature_handoff_node,
+			      ip6_reassembly_feature_handoff);
+
 static u32
 ip6_reass_get_nbuckets ()
 {
@@ -1146,28 +1391,33 @@ ip6_reass_set (u32 timeout_ms, u32 max_reassemblies,
 			     ip6_reass_main.ip6_reass_expire_node_idx,
 			     IP6_EVENT_CONFIG_CHANGED, 0);
   u32 new_nbuckets = ip6_reass_get_nbuckets ();
+  ip6_reass_per_thread_t *rt;
   if (ip6_reass_main.max_reass_n > 0 && new_nbuckets > old_nbuckets)
     {
-      clib_bihash_48_8_t new_hash;
-      memset (&new_hash, 0, sizeof (new_hash));
-      ip6_rehash_cb_ctx ctx;
-      ctx.failure = 0;
-      ctx.new_hash = &new_hash;
-      clib_bihash_init_48_8 (&new_hash, "ip6-reass", new_nbuckets,
-			     new_nbuckets * 1024);
-      clib_bihash_foreach_key_value_pair_48_8 (&ip6_reass_main.hash,
-					       ip6_rehash_cb, &ctx);
-      if (ctx.failure)
-	{
-	  clib_bihash_free_48_8 (&new_hash);
-	  return -1;
-	}
-      else
-	{
-	  clib_bihash_free_48_8 (&ip6_reass_main.hash);
-	  clib_memcpy (&ip6_reass_main.hash, &new_hash,
-		       sizeof (ip6_reass_main.hash));
-	}
+      /* *INDENT-OFF* */
+      vec_foreach (rt, ip6_reass_main.per_thread_data)
+      {
+        clib_bihash_48_8_t new_hash;
+        memset (&new_hash, 0, sizeof (new_hash));
+        ip6_rehash_cb_ctx ctx;
+        ctx.failure = 0;
+        ctx.new_hash = &new_hash;
+        clib_bihash_init_48_8 (&new_hash, "ip6-reass", new_nbuckets,
+                               new_nbuckets * 1024);
+        clib_bihash_foreach_key_value_pair_48_8 (&rt->hash, ip6_rehash_cb,
+                                                 &ctx);
+        if (ctx.failure)
+          {
+            clib_bihash_free_48_8 (&new_hash);
+            return -1;
+          }
+        else
+          {
+            clib_bihash_free_48_8 (&rt->hash);
+            clib_memcpy (&rt->hash, &new_hash, sizeof (rt->hash));
+          }
+      }
+      /* *INDENT-ON* */
     }
   return 0;
 }
@@ -1186,32 +1436,53 @@ static clib_error_t *
 ip6_reass_init_function (vlib_main_t * vm)
 {
   ip6_reass_main_t *rm = &ip6_reass_main;
+  vlib_thread_main_t *tm = vlib_get_thread_main ();
+  vlib_thread_registration_t *tr;
   clib_error_t *error = 0;
   u32 nbuckets;
   vlib_node_t *node;
+  uword *p;
+
+  if ((error = vlib_call_init_function (vm, threads_init)))
+    return error;
 
   rm->vlib_main = vm;
   rm->vnet_main = vnet_get_main ();
 
+  ip6_reass_set_params (IP6_REASS_TIMEOUT_DEFAULT_MS,
+			IP6_REASS_MAX_REASSEMBLIES_DEFAULT,
+			IP6_REASS_EXPIRE_WALK_INTERVAL_DEFAULT_MS);
+
+  nbuckets = ip6_reass_get_nbuckets ();
   vec_validate (rm->per_thread_data, vlib_num_workers () + 1);
   ip6_reass_per_thread_t *rt;
   vec_foreach (rt, rm->per_thread_data)
   {
-    clib_spinlock_init (&rt->lock);
+    clib_bihash_init_48_8 (&rt->hash, "ip6-reass", nbuckets,
+			   nbuckets * 1024);
     pool_alloc (rt->pool, rm->max_reass_n);
   }
 
+  p = hash_get_mem (tm->thread_registrations_by_name, "workers");
+  if (p)
+    {
+      tr = (vlib_thread_registration_t *) p[0];
+      rm->num_workers = tr->count;
+      rm->first_worker_index = tr->first_index;
+    }
+  if (rm->num_workers)
+    {
+      rm->fq_index = vlib_frame_queue_main_init (ip6_reass_node.index,
+						 IP6_REASS_FQ_NELTS);
+      rm->fq_feature_index =
+	vlib_frame_queue_main_init (ip6_reass_node_feature.index,
+				    IP6_REASS_FQ_NELTS);
+    }
+
   node = vlib_get_node_by_name (vm, (u8 *) "ip6-reassembly-expire-walk");
   ASSERT (node);
   rm->ip6_reass_expire_node_idx = node->index;
 
-  ip6_reass_set_params (IP6_REASS_TIMEOUT_DEFAULT_MS,
-			IP6_REASS_MAX_REASSEMBLIES_DEFAULT,
-			IP6_REASS_EXPIRE_WALK_INTERVAL_DEFAULT_MS);
-
-  nbuckets = ip6_reass_get_nbuckets ();
-  clib_bihash_init_48_8 (&rm->hash, "ip6-reass", nbuckets, nbuckets * 1024);
-
   node = vlib_get_node_by_name (vm, (u8 *) "ip6-drop");
   ASSERT (node);
   rm->ip6_drop_idx = node->index;
@@ -1264,10 +1535,18 @@ ip6_reass_walk_expired (vlib_main_t * vm,
       int index;
       const uword nthreads = os_get_nthreads ();
       u32 *vec_icmp_bi = NULL;
+      bool barrier = false;
       for (thread_index = 0; thread_index < nthreads; ++thread_index)
 	{
 	  ip6_reass_per_thread_t *rt = &rm->per_thread_data[thread_index];
-	  clib_spinlock_lock (&rt->lock);
+	  /* nothing to expire, leave the workers running */
+	  if (0 == rt->reass_n)
+	    continue;
+	  if (!barrier)
+	    {
+	      vlib_worker_thread_barrier_sync (vm);
+	      barrier = true;
+	    }
 
 	  vec_reset_length (pool_indexes_to_free);
           /* *INDENT-OFF* */
@@ -1309,9 +1588,9 @@ ip6_reass_walk_expired (vlib_main_t * vm,
             ip6_reass_free (rm, rt, reass);
           }
           /* *INDENT-ON* */
-
-	  clib_spinlock_unlock (&rt->lock);
 	}
+      if (barrier)
+	vlib_worker_thread_barrier_release (vm);
 
       while (vec_len (vec_timeout) > 0)
 	{
@@ -1476,7 +1755,6 @@ show_ip6_reass (vlib_main_t * vm, unformat_input_t * input,
   for (thread_index = 0; thread_index < nthreads; ++thread_index)
     {
       ip6_reass_per_thread_t *rt = &rm->per_thread_data[thread_index];
-      clib_spinlock_lock (&rt->lock);
       if (details)
 	{
           /* *INDENT-OFF* */
@@ -1487,7 +1765,6 @@ show_ip6_reass (vlib_main_t * vm, unformat_input_t * input,
 	}
       sum_reass_n += rt->reass_n;
       sum_buffers_n += rt->buffers_n;
-      clib_spinlock_unlock (&rt->lock);
     }
   vlib_cli_output (vm, "---------------------");
   vlib_cli_output (vm, "Current IP6 reassemblies count: %lu\n",
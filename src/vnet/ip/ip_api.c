@@ -68,7 +68,9 @@
 
 #define foreach_ip_api_msg                                              \
 _(IP_FIB_DUMP, ip_fib_dump)                                             \
+_(IP_FIB_GET, ip_fib_get)                                               \
 _(IP6_FIB_DUMP, ip6_fib_dump)                                           \
+_(IP6_FIB_GET, ip6_fib_get)                                             \
 _(IP_MFIB_DUMP, ip_mfib_dump)                                           \
 _(IP6_MFIB_DUMP, ip6_mfib_dump)                                         \
 _(IP_NEIGHBOR_DUMP, ip_neighbor_dump)                                   \
@@ -90,6 +92,7 @@ _(PROXY_ARP_INTFC_ENABLE_DISABLE, proxy_arp_intfc_enable_disable)       \
  _(PROXY_ARP_INTFC_DUMP, proxy_arp_intfc_dump)                          \
 _(RESET_FIB, reset_fib)							\
 _(IP_ADD_DEL_ROUTE, ip_add_del_route)                                   \
+_(IP_ROUTE_ADD_DEL_BULK, ip_route_add_del_bulk)                         \
 _(IP_TABLE_ADD_DEL, ip_table_add_del)                                   \
 _(IP_PUNT_POLICE, ip_punt_police)                                       \
 _(IP_PUNT_REDIRECT, ip_punt_redirect)                                   \
@@ -394,6 +397,71 @@ vl_api_ip6_fib_dump_t_handler (vl_api_ip6_fib_dump_t * mp)
   /* *INDENT-ON* */
 }
 
+/*
+ * Paged FIB dumps visit the entries of all tables in pool order
+ */
+static void
+vl_api_ip_fib_get_t_handler (vl_api_ip_fib_get_t * mp)
+{
+  vpe_api_main_t *am = &vpe_api_main;
+  vl_api_ip_fib_get_reply_t *rmp;
+  fib_route_path_encode_t *api_rpaths;
+  fib_table_t *fib_table;
+  fib_prefix_t pfx;
+  int rv = 0;
+
+  /* *INDENT-OFF* */
+  REPLY_AND_DETAILS_ITER_MACRO (VL_API_IP_FIB_GET_REPLY,
+                                fib_entry_pool_is_valid_index (cursor),
+                                fib_entry_pool_next_index (cursor),
+  ({
+    fib_entry_get_prefix (cursor, &pfx);
+    if (FIB_PROTOCOL_IP4 != pfx.fp_proto)
+      continue;
+
+    fib_table = fib_table_get (fib_entry_get_fib_index (cursor),
+                               pfx.fp_proto);
+    api_rpaths = NULL;
+    fib_entry_encode (cursor, &api_rpaths);
+    send_ip_fib_details (am, rp, fib_table, &pfx, api_rpaths, mp->context);
+    vec_free (api_rpaths);
+  }));
+  /* *INDENT-ON* */
+}
+
+static void
+vl_api_ip6_fib_get_t_handler (vl_api_ip6_fib_get_t * mp)
+{
+  vpe_api_main_t *am = &vpe_api_main;
+  vl_api_ip6_fib_get_reply_t *rmp;
+  fib_route_path_encode_t *api_rpaths;
+  fib_table_t *fib_table;
+  fib_prefix_t pfx;
+  int rv = 0;
+
+  /* *INDENT-OFF* */
+  REPLY_AND_DETAILS_ITER_MACRO (VL_API_IP6_FIB_GET_REPLY,
+                                fib_entry_pool_is_valid_index (cursor),
+                                fib_entry_pool_next_index (cursor),
+  ({
+    fib_entry_get_prefix (cursor, &pfx);
+    if (FIB_PROTOCOL_IP6 != pfx.fp_proto)
+      continue;
+
+    fib_table = fib_table_get (fib_entry_get_fib_index (cursor),
+                               pfx.fp_proto);
+    /* don't send link locals */
+    if (fib_table->ft_flags & FIB_TABLE_FLAG_IP6_LL)
+      continue;
+
+    api_rpaths = NULL;
+    fib_entry_encode (cursor, &api_rpaths);
+    send_ip6_fib_details (am, rp, fib_table, &pfx, api_rpaths, mp->context);
+    vec_free (api_rpaths);
+  }));
+  /* *INDENT-ON* */
+}
+
 static void
 send_ip_mfib_details (vl_api_registration_t * reg,
 		      u32 context, u32 table_id, fib_node_index_t mfei)
@@ -1140,6 +1208,296 @@ vl_api_ip_add_del_route_t_handler (vl_api_ip_add_del_route_t * mp)
   REPLY_MACRO (VL_API_IP_ADD_DEL_ROUTE_REPLY);
 }
 
+/*
+ * One prefix of a bulk route request, with all of its paths
+ */
+typedef struct ip_bulk_route_t_
+{
+  fib_prefix_t ibr_prefix;
+  fib_route_path_t *ibr_paths;
+  /* drop, local, etc. ; zero for a route via paths */
+  ip_null_dpo_action_t ibr_null_action;
+  u8 ibr_is_special;
+  u8 ibr_is_local;
+  /* position in the request, so the sort is stable */
+  u32 ibr_index;
+} ip_bulk_route_t;
+
+/*
+ * Adds are applied in order of increasing prefix length, so covering
+ * prefixes are in place before their more specifics and the more
+ * specifics do not need to be re-resolved, nor mtrie leaves re-written,
+ * when the cover arrives. Deletes go in the reverse order for the same
+ * reason.
+ */
+static int
+ip_bulk_route_add_cmp_for_sort (void *v1, void *v2)
+{
+  ip_bulk_route_t *r1 = v1, *r2 = v2;
+
+  if (r1->ibr_prefix.fp_len != r2->ibr_prefix.fp_len)
+    return (r1->ibr_prefix.fp_len - r2->ibr_prefix.fp_len);
+  return (r1->ibr_index - r2->ibr_index);
+}
+
+static int
+ip_bulk_route_del_cmp_for_sort (void *v1, void *v2)
+{
+  ip_bulk_route_t *r1 = v1, *r2 = v2;
+
+  if (r1->ibr_prefix.fp_len != r2->ibr_prefix.fp_len)
+    return (r2->ibr_prefix.fp_len - r1->ibr_prefix.fp_len);
+  return (r1->ibr_index - r2->ibr_index);
+}
+
+static void
+ip_bulk_routes_free (ip_bulk_route_t * routes, u8 free_labels)
+{
+  fib_route_path_t *rpath;
+  ip_bulk_route_t *r;
+
+  vec_foreach (r, routes)
+  {
+    if (free_labels)
+      vec_foreach (rpath, r->ibr_paths) vec_free (rpath->frp_label_stack);
+    vec_free (r->ibr_paths);
+  }
+  vec_free (routes);
+}
+
+static int
+ip_bulk_route_path_parse (const vl_api_fib_path_t * in,
+			  fib_route_path_t * rpath)
+{
+  vnet_main_t *vnm = vnet_get_main ();
+  int rv;
+
+  rv = fib_path_api_parse (in, rpath);
+
+  if (0 != rv)
+    return (rv);
+
+  if (~0 != rpath->frp_sw_if_index)
+    {
+      if (pool_is_free_index (vnm->interface_main.sw_interfaces,
+			      rpath->frp_sw_if_index))
+	return (VNET_API_ERROR_NO_MATCHING_INTERFACE);
+    }
+  else if (!(rpath->frp_flags & FIB_ROUTE_PATH_UDP_ENCAP) &&
+	   in->afi <= DPO_PROTO_MPLS)
+    {
+      /*
+       * the parser leaves the next-hop table ID in the fib index
+       */
+      rpath->frp_fib_index = fib_table_find (dpo_proto_to_fib (in->afi),
+					     rpath->frp_fib_index);
+      if (~0 == rpath->frp_fib_index)
+	return (VNET_API_ERROR_NO_SUCH_FIB);
+    }
+
+  return (0);
+}
+
+static int
+ip_bulk_routes_parse (const vl_api_ip_route_add_del_bulk_t * mp,
+		      fib_protocol_t fproto, ip_bulk_route_t ** routesp)
+{
+  const vl_api_ip_bulk_route_t *in;
+  ip_bulk_route_t *routes = NULL, *r = NULL;
+  fib_route_path_t rpath;
+  fib_prefix_t pfx;
+  u32 ii, n_routes;
+  int rv = 0;
+
+  n_routes = ntohl (mp->n_routes);
+
+  /*
+   * each route carries exactly one path; the message must hold them all
+   */
+  if (vl_msg_api_get_msg_length ((void *) mp) <
+      sizeof (*mp) + (u64) n_routes * sizeof (mp->routes[0]))
+    {
+      *routesp = NULL;
+      return (VNET_API_ERROR_INVALID_VALUE);
+    }
+
+  for (ii = 0; ii < n_routes; ii++)
+    {
+      in = &mp->routes[ii];
+
+      memset (&pfx, 0, sizeof (pfx));
+      pfx.fp_proto = fproto;
+      pfx.fp_len = in->dst_address_length;
+
+      if (FIB_PROTOCOL_IP4 == fproto)
+	{
+	  if (pfx.fp_len > 32)
+	    {
+	      rv = VNET_API_ERROR_INVALID_VALUE;
+	      break;
+	    }
+	  clib_memcpy (&pfx.fp_addr.ip4, in->dst_address,
+		       sizeof (pfx.fp_addr.ip4));
+	}
+      else
+	{
+	  if (pfx.fp_len > 128)
+	    {
+	      rv = VNET_API_ERROR_INVALID_VALUE;
+	      break;
+	    }
+	  clib_memcpy (&pfx.fp_addr.ip6, in->dst_address,
+		       sizeof (pfx.fp_addr.ip6));
+	}
+
+      /*
+       * consecutive entries for the same prefix are the paths of one route
+       */
+      if (NULL == r || 0 != fib_prefix_cmp (&r->ibr_prefix, &pfx))
+	{
+	  vec_add2 (routes, r, 1);
+	  r->ibr_prefix = pfx;
+	  r->ibr_index = r - routes;
+	}
+      else if (r->ibr_is_special)
+	{
+	  rv = VNET_API_ERROR_INVALID_VALUE;
+	  break;
+	}
+
+      if (in->path.is_drop || in->path.is_local ||
+	  in->path.is_unreach || in->path.is_prohibit)
+	{
+	  /*
+	   * special routes have exactly one 'path'
+	   */
+	  if (vec_len (r->ibr_paths))
+	    {
+	      rv = VNET_API_ERROR_INVALID_VALUE;
+	      break;
+	    }
+	  r->ibr_is_special = 1;
+	  r->ibr_is_local = in->path.is_local;
+	  r->ibr_null_action = (in->path.is_unreach ?
+				IP_NULL_ACTION_SEND_ICMP_UNREACH :
+				in->path.is_prohibit ?
+				IP_NULL_ACTION_SEND_ICMP_PROHIBIT :
+				IP_NULL_ACTION_NONE);
+	  continue;
+	}
+
+      if (!mp->is_add)
+	/* the paths of a route being deleted are not needed */
+	continue;
+
+      rv = ip_bulk_route_path_parse (&in->path, &rpath);
+      vec_add1 (r->ibr_paths, rpath);
+
+      if (0 != rv)
+	break;
+    }
+
+  if (0 != rv)
+    {
+      ip_bulk_routes_free (routes, 1);
+      routes = NULL;
+    }
+
+  *routesp = routes;
+  return (rv);
+}
+
+void
+vl_api_ip_route_add_del_bulk_t_handler (vl_api_ip_route_add_del_bulk_t * mp)
+{
+  vl_api_ip_route_add_del_bulk_reply_t *rmp;
+  vnet_main_t *vnm = vnet_get_main ();
+  ip_bulk_route_t *routes = NULL, *r;
+  fib_protocol_t fproto;
+  u32 fib_index, n_applied = 0;
+  int rv;
+
+  vnm->api_errno = 0;
+  fproto = (mp->is_ipv6 ? FIB_PROTOCOL_IP6 : FIB_PROTOCOL_IP4);
+
+  fib_index = fib_table_find (fproto, ntohl (mp->table_id));
+  if (~0 == fib_index)
+    {
+      rv = VNET_API_ERROR_NO_SUCH_FIB;
+      goto out;
+    }
+
+  rv = ip_bulk_routes_parse (mp, fproto, &routes);
+  if (0 != rv)
+    goto out;
+
+  if (mp->is_add)
+    vec_sort_with_function (routes, ip_bulk_route_add_cmp_for_sort);
+  else
+    vec_sort_with_function (routes, ip_bulk_route_del_cmp_for_sort);
+
+  /*
+   * one lock and one FIB batch for the whole request
+   */
+  stats_dslock_with_hint (1 /* release hint */ , 11 /* tag */ );
+  fib_table_batch_begin ();
+
+  vec_foreach (r, routes)
+  {
+    if (r->ibr_is_special)
+      {
+	if (mp->is_add)
+	  {
+	    dpo_id_t dpo = DPO_INVALID;
+	    dpo_proto_t dproto;
+
+	    dproto = fib_proto_to_dpo (fproto);
+
+	    if (r->ibr_is_local)
+	      receive_dpo_add_or_lock (dproto, ~0, NULL, &dpo);
+	    else
+	      ip_null_dpo_add_and_lock (dproto, r->ibr_null_action, &dpo);
+
+	    fib_table_entry_special_dpo_update (fib_index,
+						&r->ibr_prefix,
+						FIB_SOURCE_API,
+						FIB_ENTRY_FLAG_EXCLUSIVE,
+						&dpo);
+	    dpo_reset (&dpo);
+	  }
+	else
+	  fib_table_entry_special_remove (fib_index, &r->ibr_prefix,
+					  FIB_SOURCE_API);
+      }
+    else
+      {
+	if (mp->is_add)
+	  fib_table_entry_update (fib_index, &r->ibr_prefix,
+				  FIB_SOURCE_API, FIB_ENTRY_FLAG_NONE,
+				  r->ibr_paths);
+	else
+	  fib_table_entry_delete (fib_index, &r->ibr_prefix, FIB_SOURCE_API);
+      }
+    n_applied++;
+  }
+
+  fib_table_batch_end ();
+  stats_dsunlock ();
+
+  /* the label stacks are now owned by the FIB entries' path extensions */
+  ip_bulk_routes_free (routes, 0);
+
+  rv = vnm->api_errno;
+
+out:
+  /* *INDENT-OFF* */
+  REPLY_MACRO2 (VL_API_IP_ROUTE_ADD_DEL_BULK_REPLY,
+  ({
+    rmp->n_applied = htonl (n_applied);
+  }));
+  /* *INDENT-ON* */
+}
+
 void
 ip_table_create (fib_protocol_t fproto,
 		 u32 table_id, u8 is_api, const u8 * name)
@@ -3294,6 +3652,14 @@ ip_api_hookup (vlib_main_t * vm)
   foreach_ip_api_msg;
 #undef _
 
+  /*
+   * May be served by the read-only API thread. Only the paged gets, the
+   * dumps would hold the reader lock, and so the main thread, for as
+   * long as it takes to walk every route.
+   */
+  vl_msg_api_set_readonly (VL_API_IP_FIB_GET, 1);
+  vl_msg_api_set_readonly (VL_API_IP6_FIB_GET, 1);
+
   /*
    * Set up the (msg_name, crc, message-id) table
    */
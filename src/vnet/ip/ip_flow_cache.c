@@ -0,0 +1,749 @@
+/*
+ * Copyright (c) 2018 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vlib/vlib.h>
+#include <vnet/vnet.h>
+#include <vnet/ip/ip.h>
+#include <vnet/ip/ip_flow_cache.h>
+#include <vnet/feature/feature.h>
+#include <vnet/udp/udp_packet.h>
+#include <vnet/fib/ip4_fib.h>
+#include <vnet/fib/ip6_fib.h>
+#include <vnet/dpo/load_balance_map.h>
+#include <vnet/adj/adj.h>
+#include <vppinfra/xxhash.h>
+
+ip_flow_cache_main_t ip_flow_cache_main;
+
+#define foreach_ip_flow_cache_error             \
+_(HIT, "packets of cached flows")               \
+_(MISS, "packets of flows not cached")          \
+_(NOT_CACHEABLE, "packets not cacheable")
+
+typedef enum
+{
+#define _(sym,str) IP_FLOW_CACHE_ERROR_##sym,
+  foreach_ip_flow_cache_error
+#undef _
+    IP_FLOW_CACHE_N_ERROR,
+} ip_flow_cache_error_t;
+
+static char *ip_flow_cache_error_strings[] = {
+#define _(sym,string) string,
+  foreach_ip_flow_cache_error
+#undef _
+};
+
+typedef enum
+{
+  IP_FLOW_CACHE_NEXT_REWRITE,
+  IP_FLOW_CACHE_N_NEXT,
+} ip_flow_cache_next_t;
+
+typedef struct
+{
+  u32 sw_if_index;
+  u32 adj_index;
+  u8 hit;
+} ip_flow_cache_trace_t;
+
+static u8 *
+format_ip_flow_cache_trace (u8 * s, va_list * args)
+{
+  CLIB_UNUSED (vlib_main_t * vm) = va_arg (*args, vlib_main_t *);
+  CLIB_UNUSED (vlib_node_t * node) = va_arg (*args, vlib_node_t *);
+  ip_flow_cache_trace_t *t = va_arg (*args, ip_flow_cache_trace_t *);
+
+  s = format (s, "sw_if_index %d ", t->sw_if_index);
+  if (t->hit)
+    s = format (s, "hit, adj-idx %d", t->adj_index);
+  else
+    s = format (s, "miss");
+  return s;
+}
+
+/*
+ * Fill the key of the flow of a TCP or UDP packet, which must not be a
+ * fragment. Return 0 for any other.
+ */
+static_always_inline int
+ip_flow_cache_key (vlib_buffer_t * b, ip_flow_cache_key_t * key, u8 is_ip6)
+{
+  u32 sw_if_index = vnet_buffer (b)->sw_if_index[VLIB_RX];
+  udp_header_t *udp;
+
+  if (is_ip6)
+    {
+      ip6_header_t *ip6 = vlib_buffer_get_current (b);
+
+      if (ip6->protocol != IP_PROTOCOL_TCP &&
+	  ip6->protocol != IP_PROTOCOL_UDP)
+	return 0;
+
+      udp = (udp_header_t *) (ip6 + 1);
+      key->src_address.ip6 = ip6->src_address;
+      key->dst_address.ip6 = ip6->dst_address;
+      key->protocol = ip6->protocol;
+      key->fib_index = vec_elt (ip6_main.fib_index_by_sw_if_index,
+				sw_if_index);
+    }
+  else
+    {
+      ip4_header_t *ip4 = vlib_buffer_get_current (b);
+
+      if ((ip4->protocol != IP_PROTOCOL_TCP &&
+	   ip4->protocol != IP_PROTOCOL_UDP) || ip4_is_fragment (ip4))
+	return 0;
+
+      udp = ip4_next_header (ip4);
+      ip46_address_set_ip4 (&key->src_address, &ip4->src_address);
+      ip46_address_set_ip4 (&key->dst_address, &ip4->dst_address);
+      key->protocol = ip4->protocol;
+      key->fib_index = vec_elt (ip4_main.fib_index_by_sw_if_index,
+				sw_if_index);
+    }
+
+  key->src_port = udp->src_port;
+  key->dst_port = udp->dst_port;
+  key->is_ip6 = is_ip6;
+  key->pad = 0;
+  key->sw_if_index = sw_if_index;
+  return 1;
+}
+
+static_always_inline ip_flow_cache_entry_t *
+ip_flow_cache_entry (ip_flow_cache_per_thread_data_t * ptd,
+		     ip_flow_cache_key_t * key)
+{
+  u64 h = (key->as_u64[0] ^ key->as_u64[1] ^ key->as_u64[2] ^
+	   key->as_u64[3] ^ key->as_u64[4] ^ key->as_u64[5]);
+
+  return ptd->entries + (clib_xxhash (h) & (vec_len (ptd->entries) - 1));
+}
+
+static_always_inline int
+ip_flow_cache_key_equal (ip_flow_cache_key_t * a, ip_flow_cache_key_t * b)
+{
+  return (((a->as_u64[0] ^ b->as_u64[0]) | (a->as_u64[1] ^ b->as_u64[1]) |
+	   (a->as_u64[2] ^ b->as_u64[2]) | (a->as_u64[3] ^ b->as_u64[3]) |
+	   (a->as_u64[4] ^ b->as_u64[4]) | (a->as_u64[5] ^ b->as_u64[5]))
+	  == 0);
+}
+
+static_always_inline int
+ip_flow_cache_is_per_packet (ip_flow_cache_main_t * fcm, u32 sw_if_index,
+			     u8 is_ip6)
+{
+  u8 *n = fcm->n_per_packet_features[is_ip6];
+
+  return (sw_if_index < vec_len (n) && n[sw_if_index]);
+}
+
+static_always_inline uword
+ip_flow_cache_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
+		      vlib_frame_t * frame, u8 is_ip6)
+{
+  ip_flow_cache_main_t *fcm = &ip_flow_cache_main;
+  ip_flow_cache_per_thread_data_t *ptd =
+    vec_elt_at_index (fcm->per_thread_data, vm->thread_index);
+  vlib_combined_counter_main_t *cm = &load_balance_main.lbm_to_counters;
+  /* vlib_buffer_enqueue_to_next () reads ahead */
+  u16 nexts[VLIB_FRAME_SIZE + 32];
+  u32 n_left, *from, i;
+  u32 n_hits = 0, n_misses = 0, n_not_cacheable = 0;
+  u32 epoch = fcm->epoch;
+
+  from = vlib_frame_vector_args (frame);
+  n_left = frame->n_vectors;
+
+  for (i = 0; i < n_left; i++)
+    {
+      vlib_buffer_t *b0 = vlib_get_buffer (vm, from[i]);
+      ip_flow_cache_entry_t *e0 = 0;
+      ip_flow_cache_key_t key0;
+      u32 next0;
+      int hit0 = 0;
+
+      if (i + 2 < n_left)
+	{
+	  vlib_buffer_t *p2 = vlib_get_buffer (vm, from[i + 2]);
+	  vlib_prefetch_buffer_header (p2, STORE);
+	  CLIB_PREFETCH (p2->data + p2->current_data, CLIB_CACHE_LINE_BYTES,
+			 LOAD);
+	}
+
+      /* no entries if the feature was enabled by other means */
+      if (PREDICT_TRUE (ptd->entries != 0) &&
+	  !ip_flow_cache_is_per_packet (fcm,
+				       vnet_buffer (b0)->sw_if_index
+				       [VLIB_RX], is_ip6) &&
+	  ip_flow_cache_key (b0, &key0, is_ip6))
+	{
+	  e0 = ip_flow_cache_entry (ptd, &key0);
+	  hit0 = (e0->epoch == epoch && e0->adj_index != ~0 &&
+		  ip_flow_cache_key_equal (&e0->key, &key0) &&
+		  adj_get (e0->adj_index)->lookup_next_index ==
+		  IP_LOOKUP_NEXT_REWRITE);
+	}
+
+      if (hit0)
+	{
+	  /* what ip4-lookup and ip6-lookup would have done */
+	  vnet_buffer (b0)->ip.fib_index = key0.fib_index;
+	  vnet_buffer (b0)->ip.flow_hash = e0->flow_hash;
+	  vnet_buffer (b0)->ip.adj_index[VLIB_TX] = e0->adj_index;
+	  if (PREDICT_FALSE (e0->is_resilient))
+	    {
+	      const load_balance_t *lb0 = load_balance_get (e0->lb_index);
+	      load_balance_bucket_mark_active (lb0, e0->flow_hash &
+					       lb0->lb_n_buckets_minus_1);
+	    }
+	  vlib_increment_combined_counter (cm, vm->thread_index,
+					   e0->lb_index, 1,
+					   vlib_buffer_length_in_chain (vm,
+									b0));
+	  b0->flags &= ~VNET_BUFFER_F_FLOW_CACHE_LEARN;
+	  next0 = IP_FLOW_CACHE_NEXT_REWRITE;
+	  n_hits++;
+	}
+      else
+	{
+	  if (e0)
+	    {
+	      /* the lookup completes the entry if the packet gets there */
+	      e0->key = key0;
+	      e0->epoch = epoch;
+	      e0->adj_index = ~0;
+	      b0->flags |= VNET_BUFFER_F_FLOW_CACHE_LEARN;
+	      n_misses++;
+	    }
+	  else
+	    n_not_cacheable++;
+	  vnet_feature_next (vnet_buffer (b0)->sw_if_index[VLIB_RX], &next0,
+			     b0);
+	}
+
+      if (PREDICT_FALSE (b0->flags & VLIB_BUFFER_IS_TRACED))
+	{
+	  ip_flow_cache_trace_t *t = vlib_add_trace (vm, node, b0,
+						     sizeof (*t));
+	  t->sw_if_index = vnet_buffer (b0)->sw_if_index[VLIB_RX];
+	  t->adj_index = hit0 ? e0->adj_index : ~0;
+	  t->hit = hit0;
+	}
+
+      nexts[i] = next0;
+    }
+
+  vlib_buffer_enqueue_to_next (vm, node, from, nexts, n_left);
+
+  if (n_misses)
+    {
+      ptd->n_learning += n_misses;
+      ptd->n_learning_frames = IP_FLOW_CACHE_LEARNING_FRAMES;
+    }
+  ptd->n_hits += n_hits;
+  ptd->n_misses += n_misses;
+
+  vlib_node_increment_counter (vm, node->node_index, IP_FLOW_CACHE_ERROR_HIT,
+			       n_hits);
+  vlib_node_increment_counter (vm, node->node_index,
+			       IP_FLOW_CACHE_ERROR_MISS, n_misses);
+  vlib_node_increment_counter (vm, node->node_index,
+			       IP_FLOW_CACHE_ERROR_NOT_CACHEABLE,
+			       n_not_cacheable);
+
+  return frame->n_vectors;
+}
+
+static uword
+ip4_flow_cache (vlib_main_t * vm, vlib_node_runtime_t * node,
+		vlib_frame_t * frame)
+{
+  return ip_flow_cache_inline (vm, node, frame, 0 /* is_ip6 */ );
+}
+
+static uword
+ip6_flow_cache (vlib_main_t * vm, vlib_node_runtime_t * node,
+		vlib_frame_t * frame)
+{
+  return ip_flow_cache_inline (vm, node, frame, 1 /* is_ip6 */ );
+}
+
+/* *INDENT-OFF* */
+VLIB_REGISTER_NODE (ip4_flow_cache_node) =
+{
+  .function = ip4_flow_cache,
+  .name = "ip4-flow-cache",
+  .vector_size = sizeof (u32),
+  .format_trace = format_ip_flow_cache_trace,
+  .type = VLIB_NODE_TYPE_INTERNAL,
+  .n_errors = IP_FLOW_CACHE_N_ERROR,
+  .error_strings = ip_flow_cache_error_strings,
+  .n_next_nodes = IP_FLOW_CACHE_N_NEXT,
+  .next_nodes = {
+    [IP_FLOW_CACHE_NEXT_REWRITE] = "ip4-rewrite",
+  },
+};
+
+VLIB_NODE_FUNCTION_MULTIARCH (ip4_flow_cache_node, ip4_flow_cache);
+
+VNET_FEATURE_INIT (ip4_flow_cache_feature, static) =
+{
+  .arc_name = "ip4-unicast",
+  .node_name = "ip4-flow-cache",
+  .runs_before = VNET_FEATURES ("ip4-flow-classify", "ip4-inacl",
+                                "ip4-source-check-via-rx",
+                                "ip4-source-check-via-any",
+                                "ip4-source-and-port-range-check-rx",
+                                "ip4-policer-classify", "ipsec-input-ip4",
+                                "vpath-input-ip4", "ip4-vxlan-bypass",
+                                "ip4-not-enabled", "ip4-lookup"),
+};
+
+VLIB_REGISTER_NODE (ip6_flow_cache_node) =
+{
+  .function = ip6_flow_cache,
+  .name = "ip6-flow-cache",
+  .vector_size = sizeof (u32),
+  .format_trace = format_ip_flow_cache_trace,
+  .type = VLIB_NODE_TYPE_INTERNAL,
+  .n_errors = IP_FLOW_CACHE_N_ERROR,
+  .error_strings = ip_flow_cache_error_strings,
+  .n_next_nodes = IP_FLOW_CACHE_N_NEXT,
+  .next_nodes = {
+    [IP_FLOW_CACHE_NEXT_REWRITE] = "ip6-rewrite",
+  },
+};
+
+VLIB_NODE_FUNCTION_MULTIARCH (ip6_flow_cache_node, ip6_flow_cache);
+
+VNET_FEATURE_INIT (ip6_flow_cache_feature, static) =
+{
+  .arc_name = "ip6-unicast",
+  .node_name = "ip6-flow-cache",
+  .runs_before = VNET_FEATURES ("ip6-flow-classify", "ip6-inacl",
+                                "ip6-policer-classify", "ipsec-input-ip6",
+                                "l2tp-decap", "vpath-input-ip6",
+                                "ip6-vxlan-bypass", "ip6-not-enabled",
+                                "ip6-lookup"),
+};
+/* *INDENT-ON* */
+
+/*
+ * The bucket of the load balance the lookup forwarded the packet through,
+ * found as ip4-lookup and ip6-lookup do
+ */
+static_always_inline const dpo_id_t *
+ip_flow_cache_lb_bucket (const load_balance_t * lb, u32 flow_hash)
+{
+  if (lb->lb_n_buckets > 1)
+    return (load_balance_get_fwd_bucket (lb,
+					 flow_hash &
+					 lb->lb_n_buckets_minus_1));
+  return (load_balance_get_bucket_i (lb, 0));
+}
+
+/*
+ * Complete the entries of the flows whose packets reached the lookup
+ * unchanged, if they were forwarded through a rewrite adjacency. The
+ * load balance and bucket are found again the way the lookup does.
+ */
+static_always_inline void
+ip_flow_cache_learn (vlib_main_t * vm, u32 * buffers, u32 n_buffers,
+		     u8 is_ip6)
+{
+  ip_flow_cache_main_t *fcm = &ip_flow_cache_main;
+  ip_flow_cache_per_thread_data_t *ptd =
+    vec_elt_at_index (fcm->per_thread_data, vm->thread_index);
+  u32 i, n_seen = 0;
+
+  for (i = 0; i < n_buffers; i++)
+    {
+      vlib_buffer_t *b = vlib_get_buffer (vm, buffers[i]);
+      ip_flow_cache_entry_t *e;
+      ip_flow_cache_key_t key;
+      const load_balance_t *lb;
+      const dpo_id_t *dpo;
+      u32 lbi;
+
+      if (!(b->flags & VNET_BUFFER_F_FLOW_CACHE_LEARN))
+	continue;
+      b->flags &= ~VNET_BUFFER_F_FLOW_CACHE_LEARN;
+      n_seen++;
+
+      if (!ip_flow_cache_key (b, &key, is_ip6))
+	continue;
+
+      /* a feature may have moved the packet to another table */
+      if (vnet_buffer (b)->ip.fib_index != key.fib_index)
+	continue;
+
+      e = ip_flow_cache_entry (ptd, &key);
+      if (e->epoch != fcm->epoch || e->adj_index != ~0 ||
+	  !ip_flow_cache_key_equal (&e->key, &key))
+	continue;
+
+      if (is_ip6)
+	{
+	  ip6_header_t *ip6 = vlib_buffer_get_current (b);
+	  lbi = ip6_fib_table_fwding_lookup (&ip6_main,
+					     vnet_buffer (b)->ip.fib_index,
+					     &ip6->dst_address);
+	}
+      else
+	{
+	  ip4_header_t *ip4 = vlib_buffer_get_current (b);
+	  lbi = ip4_fib_forwarding_lookup (vnet_buffer (b)->ip.fib_index,
+					   &ip4->dst_address);
+	}
+      lb = load_balance_get (lbi);
+      dpo = ip_flow_cache_lb_bucket (lb, vnet_buffer (b)->ip.flow_hash);
+
+      if (dpo->dpoi_type != DPO_ADJACENCY ||
+	  dpo->dpoi_index != vnet_buffer (b)->ip.adj_index[VLIB_TX] ||
+	  adj_get (dpo->dpoi_index)->lookup_next_index !=
+	  IP_LOOKUP_NEXT_REWRITE)
+	continue;
+
+      e->adj_index = dpo->dpoi_index;
+      e->lb_index = lbi;
+      e->flow_hash = vnet_buffer (b)->ip.flow_hash;
+      e->is_resilient = ! !(lb->lb_flags & LOAD_BALANCE_FLAG_RESILIENT);
+      ptd->n_learnt++;
+    }
+
+  /*
+   * The packets of a miss frame may reach the lookup in several frames,
+   * and those a feature drops or consumes never do, so learning stops
+   * once they are all seen or after a few frames without them
+   */
+  ptd->n_learning -= clib_min (n_seen, ptd->n_learning);
+  if (n_seen == 0 && ptd->n_learning_frames)
+    ptd->n_learning_frames--;
+  if (0 == ptd->n_learning_frames)
+    ptd->n_learning = 0;
+}
+
+void
+ip4_flow_cache_learn (vlib_main_t * vm, u32 * buffers, u32 n_buffers)
+{
+  ip_flow_cache_learn (vm, buffers, n_buffers, 0 /* is_ip6 */ );
+}
+
+void
+ip6_flow_cache_learn (vlib_main_t * vm, u32 * buffers, u32 n_buffers)
+{
+  ip_flow_cache_learn (vm, buffers, n_buffers, 1 /* is_ip6 */ );
+}
+
+/*
+ * The features which must see every packet of a flow, whose outcome
+ * depends on rates or counts
+ */
+static char *ip_flow_cache_per_packet_features[2][3] = {
+  {"ip4-policer-classify", "ip4-flow-classify", 0},
+  {"ip6-policer-classify", "ip6-flow-classify", 0},
+};
+
+/*
+ * Called on any change of the features of an interface: invalidate the
+ * flows cached and track the features which must see every packet.
+ */
+void
+ip_flow_cache_feature_update (u8 arc_index, u32 feature_index,
+			      u32 sw_if_index, int is_enable)
+{
+  ip_flow_cache_main_t *fcm = &ip_flow_cache_main;
+  char **name;
+  u8 is_ip6, *n;
+
+  ip_flow_cache_invalidate ();
+
+  if (arc_index == ip4_main.lookup_main.ucast_feature_arc_index)
+    is_ip6 = 0;
+  else if (arc_index == ip6_main.lookup_main.ucast_feature_arc_index)
+    is_ip6 = 1;
+  else
+    return;
+
+  for (name = ip_flow_cache_per_packet_features[is_ip6]; *name; name++)
+    if (vnet_get_feature_index (arc_index, *name) == feature_index)
+      {
+	vec_validate (fcm->n_per_packet_features[is_ip6], sw_if_index);
+	n = &fcm->n_per_packet_features[is_ip6][sw_if_index];
+	if (is_enable)
+	  n[0]++;
+	else if (n[0])
+	  n[0]--;
+	return;
+      }
+}
+
+static void
+ip_flow_cache_alloc_entries (void)
+{
+  ip_flow_cache_main_t *fcm = &ip_flow_cache_main;
+  ip_flow_cache_per_thread_data_t *ptd;
+  ip_flow_cache_entry_t *e;
+
+  vec_foreach (ptd, fcm->per_thread_data)
+  {
+    vec_free (ptd->entries);
+    vec_validate_aligned (ptd->entries, (1 << fcm->log2_n_entries) - 1,
+			  CLIB_CACHE_LINE_BYTES);
+    vec_foreach (e, ptd->entries) e->adj_index = ~0;
+    ptd->n_learning = 0;
+    ptd->n_learning_frames = 0;
+  }
+}
+
+int
+vnet_ip_flow_cache_enable_disable (u32 sw_if_index, u8 is_ip6, u8 enable)
+{
+  ip_flow_cache_main_t *fcm = &ip_flow_cache_main;
+  vnet_main_t *vnm = vnet_get_main ();
+
+  if (pool_is_free_index (vnm->interface_main.sw_interfaces, sw_if_index))
+    return VNET_API_ERROR_INVALID_SW_IF_INDEX;
+
+  if (enable && fcm->per_thread_data[0].entries == 0)
+    ip_flow_cache_alloc_entries ();
+
+  return vnet_feature_enable_disable (is_ip6 ? "ip6-unicast" : "ip4-unicast",
+				      is_ip6 ? "ip6-flow-cache" :
+				      "ip4-flow-cache", sw_if_index, enable,
+				      0, 0);
+}
+
+int
+vnet_ip_flow_cache_set_entries (u32 n_entries)
+{
+  ip_flow_cache_main_t *fcm = &ip_flow_cache_main;
+
+  if (!is_pow2 (n_entries) ||
+      n_entries > (1 << IP_FLOW_CACHE_MAX_LOG2_ENTRIES))
+    return VNET_API_ERROR_INVALID_VALUE;
+
+  fcm->log2_n_entries = min_log2 (n_entries);
+  if (fcm->per_thread_data[0].entries)
+    ip_flow_cache_alloc_entries ();
+  return 0;
+}
+
+static clib_error_t *
+set_interface_ip_flow_cache_command_fn (vlib_main_t * vm,
+					unformat_input_t * input,
+					vlib_cli_command_t * cmd)
+{
+  vnet_main_t *vnm = vnet_get_main ();
+  u32 sw_if_index = ~0;
+  u8 enable = 1, ip4 = 0, ip6 = 0;
+  int rv = 0;
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "%U", unformat_vnet_sw_interface, vnm,
+		    &sw_if_index))
+	;
+      else if (unformat (input, "ip4"))
+	ip4 = 1;
+      else if (unformat (input, "ip6"))
+	ip6 = 1;
+      else if (unformat (input, "disable"))
+	enable = 0;
+      else
+	return clib_error_return (0, "unknown input `%U'",
+				  format_unformat_error, input);
+    }
+
+  if (sw_if_index == ~0)
+    return clib_error_return (0, "interface required");
+
+  if (!ip4 && !ip6)
+    ip4 = ip6 = 1;
+
+  if (ip4)
+    rv = vnet_ip_flow_cache_enable_disable (sw_if_index, 0, enable);
+  if (ip6 && !rv)
+    rv = vnet_ip_flow_cache_enable_disable (sw_if_index, 1, enable);
+  if (rv)
+    return clib_error_return (0, "vnet_ip_flow_cache_enable_disable "
+			      "returned %d", rv);
+  return 0;
+}
+
+/*?
+ * Cache the forwarding of the TCP and UDP flows received on an
+ * interface. The first packet of a flow is processed as usual; the
+ * following ones skip the features of the unicast arc and the lookup,
+ * and go straight to the rewrite of the adjacency the first one was
+ * forwarded through. The features are thus applied per flow rather
+ * than per packet. Nothing is cached on an interface with policer or
+ * flow classification enabled, as they must see every packet; do not
+ * enable the cache on an interface with other features which keep
+ * state, such as reflexive ACLs.
+ *
+ * @cliexpar
+ * @cliexcmd{set interface ip flow-cache GigabitEthernet2/0/0}
+ * @cliexcmd{set interface ip flow-cache GigabitEthernet2/0/0 ip6 disable}
+?*/
+/* *INDENT-OFF* */
+VLIB_CLI_COMMAND (set_interface_ip_flow_cache_command, static) =
+{
+  .path = "set interface ip flow-cache",
+  .short_help = "set interface ip flow-cache <interface> [ip4|ip6] "
+                "[disable]",
+  .function = set_interface_ip_flow_cache_command_fn,
+};
+/* *INDENT-ON* */
+
+static clib_error_t *
+set_ip_flow_cache_command_fn (vlib_main_t * vm, unformat_input_t * input,
+			      vlib_cli_command_t * cmd)
+{
+  u32 n_entries = ~0;
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "entries %u", &n_entries))
+	;
+      else
+	return clib_error_return (0, "unknown input `%U'",
+				  format_unformat_error, input);
+    }
+
+  if (n_entries == ~0)
+    return clib_error_return (0, "entries required");
+
+  if (vnet_ip_flow_cache_set_entries (n_entries))
+    return clib_error_return (0, "entries must be a power of 2, at most %d",
+			      1 << IP_FLOW_CACHE_MAX_LOG2_ENTRIES);
+  return 0;
+}
+
+/*?
+ * Set how many flows each thread caches. Flows are hashed to an entry,
+ * a flow replaces any other in the same entry. Resizing empties the
+ * cache.
+ *
+ * @cliexpar
+ * @cliexcmd{set ip flow-cache entries 4096}
+?*/
+/* *INDENT-OFF* */
+VLIB_CLI_COMMAND (set_ip_flow_cache_command, static) =
+{
+  .path = "set ip flow-cache",
+  .short_help = "set ip flow-cache entries <n>",
+  .function = set_ip_flow_cache_command_fn,
+};
+/* *INDENT-ON* */
+
+static clib_error_t *
+show_ip_flow_cache_command_fn (vlib_main_t * vm, unformat_input_t * input,
+			       vlib_cli_command_t * cmd)
+{
+  ip_flow_cache_main_t *fcm = &ip_flow_cache_main;
+  ip_flow_cache_per_thread_data_t *ptd;
+  ip_flow_cache_entry_t *e;
+  u64 n_hits = 0, n_misses = 0, n_learnt = 0;
+  u32 n_cached = 0;
+
+  vec_foreach (ptd, fcm->per_thread_data)
+  {
+    n_hits += ptd->n_hits;
+    n_misses += ptd->n_misses;
+    n_learnt += ptd->n_learnt;
+    vec_foreach (e, ptd->entries)
+      n_cached += (e->epoch == fcm->epoch && e->adj_index != ~0);
+  }
+
+  vlib_cli_output (vm, "entries per thread %u, epoch %u",
+		   1 << fcm->log2_n_entries, fcm->epoch);
+  vlib_cli_output (vm, "flows cached %u, learnt %llu", n_cached, n_learnt);
+  vlib_cli_output (vm, "hits %llu, misses %llu", n_hits, n_misses);
+  return 0;
+}
+
+/*?
+ * Show the IP flow cache: the flows currently cached, over all threads,
+ * those learnt since start, and the packets which hit and missed the
+ * cache.
+ *
+ * @cliexpar
+ * @cliexstart{show ip flow-cache}
+ * entries per thread 1024, epoch 7
+ * flows cached 12, learnt 40
+ * hits 1843220, misses 52
+ * @cliexend
+?*/
+/* *INDENT-OFF* */
+VLIB_CLI_COMMAND (show_ip_flow_cache_command, static) =
+{
+  .path = "show ip flow-cache",
+  .short_help = "show ip flow-cache",
+  .function = show_ip_flow_cache_command_fn,
+};
+/* *INDENT-ON* */
+
+static clib_error_t *
+clear_ip_flow_cache_command_fn (vlib_main_t * vm, unformat_input_t * input,
+				vlib_cli_command_t * cmd)
+{
+  ip_flow_cache_invalidate ();
+  return 0;
+}
+
+/*?
+ * Invalidate all the flows cached. This is done automatically on any
+ * change of the forwarding or of the unicast features; configuration
+ * the cache does not see, such as that of plugin features, requires it.
+ *
+ * @cliexpar
+ * @cliexcmd{clear ip flow-cache}
+?*/
+/* *INDENT-OFF* */
+VLIB_CLI_COMMAND (clear_ip_flow_cache_command, static) =
+{
+  .path = "clear ip flow-cache",
+  .short_help = "clear ip flow-cache",
+  .function = clear_ip_flow_cache_command_fn,
+};
+/* *INDENT-ON* */
+
+static clib_error_t *
+ip_flow_cache_init (vlib_main_t * vm)
+{
+  ip_flow_cache_main_t *fcm = &ip_flow_cache_main;
+  vlib_thread_main_t *tm = vlib_get_thread_main ();
+
+  /* zeroed entries are of no epoch */
+  fcm->epoch = 1;
+  fcm->log2_n_entries = IP_FLOW_CACHE_DEFAULT_LOG2_ENTRIES;
+  vec_validate_aligned (fcm->per_thread_data, tm->n_vlib_mains - 1,
+			CLIB_CACHE_LINE_BYTES);
+
+  return 0;
+}
+
+VLIB_INIT_FUNCTION (ip_flow_cache_init);
+
+/*
+ * fd.io coding-style-patch-verification: ON
+ *
+ * Local Variables:
+ * eval: (c-set-style "gnu")
+ * End:
+ */
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2018 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file
+ * @brief IP flow cache.
+ *
+ * The "ip4-flow-cache" and "ip6-flow-cache" features run first on the
+ * unicast arcs of the interfaces they are enabled on. The first packet
+ * of a TCP or UDP flow goes through the rest of the arc and the lookup
+ * as usual; if it reaches the lookup unchanged and is forwarded through
+ * a rewrite adjacency, that adjacency is recorded for the flow. Later
+ * packets of the flow skip the rest of the arc and the lookup and go
+ * straight to the rewrite.
+ *
+ * The features after the flow cache are thus only run on the first
+ * packet of a flow: it is only to be enabled where their outcome for a
+ * flow changes with configuration only, not with time or state.
+ * Packets they rewrite, NAT for instance, or move to another table are
+ * never cached. Nothing is cached on an interface with a feature which
+ * must see every packet, policer and flow classification, enabled.
+ * The ACL plugin orders its input nodes after the flow cache.
+ *
+ * A hit on a flow through a resilient load balance marks its bucket
+ * active, as the lookup does, so that the flow keeps its path.
+ *
+ * All entries are invalidated at once, by bumping an epoch, whenever
+ * forwarding, feature, classifier, ACL or IPsec configuration changes.
+ */
+
+#ifndef __included_ip_flow_cache_h__
+#define __included_ip_flow_cache_h__
+
+#include <vnet/vnet.h>
+#include <vnet/ip/ip6_packet.h>
+
+#define IP_FLOW_CACHE_DEFAULT_LOG2_ENTRIES 10
+#define IP_FLOW_CACHE_MAX_LOG2_ENTRIES 20
+
+/** Lookup frames to wait for the packets of a miss before giving up */
+#define IP_FLOW_CACHE_LEARNING_FRAMES 8
+
+typedef struct
+{
+  union
+  {
+    struct
+    {
+      ip46_address_t src_address;
+      ip46_address_t dst_address;
+      u16 src_port;
+      u16 dst_port;
+      u8 protocol;
+      u8 is_ip6;
+      u16 pad;
+      u32 sw_if_index;
+      u32 fib_index;
+    };
+    u64 as_u64[6];
+  };
+} ip_flow_cache_key_t;
+
+typedef struct
+{
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
+  ip_flow_cache_key_t key;
+  /** Epoch the entry was created in, it is stale in any other */
+  u32 epoch:31;
+  /**
+   * The load balance is resilient: a hit marks the flow's bucket active,
+   * as the lookup would, so that the bucket does not move
+   */
+  u32 is_resilient:1;
+  /** Rewrite adjacency of the flow, ~0 while it is being learnt */
+  u32 adj_index;
+  /** Load balance the adjacency was found through, for its counters */
+  u32 lb_index;
+  u32 flow_hash;
+} ip_flow_cache_entry_t;
+
+/** The epoch wraps within the bits of ip_flow_cache_entry_t's */
+#define IP_FLOW_CACHE_EPOCH_MASK ((1u << 31) - 1)
+
+typedef struct
+{
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
+  /** Direct mapped by flow hash */
+  ip_flow_cache_entry_t *entries;
+  /** Packets sent to the lookup to learn their flow, not seen there yet */
+  u32 n_learning;
+  /**
+   * Lookup frames to go before giving up on the packets still counted
+   * in n_learning, which a feature dropped or consumed on the way
+   */
+  u32 n_learning_frames;
+
+  /* Statistics */
+  u64 n_hits;
+  u64 n_misses;
+  u64 n_learnt;
+} ip_flow_cache_per_thread_data_t;
+
+typedef struct
+{
+  ip_flow_cache_per_thread_data_t *per_thread_data;
+
+  /** Bumped on configuration changes, invalidating all entries */
+  u32 epoch;
+
+  /** Entries per thread */
+  u32 log2_n_entries;
+
+  /**
+   * Features enabled which must see every packet, by is_ip6 and
+   * sw_if_index: nothing is cached on interfaces with any
+   */
+  u8 *n_per_packet_features[2];
+} ip_flow_cache_main_t;
+
+extern ip_flow_cache_main_t ip_flow_cache_main;
+
+/**
+ * Invalidate all the flows cached. To be called on any change of the
+ * forwarding or of the features of the unicast arcs.
+ */
+static_always_inline void
+ip_flow_cache_invalidate (void)
+{
+  ip_flow_cache_main_t *fcm = &ip_flow_cache_main;
+
+  /* zeroed entries are of epoch 0, which is skipped */
+  fcm->epoch = (fcm->epoch + 1) & IP_FLOW_CACHE_EPOCH_MASK;
+  if (0 == fcm->epoch)
+    fcm->epoch = 1;
+}
+
+void ip_flow_cache_feature_update (u8 arc_index, u32 feature_index,
+				   u32 sw_if_index, int is_enable);
+
+/* Called from ip4-lookup and ip6-lookup, on the packets of a frame */
+void ip4_flow_cache_learn (vlib_main_t * vm, u32 * buffers, u32 n_buffers);
+void ip6_flow_cache_learn (vlib_main_t * vm, u32 * buffers, u32 n_buffers);
+
+static_always_inline int
+ip_flow_cache_is_learning (u32 thread_index)
+{
+  ip_flow_cache_main_t *fcm = &ip_flow_cache_main;
+
+  return fcm->per_thread_data[thread_index].n_learning;
+}
+
+int vnet_ip_flow_cache_enable_disable (u32 sw_if_index, u8 is_ip6,
+				       u8 enable);
+int vnet_ip_flow_cache_set_entries (u32 n_entries);
+
+#endif /* __included_ip_flow_cache_h__ */
+
+/*
+ * fd.io coding-style-patch-verification: ON
+ *
+ * Local Variables:
+ * eval: (c-set-style "gnu")
+ * End:
+ */
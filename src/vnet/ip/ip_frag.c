@@ -46,6 +46,235 @@ format_ip_frag_trace (u8 * s, va_list * args)
 
 static u32 running_fragment_id;
 
+/* longest buffer chain ip4_frag_do_fragment_chain handles */
+#define IP_FRAG_MAX_CHAIN_LENGTH 32
+
+/*
+ * Copy n bytes to the end of a fragment, in the tail buffer if it is one
+ * of ours with room left, or else in new buffers linked after it.
+ */
+static int
+ip4_frag_chain_copy (vlib_main_t * vm, vlib_buffer_t * b,
+		     vlib_buffer_t ** tail, u8 * tail_is_ours, u8 * src,
+		     u32 n)
+{
+  while (n)
+    {
+      vlib_buffer_t *t = *tail;
+      u32 room, bi;
+
+      room = *tail_is_ours ?
+	VLIB_BUFFER_DATA_SIZE - t->current_data - t->current_length : 0;
+      if (0 == room)
+	{
+	  if (!vlib_buffer_alloc (vm, &bi, 1))
+	    return -1;
+	  t->next_buffer = bi;
+	  t->flags |= VLIB_BUFFER_NEXT_PRESENT;
+	  t = *tail = vlib_get_buffer (vm, bi);
+	  t->current_length = 0;
+	  t->flags = 0;
+	  *tail_is_ours = 1;
+	  room = VLIB_BUFFER_DATA_SIZE - t->current_data;
+	}
+      room = clib_min (room, n);
+      clib_memcpy (vlib_buffer_get_current (t) + t->current_length, src,
+		   room);
+      t->current_length += room;
+      if (t != b)
+	b->total_length_not_including_first_buffer += room;
+      src += room;
+      n -= room;
+    }
+  return 0;
+}
+
+/*
+ * Fragment a buffer chain, as a jumbo frame is, without copying its
+ * payload. Each fragment is a header buffer followed by the segments of
+ * the original chain which start in it, linked in as they are and cut at
+ * the fragment's end; only the bytes of a segment which run into the
+ * next fragment are copied, into that fragment's header buffer. The head
+ * buffer is the first fragment. Segments shared with another packet are
+ * copied, not linked.
+ */
+static void
+ip4_frag_do_fragment_chain (vlib_main_t * vm, u32 pi, u32 ** buffer,
+			    ip_frag_error_t * error, u16 ip_frag_id,
+			    u16 ip_frag_offset, u8 more)
+{
+  u32 segs[IP_FRAG_MAX_CHAIN_LENGTH], n_segs = 0, owned = 1, si = 0;
+  u16 offset, headers_len, max, len, rem, ptr = 0;
+  u32 bi, sbi, s_off, s_avail;
+  vlib_buffer_t *p, *b, *sb, *tail;
+  ip4_header_t *ip4, *fip4;
+  u8 *packet, tail_is_ours;
+
+  p = vlib_get_buffer (vm, pi);
+  offset = vnet_buffer (p)->ip_frag.header_offset;
+  packet = (u8 *) vlib_buffer_get_current (p);
+  ip4 = (ip4_header_t *) (packet + offset);
+  headers_len = offset + sizeof (*ip4);
+  rem = clib_net_to_host_u16 (ip4->length) - sizeof (*ip4);
+  max = (vnet_buffer (p)->ip_frag.mtu - headers_len) & ~0x7;
+
+  sbi = pi;
+  while (1)
+    {
+      sb = vlib_get_buffer (vm, sbi);
+      segs[n_segs++] = sbi;
+      if (!(sb->flags & VLIB_BUFFER_NEXT_PRESENT))
+	break;
+      if (n_segs == IP_FRAG_MAX_CHAIN_LENGTH)
+	{
+	  *error = IP_FRAG_ERROR_MALFORMED;
+	  return;
+	}
+      sbi = sb->next_buffer;
+    }
+
+  if (p->current_length < headers_len ||
+      rem > vlib_buffer_length_in_chain (vm, p) - headers_len || 0 == max)
+    {
+      *error = IP_FRAG_ERROR_MALFORMED;
+      return;
+    }
+
+  /* the read position in the original chain */
+  s_off = headers_len;
+  s_avail = p->current_length - headers_len;
+
+  while (rem)
+    {
+      u32 need;
+
+      len = (rem > max) ? max : rem;
+
+      if (ptr == 0)
+	{
+	  bi = pi;
+	  b = p;
+	}
+      else
+	{
+	  if (!vlib_buffer_alloc (vm, &bi, 1))
+	    {
+	      *error = IP_FRAG_ERROR_MEMORY;
+	      goto done;
+	    }
+	  vec_add1 (*buffer, bi);
+	  b = vlib_get_buffer (vm, bi);
+	  b->flags = 0;
+	  vnet_buffer (b)->sw_if_index[VLIB_RX] =
+	    vnet_buffer (p)->sw_if_index[VLIB_RX];
+	  vnet_buffer (b)->sw_if_index[VLIB_TX] =
+	    vnet_buffer (p)->sw_if_index[VLIB_TX];
+	  vnet_buffer (b)->ip.adj_index[VLIB_RX] =
+	    vnet_buffer (p)->ip.adj_index[VLIB_RX];
+	  vnet_buffer (b)->ip.adj_index[VLIB_TX] =
+	    vnet_buffer (p)->ip.adj_index[VLIB_TX];
+	  //Copy offset and ip4 header
+	  clib_memcpy (b->data, packet, headers_len);
+	}
+      b->current_length = headers_len;
+      b->total_length_not_including_first_buffer = 0;
+      b->flags &= ~VLIB_BUFFER_NEXT_PRESENT;
+      tail = b;
+      tail_is_ours = (b != p);
+
+      need = len;
+      while (need)
+	{
+	  u32 n;
+
+	  if (0 == s_avail)
+	    {
+	      /* move on to the next segment */
+	      si++;
+	      ASSERT (si < n_segs);
+	      s_off = 0;
+	      s_avail = vlib_get_buffer (vm, segs[si])->current_length;
+	      continue;
+	    }
+
+	  sb = vlib_get_buffer (vm, segs[si]);
+	  n = clib_min (need, s_avail);
+
+	  if (sb == b)
+	    {
+	      /* the head's own payload, already in place */
+	      b->current_length += n;
+	    }
+	  else if (0 == s_off && 0 == sb->n_add_refs)
+	    {
+	      /* link the segment in, cut to this fragment */
+	      tail->next_buffer = segs[si];
+	      tail->flags |= VLIB_BUFFER_NEXT_PRESENT;
+	      sb->current_length = n;
+	      b->total_length_not_including_first_buffer += n;
+	      tail = sb;
+	      tail_is_ours = 0;
+	      owned |= 1u << si;
+	    }
+	  else if (ip4_frag_chain_copy (vm, b, &tail, &tail_is_ours,
+					vlib_buffer_get_current (sb) + s_off,
+					n))
+	    {
+	      tail->flags &= ~VLIB_BUFFER_NEXT_PRESENT;
+	      *error = IP_FRAG_ERROR_MEMORY;
+	      goto done;
+	    }
+
+	  s_off += n;
+	  s_avail -= n;
+	  need -= n;
+	}
+      tail->flags &= ~VLIB_BUFFER_NEXT_PRESENT;
+      if (b->flags & VLIB_BUFFER_NEXT_PRESENT)
+	b->flags |= VLIB_BUFFER_TOTAL_LENGTH_VALID;
+
+      fip4 = (ip4_header_t *) (vlib_buffer_get_current (b) + offset);
+      fip4->fragment_id = ip_frag_id;
+      fip4->flags_and_fragment_offset =
+	clib_host_to_net_u16 ((ptr >> 3) + ip_frag_offset);
+      fip4->flags_and_fragment_offset |=
+	clib_host_to_net_u16 (((len != rem) || more) << 13);
+      fip4->length = clib_host_to_net_u16 (len + sizeof (*fip4));
+      fip4->checksum = ip4_header_checksum (fip4);
+
+      if (vnet_buffer (p)->ip_frag.flags & IP_FRAG_FLAG_IP4_HEADER)
+	{
+	  //Encapsulating ipv4 header
+	  ip4_header_t *encap_header4 =
+	    (ip4_header_t *) vlib_buffer_get_current (b);
+	  encap_header4->length = clib_host_to_net_u16 (headers_len + len);
+	  encap_header4->checksum = ip4_header_checksum (encap_header4);
+	}
+      else if (vnet_buffer (p)->ip_frag.flags & IP_FRAG_FLAG_IP6_HEADER)
+	{
+	  //Encapsulating ipv6 header
+	  ip6_header_t *encap_header6 =
+	    (ip6_header_t *) vlib_buffer_get_current (b);
+	  encap_header6->payload_length =
+	    clib_host_to_net_u16 (headers_len + len -
+				  sizeof (*encap_header6));
+	}
+
+      rem -= len;
+      ptr += len;
+    }
+
+done:
+  /* free the segments no fragment took, e.g. trailing padding */
+  for (si = 1; si < n_segs; si++)
+    if (!(owned & (1u << si)))
+      {
+	sb = vlib_get_buffer (vm, segs[si]);
+	sb->flags &= ~VLIB_BUFFER_NEXT_PRESENT;
+	vlib_buffer_free_one (vm, segs[si]);
+      }
+}
+
 void
 ip4_frag_do_fragment (vlib_main_t * vm, u32 pi, u32 ** buffer,
 		      ip_frag_error_t * error)
@@ -85,12 +314,6 @@ ip4_frag_do_fragment (vlib_main_t * vm, u32 pi, u32 ** buffer,
       return;
     }
 
-  if (p->flags & VLIB_BUFFER_NEXT_PRESENT)
-    {
-      *error = IP_FRAG_ERROR_MALFORMED;
-      return;
-    }
-
   if (ip4_is_fragment (ip4))
     {
       ip_frag_id = ip4->fragment_id;
@@ -106,6 +329,13 @@ ip4_frag_do_fragment (vlib_main_t * vm, u32 pi, u32 ** buffer,
       more = 0;
     }
 
+  if (p->flags & VLIB_BUFFER_NEXT_PRESENT)
+    {
+      ip4_frag_do_fragment_chain (vm, pi, buffer, error, ip_frag_id,
+				  ip_frag_offset, more);
+      return;
+    }
+
   //Do the actual fragmentation
   while (rem)
     {
@@ -109,6 +109,9 @@ ip_in_out_acl_inline (vlib_main_t * vm,
   in_out_acl_table_id_t tid;
   vlib_node_runtime_t *error_node;
   u32 n_next_nodes;
+  u16 reass_ports[VLIB_FRAME_SIZE][2];
+  u32x4 copy[VNET_CLASSIFY_REWRITE_N_VECTORS];
+  u32 *buffers;
 
   n_next_nodes = node->n_next_nodes;
 
@@ -123,7 +126,7 @@ ip_in_out_acl_inline (vlib_main_t * vm,
       error_node = vlib_node_get_runtime (vm, ip6_input_node.index);
     }
 
-  from = vlib_frame_vector_args (frame);
+  from = buffers = vlib_frame_vector_args (frame);
   n_left_from = frame->n_vectors;
 
   /* First pass: compute hashes */
@@ -183,6 +186,13 @@ ip_in_out_acl_inline (vlib_main_t * vm,
 	  /* advance the match pointer so the matching happens on IP header */
 	  h0 += vnet_buffer (b0)->l2_classify.pad.l2_len;
 	}
+      else if (is_ip4)
+	{
+	  u16 *ports0 = reass_ports[from - buffers];
+
+	  vnet_classify_get_ip4_reass_ports (b0, ports0);
+	  h0 = vnet_classify_ip4_reass_data (b0, t0, h0, ports0, copy);
+	}
 
       vnet_buffer (b0)->l2_classify.hash =
 	vnet_classify_hash_packet (t0, (u8 *) h0);
@@ -202,6 +212,13 @@ ip_in_out_acl_inline (vlib_main_t * vm,
 	  /* advance the match pointer so the matching happens on IP header */
 	  h1 += vnet_buffer (b1)->l2_classify.pad.l2_len;
 	}
+      else if (is_ip4)
+	{
+	  u16 *ports1 = reass_ports[from + 1 - buffers];
+
+	  vnet_classify_get_ip4_reass_ports (b1, ports1);
+	  h1 = vnet_classify_ip4_reass_data (b1, t1, h1, ports1, copy);
+	}
 
       vnet_buffer (b1)->l2_classify.hash =
 	vnet_classify_hash_packet (t1, (u8 *) h1);
@@ -248,6 +265,13 @@ ip_in_out_acl_inline (vlib_main_t * vm,
 	  /* advance the match pointer so the matching happens on IP header */
 	  h0 += vnet_buffer (b0)->l2_classify.pad.l2_len;
 	}
+      else if (is_ip4)
+	{
+	  u16 *ports0 = reass_ports[from - buffers];
+
+	  vnet_classify_get_ip4_reass_ports (b0, ports0);
+	  h0 = vnet_classify_ip4_reass_data (b0, t0, h0, ports0, copy);
+	}
 
       vnet_buffer (b0)->l2_classify.hash =
 	vnet_classify_hash_packet (t0, (u8 *) h0);
@@ -260,7 +284,7 @@ ip_in_out_acl_inline (vlib_main_t * vm,
     }
 
   next_index = node->cached_next_index;
-  from = vlib_frame_vector_args (frame);
+  from = buffers;
   n_left_from = frame->n_vectors;
 
   while (n_left_from > 0)
@@ -281,6 +305,7 @@ ip_in_out_acl_inline (vlib_main_t * vm,
 	  u64 hash0;
 	  u8 *h0;
 	  u8 error0;
+	  u16 *ports0;
 
 	  /* Stride 3 seems to work best */
 	  if (PREDICT_TRUE (n_left_from > 3))
@@ -303,6 +328,7 @@ ip_in_out_acl_inline (vlib_main_t * vm,
 
 	  /* speculatively enqueue b0 to the current next frame */
 	  bi0 = from[0];
+	  ports0 = reass_ports[from - buffers];
 	  to_next[0] = bi0;
 	  from += 1;
 	  to_next += 1;
@@ -334,6 +360,8 @@ ip_in_out_acl_inline (vlib_main_t * vm,
 	      /* advance the match pointer so the matching happens on IP header */
 	      if (is_output)
 		h0 += vnet_buffer (b0)->l2_classify.pad.l2_len;
+	      else if (is_ip4)
+		h0 = vnet_classify_ip4_reass_data (b0, t0, h0, ports0, copy);
 
 	      e0 = vnet_classify_find_entry (t0, (u8 *) h0, hash0, now);
 	      if (e0)
@@ -401,6 +429,9 @@ ip_in_out_acl_inline (vlib_main_t * vm,
 		      else
 			h0 = b0->data;
 
+		      if (is_ip4 && !is_output)
+			h0 = vnet_classify_ip4_reass_data (b0, t0, h0, ports0, copy);
+
 		      hash0 = vnet_classify_hash_packet (t0, (u8 *) h0);
 		      e0 = vnet_classify_find_entry
 			(t0, (u8 *) h0, hash0, now);
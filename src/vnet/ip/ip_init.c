@@ -101,6 +101,11 @@ do {						\
       }
   }
 
+  im->sw_csum_counters.name = "sw-checksums";
+  im->sw_csum_counters.stat_segment_name = "/ip/sw-checksums";
+  vlib_validate_simple_counter (&im->sw_csum_counters, IP_N_SW_CSUM - 1);
+  vlib_zero_simple_counter (&im->sw_csum_counters, 0);
+
   if ((error = vlib_call_init_function (vm, vnet_main_init)))
     return error;
 
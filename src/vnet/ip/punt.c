@@ -22,6 +22,7 @@
  * to the local TCP/IP stack
  */
 
+#define _GNU_SOURCE
 #include <vnet/ip/ip.h>
 #include <vlib/vlib.h>
 #include <vnet/pg/pg.h>
@@ -267,14 +268,21 @@ punt_socket_register (bool is_ip4, u8 protocol, u16 port,
 {
   punt_main_t *pm = &punt_main;
   punt_client_t c, *n;
-  punt_client_t *v = is_ip4 ? pm->clients_by_dst_port4 :
-    pm->clients_by_dst_port6;
+  punt_client_t **v = is_ip4 ? &pm->clients_by_dst_port4 :
+    &pm->clients_by_dst_port6;
 
+  n = punt_client_get (is_ip4, port);
   memset (&c, 0, sizeof (c));
   memcpy (c.caddr.sun_path, client_pathname, sizeof (c.caddr.sun_path));
   c.caddr.sun_family = AF_UNIX;
   c.port = port;
-  n = sparse_vec_validate (v, port);
+  /* a client registering again keeps its rate limit and counters */
+  if (n)
+    c.per_thread = n->per_thread;
+  else
+    vec_validate_aligned (c.per_thread, vlib_num_workers (),
+			  CLIB_CACHE_LINE_BYTES);
+  n = sparse_vec_validate (*v, port);
   n[0] = c;
 }
 
@@ -307,6 +315,11 @@ format_udp_punt_trace (u8 * s, va_list * args)
   return s;
 }
 
+/*
+ * Send the packets of the frame with one sendmmsg, as the socket takes
+ * them. A packet is dropped if its client is not registered or over its
+ * rate limit, or if the socket is full.
+ */
 always_inline uword
 udp46_punt_socket_inline (vlib_main_t * vm,
 			  vlib_node_runtime_t * node,
@@ -314,19 +327,30 @@ udp46_punt_socket_inline (vlib_main_t * vm,
 {
   u32 *buffers = vlib_frame_args (frame);
   uword n_packets = frame->n_vectors;
-  struct iovec *iovecs = 0;
   punt_main_t *pm = &punt_main;
-  int i;
+  punt_thread_data_t *ptd;
+  punt_client_thread_t *ct;
+  u32 n_no_client = 0, n_rate_limited = 0, n_tx_error = 0, n_full = 0;
+  u32 n_msgs, n_sent;
+  f64 now = vlib_time_now (vm);
+  int i, rv;
 
   u32 node_index = is_ip4 ? udp4_punt_socket_node.index :
     udp6_punt_socket_node.index;
 
+  ptd = vec_elt_at_index (pm->thread_data, vm->thread_index);
+  vec_reset_length (ptd->msgs);
+  vec_reset_length (ptd->iovecs);
+  vec_reset_length (ptd->descs);
+  vec_reset_length (ptd->clients);
+  vec_reset_length (ptd->iov_start);
+
   for (i = 0; i < n_packets; i++)
     {
       struct iovec *iov;
+      struct mmsghdr *msg;
+      punt_packetdesc_t *desc;
       vlib_buffer_t *b;
-      uword l;
-      punt_packetdesc_t packetdesc;
 
       b = vlib_get_buffer (vm, buffers[i]);
 
@@ -353,40 +377,49 @@ udp46_punt_socket_inline (vlib_main_t * vm,
        * Find registerered client
        * If no registered client, drop packet and count
        */
-      struct sockaddr_un *caddr;
-      caddr = punt_socket_get (is_ip4, port);
-      if (!caddr)
+      punt_client_t *c = punt_client_get (is_ip4, port);
+      if (!c)
 	{
-	  vlib_node_increment_counter (vm, node_index,
-				       PUNT_ERROR_SOCKET_TX_ERROR, 1);
-	  goto error;
+	  n_no_client++;
+	  continue;
+	}
+
+      ct = vec_elt_at_index (c->per_thread, vm->thread_index);
+      if (!punt_rate_limit_allow (&ct->rate_limit, now))
+	{
+	  ct->n_rate_limited++;
+	  n_rate_limited++;
+	  continue;
 	}
 
-      punt_client_t *c = NULL;
       if (PREDICT_FALSE (b->flags & VLIB_BUFFER_IS_TRACED))
 	{
-	  c = punt_client_get (is_ip4, port);
 	  udp_punt_trace_t *t;
 	  t = vlib_add_trace (vm, node, b, sizeof (t[0]));
 	  clib_memcpy (&t->client, c, sizeof (t->client));
 	}
 
-      /* Re-set iovecs if present. */
-      if (iovecs)
-	_vec_len (iovecs) = 0;
-
       /* Add packet descriptor */
-      packetdesc.sw_if_index = vnet_buffer (b)->sw_if_index[VLIB_RX];
-      packetdesc.action = 0;
-      vec_add2 (iovecs, iov, 1);
-      iov->iov_base = &packetdesc;
-      iov->iov_len = sizeof (packetdesc);
+      vec_add2 (ptd->descs, desc, 1);
+      desc->sw_if_index = vnet_buffer (b)->sw_if_index[VLIB_RX];
+      desc->action = 0;
+
+      vec_add2 (ptd->msgs, msg, 1);
+      memset (msg, 0, sizeof (*msg));
+      msg->msg_hdr.msg_name = &c->caddr;
+      msg->msg_hdr.msg_namelen = sizeof (c->caddr);
+      vec_add1 (ptd->iov_start, vec_len (ptd->iovecs));
+      vec_add1 (ptd->clients, ct);
+
+      /* the descriptor vector may move, its iovec is set when sending */
+      vec_add2 (ptd->iovecs, iov, 1);
+      iov->iov_len = sizeof (*desc);
 
       /** VLIB buffer chain -> Unix iovec(s). */
       vlib_buffer_advance (b, -(sizeof (ethernet_header_t)));
-      vec_add2 (iovecs, iov, 1);
+      vec_add2 (ptd->iovecs, iov, 1);
       iov->iov_base = b->data + b->current_data;
-      iov->iov_len = l = b->current_length;
+      iov->iov_len = b->current_length;
 
       if (PREDICT_FALSE (b->flags & VLIB_BUFFER_NEXT_PRESENT))
 	{
@@ -395,38 +428,78 @@ udp46_punt_socket_inline (vlib_main_t * vm,
 	      b = vlib_get_buffer (vm, b->next_buffer);
 	      if (PREDICT_FALSE (b->flags & VLIB_BUFFER_IS_TRACED))
 		{
-		  if (PREDICT_FALSE (!c))
-		    {
-		      c = punt_client_get (is_ip4, port);
-		    }
 		  udp_punt_trace_t *t;
 		  t = vlib_add_trace (vm, node, b, sizeof (t[0]));
 		  clib_memcpy (&t->client, c, sizeof (t->client));
 		  t->is_midchain = 1;
 		}
 
-	      vec_add2 (iovecs, iov, 1);
+	      vec_add2 (ptd->iovecs, iov, 1);
 
 	      iov->iov_base = b->data + b->current_data;
 	      iov->iov_len = b->current_length;
-	      l += b->current_length;
 	    }
 	  while (b->flags & VLIB_BUFFER_NEXT_PRESENT);
 	}
+    }
 
-      struct msghdr msg = {
-	.msg_name = caddr,
-	.msg_namelen = sizeof (*caddr),
-	.msg_iov = iovecs,
-	.msg_iovlen = vec_len (iovecs),
-      };
+  n_msgs = vec_len (ptd->msgs);
+  for (i = 0; i < n_msgs; i++)
+    {
+      struct msghdr *mh = &ptd->msgs[i].msg_hdr;
+      u32 start = ptd->iov_start[i];
+      u32 end = i + 1 < n_msgs ? ptd->iov_start[i + 1] :
+	vec_len (ptd->iovecs);
+
+      ptd->iovecs[start].iov_base = &ptd->descs[i];
+      mh->msg_iov = &ptd->iovecs[start];
+      mh->msg_iovlen = end - start;
+    }
 
-      if (sendmsg (pm->socket_fd, &msg, 0) < (ssize_t) l)
-	vlib_node_increment_counter (vm, node_index,
-				     PUNT_ERROR_SOCKET_TX_ERROR, 1);
+  n_sent = 0;
+  while (n_sent < n_msgs)
+    {
+      rv = sendmmsg (pm->socket_fd, ptd->msgs + n_sent, n_msgs - n_sent, 0);
+      if (rv > 0)
+	{
+	  n_sent += rv;
+	  continue;
+	}
+
+      /*
+       * The message at n_sent was not sent; if the socket is full, none
+       * of those after it will be either.
+       */
+      if (errno == EAGAIN || errno == EWOULDBLOCK)
+	{
+	  for (i = n_sent; i < n_msgs; i++)
+	    ptd->clients[i]->n_socket_full++;
+	  n_full += n_msgs - n_sent;
+	  break;
+	}
+      /* skip the message the socket refused */
+      ptd->clients[n_sent] = 0;
+      n_tx_error++;
+      n_sent++;
     }
 
-error:
+  for (i = 0; i < n_sent; i++)
+    if (ptd->clients[i])
+      ptd->clients[i]->n_packets++;
+
+  if (n_no_client + n_tx_error)
+    vlib_node_increment_counter (vm, node_index, PUNT_ERROR_SOCKET_TX_ERROR,
+				 n_no_client + n_tx_error);
+  if (n_rate_limited)
+    vlib_node_increment_counter (vm, node_index,
+				 PUNT_ERROR_SOCKET_TX_RATE_LIMITED,
+				 n_rate_limited);
+  if (n_full)
+    vlib_node_increment_counter (vm, node_index, PUNT_ERROR_SOCKET_TX_FULL,
+				 n_full);
+  vlib_node_increment_counter (vm, node_index, PUNT_ERROR_SOCKET_TX,
+			       n_sent - n_tx_error);
+
   vlib_buffer_free (vm, buffers, n_packets);
 
   return n_packets;
@@ -487,98 +560,145 @@ format_punt_trace (u8 * s, va_list * va)
   return s;
 }
 
+/*
+ * Read and inject up to PUNT_SOCKET_RX_BATCH packets with one recvmmsg.
+ * Packets over the inject rate limit are dropped.
+ */
 static uword
 punt_socket_rx_fd (vlib_main_t * vm, vlib_node_runtime_t * node, u32 fd)
 {
   const uword buffer_size = VLIB_BUFFER_DATA_SIZE;
+  punt_main_t *pm = &punt_main;
   u32 n_trace = vlib_get_trace_count (vm, node);
-  u32 next = node->cached_next_index;
-  u32 n_left_to_next, next_index;
-  u32 *to_next;
-  u32 error = PUNT_ERROR_NONE;
-  vlib_get_next_frame (vm, node, next, to_next, n_left_to_next);
-
-  /* $$$$ Only dealing with one buffer at the time for now */
-
-  u32 bi;
-  vlib_buffer_t *b;
-  punt_packetdesc_t packetdesc;
-  ssize_t size;
-  struct iovec io[2];
+  punt_packetdesc_t descs[PUNT_SOCKET_RX_BATCH];
+  struct mmsghdr msgs[PUNT_SOCKET_RX_BATCH];
+  struct iovec iovs[PUNT_SOCKET_RX_BATCH][2];
+  u32 to_enq[PUNT_SOCKET_RX_BATCH], to_free[PUNT_SOCKET_RX_BATCH];
+  /* vlib_buffer_enqueue_to_next () reads ahead */
+  u16 nexts[PUNT_SOCKET_RX_BATCH + 32];
+  u32 n_alloc, n_recv, n_enq = 0, n_free = 0, i;
+  u32 n_short = 0, n_bad_action = 0, n_rate_limited = 0;
+  f64 now = vlib_time_now (vm);
+  int rv;
+
+  vec_validate (pm->rx_buffers, PUNT_SOCKET_RX_BATCH - 1);
+  n_alloc = vlib_buffer_alloc (vm, pm->rx_buffers, PUNT_SOCKET_RX_BATCH);
+  if (n_alloc == 0)
+    {
+      vlib_node_increment_counter (vm, punt_socket_rx_node.index,
+				   PUNT_ERROR_NOBUFFER, 1);
+      return 0;
+    }
 
-  if (vlib_buffer_alloc (vm, &bi, 1) != 1)
+  memset (msgs, 0, n_alloc * sizeof (msgs[0]));
+  for (i = 0; i < n_alloc; i++)
     {
-      error = PUNT_ERROR_NOBUFFER;
-      goto error;
+      vlib_buffer_t *b = vlib_get_buffer (vm, pm->rx_buffers[i]);
+
+      iovs[i][0].iov_base = &descs[i];
+      iovs[i][0].iov_len = sizeof (descs[i]);
+      iovs[i][1].iov_base = b->data;
+      iovs[i][1].iov_len = buffer_size;
+      msgs[i].msg_hdr.msg_iov = iovs[i];
+      msgs[i].msg_hdr.msg_iovlen = 2;
     }
 
-  b = vlib_get_buffer (vm, bi);
-  io[0].iov_base = &packetdesc;
-  io[0].iov_len = sizeof (packetdesc);
-  io[1].iov_base = b->data;
-  io[1].iov_len = buffer_size;
+  rv = recvmmsg (fd, msgs, n_alloc, MSG_DONTWAIT, 0);
+  n_recv = rv > 0 ? rv : 0;
+  if (rv < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+    vlib_node_increment_counter (vm, punt_socket_rx_node.index,
+				 PUNT_ERROR_READV, 1);
 
-  size = readv (fd, io, 2);
-  /* We need at least the packet descriptor plus a header */
-  if (size <= (int) (sizeof (packetdesc) + sizeof (ip4_header_t)))
+  for (i = 0; i < n_recv; i++)
     {
-      vlib_buffer_free (vm, &bi, 1);
-      error = PUNT_ERROR_READV;
-      goto error;
-    }
+      u32 bi = pm->rx_buffers[i];
+      vlib_buffer_t *b = vlib_get_buffer (vm, bi);
+      punt_packetdesc_t *packetdesc = &descs[i];
+      u32 size = msgs[i].msg_len;
+      u16 next_index;
+
+      /* We need at least the packet descriptor plus a header */
+      if (size <= (int) (sizeof (*packetdesc) + sizeof (ip4_header_t)))
+	{
+	  n_short++;
+	  to_free[n_free++] = bi;
+	  continue;
+	}
 
-  b->flags = VNET_BUFFER_F_LOCALLY_ORIGINATED;
-  b->current_length = size - sizeof (packetdesc);
+      if (!punt_rate_limit_allow (&pm->rx_rate_limit, now))
+	{
+	  n_rate_limited++;
+	  to_free[n_free++] = bi;
+	  continue;
+	}
 
-  VLIB_BUFFER_TRACE_TRAJECTORY_INIT (b);
+      b->flags = VNET_BUFFER_F_LOCALLY_ORIGINATED;
+      b->current_length = size - sizeof (*packetdesc);
 
-  switch (packetdesc.action)
-    {
-    case PUNT_L2:
-      vnet_buffer (b)->sw_if_index[VLIB_TX] = packetdesc.sw_if_index;
-      next_index = PUNT_SOCKET_RX_NEXT_INTERFACE_OUTPUT;
-      break;
-
-    case PUNT_IP4_ROUTED:
-      vnet_buffer (b)->sw_if_index[VLIB_RX] = packetdesc.sw_if_index;
-      vnet_buffer (b)->sw_if_index[VLIB_TX] = ~0;
-      next_index = PUNT_SOCKET_RX_NEXT_IP4_LOOKUP;
-      break;
-
-    case PUNT_IP6_ROUTED:
-      vnet_buffer (b)->sw_if_index[VLIB_RX] = packetdesc.sw_if_index;
-      vnet_buffer (b)->sw_if_index[VLIB_TX] = ~0;
-      next_index = PUNT_SOCKET_RX_NEXT_IP6_LOOKUP;
-      break;
-
-    default:
-      error = PUNT_ERROR_ACTION;
-      vlib_buffer_free (vm, &bi, 1);
-      goto error;
-    }
+      VLIB_BUFFER_TRACE_TRAJECTORY_INIT (b);
 
-  if (PREDICT_FALSE (n_trace > 0))
-    {
-      punt_trace_t *t;
-      vlib_trace_buffer (vm, node, next_index, b, 1 /* follow_chain */ );
-      vlib_set_trace_count (vm, node, --n_trace);
-      t = vlib_add_trace (vm, node, b, sizeof (*t));
-      t->sw_if_index = packetdesc.sw_if_index;
-      t->action = packetdesc.action;
-    }
+      switch (packetdesc->action)
+	{
+	case PUNT_L2:
+	  vnet_buffer (b)->sw_if_index[VLIB_TX] = packetdesc->sw_if_index;
+	  next_index = PUNT_SOCKET_RX_NEXT_INTERFACE_OUTPUT;
+	  break;
+
+	case PUNT_IP4_ROUTED:
+	  vnet_buffer (b)->sw_if_index[VLIB_RX] = packetdesc->sw_if_index;
+	  vnet_buffer (b)->sw_if_index[VLIB_TX] = ~0;
+	  next_index = PUNT_SOCKET_RX_NEXT_IP4_LOOKUP;
+	  break;
+
+	case PUNT_IP6_ROUTED:
+	  vnet_buffer (b)->sw_if_index[VLIB_RX] = packetdesc->sw_if_index;
+	  vnet_buffer (b)->sw_if_index[VLIB_TX] = ~0;
+	  next_index = PUNT_SOCKET_RX_NEXT_IP6_LOOKUP;
+	  break;
+
+	default:
+	  n_bad_action++;
+	  to_free[n_free++] = bi;
+	  continue;
+	}
 
-  to_next[0] = bi;
-  to_next++;
-  n_left_to_next--;
+      if (PREDICT_FALSE (n_trace > 0))
+	{
+	  punt_trace_t *t;
+	  vlib_trace_buffer (vm, node, next_index, b, 1 /* follow_chain */ );
+	  vlib_set_trace_count (vm, node, --n_trace);
+	  t = vlib_add_trace (vm, node, b, sizeof (*t));
+	  t->sw_if_index = packetdesc->sw_if_index;
+	  t->action = packetdesc->action;
+	}
 
-  vlib_validate_buffer_enqueue_x1 (vm, node, next, to_next, n_left_to_next,
-				   bi, next_index);
-  vlib_put_next_frame (vm, node, next, n_left_to_next);
-  return 1;
+      to_enq[n_enq] = bi;
+      nexts[n_enq] = next_index;
+      n_enq++;
+    }
 
-error:
-  vlib_node_increment_counter (vm, punt_socket_rx_node.index, error, 1);
-  return 0;
+  for (i = n_recv; i < n_alloc; i++)
+    to_free[n_free++] = pm->rx_buffers[i];
+  vlib_buffer_free (vm, to_free, n_free);
+
+  vlib_buffer_enqueue_to_next (vm, node, to_enq, nexts, n_enq);
+
+  pm->n_rx_packets += n_enq;
+  pm->n_rx_rate_limited += n_rate_limited;
+  if (n_short)
+    vlib_node_increment_counter (vm, punt_socket_rx_node.index,
+				 PUNT_ERROR_READV, n_short);
+  if (n_bad_action)
+    vlib_node_increment_counter (vm, punt_socket_rx_node.index,
+				 PUNT_ERROR_ACTION, n_bad_action);
+  if (n_rate_limited)
+    vlib_node_increment_counter (vm, punt_socket_rx_node.index,
+				 PUNT_ERROR_SOCKET_RX_RATE_LIMITED,
+				 n_rate_limited);
+  vlib_node_increment_counter (vm, punt_socket_rx_node.index,
+			       PUNT_ERROR_SOCKET_RX, n_enq);
+
+  return n_enq;
 }
 
 static uword
@@ -590,10 +710,9 @@ punt_socket_rx (vlib_main_t * vm,
   int i;
 
   for (i = 0; i < vec_len (pm->ready_fds); i++)
-    {
-      total_count += punt_socket_rx_fd (vm, node, pm->ready_fds[i]);
-      vec_del1 (pm->ready_fds, i);
-    }
+    total_count += punt_socket_rx_fd (vm, node, pm->ready_fds[i]);
+  vec_reset_length (pm->ready_fds);
+
   return total_count;
 }
 
@@ -669,6 +788,56 @@ vnet_punt_socket_del (vlib_main_t * vm, bool is_ip4, u8 l4_protocol, u16 port)
   return 0;
 }
 
+static void
+punt_rate_limit_set (punt_rate_limit_t * rl, u32 rate, u32 burst)
+{
+  rl->rate = rate;
+  rl->burst = burst ? burst : rate;
+  rl->tokens = rl->burst;
+  rl->last_time = 0;
+}
+
+/**
+ * @brief Limit the packets per second punted to a registered client, on
+ * each thread, or injected by all clients.
+ *
+ * @param is_inject limit the packets injected, else those punted to the
+ *                  client registered for is_ip4, l4_protocol and port
+ * @param rate      packets per second, 0 for no limit
+ * @param burst     packets let through at once, 0 for one second's worth
+ */
+clib_error_t *
+vnet_punt_socket_rate_limit (vlib_main_t * vm, bool is_inject, bool is_ip4,
+			     u8 l4_protocol, u16 port, u32 rate, u32 burst)
+{
+  punt_main_t *pm = &punt_main;
+  punt_client_thread_t *ct;
+  punt_client_t *c;
+
+  if (!pm->is_configured)
+    return clib_error_return (0, "socket is not configured");
+
+  if (is_inject)
+    {
+      punt_rate_limit_set (&pm->rx_rate_limit, rate, burst);
+      return 0;
+    }
+
+  if (l4_protocol != IP_PROTOCOL_UDP)
+    return clib_error_return (0,
+			      "only UDP protocol (%d) is supported, got %d",
+			      IP_PROTOCOL_UDP, l4_protocol);
+
+  c = punt_client_get (is_ip4, port);
+  if (!c)
+    return clib_error_return (0, "no client registered for port %d", port);
+
+  vec_foreach (ct, c->per_thread)
+    punt_rate_limit_set (&ct->rate_limit, rate, burst);
+
+  return 0;
+}
+
 /**
  * @brief Request IP traffic punt to the local TCP/IP stack.
  *
@@ -820,6 +989,137 @@ VLIB_CLI_COMMAND (punt_command, static) = {
 };
 /* *INDENT-ON* */
 
+static clib_error_t *
+punt_socket_rate_limit_cli (vlib_main_t * vm, unformat_input_t * input,
+			    vlib_cli_command_t * cmd)
+{
+  bool is_inject = false, is_ip4 = true;
+  u32 port = ~0, rate = ~0, burst = 0;
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "inject"))
+	is_inject = true;
+      else if (unformat (input, "udp %d", &port))
+	;
+      else if (unformat (input, "ip4"))
+	is_ip4 = true;
+      else if (unformat (input, "ip6"))
+	is_ip4 = false;
+      else if (unformat (input, "burst %d", &burst))
+	;
+      else if (unformat (input, "%d", &rate))
+	;
+      else
+	return clib_error_return (0, "parse error: '%U'",
+				  format_unformat_error, input);
+    }
+
+  if (rate == ~0)
+    return clib_error_return (0, "rate required");
+  if (!is_inject && port == ~0)
+    return clib_error_return (0, "inject or udp port required");
+
+  return vnet_punt_socket_rate_limit (vm, is_inject, is_ip4,
+				      IP_PROTOCOL_UDP, port, rate, burst);
+}
+
+/*?
+ * Limit the packets per second punted to the client registered for a
+ * UDP port, on each thread, or injected through the punt socket by all
+ * clients. A rate of 0 removes the limit.
+ *
+ * @cliexpar
+ * @cliexcmd{set punt socket rate-limit udp 4789 ip4 10000 burst 500}
+ * @cliexcmd{set punt socket rate-limit inject 50000}
+?*/
+/* *INDENT-OFF* */
+VLIB_CLI_COMMAND (punt_socket_rate_limit_command, static) = {
+  .path = "set punt socket rate-limit",
+  .short_help = "set punt socket rate-limit [inject | udp <port> [ip4|ip6]]"
+                " <pps> [burst <n>]",
+  .function = punt_socket_rate_limit_cli,
+};
+/* *INDENT-ON* */
+
+static u8 *
+format_punt_rate_limit (u8 * s, va_list * args)
+{
+  punt_rate_limit_t *rl = va_arg (*args, punt_rate_limit_t *);
+
+  if (rl->rate == 0)
+    return format (s, "unlimited");
+  return format (s, "%.0f pps burst %.0f", rl->rate, rl->burst);
+}
+
+static void
+punt_socket_show_clients (vlib_main_t * vm, punt_client_t * clients,
+			  bool is_ip4)
+{
+  punt_client_thread_t *ct;
+  punt_client_t *c;
+  u64 n_packets, n_rate_limited, n_socket_full;
+
+  vec_foreach (c, clients)
+  {
+    /* the sparse vector's slot 0 holds the ports not registered */
+    if (c->per_thread == 0)
+      continue;
+
+    n_packets = n_rate_limited = n_socket_full = 0;
+    vec_foreach (ct, c->per_thread)
+    {
+      n_packets += ct->n_packets;
+      n_rate_limited += ct->n_rate_limited;
+      n_socket_full += ct->n_socket_full;
+    }
+
+    vlib_cli_output (vm, "  udp %d %s to %s", c->port,
+		     is_ip4 ? "ip4" : "ip6", c->caddr.sun_path);
+    vlib_cli_output (vm, "    rate limit %U per thread",
+		     format_punt_rate_limit, &c->per_thread[0].rate_limit);
+    vlib_cli_output (vm, "    punted %lld, rate limited %lld, "
+		     "socket full %lld", n_packets, n_rate_limited,
+		     n_socket_full);
+  }
+}
+
+static clib_error_t *
+punt_socket_show_cli (vlib_main_t * vm, unformat_input_t * input,
+		      vlib_cli_command_t * cmd)
+{
+  punt_main_t *pm = &punt_main;
+
+  if (!pm->is_configured)
+    return clib_error_return (0, "socket is not configured");
+
+  vlib_cli_output (vm, "punt socket %s", pm->sun_path);
+  punt_socket_show_clients (vm, pm->clients_by_dst_port4, true);
+  punt_socket_show_clients (vm, pm->clients_by_dst_port6, false);
+  vlib_cli_output (vm, "inject rate limit %U",
+		   format_punt_rate_limit, &pm->rx_rate_limit);
+  vlib_cli_output (vm, "  injected %lld, rate limited %lld",
+		   pm->n_rx_packets, pm->n_rx_rate_limited);
+
+  return 0;
+}
+
+/*?
+ * Show the clients registered on the punt socket with their rate limits
+ * and counters, summed over the threads, and those of the packets
+ * injected.
+ *
+ * @cliexpar
+ * @cliexcmd{show punt socket}
+?*/
+/* *INDENT-OFF* */
+VLIB_CLI_COMMAND (punt_socket_show_command, static) = {
+  .path = "show punt socket",
+  .short_help = "show punt socket",
+  .function = punt_socket_show_cli,
+};
+/* *INDENT-ON* */
+
 clib_error_t *
 punt_init (vlib_main_t * vm)
 {
@@ -832,6 +1132,9 @@ punt_init (vlib_main_t * vm)
     (sizeof (pm->clients_by_dst_port4[0]),
      BITS (((udp_header_t *) 0)->dst_port));
 
+  vec_validate_aligned (pm->thread_data, vlib_num_workers (),
+			CLIB_CACHE_LINE_BYTES);
+
   pm->is_configured = false;
   pm->interface_output_node = vlib_get_node_by_name (vm,
 						     (u8 *)
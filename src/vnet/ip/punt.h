@@ -39,6 +39,9 @@ clib_error_t *vnet_punt_socket_add (vlib_main_t * vm, u32 header_version,
 				    char *client_pathname);
 clib_error_t *vnet_punt_socket_del (vlib_main_t * vm, bool is_ip4,
 				    u8 l4_protocol, u16 port);
+clib_error_t *vnet_punt_socket_rate_limit (vlib_main_t * vm, bool is_inject,
+					   bool is_ip4, u8 l4_protocol,
+					   u16 port, u32 rate, u32 burst);
 char *vnet_punt_get_server_pathname (void);
 
 enum punt_action_e
@@ -60,14 +63,76 @@ typedef struct __attribute__ ((packed))
 } punt_packetdesc_t;
 
 /*
- * Client registration
+ * Token bucket limiting the packets per second punted to a client or
+ * injected by all clients. A rate of 0 means no limit.
+ */
+typedef struct
+{
+  f64 rate;
+  f64 burst;
+  f64 tokens;
+  f64 last_time;
+} punt_rate_limit_t;
+
+always_inline int
+punt_rate_limit_allow (punt_rate_limit_t * rl, f64 now)
+{
+  if (PREDICT_TRUE (rl->rate == 0))
+    return 1;
+
+  rl->tokens += (now - rl->last_time) * rl->rate;
+  rl->last_time = now;
+  if (rl->tokens > rl->burst)
+    rl->tokens = rl->burst;
+  if (rl->tokens < 1)
+    return 0;
+  rl->tokens -= 1;
+  return 1;
+}
+
+/*
+ * Per thread state of a client: its share of the rate limit and its
+ * counters
+ */
+typedef struct
+{
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
+  punt_rate_limit_t rate_limit;
+  u64 n_packets;
+  u64 n_rate_limited;
+  u64 n_socket_full;
+} punt_client_thread_t;
+
+/*
+ * Client registration. The punt reasons the socket serves are the UDP
+ * ports, each with its own client socket, rate limit and counters, so a
+ * burst for one port cannot use up what another is allowed.
  */
 typedef struct
 {
   u16 port;
   struct sockaddr_un caddr;
+  punt_client_thread_t *per_thread;
 } punt_client_t;
 
+/*
+ * Per thread scratch space of the punt socket nodes, one message per
+ * packet of a frame, all sent with one system call.
+ */
+typedef struct
+{
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
+  struct mmsghdr *msgs;
+  struct iovec *iovecs;
+  punt_packetdesc_t *descs;
+  punt_client_thread_t **clients;
+  /* index of the first iovec of each message */
+  u32 *iov_start;
+} punt_thread_data_t;
+
+/* Most packets injected per read ready event */
+#define PUNT_SOCKET_RX_BATCH 32
+
 typedef struct
 {
   int socket_fd;
@@ -79,6 +144,12 @@ typedef struct
   vlib_node_t *interface_output_node;
   u32 *ready_fds;
   u32 *rx_buffers;
+  punt_thread_data_t *thread_data;
+
+  /* Inject direction, serviced by the main thread */
+  punt_rate_limit_t rx_rate_limit;
+  u64 n_rx_packets;
+  u64 n_rx_rate_limited;
 } punt_main_t;
 extern punt_main_t punt_main;
 
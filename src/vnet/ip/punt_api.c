@@ -42,7 +42,8 @@
 #define foreach_punt_api_msg                                            \
 _(PUNT, punt)                                                           \
 _(PUNT_SOCKET_REGISTER, punt_socket_register)                           \
-_(PUNT_SOCKET_DEREGISTER, punt_socket_deregister)
+_(PUNT_SOCKET_DEREGISTER, punt_socket_deregister)                       \
+_(PUNT_SOCKET_RATE_LIMIT, punt_socket_rate_limit)
 
 static void
 vl_api_punt_t_handler (vl_api_punt_t * mp)
@@ -123,6 +124,27 @@ vl_api_punt_socket_deregister_t_handler (vl_api_punt_socket_deregister_t * mp)
   vl_api_send_msg (reg, (u8 *) rmp);
 }
 
+static void
+vl_api_punt_socket_rate_limit_t_handler (vl_api_punt_socket_rate_limit_t *
+					 mp)
+{
+  vl_api_punt_socket_rate_limit_reply_t *rmp;
+  vlib_main_t *vm = vlib_get_main ();
+  int rv = 0;
+  clib_error_t *error;
+
+  error = vnet_punt_socket_rate_limit (vm, mp->is_inject, mp->is_ip4,
+				       mp->l4_protocol, ntohs (mp->l4_port),
+				       ntohl (mp->rate), ntohl (mp->burst));
+  if (error)
+    {
+      rv = -1;
+      clib_error_report (error);
+    }
+
+  REPLY_MACRO (VL_API_PUNT_SOCKET_RATE_LIMIT_REPLY);
+}
+
 #define vl_msg_name_crc_list
 #include <vnet/ip/punt.api.h>
 #undef vl_msg_name_crc_list
@@ -18,6 +18,7 @@
 #include <vnet/vnet.h>
 #include <vnet/api_errno.h>
 #include <vnet/ip/ip.h>
+#include <vnet/ip/ip_flow_cache.h>
 #include <vnet/interface.h>
 #include <vnet/udp/udp.h>
 
@@ -101,6 +102,9 @@ ipsec_add_del_spd (vlib_main_t * vm, u32 spd_id, int is_add)
   if (!p && !is_add)
     return VNET_API_ERROR_INVALID_VALUE;
 
+  /* flows classified by the SPD may be cached */
+  ip_flow_cache_invalidate ();
+
   if (!is_add)			/* delete */
     {
       spd_index = p[0];
@@ -178,6 +182,9 @@ ipsec_add_del_policy (vlib_main_t * vm, ipsec_policy_t * policy, int is_add)
   if (!spd)
     return VNET_API_ERROR_SYSCALL_ERROR_1;
 
+  /* flows classified by the SPD may be cached */
+  ip_flow_cache_invalidate ();
+
   if (is_add)
     {
       u32 policy_index;
@@ -428,6 +435,9 @@ ipsec_add_del_sa (vlib_main_t * vm, ipsec_sa_t * new_sa, int is_add,
   if (!p && !is_add)
     return VNET_API_ERROR_SYSCALL_ERROR_1;
 
+  /* flows through the SA may be cached */
+  ip_flow_cache_invalidate ();
+
   if (!is_add)			/* delete */
     {
       sa_index = p[0];
@@ -479,6 +489,9 @@ ipsec_set_sa_key (vlib_main_t * vm, ipsec_sa_t * sa_update)
   sa_index = p[0];
   sa = pool_elt_at_index (im->sad, sa_index);
 
+  /* flows through the SA may be cached */
+  ip_flow_cache_invalidate ();
+
   /* new crypto key */
   if (0 < sa_update->crypto_key_len)
     {
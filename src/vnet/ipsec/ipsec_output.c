@@ -294,18 +294,24 @@ ipsec_output_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 		  if (PREDICT_FALSE
 		      (b0->flags & VNET_BUFFER_F_OFFLOAD_TCP_CKSUM))
 		    {
+		      tcp0->checksum = 0;
 		      tcp0->checksum =
 			ip6_tcp_udp_icmp_compute_checksum (vm, b0, ip6_0,
 							   &bogus);
 		      b0->flags &= ~VNET_BUFFER_F_OFFLOAD_TCP_CKSUM;
+		      ip_sw_csum_count (vm, IP_SW_CSUM_IPSEC_OUTPUT, 1);
 		    }
 		  if (PREDICT_FALSE
 		      (b0->flags & VNET_BUFFER_F_OFFLOAD_UDP_CKSUM))
 		    {
+		      udp0->checksum = 0;
 		      udp0->checksum =
 			ip6_tcp_udp_icmp_compute_checksum (vm, b0, ip6_0,
 							   &bogus);
+		      if (udp0->checksum == 0)
+			udp0->checksum = 0xffff;
 		      b0->flags &= ~VNET_BUFFER_F_OFFLOAD_UDP_CKSUM;
+		      ip_sw_csum_count (vm, IP_SW_CSUM_IPSEC_OUTPUT, 1);
 		    }
 		}
 	      else
@@ -319,16 +325,22 @@ ipsec_output_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 		  if (PREDICT_FALSE
 		      (b0->flags & VNET_BUFFER_F_OFFLOAD_TCP_CKSUM))
 		    {
+		      tcp0->checksum = 0;
 		      tcp0->checksum =
 			ip4_tcp_udp_compute_checksum (vm, b0, ip0);
 		      b0->flags &= ~VNET_BUFFER_F_OFFLOAD_TCP_CKSUM;
+		      ip_sw_csum_count (vm, IP_SW_CSUM_IPSEC_OUTPUT, 1);
 		    }
 		  if (PREDICT_FALSE
 		      (b0->flags & VNET_BUFFER_F_OFFLOAD_UDP_CKSUM))
 		    {
+		      udp0->checksum = 0;
 		      udp0->checksum =
 			ip4_tcp_udp_compute_checksum (vm, b0, ip0);
+		      if (udp0->checksum == 0)
+			udp0->checksum = 0xffff;
 		      b0->flags &= ~VNET_BUFFER_F_OFFLOAD_UDP_CKSUM;
+		      ip_sw_csum_count (vm, IP_SW_CSUM_IPSEC_OUTPUT, 1);
 		    }
 		}
 	      vlib_buffer_advance (b0, iph_offset);
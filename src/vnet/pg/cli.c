@@ -603,7 +603,8 @@ create_pg_if_cmd_fn (vlib_main_t * vm,
 {
   pg_main_t *pg = &pg_main;
   unformat_input_t _line_input, *line_input = &_line_input;
-  u32 if_id;
+  u32 if_id, gso_size = 0;
+  u8 gso_enabled = 0;
   clib_error_t *error = NULL;
 
   if (!unformat_user (input, unformat_line_input, line_input))
@@ -613,6 +614,8 @@ create_pg_if_cmd_fn (vlib_main_t * vm,
     {
       if (unformat (line_input, "interface pg%u", &if_id))
 	;
+      else if (unformat (line_input, "gso-enabled gso-size %u", &gso_size))
+	gso_enabled = 1;
 
       else
 	{
@@ -622,7 +625,14 @@ create_pg_if_cmd_fn (vlib_main_t * vm,
 	}
     }
 
-  pg_interface_add_or_get (pg, if_id);
+  if (gso_enabled && gso_size < VNET_GSO_MIN_SIZE)
+    {
+      error = clib_error_create ("gso-size must be at least %u",
+				 VNET_GSO_MIN_SIZE);
+      goto done;
+    }
+
+  pg_interface_add_or_get (pg, if_id, gso_enabled, gso_size);
 
 done:
   unformat_free (line_input);
@@ -633,7 +643,8 @@ done:
 /* *INDENT-OFF* */
 VLIB_CLI_COMMAND (create_pg_if_cmd, static) = {
   .path = "create packet-generator",
-  .short_help = "create packet-generator interface <interface name>",
+  .short_help = "create packet-generator interface <interface name>"
+                " [gso-enabled gso-size <size>]",
   .function = create_pg_if_cmd_fn,
 };
 /* *INDENT-ON* */
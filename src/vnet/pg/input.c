@@ -42,6 +42,10 @@
 #include <vnet/vnet.h>
 #include <vnet/feature/feature.h>
 #include <vnet/devices/devices.h>
+#include <vnet/ethernet/ethernet.h>
+#include <vnet/ip/ip4_packet.h>
+#include <vnet/ip/ip6_packet.h>
+#include <vnet/tcp/tcp_packet.h>
 
 static int
 validate_buffer_data2 (vlib_buffer_t * b, pg_stream_t * s,
@@ -1457,6 +1461,57 @@ pg_input_trace (pg_main_t * pg,
     }
 }
 
+/*
+ * Hand the untagged TCP packets among the given ones to the graph as
+ * GSO packets of gso_size segments, as a GSO capable device would.
+ */
+static void
+pg_set_gso_buffer_flags (vlib_main_t * vm, u32 * buffers, u32 n_buffers,
+			 u32 gso_size)
+{
+  while (n_buffers > 0)
+    {
+      vlib_buffer_t *b0 = vlib_get_buffer (vm, buffers[0]);
+      ethernet_header_t *eth = vlib_buffer_get_current (b0);
+      u16 ethertype = clib_net_to_host_u16 (eth->type);
+      i16 l3_hdr_offset = b0->current_data + sizeof (*eth);
+      i16 l4_hdr_offset;
+      tcp_header_t *tcp;
+      u8 protocol;
+
+      buffers += 1;
+      n_buffers -= 1;
+
+      if (ethertype == ETHERNET_TYPE_IP4)
+	{
+	  ip4_header_t *ip4 = (ip4_header_t *) (b0->data + l3_hdr_offset);
+	  protocol = ip4->protocol;
+	  l4_hdr_offset = l3_hdr_offset + ip4_header_bytes (ip4);
+	  b0->flags |= VNET_BUFFER_F_IS_IP4;
+	}
+      else if (ethertype == ETHERNET_TYPE_IP6)
+	{
+	  ip6_header_t *ip6 = (ip6_header_t *) (b0->data + l3_hdr_offset);
+	  protocol = ip6->protocol;
+	  l4_hdr_offset = l3_hdr_offset + sizeof (*ip6);
+	  b0->flags |= VNET_BUFFER_F_IS_IP6;
+	}
+      else
+	continue;
+
+      if (protocol != IP_PROTOCOL_TCP)
+	continue;
+
+      tcp = (tcp_header_t *) (b0->data + l4_hdr_offset);
+      vnet_buffer (b0)->l3_hdr_offset = l3_hdr_offset;
+      vnet_buffer (b0)->l4_hdr_offset = l4_hdr_offset;
+      vnet_buffer2 (b0)->gso_size = gso_size;
+      vnet_buffer2 (b0)->gso_l4_hdr_sz = tcp_header_bytes (tcp);
+      b0->flags |= (VNET_BUFFER_F_L3_HDR_OFFSET_VALID |
+		    VNET_BUFFER_F_L4_HDR_OFFSET_VALID | VNET_BUFFER_F_GSO);
+    }
+}
+
 static uword
 pg_generate_packets (vlib_node_runtime_t * node,
 		     pg_main_t * pg,
@@ -1466,6 +1521,7 @@ pg_generate_packets (vlib_node_runtime_t * node,
   u32 *to_next, n_this_frame, n_left, n_trace, n_packets_in_fifo;
   uword n_packets_generated;
   pg_buffer_index_t *bi, *bi0;
+  pg_interface_t *pi = pool_elt_at_index (pg->interfaces, s->pg_if_index);
   u32 next_index = s->next_index;
   vnet_feature_main_t *fm = &feature_main;
   vnet_feature_config_main_t *cm;
@@ -1527,6 +1583,9 @@ pg_generate_packets (vlib_node_runtime_t * node,
 	    vnet_buffer (b)->feature_arc_index = feature_arc_index;
 	  }
 
+      if (pi->gso_enabled)
+	pg_set_gso_buffer_flags (vm, to_next, n_this_frame, pi->gso_size);
+
       n_trace = vlib_get_trace_count (vm, node);
       if (n_trace > 0)
 	{
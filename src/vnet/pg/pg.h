@@ -302,6 +302,10 @@ typedef struct
   /* Identifies stream for this interface. */
   u32 id;
 
+  /* TCP packets are generated as GSO packets of gso_size segments. */
+  u8 gso_enabled;
+  u32 gso_size;
+
   pcap_main_t pcap_main;
   u8 *pcap_file_name;
 } pg_interface_t;
@@ -350,7 +354,8 @@ void pg_stream_enable_disable (pg_main_t * pg, pg_stream_t * s,
 			       int is_enable);
 
 /* Find/create free packet-generator interface index. */
-u32 pg_interface_add_or_get (pg_main_t * pg, uword stream_index);
+u32 pg_interface_add_or_get (pg_main_t * pg, uword stream_index,
+			     u8 gso_enabled, u32 gso_size);
 
 always_inline pg_node_t *
 pg_get_node (uword node_index)
@@ -54,15 +54,24 @@ vl_api_pg_create_interface_t_handler (vl_api_pg_create_interface_t * mp)
 {
   vl_api_pg_create_interface_reply_t *rmp;
   int rv = 0;
+  u32 sw_if_index = ~0;
 
   pg_main_t *pg = &pg_main;
-  u32 pg_if_id = pg_interface_add_or_get (pg, ntohl (mp->interface_id));
-  pg_interface_t *pi = pool_elt_at_index (pg->interfaces, pg_if_id);
+  if (mp->gso_enabled && ntohl (mp->gso_size) < VNET_GSO_MIN_SIZE)
+    rv = VNET_API_ERROR_INVALID_VALUE;
+  else
+    {
+      u32 pg_if_id = pg_interface_add_or_get (pg, ntohl (mp->interface_id),
+					      mp->gso_enabled,
+					      ntohl (mp->gso_size));
+      pg_interface_t *pi = pool_elt_at_index (pg->interfaces, pg_if_id);
+      sw_if_index = pi->sw_if_index;
+    }
 
   /* *INDENT-OFF* */
   REPLY_MACRO2(VL_API_PG_CREATE_INTERFACE_REPLY,
   ({
-    rmp->sw_if_index = ntohl(pi->sw_if_index);
+    rmp->sw_if_index = ntohl(sw_if_index);
   }));
   /* *INDENT-ON* */
 }
@@ -179,7 +179,8 @@ pg_eth_flag_change (vnet_main_t * vnm, vnet_hw_interface_t * hi, u32 flags)
 }
 
 u32
-pg_interface_add_or_get (pg_main_t * pg, uword if_id)
+pg_interface_add_or_get (pg_main_t * pg, uword if_id, u8 gso_enabled,
+			 u32 gso_size)
 {
   vnet_main_t *vnm = vnet_get_main ();
   vlib_main_t *vm = vlib_get_main ();
@@ -210,6 +211,8 @@ pg_interface_add_or_get (pg_main_t * pg, uword if_id)
       hw_addr[1] = 0xfe;
 
       pi->id = if_id;
+      pi->gso_enabled = gso_enabled;
+      pi->gso_size = gso_size;
       ethernet_register_interface (vnm, pg_dev_class.index, i, hw_addr,
 				   &pi->hw_if_index, pg_eth_flag_change);
       hi = vnet_get_hw_interface (vnm, pi->hw_if_index);
@@ -449,7 +452,7 @@ pg_stream_add (pg_main_t * pg, pg_stream_t * s_init)
   }
 
   /* Find an interface to use. */
-  s->pg_if_index = pg_interface_add_or_get (pg, s->if_id);
+  s->pg_if_index = pg_interface_add_or_get (pg, s->if_id, 0 /* gso */ , 0);
 
   {
     pg_interface_t *pi = pool_elt_at_index (pg->interfaces, s->pg_if_index);
@@ -742,6 +742,21 @@ tcp_enqueue_to_output_now (vlib_main_t * vm, vlib_buffer_t * b, u32 bi,
   tcp_enqueue_to_output_i (vm, b, bi, is_ip4, 1);
 }
 
+/**
+ * Leave the checksum of a control packet to the interface, or to
+ * interface-output if the interface cannot compute it.
+ */
+always_inline void
+tcp_buffer_cksum_offload (vlib_buffer_t * b, void *ih, tcp_header_t * th,
+			  u8 is_ip4)
+{
+  b->flags |= VNET_BUFFER_F_OFFLOAD_TCP_CKSUM;
+  b->flags |= is_ip4 ? VNET_BUFFER_F_IS_IP4 : VNET_BUFFER_F_IS_IP6;
+  vnet_buffer (b)->l3_hdr_offset = (u8 *) ih - b->data;
+  vnet_buffer (b)->l4_hdr_offset = (u8 *) th - b->data;
+  th->checksum = 0;
+}
+
 static int
 tcp_make_reset_in_place (vlib_main_t * vm, vlib_buffer_t * b0,
 			 tcp_state_t state, u8 thread_index, u8 is_ip4)
@@ -807,15 +822,13 @@ tcp_make_reset_in_place (vlib_main_t * vm, vlib_buffer_t * b0,
     {
       ih4 = vlib_buffer_push_ip4 (vm, b0, &dst_ip40, &src_ip40,
 				  IP_PROTOCOL_TCP, 1);
-      th0->checksum = ip4_tcp_udp_compute_checksum (vm, b0, ih4);
+      tcp_buffer_cksum_offload (b0, ih4, th0, 1);
     }
   else
     {
-      int bogus = ~0;
       ih6 = vlib_buffer_push_ip6 (vm, b0, &dst_ip60, &src_ip60,
 				  IP_PROTOCOL_TCP);
-      th0->checksum = ip6_tcp_udp_icmp_compute_checksum (vm, b0, ih6, &bogus);
-      ASSERT (!bogus);
+      tcp_buffer_cksum_offload (b0, ih6, th0, 0);
     }
 
   return 0;
@@ -885,17 +898,15 @@ tcp_send_reset_w_pkt (tcp_connection_t * tc, vlib_buffer_t * pkt, u8 is_ip4)
       ASSERT ((pkt_ih4->ip_version_and_header_length & 0xF0) == 0x40);
       ih4 = vlib_buffer_push_ip4 (vm, b, &pkt_ih4->dst_address,
 				  &pkt_ih4->src_address, IP_PROTOCOL_TCP, 1);
-      th->checksum = ip4_tcp_udp_compute_checksum (vm, b, ih4);
+      tcp_buffer_cksum_offload (b, ih4, th, 1);
     }
   else
     {
-      int bogus = ~0;
       ASSERT ((pkt_ih6->ip_version_traffic_class_and_flow_label & 0xF0) ==
 	      0x60);
       ih6 = vlib_buffer_push_ip6 (vm, b, &pkt_ih6->dst_address,
 				  &pkt_ih6->src_address, IP_PROTOCOL_TCP);
-      th->checksum = ip6_tcp_udp_icmp_compute_checksum (vm, b, ih6, &bogus);
-      ASSERT (!bogus);
+      tcp_buffer_cksum_offload (b, ih6, th, 0);
     }
 
   tcp_enqueue_to_ip_lookup_now (vm, b, bi, is_ip4, fib_index);
@@ -936,16 +947,14 @@ tcp_send_reset (tcp_connection_t * tc)
       ip4_header_t *ih4;
       ih4 = vlib_buffer_push_ip4 (vm, b, &tc->c_lcl_ip.ip4,
 				  &tc->c_rmt_ip.ip4, IP_PROTOCOL_TCP, 0);
-      th->checksum = ip4_tcp_udp_compute_checksum (vm, b, ih4);
+      tcp_buffer_cksum_offload (b, ih4, th, 1);
     }
   else
     {
-      int bogus = ~0;
       ip6_header_t *ih6;
       ih6 = vlib_buffer_push_ip6 (vm, b, &tc->c_lcl_ip.ip6,
 				  &tc->c_rmt_ip.ip6, IP_PROTOCOL_TCP);
-      th->checksum = ip6_tcp_udp_icmp_compute_checksum (vm, b, ih6, &bogus);
-      ASSERT (!bogus);
+      tcp_buffer_cksum_offload (b, ih6, th, 0);
     }
   tcp_enqueue_to_ip_lookup_now (vm, b, bi, tc->c_is_ip4, tc->c_fib_index);
   TCP_EVT_DBG (TCP_EVT_RST_SENT, tc);
@@ -961,17 +970,15 @@ tcp_push_ip_hdr (tcp_main_t * tm, tcp_connection_t * tc, vlib_buffer_t * b)
       ip4_header_t *ih;
       ih = vlib_buffer_push_ip4 (vm, b, &tc->c_lcl_ip4,
 				 &tc->c_rmt_ip4, IP_PROTOCOL_TCP, 1);
-      th->checksum = ip4_tcp_udp_compute_checksum (vm, b, ih);
+      tcp_buffer_cksum_offload (b, ih, th, 1);
     }
   else
     {
       ip6_header_t *ih;
-      int bogus = ~0;
 
       ih = vlib_buffer_push_ip6 (vm, b, &tc->c_lcl_ip6,
 				 &tc->c_rmt_ip6, IP_PROTOCOL_TCP);
-      th->checksum = ip6_tcp_udp_icmp_compute_checksum (vm, b, ih, &bogus);
-      ASSERT (!bogus);
+      tcp_buffer_cksum_offload (b, ih, th, 0);
     }
 }
 
@@ -268,6 +268,37 @@ vlib_buffer_push_udp (vlib_buffer_t * b, u16 sp, u16 dp, u8 offload_csum)
   return uh;
 }
 
+/**
+ * Set the mandatory UDP checksum of an IPv6 encapsulation. It is left to
+ * the interface, or to interface-output if the interface cannot compute
+ * it, unless the offload metadata is taken by checksums of the inner
+ * packet still to be computed.
+ */
+always_inline void
+ip6_udp_encap_checksum (vlib_main_t * vm, vlib_buffer_t * b,
+			ip6_header_t * ip6, udp_header_t * udp)
+{
+  int bogus;
+
+  if (PREDICT_TRUE (!(b->flags & (VNET_BUFFER_F_OFFLOAD_IP_CKSUM |
+				  VNET_BUFFER_F_OFFLOAD_L4_CKSUM))))
+    {
+      b->flags &= ~VNET_BUFFER_F_IS_IP4;
+      b->flags |= VNET_BUFFER_F_OFFLOAD_UDP_CKSUM | VNET_BUFFER_F_IS_IP6;
+      vnet_buffer (b)->l3_hdr_offset = (u8 *) ip6 - b->data;
+      vnet_buffer (b)->l4_hdr_offset = (u8 *) udp - b->data;
+      udp->checksum = 0;
+      return;
+    }
+
+  udp->checksum = 0;
+  udp->checksum = ip6_tcp_udp_icmp_compute_checksum (vm, b, ip6, &bogus);
+  ASSERT (bogus == 0);
+  if (udp->checksum == 0)
+    udp->checksum = 0xffff;
+  ip_sw_csum_count (vm, IP_SW_CSUM_UDP_ENCAP, 1);
+}
+
 always_inline void
 ip_udp_fixup_one (vlib_main_t * vm, vlib_buffer_t * b0, u8 is_ip4)
 {
@@ -301,7 +332,6 @@ ip_udp_fixup_one (vlib_main_t * vm, vlib_buffer_t * b0, u8 is_ip4)
   else
     {
       ip6_header_t *ip0;
-      int bogus0;
 
       ip0 = vlib_buffer_get_current (b0);
 
@@ -313,12 +343,7 @@ ip_udp_fixup_one (vlib_main_t * vm, vlib_buffer_t * b0, u8 is_ip4)
       udp0 = (udp_header_t *) (ip0 + 1);
       udp0->length = new_l0;
 
-      udp0->checksum =
-	ip6_tcp_udp_icmp_compute_checksum (vm, b0, ip0, &bogus0);
-      ASSERT (bogus0 == 0);
-
-      if (udp0->checksum == 0)
-	udp0->checksum = 0xffff;
+      ip6_udp_encap_checksum (vm, b0, ip0, udp0);
     }
 }
 
@@ -410,7 +435,6 @@ ip_udp_encap_two (vlib_main_t * vm, vlib_buffer_t * b0, vlib_buffer_t * b1,
   else
     {
       ip6_header_t *ip0, *ip1;
-      int bogus0, bogus1;
 
       ip0 = vlib_buffer_get_current (b0);
       ip1 = vlib_buffer_get_current (b1);
@@ -433,17 +457,8 @@ ip_udp_encap_two (vlib_main_t * vm, vlib_buffer_t * b0, vlib_buffer_t * b1,
       udp0->length = new_l0;
       udp1->length = new_l1;
 
-      udp0->checksum =
-	ip6_tcp_udp_icmp_compute_checksum (vm, b0, ip0, &bogus0);
-      udp1->checksum =
-	ip6_tcp_udp_icmp_compute_checksum (vm, b1, ip1, &bogus1);
-      ASSERT (bogus0 == 0);
-      ASSERT (bogus1 == 0);
-
-      if (udp0->checksum == 0)
-	udp0->checksum = 0xffff;
-      if (udp1->checksum == 0)
-	udp1->checksum = 0xffff;
+      ip6_udp_encap_checksum (vm, b0, ip0, udp0);
+      ip6_udp_encap_checksum (vm, b1, ip1, udp1);
     }
 }
 
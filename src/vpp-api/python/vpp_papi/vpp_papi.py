@@ -388,10 +388,13 @@ class VPP():
             raise Exception("Not connected, api definitions not available")
         return self._api
 
-    def make_function(self, msg, i, multipart, async):
+    def make_function(self, msg, i, multipart, async, reply=None):
         if (async):
             def f(**kwargs):
                 return self._call_vpp_async(i, msg, **kwargs)
+        elif reply:
+            def f(**kwargs):
+                return self._call_vpp_paged(i, msg, reply, **kwargs)
         else:
             def f(**kwargs):
                 return self._call_vpp(i, msg, multipart, **kwargs)
@@ -414,7 +417,13 @@ class VPP():
                 self.id_names[i] = name
                 # TODO: Fix multipart (use services)
                 multipart = True if name.find('_dump') > 0 else False
-                f = self.make_function(msg, i, multipart, async)
+                # paged dumps: the details precede a reply with a cursor
+                reply = None
+                if name.endswith('_get') and 'cursor' in msg.fields:
+                    reply_msg = self.messages.get(name + '_reply')
+                    if reply_msg and 'cursor' in reply_msg.fields:
+                        reply = reply_msg.name
+                f = self.make_function(msg, i, multipart, async, reply)
                 setattr(self._api, name, FuncWrapper(f))
             else:
                 self.logger.debug(
@@ -622,6 +631,47 @@ class VPP():
 
         return rl
 
+    def _call_vpp_paged(self, i, msg, reply, **kwargs):
+        """Send one page request of a paged dump and collect the page.
+
+        reply - the name of the reply message that ends the page.
+
+        The return value is a (reply, details) tuple. Once the reply's
+        cursor is ~0 the dump is complete, else the request is repeated
+        with that cursor to fetch the next page.
+        """
+        if 'context' not in kwargs:
+            context = self.get_context()
+            kwargs['context'] = context
+        else:
+            context = kwargs['context']
+        kwargs['_vl_msg_id'] = i
+
+        self.validate_args(msg, kwargs)
+        b = msg.pack(kwargs)
+        vpp_api.vac_rx_suspend()
+        self._write(b)
+
+        rl = []
+        while (True):
+            msg = self._read()
+            if not msg:
+                raise IOError(2, 'VPP API client: read failed')
+            r = self.decode_incoming_msg(msg)
+            msgname = type(r).__name__
+            if context not in r or r.context == 0 or context != r.context:
+                self.message_queue.put_nowait(r)
+                continue
+
+            if msgname == reply:
+                break
+
+            rl.append(r)
+
+        vpp_api.vac_rx_resume()
+
+        return r, rl
+
     def _call_vpp_async(self, i, msg, **kwargs):
         """Given a message, send the message and await a reply.
 
@@ -539,6 +539,8 @@ api_segment_config (vlib_main_t * vm, unformat_input_t * input)
 	vl_set_api_memory_size (size * (1ULL << 30));
       else if (unformat (input, "api-size %lld", &size))
 	vl_set_api_memory_size (size);
+      else if (unformat (input, "lockfree-queue"))
+	vl_set_api_lockfree_queues (1);
       else if (unformat (input, "uid %s", &s))
 	{
 	  /* lookup the username */
@@ -1802,6 +1802,8 @@ static void *vl_api_create_vhost_user_if_t_print
     s = format (s, "server ");
   if (mp->renumber)
     s = format (s, "renumber %d ", ntohl (mp->custom_dev_instance));
+  if (mp->enable_gso)
+    s = format (s, "gso ");
   if (mp->tag[0])
     s = format (s, "tag %s", mp->tag);
 
@@ -1821,6 +1823,8 @@ static void *vl_api_modify_vhost_user_if_t_print
     s = format (s, "server ");
   if (mp->renumber)
     s = format (s, "renumber %d ", ntohl (mp->custom_dev_instance));
+  if (mp->enable_gso)
+    s = format (s, "gso ");
 
   FINISH;
 }
@@ -1861,6 +1865,21 @@ static void *vl_api_sw_interface_dump_t_print
   FINISH;
 }
 
+static void *vl_api_sw_interface_get_t_print
+  (vl_api_sw_interface_get_t * mp, void *handle)
+{
+  u8 *s;
+
+  s = format (0, "SCRIPT: sw_interface_get ");
+
+  if (mp->name_filter_valid)
+    s = format (s, "name_filter %s ", mp->name_filter);
+  s = format (s, "cursor %d max_entries %d ", ntohl (mp->cursor),
+	      ntohl (mp->max_entries));
+
+  FINISH;
+}
+
 static void *vl_api_l2_fib_table_dump_t_print
   (vl_api_l2_fib_table_dump_t * mp, void *handle)
 {
@@ -2440,6 +2459,28 @@ static void *vl_api_ip6_fib_dump_t_print
   FINISH;
 }
 
+static void *vl_api_ip_fib_get_t_print
+  (vl_api_ip_fib_get_t * mp, void *handle)
+{
+  u8 *s;
+
+  s = format (0, "SCRIPT: ip_fib_get cursor %d max_entries %d ",
+	      ntohl (mp->cursor), ntohl (mp->max_entries));
+
+  FINISH;
+}
+
+static void *vl_api_ip6_fib_get_t_print
+  (vl_api_ip6_fib_get_t * mp, void *handle)
+{
+  u8 *s;
+
+  s = format (0, "SCRIPT: ip6_fib_get cursor %d max_entries %d ",
+	      ntohl (mp->cursor), ntohl (mp->max_entries));
+
+  FINISH;
+}
+
 static void *vl_api_classify_table_ids_t_print
   (vl_api_classify_table_ids_t * mp, void *handle)
 {
@@ -2628,6 +2669,8 @@ static void *vl_api_pg_create_interface_t_print
 
   s = format (0, "SCRIPT: pg_create_interface ");
   s = format (0, "if_id %d", ntohl (mp->interface_id));
+  if (mp->gso_enabled)
+    s = format (s, " gso-enabled gso-size %d", ntohl (mp->gso_size));
 
   FINISH;
 }
@@ -3590,6 +3633,7 @@ _(CREATE_VHOST_USER_IF, create_vhost_user_if)				\
 _(MODIFY_VHOST_USER_IF, modify_vhost_user_if)				\
 _(DELETE_VHOST_USER_IF, delete_vhost_user_if)				\
 _(SW_INTERFACE_DUMP, sw_interface_dump)					\
+_(SW_INTERFACE_GET, sw_interface_get)					\
 _(CONTROL_PING, control_ping)						\
 _(WANT_INTERFACE_EVENTS, want_interface_events)				\
 _(CLI, cli)								\
@@ -3683,7 +3727,9 @@ _(GET_FIRST_MSG_ID, get_first_msg_id)                                   \
 _(IOAM_ENABLE, ioam_enable)                                             \
 _(IOAM_DISABLE, ioam_disable)                                           \
 _(IP_FIB_DUMP, ip_fib_dump)                                             \
+_(IP_FIB_GET, ip_fib_get)                                               \
 _(IP6_FIB_DUMP, ip6_fib_dump)                                           \
+_(IP6_FIB_GET, ip6_fib_get)                                             \
 _(FEATURE_ENABLE_DISABLE, feature_enable_disable)			\
 _(SW_INTERFACE_TAG_ADD_DEL, sw_interface_tag_add_del)			\
 _(HW_INTERFACE_SET_MTU, hw_interface_set_mtu)                           \
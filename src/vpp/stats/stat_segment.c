@@ -236,6 +236,10 @@ vlib_map_stat_segment_init (void)
   sm->input_rate_ptr = (scalar_data + 1);
   sm->last_runtime_ptr = (scalar_data + 2);
   sm->last_runtime_stats_clear_ptr = (scalar_data + 3);
+  sm->fib_convergence_last_ptr = (scalar_data + 4);
+  sm->fib_convergence_max_ptr = (scalar_data + 5);
+  sm->fib_convergences_ptr = (scalar_data + 6);
+  sm->fib_convergence_visits_ptr = (scalar_data + 7);
 
   name = format (0, "/sys/vector_rate%c", 0);
   ep = clib_mem_alloc (sizeof (*ep));
@@ -265,6 +269,34 @@ vlib_map_stat_segment_init (void)
 
   hash_set_mem (sm->counter_vector_by_name, name, ep);
 
+  name = format (0, "/fib/walk/convergence_last%c", 0);
+  ep = clib_mem_alloc (sizeof (*ep));
+  ep->type = STAT_DIR_TYPE_SCALAR_POINTER;
+  ep->value = sm->fib_convergence_last_ptr;
+
+  hash_set_mem (sm->counter_vector_by_name, name, ep);
+
+  name = format (0, "/fib/walk/convergence_max%c", 0);
+  ep = clib_mem_alloc (sizeof (*ep));
+  ep->type = STAT_DIR_TYPE_SCALAR_POINTER;
+  ep->value = sm->fib_convergence_max_ptr;
+
+  hash_set_mem (sm->counter_vector_by_name, name, ep);
+
+  name = format (0, "/fib/walk/convergences%c", 0);
+  ep = clib_mem_alloc (sizeof (*ep));
+  ep->type = STAT_DIR_TYPE_SCALAR_POINTER;
+  ep->value = sm->fib_convergences_ptr;
+
+  hash_set_mem (sm->counter_vector_by_name, name, ep);
+
+  name = format (0, "/fib/walk/convergence_visits%c", 0);
+  ep = clib_mem_alloc (sizeof (*ep));
+  ep->type = STAT_DIR_TYPE_SCALAR_POINTER;
+  ep->value = sm->fib_convergence_visits_ptr;
+
+  hash_set_mem (sm->counter_vector_by_name, name, ep);
+
 
   /* Publish the hash table */
   shared_header->opaque[STAT_SEGMENT_OPAQUE_DIR] = sm->counter_vector_by_name;
@@ -510,6 +542,20 @@ do_stat_segment_updates (stats_main_t * sm)
   sm->last_runtime_stats_clear_ptr[0] =
     vm->node_main.time_last_runtime_stats_clear;
 
+  /*
+   * FIB convergence. Read without the barrier; a torn read of one
+   * scalar is corrected at the next update.
+   */
+  {
+    const fib_walk_convergence_stats_t *fwcs;
+
+    fwcs = fib_walk_get_convergence_stats ();
+    sm->fib_convergence_last_ptr[0] = fwcs->fwcs_last;
+    sm->fib_convergence_max_ptr[0] = fwcs->fwcs_max;
+    sm->fib_convergences_ptr[0] = fwcs->fwcs_n_convergences;
+    sm->fib_convergence_visits_ptr[0] = fwcs->fwcs_last_n_visits;
+  }
+
   if (sm->serialize_nodes)
     update_serialized_nodes (sm);
 }
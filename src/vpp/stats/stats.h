@@ -22,6 +22,7 @@
 #include <pthread.h>
 #include <vlib/threads.h>
 #include <vnet/fib/fib_table.h>
+#include <vnet/fib/fib_walk.h>
 #include <vnet/mfib/mfib_table.h>
 #include <vlib/unix/unix.h>
 #include <vlibmemory/api.h>
@@ -177,6 +178,12 @@ typedef struct
   f64 *vector_rate_ptr;
   u64 last_input_packets;
 
+  /* FIB convergence, copied from the fib walk stats */
+  f64 *fib_convergence_last_ptr;
+  f64 *fib_convergence_max_ptr;
+  f64 *fib_convergences_ptr;
+  f64 *fib_convergence_visits_ptr;
+
   /* Pointers to vector stats maintained by the stat thread */
   u8 *serialized_nodes;
   vlib_main_t **stat_vms;
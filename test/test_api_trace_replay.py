@@ -0,0 +1,76 @@
+#!/usr/bin/env python
+
+import os
+import shutil
+import unittest
+
+from framework import VppTestCase, VppTestRunner
+from vpp_ip_route import VppIpRoute, VppRoutePath, find_route
+
+
+class TestApiTraceReplay(VppTestCase):
+    """ API Trace Replay Benchmark Test Case """
+
+    @classmethod
+    def setUpClass(cls):
+        super(TestApiTraceReplay, cls).setUpClass()
+
+    def setUp(self):
+        super(TestApiTraceReplay, self).setUp()
+        self.create_pg_interfaces(range(1))
+        for i in self.pg_interfaces:
+            i.admin_up()
+            i.config_ip4()
+            i.resolve_arp()
+
+    def tearDown(self):
+        for i in self.pg_interfaces:
+            i.unconfig_ip4()
+            i.admin_down()
+        super(TestApiTraceReplay, self).tearDown()
+
+    def test_benchmark(self):
+        """ Replay a route add/delete trace as a benchmark """
+
+        # capture a fresh trace holding only the workload
+        self.vapi.cli("api trace free")
+        self.vapi.cli("api trace on")
+
+        routes = []
+        for i in range(50):
+            r = VppIpRoute(self, "10.10.%d.0" % i, 24,
+                           [VppRoutePath(self.pg0.remote_ip4,
+                                         self.pg0.sw_if_index)])
+            r.add_vpp_config()
+            routes.append(r)
+        for r in routes:
+            r.remove_vpp_config()
+
+        self.vapi.cli("api trace off")
+
+        # vpp saves traces to /tmp only, move it to the test's own directory
+        name = "replay-bench-%s.api" % os.path.basename(self.tempdir)
+        self.vapi.cli("api trace save %s" % name)
+        trace = "%s/replay-bench.api" % self.tempdir
+        shutil.move("/tmp/%s" % name, trace)
+
+        reply = self.vapi.cli("api trace benchmark %s repeat 3" % trace)
+        self.logger.info(reply)
+
+        self.assertIn("Replayed", reply)
+        self.assertIn("ip_add_del_route", reply)
+        self.assertIn("pass 3", reply)
+
+        # each pass adds then deletes, nothing is left behind
+        for i in range(50):
+            self.assertFalse(find_route(self, "10.10.%d.0" % i, 24))
+
+        # paced replay
+        reply = self.vapi.cli("api trace benchmark %s rate 5000" % trace)
+        self.assertIn("Replayed", reply)
+
+        # trace capture is on for the rest of the run
+        self.vapi.cli("api trace on")
+
+if __name__ == '__main__':
+    unittest.main(testRunner=VppTestRunner)
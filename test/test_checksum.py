@@ -0,0 +1,171 @@
+#!/usr/bin/env python
+"""Software checksum functional tests"""
+
+import struct
+import unittest
+
+from scapy.packet import Raw
+from scapy.layers.l2 import Ether
+from scapy.layers.inet import IP, UDP, TCP
+from scapy.layers.inet6 import IPv6
+
+from framework import VppTestCase, VppTestRunner
+from vpp_ip_route import VppIpRoute, VppRoutePath
+from vpp_udp_encap import VppUdpEncap
+
+
+class TestSwChecksum(VppTestCase):
+    """ Software Checksum Test Case """
+
+    @classmethod
+    def setUpClass(cls):
+        super(TestSwChecksum, cls).setUpClass()
+        # pg interfaces offload no checksum, so interface-output computes
+        # the ones left to the interface
+        cls.create_pg_interfaces(range(2), gso_size=1000)
+
+    def setUp(self):
+        super(TestSwChecksum, self).setUp()
+        for i in self.pg_interfaces:
+            i.admin_up()
+            i.config_ip4()
+            i.config_ip6()
+            i.disable_ipv6_ra()
+            i.resolve_arp()
+            i.resolve_ndp()
+        self.vapi.cli("clear ip sw-checksum")
+
+    def tearDown(self):
+        super(TestSwChecksum, self).tearDown()
+        if not self.vpp_dead:
+            self.logger.info(self.vapi.cli("show ip sw-checksum"))
+            for i in self.pg_interfaces:
+                i.unconfig_ip4()
+                i.unconfig_ip6()
+                i.admin_down()
+
+    def send(self, pkts):
+        # the replies, ICMP port unreachables, are of no interest
+        self.pg0.add_stream(pkts)
+        self.pg_enable_capture(self.pg_interfaces)
+        self.pg_start()
+
+    def get_sw_checksums(self):
+        # a header line, then "<node> <count>" per node
+        counters = {}
+        for line in self.vapi.cli("show ip sw-checksum").splitlines()[1:]:
+            f = line.split()
+            if len(f) == 2:
+                counters[f[0]] = int(f[1])
+        return counters
+
+    def assert_sw_checksums(self, **expected):
+        counters = self.get_sw_checksums()
+        for node, count in counters.items():
+            self.assertEqual(count,
+                             expected.get(node.replace("-", "_"), 0),
+                             "software checksums in %s" % node)
+
+    def test_show_clear(self):
+        """ sw-checksum counters are shown and cleared """
+        counters = self.get_sw_checksums()
+        for node in ["interface-output", "ip4-local", "ip6-local", "gro",
+                     "ipsec-output", "udp-encap"]:
+            self.assertIn(node, counters)
+
+        p = (Ether(src=self.pg0.remote_mac, dst=self.pg0.local_mac) /
+             IP(src=self.pg0.remote_ip4, dst=self.pg0.local_ip4) /
+             UDP(sport=1234, dport=1234) /
+             Raw('\xa5' * 100))
+        self.send(p * 3)
+        self.assert_sw_checksums(ip4_local=3)
+
+        self.vapi.cli("clear ip sw-checksum")
+        self.assert_sw_checksums()
+
+    def test_local(self):
+        """ sw-checksum counts checksums verified by ip4/ip6-local """
+        p4 = (Ether(src=self.pg0.remote_mac, dst=self.pg0.local_mac) /
+              IP(src=self.pg0.remote_ip4, dst=self.pg0.local_ip4) /
+              UDP(sport=1234, dport=1234) /
+              Raw('\xa5' * 100))
+        p6 = (Ether(src=self.pg0.remote_mac, dst=self.pg0.local_mac) /
+              IPv6(src=self.pg0.remote_ip6, dst=self.pg0.local_ip6) /
+              UDP(sport=1234, dport=1234) /
+              Raw('\xa5' * 100))
+        self.send(p4 * 5 + p6 * 7)
+        self.assert_sw_checksums(ip4_local=5, ip6_local=7)
+
+    def test_tcp_reset(self):
+        """ TCP reset offloaded to a non-offload interface """
+        self.vapi.session_enable_disable(is_enabled=1)
+        try:
+            p = (Ether(src=self.pg0.remote_mac, dst=self.pg0.local_mac) /
+                 IP(src=self.pg0.remote_ip4, dst=self.pg0.local_ip4) /
+                 TCP(sport=1234, dport=80, flags="S", seq=100))
+            rx = self.send_and_expect(self.pg0, [p], self.pg0)
+            self.assertEqual(rx[0][TCP].flags, 0x14)  # RST|ACK
+            self.assert_ip_checksum_valid(rx[0])
+            self.assert_tcp_checksum_valid(rx[0])
+            # verified on the way in, computed on the way out
+            self.assert_sw_checksums(ip4_local=1, interface_output=1)
+        finally:
+            self.vapi.session_enable_disable(is_enabled=0)
+
+    def test_gso(self):
+        """ GSO segments get their checksums on a non-offload interface """
+        p = (Ether(src=self.pg0.remote_mac, dst=self.pg0.local_mac) /
+             IP(src=self.pg0.remote_ip4, dst=self.pg1.remote_ip4) /
+             TCP(sport=1234, dport=5678, flags="A", seq=1000, ack=1) /
+             Raw('\xa5' * 4000))
+        self.pg0.add_stream([p])
+        self.pg_enable_capture(self.pg_interfaces)
+        self.pg_start()
+        rx = self.pg1.get_capture(4)
+        for s in rx:
+            self.assert_ip_checksum_valid(s)
+            self.assert_tcp_checksum_valid(s)
+        self.assert_sw_checksums(interface_output=4)
+
+    def test_udp_encap6(self):
+        """ IPv6 encap UDP checksum computed at interface-output """
+        encap = VppUdpEncap(self, 0,
+                            self.pg1.local_ip6,
+                            self.pg1.remote_ip6,
+                            330, 440,
+                            is_ip6=1)
+        encap.add_vpp_config()
+        route = VppIpRoute(self, "1.1.2.1", 32,
+                           [VppRoutePath("0.0.0.0",
+                                         0xFFFFFFFF,
+                                         is_udp_encap=1,
+                                         next_hop_id=0)])
+        route.add_vpp_config()
+
+        def inner(word):
+            # the inner UDP checksum is disabled so that the word is the
+            # only difference the outer checksum sees
+            return (Ether(src=self.pg0.remote_mac, dst=self.pg0.local_mac) /
+                    IP(src="2.2.2.2", dst="1.1.2.1") /
+                    UDP(sport=1234, dport=1234, chksum=0) /
+                    Raw(struct.pack("!H", word) + '\xa5' * 98))
+
+        rx = self.send_and_expect(self.pg0, inner(0) * 5, self.pg1)
+        for p in rx:
+            self.assertNotEqual(p[UDP].chksum, 0)
+            self.assert_udp_checksum_valid(p, ignore_zero_checksum=False)
+        self.assert_sw_checksums(interface_output=5)
+
+        # adding the checksum to an even-aligned word of the payload
+        # makes the sum 0xffff, whose checksum of 0 is sent as 0xffff
+        rx = self.send_and_expect(self.pg0, [inner(rx[0][UDP].chksum)],
+                                  self.pg1)
+        self.assertEqual(rx[0][UDP].chksum, 0xffff)
+        self.assert_udp_checksum_valid(rx[0], ignore_zero_checksum=False)
+
+        route.remove_vpp_config()
+        encap.remove_vpp_config()
+
+
+if __name__ == '__main__':
+    unittest.main(testRunner=VppTestRunner)
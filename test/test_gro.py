@@ -0,0 +1,120 @@
+#!/usr/bin/env python
+"""GRO functional tests"""
+
+import unittest
+
+from scapy.packet import Raw
+from scapy.layers.l2 import Ether
+from scapy.layers.inet import IP, TCP
+from scapy.layers.inet6 import IPv6
+
+from framework import VppTestCase, VppTestRunner
+
+
+class TestGRO(VppTestCase):
+    """ GRO Test Case """
+
+    @classmethod
+    def setUpClass(cls):
+        super(TestGRO, cls).setUpClass()
+        cls.create_pg_interfaces(range(2))
+
+    def setUp(self):
+        super(TestGRO, self).setUp()
+        for i in self.pg_interfaces:
+            i.admin_up()
+            i.config_ip4()
+            i.config_ip6()
+            i.disable_ipv6_ra()
+            i.resolve_arp()
+            i.resolve_ndp()
+        self.vapi.cli("set interface gro pg0")
+
+    def tearDown(self):
+        super(TestGRO, self).tearDown()
+        if not self.vpp_dead:
+            self.logger.info(self.vapi.cli("show gro"))
+            self.vapi.cli("set interface gro pg0 disable")
+            for i in self.pg_interfaces:
+                i.unconfig_ip4()
+                i.unconfig_ip6()
+                i.admin_down()
+
+    def create_stream(self, ip, n_segs, seg_size, flags="A"):
+        pkts = []
+        for i in range(n_segs):
+            payload = chr(ord('a') + i) * seg_size
+            pkts.append(Ether(src=self.pg0.remote_mac,
+                              dst=self.pg0.local_mac) /
+                        ip /
+                        TCP(sport=1234, dport=5678, flags=flags,
+                            seq=1000 + i * seg_size, ack=1) /
+                        Raw(payload))
+        return pkts
+
+    def get_gro_counters(self):
+        # "segments <n>, packets <n>, ratio <r>"
+        for line in self.vapi.cli("show gro").splitlines():
+            if line.startswith("segments"):
+                f = line.replace(",", "").split()
+                return int(f[1]), int(f[3])
+        return 0, 0
+
+    def verify_stream(self, rx, n_segs, seg_size):
+        self.assertEqual(len(rx), n_segs)
+        for i, p in enumerate(rx):
+            self.assertEqual(p[TCP].seq, 1000 + i * seg_size)
+            self.assertEqual(p[Raw].load, chr(ord('a') + i) * seg_size)
+            # checksums computed at segmentation must be correct
+            tcp = p[TCP]
+            chksum = tcp.chksum
+            del tcp.chksum
+            self.assertEqual(chksum, p.__class__(str(p))[TCP].chksum)
+
+    def test_gro_ip4(self):
+        """ GRO IPv4 segments are coalesced and resegmented """
+        ip = IP(src=self.pg0.remote_ip4, dst=self.pg1.remote_ip4)
+        segs, pkts = self.get_gro_counters()
+        rx = self.send_and_expect(self.pg0,
+                                  self.create_stream(ip, 8, 1000),
+                                  self.pg1)
+        self.verify_stream(rx, 8, 1000)
+        self.assertEqual(self.get_gro_counters(), (segs + 8, pkts + 1))
+
+    def test_gro_ip6(self):
+        """ GRO IPv6 segments are coalesced and resegmented """
+        ip = IPv6(src=self.pg0.remote_ip6, dst=self.pg1.remote_ip6)
+        segs, pkts = self.get_gro_counters()
+        rx = self.send_and_expect(self.pg0,
+                                  self.create_stream(ip, 8, 1000),
+                                  self.pg1)
+        self.verify_stream(rx, 8, 1000)
+        self.assertEqual(self.get_gro_counters(), (segs + 8, pkts + 1))
+
+    def test_gro_sequence_gap(self):
+        """ GRO flushes the held packet on a sequence gap """
+        ip = IP(src=self.pg0.remote_ip4, dst=self.pg1.remote_ip4)
+        segs, pkts = self.get_gro_counters()
+        stream = self.create_stream(ip, 6, 1000)
+        # segment 2 is lost: 0-1 and 3-5 are coalesced separately
+        del stream[2]
+        rx = self.send_and_expect(self.pg0, stream, self.pg1)
+        self.assertEqual([p[TCP].seq for p in rx],
+                         [1000 + i * 1000 for i in (0, 1, 3, 4, 5)])
+        for p in rx:
+            self.assert_tcp_checksum_valid(p)
+        self.assertEqual(self.get_gro_counters(), (segs + 5, pkts + 2))
+
+    def test_gro_not_coalesced(self):
+        """ GRO leaves out of order and non ACK segments alone """
+        ip = IP(src=self.pg0.remote_ip4, dst=self.pg1.remote_ip4)
+        counters = self.get_gro_counters()
+        pkts = self.create_stream(ip, 4, 1000, flags="PA")
+        pkts.reverse()
+        rx = self.send_and_expect(self.pg0, pkts, self.pg1)
+        self.assertEqual(len(rx), 4)
+        self.assertEqual(self.get_gro_counters(), counters)
+
+
+if __name__ == '__main__':
+    unittest.main(testRunner=VppTestRunner)
@@ -0,0 +1,108 @@
+#!/usr/bin/env python
+"""GSO functional tests"""
+
+import unittest
+
+from scapy.packet import Raw
+from scapy.layers.l2 import Ether
+from scapy.layers.inet import IP, TCP
+from scapy.layers.inet6 import IPv6
+
+from framework import VppTestCase, VppTestRunner
+
+
+class TestGSO(VppTestCase):
+    """ GSO Test Case """
+
+    gso_size = 1000
+
+    @classmethod
+    def setUpClass(cls):
+        super(TestGSO, cls).setUpClass()
+        # pg0 hands the TCP packets it is given to the graph as GSO
+        # packets; pg1 cannot take them and has them segmented in software
+        cls.create_pg_interfaces(range(2), gso_size=cls.gso_size)
+
+    def setUp(self):
+        super(TestGSO, self).setUp()
+        for i in self.pg_interfaces:
+            i.admin_up()
+            i.config_ip4()
+            i.config_ip6()
+            i.disable_ipv6_ra()
+            i.resolve_arp()
+            i.resolve_ndp()
+
+    def tearDown(self):
+        super(TestGSO, self).tearDown()
+        if not self.vpp_dead:
+            for i in self.pg_interfaces:
+                i.unconfig_ip4()
+                i.unconfig_ip6()
+                i.admin_down()
+
+    def create_packet(self, ip, size, flags="PA"):
+        return (Ether(src=self.pg0.remote_mac, dst=self.pg0.local_mac) /
+                ip /
+                TCP(sport=1234, dport=5678, flags=flags, seq=1000, ack=1) /
+                Raw(''.join(chr(ord('a') + i % 26) for i in range(size))))
+
+    def send_and_expect_segments(self, p, n_segs):
+        self.pg0.add_stream([p])
+        self.pg_enable_capture(self.pg_interfaces)
+        self.pg_start()
+        rx = self.pg1.get_capture(n_segs)
+        self.verify_segments(p, rx)
+
+    def verify_segments(self, p, rx):
+        payload = p[Raw].load
+        n_segs = (len(payload) + self.gso_size - 1) / self.gso_size
+        self.assertEqual(len(rx), n_segs)
+        for i, s in enumerate(rx):
+            seg = payload[i * self.gso_size:(i + 1) * self.gso_size]
+            self.assertEqual(s[TCP].seq, p[TCP].seq + i * self.gso_size)
+            self.assertEqual(s[Raw].load, seg)
+            # PSH and FIN only on the last segment
+            flags = int(p[TCP].flags)
+            if i != n_segs - 1:
+                flags &= ~0x09
+            self.assertEqual(int(s[TCP].flags), flags)
+            if IP in s:
+                self.assertEqual(s[IP].len, 40 + len(seg))
+                self.assertEqual(s[IP].id, (p[IP].id + i) & 0xffff)
+                self.assert_ip_checksum_valid(s)
+            else:
+                self.assertEqual(s[IPv6].plen, 20 + len(seg))
+            self.assert_tcp_checksum_valid(s)
+
+    def test_gso_ip4(self):
+        """ GSO IPv4 packet is segmented for a non-GSO interface """
+        p = self.create_packet(IP(src=self.pg0.remote_ip4,
+                                  dst=self.pg1.remote_ip4, id=7),
+                               4500, flags="FPA")
+        self.send_and_expect_segments(p, 5)
+
+    def test_gso_ip6(self):
+        """ GSO IPv6 packet is segmented for a non-GSO interface """
+        p = self.create_packet(IPv6(src=self.pg0.remote_ip6,
+                                    dst=self.pg1.remote_ip6),
+                               4500)
+        self.send_and_expect_segments(p, 5)
+
+    def test_gso_small(self):
+        """ GSO packet within the segment size is sent as it is """
+        p = self.create_packet(IP(src=self.pg0.remote_ip4,
+                                  dst=self.pg1.remote_ip4),
+                               self.gso_size)
+        self.send_and_expect_segments(p, 1)
+
+    def test_gso_size_too_small(self):
+        """ GSO size below the minimum is refused """
+        with self.vapi.expect_negative_api_retval():
+            self.vapi.pg_create_interface(2, 1, 10)
+        with self.vapi.expect_negative_api_retval():
+            self.vapi.pg_create_interface(2, 1, 0)
+
+
+if __name__ == '__main__':
+    unittest.main(testRunner=VppTestRunner)
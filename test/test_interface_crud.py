@@ -119,6 +119,55 @@ class TestLoopbackInterfaceCRUD(VppTestCase):
         self.pg_start()
         self.pg0.assert_nothing_captured()
 
+    def test_paged_read(self):
+        # create
+        loopbacks = self.create_loopback_interfaces(20)
+        for i in loopbacks:
+            i.local_ip4_prefix_len = 32
+            i.config_ip4()
+            i.admin_up()
+
+        # read a few entries at a time and compare with a full dump
+        if_dump = self.vapi.sw_interface_dump()
+        if_get, n_pages = self.vapi.sw_interface_get(page_size=3)
+        self.assertGreater(n_pages, 1)
+        self.assertEqual(sorted(i.sw_if_index for i in if_get),
+                         sorted(i.sw_if_index for i in if_dump))
+
+        fib4_dump = self.vapi.ip_fib_dump()
+        fib4_get, n_pages = self.vapi.ip_fib_get(page_size=5)
+        self.assertGreater(n_pages, 1)
+        self.assertEqual(len(fib4_get), len(fib4_dump))
+        for i in loopbacks:
+            self.assertTrue(i.is_interface_config_in_dump(if_get))
+            self.assertTrue(i.is_ip4_entry_in_fib_dump(fib4_get))
+
+        # no limit on the page size - one request
+        if_get, n_pages = self.vapi.sw_interface_get()
+        self.assertEqual(n_pages, 1)
+        self.assertEqual(len(if_get), len(if_dump))
+
+        # name filtered
+        if_get, n_pages = self.vapi.sw_interface_get(filter="loop",
+                                                     page_size=3)
+        for i in if_get:
+            self.assertIn("loop", i.interface_name)
+        for i in loopbacks:
+            self.assertTrue(i.is_interface_config_in_dump(if_get))
+
+        # delete
+        for i in loopbacks:
+            i.remove_vpp_config()
+
+        if_get, n_pages = self.vapi.sw_interface_get(page_size=3)
+        for i in loopbacks:
+            self.assertFalse(i.is_interface_config_in_dump(if_get))
+
+        # the read-only handlers are accounted per message type
+        latency = self.vapi.cli("show api handler-latency")
+        self.assertIn("sw_interface_get", latency)
+        self.assertIn("ip_fib_get", latency)
+
     def test_down(self):
         # create
         loopbacks = self.create_loopback_interfaces(20)
@@ -1,5 +1,7 @@
 #!/usr/bin/env python
+import binascii
 import random
+import re
 import socket
 import unittest
 
@@ -7,11 +9,12 @@ from framework import VppTestCase, VppTestRunner
 from vpp_sub_interface import VppSubInterface, VppDot1QSubint, VppDot1ADSubint
 from vpp_ip_route import VppIpRoute, VppRoutePath, VppIpMRoute, \
     VppMRoutePath, MRouteItfFlags, MRouteEntryFlags, VppMplsIpBind, \
-    VppMplsTable, VppIpTable
+    VppMplsTable, VppIpTable, find_route, DpoProto
 
 from scapy.packet import Raw
 from scapy.layers.l2 import Ether, Dot1Q, ARP
 from scapy.layers.inet import IP, UDP, TCP, ICMP, icmptypes, icmpcodes
+from scapy.layers.inet6 import IPv6
 from util import ppp
 from scapy.contrib.mpls import MPLS
 
@@ -220,6 +223,49 @@ class TestIPv4(VppTestCase):
             pkts = i.parent.get_capture()
             self.verify_capture(i, pkts)
 
+    def test_mtrie_lookup(self):
+        """ IPv4 batched mtrie lookup
+
+        Test scenario:
+
+            - Check each mtrie lookup the CPU supports against the scalar
+              one on a private trie.
+            - Forward the FIB test streams with the scalar lookup and with
+              the default one and compare ip4-lookup clocks per packet.
+        """
+        reply = self.vapi.cli("test ip mtrie lookup routes 20000 "
+                              "lookups 1000000")
+        self.logger.info(reply)
+        self.assertNotIn("disagrees", reply)
+        self.assertIn("scalar", reply)
+
+        clocks = dict()
+        for variant in ["scalar", "auto"]:
+            self.logger.info(self.vapi.cli("set ip mtrie lookup %s" %
+                                           variant))
+            self.vapi.cli("clear runtime")
+
+            pkts = self.create_stream(self.pg0)
+            self.pg0.add_stream(pkts)
+            for i in self.sub_interfaces:
+                pkts = self.create_stream(i)
+                i.parent.add_stream(pkts)
+
+            self.pg_enable_capture(self.pg_interfaces)
+            self.pg_start()
+
+            pkts = self.pg0.get_capture()
+            self.verify_capture(self.pg0, pkts)
+            for i in self.sub_interfaces:
+                pkts = i.parent.get_capture()
+                self.verify_capture(i, pkts)
+
+            for line in self.vapi.cli("show runtime ip4-lookup").splitlines():
+                if line.split()[:1] == ["ip4-lookup"]:
+                    clocks[variant] = float(line.split()[-2])
+        self.logger.info("ip4-lookup clocks/packet: %s" % clocks)
+        self.vapi.cli("set ip mtrie lookup auto")
+
 
 class TestICMPEcho(VppTestCase):
     """ ICMP Echo Test Case """
@@ -544,6 +590,66 @@ class TestIPv4FibCrud(VppTestCase):
         fib_dump = self.vapi.ip_fib_dump()
         self.verify_not_in_route_dump(fib_dump, self.deleted_routes)
 
+    def test_5_bulk_routes(self):
+        """ Bulk add/delete routes
+
+        - add a covering /24 and 255 /32s in one request, more specifics
+          first, check with traffic script.
+        - a request with an invalid route changes nothing.
+        - delete them all in one request.
+        """
+        path = VppRoutePath(
+            socket.inet_pton(socket.AF_INET, self.pg0.remote_ip4),
+            self.pg0.sw_if_index).encode()
+        bulk_ips = ["10.0.2.%d" % i for i in range(1, 256)]
+        routes = [{'dst_address': socket.inet_pton(socket.AF_INET, ip),
+                   'dst_address_length': 32,
+                   'path': path} for ip in bulk_ips]
+        routes.append({'dst_address': socket.inet_pton(socket.AF_INET,
+                                                       "10.0.2.0"),
+                       'dst_address_length': 24,
+                       'path': path})
+
+        reply = self.vapi.ip_route_add_del_bulk(routes)
+        self.assertEqual(reply.n_applied, len(routes))
+
+        fib_dump = self.vapi.ip_fib_dump()
+        self.verify_route_dump(fib_dump, bulk_ips)
+        self.assertTrue(find_route(self, "10.0.2.0", 24))
+
+        self.stream_1 = self.create_stream(
+            self.pg1, self.pg0, bulk_ips, 100)
+        self.pg1.add_stream(self.stream_1)
+        self.pg_enable_capture(self.pg_interfaces)
+        self.pg_start()
+
+        pkts = self.pg0.get_capture(len(self.stream_1))
+        self.verify_capture(self.pg0, pkts, self.stream_1)
+
+        #
+        # a path via an interface that does not exist fails the request
+        # before any route is added
+        #
+        bad_path = VppRoutePath(
+            socket.inet_pton(socket.AF_INET, self.pg0.remote_ip4),
+            1000).encode()
+        bad = [{'dst_address': socket.inet_pton(socket.AF_INET, "10.0.3.1"),
+                'dst_address_length': 32,
+                'path': path},
+               {'dst_address': socket.inet_pton(socket.AF_INET, "10.0.3.2"),
+                'dst_address_length': 32,
+                'path': bad_path}]
+        with self.vapi.expect_negative_api_retval():
+            self.vapi.ip_route_add_del_bulk(bad)
+        self.assertFalse(find_route(self, "10.0.3.1", 32))
+
+        reply = self.vapi.ip_route_add_del_bulk(routes, is_add=0)
+        self.assertEqual(reply.n_applied, len(routes))
+
+        fib_dump = self.vapi.ip_fib_dump()
+        self.verify_not_in_route_dump(fib_dump, bulk_ips)
+        self.assertFalse(find_route(self, "10.0.2.0", 24))
+
 
 class TestIPNull(VppTestCase):
     """ IPv4 routes via NULL """
@@ -1021,6 +1127,77 @@ class TestIPLoadBalance(VppTestCase):
         self.vapi.cli("clear trace")
         self.send_and_expect_one_itf(self.pg0, port_pkts, self.pg3)
 
+    def send_and_map_flows(self, input, pkts, outputs):
+        input.add_stream(pkts)
+        self.pg_enable_capture(self.pg_interfaces)
+        self.pg_start()
+        flows = dict()
+        for oo in outputs:
+            for rx in oo._get_capture(1):
+                flows[rx[UDP].dport] = oo.sw_if_index
+        self.assertEqual(len(flows), len(pkts))
+        return flows
+
+    def test_ip_load_balance_resilient(self):
+        """ IP Resilient Load-Balancing """
+
+        self.vapi.cli("set load-balance resilient buckets 64")
+
+        pkts = []
+        for ii in range(257):
+            pkts.append((Ether(src=self.pg0.remote_mac,
+                               dst=self.pg0.local_mac) /
+                         IP(dst="10.0.0.1", src="20.0.0.1") /
+                         UDP(sport=1234, dport=1234 + ii) /
+                         Raw('\xa5' * 100)))
+
+        paths = [VppRoutePath(self.pg_interfaces[ii].remote_ip4,
+                              self.pg_interfaces[ii].sw_if_index)
+                 for ii in range(1, 5)]
+        route_10_0_0_1 = VppIpRoute(self, "10.0.0.1", 32, paths)
+        route_10_0_0_1.add_vpp_config()
+
+        lb = self.vapi.cli("show ip fib 10.0.0.1/32")
+        self.assertIn("buckets:64", lb)
+        self.assertIn("resilient", lb)
+
+        before = self.send_and_map_flows(self.pg0, pkts,
+                                         self.pg_interfaces[1:5])
+
+        #
+        # remove the path via pg4. only the flows that used it move
+        #
+        self.vapi.ip_add_del_route(route_10_0_0_1.dest_addr, 32,
+                                   self.pg4.remote_ip4n,
+                                   self.pg4.sw_if_index,
+                                   is_multipath=1, is_add=0)
+        route_10_0_0_1.modify(paths[:3])
+
+        after = self.send_and_map_flows(self.pg0, pkts,
+                                        self.pg_interfaces[1:4])
+        for flow, sw_if_index in before.items():
+            if sw_if_index != self.pg4.sw_if_index:
+                self.assertEqual(after[flow], sw_if_index)
+
+        #
+        # add it back; flows move only to the new path
+        #
+        self.vapi.ip_add_del_route(route_10_0_0_1.dest_addr, 32,
+                                   self.pg4.remote_ip4n,
+                                   self.pg4.sw_if_index,
+                                   is_multipath=1)
+        route_10_0_0_1.modify(paths)
+
+        again = self.send_and_map_flows(self.pg0, pkts,
+                                        self.pg_interfaces[1:5])
+        for flow, sw_if_index in again.items():
+            if sw_if_index != self.pg4.sw_if_index:
+                self.assertEqual(after[flow], sw_if_index)
+        self.assertIn(self.pg4.sw_if_index, again.values())
+
+        route_10_0_0_1.remove_vpp_config()
+        self.vapi.cli("set load-balance resilient disable")
+
 
 class TestIPVlan0(VppTestCase):
     """ IPv4 VLAN-0 """
@@ -1063,6 +1240,372 @@ class TestIPVlan0(VppTestCase):
         self.send_and_expect(self.pg0, pkts, self.pg1)
 
 
+class TestIPVlanMixed(VppTestCase):
+    """ IPv4 VLAN mixed frames """
+
+    def setUp(self):
+        super(TestIPVlanMixed, self).setUp()
+
+        self.create_pg_interfaces(range(2))
+        self.sub_interfaces = [
+            VppDot1QSubint(self, self.pg0, 100),
+            VppDot1QSubint(self, self.pg0, 200),
+            VppDot1ADSubint(self, self.pg0, 300, 300, 400)]
+
+        self.interfaces = list(self.pg_interfaces)
+        self.interfaces.extend(self.sub_interfaces)
+        for i in self.interfaces:
+            i.admin_up()
+            i.config_ip4()
+            i.resolve_arp()
+
+    def tearDown(self):
+        for i in self.interfaces:
+            i.unconfig_ip4()
+            i.admin_down()
+        for i in self.sub_interfaces:
+            i.remove_vpp_config()
+        super(TestIPVlanMixed, self).tearDown()
+
+    def create_packet(self, src_if, n):
+        p = (Ether(src=self.pg0.remote_mac, dst=self.pg0.local_mac) /
+             IP(src=src_if.remote_ip4, dst=self.pg1.remote_ip4, id=n) /
+             UDP(sport=1234, dport=1234) /
+             Raw('\xa5' * 100))
+        if isinstance(src_if, VppSubInterface):
+            p = src_if.add_dot1_layer(p)
+        return p
+
+    def test_ip_vlan_mixed(self):
+        """ IP VLAN mixed frames """
+
+        #
+        # Frames all from one interface, then a frame with untagged,
+        # single and double tagged packets of each interface interleaved
+        # with packets of a VLAN with no subinterface, which are dropped.
+        #
+        for src_if in self.interfaces:
+            if src_if is self.pg1:
+                continue
+            pkts = [self.create_packet(src_if, n) for n in range(65)]
+            self.send_and_expect(self.pg0, pkts, self.pg1)
+
+        srcs = [self.pg0] + self.sub_interfaces
+        unknown = (Ether(src=self.pg0.remote_mac, dst=self.pg0.local_mac) /
+                   Dot1Q(vlan=999) /
+                   IP(src=self.pg0.remote_ip4, dst=self.pg1.remote_ip4) /
+                   UDP(sport=1234, dport=1234) /
+                   Raw('\xa5' * 100))
+        self.pg0.add_stream(unknown * 65)
+        self.pg_enable_capture(self.pg_interfaces)
+        self.pg_start()
+        self.pg1.assert_nothing_captured()
+
+        pkts = []
+        for n in range(65):
+            pkts.append(self.create_packet(srcs[n % len(srcs)], n))
+            pkts.append(unknown)
+
+        self.pg0.add_stream(pkts)
+        self.pg_enable_capture(self.pg_interfaces)
+        self.pg_start()
+        rx = self.pg1.get_capture(65)
+        for n, p in enumerate(rx):
+            self.assertEqual(p[IP].id, n)
+            self.assertEqual(p[IP].src, srcs[n % len(srcs)].remote_ip4)
+
+
+class TestIPFlowCache(VppTestCase):
+    """ IP flow cache """
+
+    def setUp(self):
+        super(TestIPFlowCache, self).setUp()
+
+        self.create_pg_interfaces(range(3))
+
+        for i in self.pg_interfaces:
+            i.admin_up()
+            i.config_ip4()
+            i.resolve_arp()
+            i.config_ip6()
+            i.disable_ipv6_ra()
+            i.resolve_ndp()
+
+        self.vapi.cli("set interface ip flow-cache pg0")
+
+    def tearDown(self):
+        self.vapi.cli("set interface ip flow-cache pg0 disable")
+        for i in self.pg_interfaces:
+            i.unconfig_ip4()
+            i.unconfig_ip6()
+            i.admin_down()
+        super(TestIPFlowCache, self).tearDown()
+
+    def get_hits(self):
+        # "hits <n>, misses <n>"
+        for line in self.vapi.cli("show ip flow-cache").splitlines():
+            if line.startswith("hits"):
+                return int(line.replace(",", "").split()[1])
+        return 0
+
+    def create_stream(self):
+        return (Ether(src=self.pg0.remote_mac,
+                      dst=self.pg0.local_mac) /
+                IP(dst="10.0.0.1", src=self.pg0.remote_ip4) /
+                UDP(sport=1234, dport=1234) /
+                Raw('\xa5' * 100)) * 65
+
+    def create_dst_table(self):
+        # match on the IPv4 destination, from the IP header on
+        mask = ('00' * 16 + 'ffffffff').ljust(64, '0')
+        r = self.vapi.classify_add_del_table(1, binascii.unhexlify(mask),
+                                             match_n_vectors=2,
+                                             current_data_flag=1)
+        return r.new_table_index
+
+    def delete_table(self, table_index):
+        self.vapi.classify_add_del_table(0, '\x00' * 32,
+                                         match_n_vectors=2,
+                                         table_index=table_index)
+
+    def add_del_dst_session(self, table_index, dst, is_add=1, **kwargs):
+        match = ('00' * 16 + socket.inet_aton(dst).encode('hex')).ljust(
+            64, '0')
+        self.vapi.classify_add_del_session(is_add, table_index,
+                                           binascii.unhexlify(match),
+                                           **kwargs)
+
+    def cache_route(self):
+        route = VppIpRoute(self, "10.0.0.1", 32,
+                           [VppRoutePath(self.pg1.remote_ip4,
+                                         self.pg1.sw_if_index)])
+        route.add_vpp_config()
+        return route
+
+    def test_ip_flow_cache(self):
+        """ IP flow cache """
+
+        pkts = self.create_stream()
+
+        route = VppIpRoute(self, "10.0.0.1", 32,
+                           [VppRoutePath(self.pg1.remote_ip4,
+                                         self.pg1.sw_if_index)])
+        route.add_vpp_config()
+
+        #
+        # The first packet learns the flow, the following hit the cache
+        # and are forwarded just the same.
+        #
+        hits = self.get_hits()
+        self.send_and_expect(self.pg0, pkts, self.pg1)
+        self.send_and_expect(self.pg0, pkts, self.pg1)
+        self.assertGreater(self.get_hits(), hits)
+
+        #
+        # A change of route invalidates the cached flow
+        #
+        route.remove_vpp_config()
+        route = VppIpRoute(self, "10.0.0.1", 32,
+                           [VppRoutePath(self.pg2.remote_ip4,
+                                         self.pg2.sw_if_index)])
+        route.add_vpp_config()
+        self.send_and_expect(self.pg0, pkts, self.pg2)
+
+        route.remove_vpp_config()
+        self.send_and_assert_no_replies(self.pg0, pkts)
+
+    def test_ip6_flow_cache(self):
+        """ IPv6 flow cache """
+
+        pkts = (Ether(src=self.pg0.remote_mac,
+                      dst=self.pg0.local_mac) /
+                IPv6(dst="2001::1", src=self.pg0.remote_ip6) /
+                UDP(sport=1234, dport=1234) /
+                Raw('\xa5' * 100)) * 65
+
+        route = VppIpRoute(self, "2001::1", 128,
+                           [VppRoutePath(self.pg1.remote_ip6,
+                                         self.pg1.sw_if_index,
+                                         proto=DpoProto.DPO_PROTO_IP6)],
+                           is_ip6=1)
+        route.add_vpp_config()
+
+        hits = self.get_hits()
+        self.send_and_expect(self.pg0, pkts, self.pg1)
+        self.send_and_expect(self.pg0, pkts, self.pg1)
+        self.assertGreater(self.get_hits(), hits)
+
+        route.remove_vpp_config()
+        route = VppIpRoute(self, "2001::1", 128,
+                           [VppRoutePath(self.pg2.remote_ip6,
+                                         self.pg2.sw_if_index,
+                                         proto=DpoProto.DPO_PROTO_IP6)],
+                           is_ip6=1)
+        route.add_vpp_config()
+        self.send_and_expect(self.pg0, pkts, self.pg2)
+        route.remove_vpp_config()
+
+    def send_and_expect_either(self, pkts, outputs):
+        # the flow takes any one of the paths, none is captured on others
+        self.pg0.add_stream(pkts)
+        self.pg_enable_capture(self.pg_interfaces)
+        self.pg_start()
+        self.assertEqual(sum(len(oo._get_capture(1) or [])
+                             for oo in outputs), len(pkts))
+
+    def get_resilient_active(self, prefix):
+        # "resilient active:<n> was-active:<n>"
+        fib = self.vapi.cli("show ip fib %s" % prefix)
+        m = re.search(r"resilient active:(\d+) was-active:(\d+)", fib)
+        self.assertIsNotNone(m)
+        return int(m.group(1)) + int(m.group(2))
+
+    def test_ip_flow_cache_resilient(self):
+        """ IP flow cache with resilient load-balancing """
+
+        self.vapi.cli("set load-balance resilient buckets 64 age 1")
+
+        pkts = self.create_stream()
+        route = VppIpRoute(self, "10.0.0.1", 32,
+                           [VppRoutePath(self.pg1.remote_ip4,
+                                         self.pg1.sw_if_index),
+                            VppRoutePath(self.pg2.remote_ip4,
+                                         self.pg2.sw_if_index)])
+        route.add_vpp_config()
+
+        self.send_and_expect_either(pkts, [self.pg1, self.pg2])
+
+        #
+        # let the buckets age, then only cache hits mark the flow's
+        # bucket active again
+        #
+        self.sleep(2.5)
+        self.assertEqual(self.get_resilient_active("10.0.0.1/32"), 0)
+
+        hits = self.get_hits()
+        self.send_and_expect_either(pkts, [self.pg1, self.pg2])
+        self.assertEqual(self.get_hits(), hits + len(pkts))
+        self.assertGreater(self.get_resilient_active("10.0.0.1/32"), 0)
+
+        route.remove_vpp_config()
+        self.vapi.cli("set load-balance resilient disable age 30")
+
+    def test_ip_flow_cache_feature(self):
+        """ IP flow cache invalidated by a feature enable """
+
+        pkts = self.create_stream()
+        route = self.cache_route()
+        table_index = self.create_dst_table()
+        self.add_del_dst_session(table_index, "10.0.0.1", hit_next_index=0)
+
+        hits = self.get_hits()
+        self.send_and_expect(self.pg0, pkts, self.pg1)
+        self.send_and_expect(self.pg0, pkts, self.pg1)
+        self.assertGreater(self.get_hits(), hits)
+
+        #
+        # The input ACL denying the flow now sees its packets
+        #
+        self.vapi.input_acl_set_interface(1, self.pg0.sw_if_index,
+                                          ip4_table_index=table_index)
+        self.send_and_assert_no_replies(self.pg0, pkts)
+
+        self.vapi.input_acl_set_interface(0, self.pg0.sw_if_index,
+                                          ip4_table_index=table_index)
+        self.send_and_expect(self.pg0, pkts, self.pg1)
+
+        self.add_del_dst_session(table_index, "10.0.0.1", is_add=0)
+        self.delete_table(table_index)
+        route.remove_vpp_config()
+
+    def test_ip_flow_cache_session(self):
+        """ IP flow cache invalidated by a classify session add """
+
+        pkts = self.create_stream()
+        route = self.cache_route()
+        table_index = self.create_dst_table()
+        self.vapi.input_acl_set_interface(1, self.pg0.sw_if_index,
+                                          ip4_table_index=table_index)
+
+        #
+        # The flow misses the input ACL and is cached
+        #
+        hits = self.get_hits()
+        self.send_and_expect(self.pg0, pkts, self.pg1)
+        self.send_and_expect(self.pg0, pkts, self.pg1)
+        self.assertGreater(self.get_hits(), hits)
+
+        self.add_del_dst_session(table_index, "10.0.0.1", hit_next_index=0)
+        self.send_and_assert_no_replies(self.pg0, pkts)
+
+        self.add_del_dst_session(table_index, "10.0.0.1", is_add=0)
+        self.send_and_expect(self.pg0, pkts, self.pg1)
+
+        self.vapi.input_acl_set_interface(0, self.pg0.sw_if_index,
+                                          ip4_table_index=table_index)
+        self.delete_table(table_index)
+        route.remove_vpp_config()
+
+    def test_ip_flow_cache_moved(self):
+        """ IP flow cache does not cache flows moved to another table """
+
+        pkts = self.create_stream()
+        route = self.cache_route()
+
+        table = VppIpTable(self, 1)
+        table.add_vpp_config()
+        route1 = VppIpRoute(self, "10.0.0.1", 32,
+                            [VppRoutePath(self.pg2.remote_ip4,
+                                          self.pg2.sw_if_index)],
+                            table_id=1)
+        route1.add_vpp_config()
+
+        #
+        # The input ACL moves the flow to table 1
+        #
+        table_index = self.create_dst_table()
+        self.add_del_dst_session(table_index, "10.0.0.1",
+                                 action=1, metadata=1)
+        self.vapi.input_acl_set_interface(1, self.pg0.sw_if_index,
+                                          ip4_table_index=table_index)
+
+        hits = self.get_hits()
+        self.send_and_expect(self.pg0, pkts, self.pg2)
+        self.send_and_expect(self.pg0, pkts, self.pg2)
+        self.assertEqual(self.get_hits(), hits)
+
+        self.vapi.input_acl_set_interface(0, self.pg0.sw_if_index,
+                                          ip4_table_index=table_index)
+        self.add_del_dst_session(table_index, "10.0.0.1", is_add=0)
+        self.delete_table(table_index)
+        route1.remove_vpp_config()
+        table.remove_vpp_config()
+        route.remove_vpp_config()
+
+    def test_ip_flow_cache_policer(self):
+        """ IP flow cache skips interfaces with policer classification """
+
+        pkts = self.create_stream()
+        route = self.cache_route()
+        table_index = self.create_dst_table()
+
+        self.vapi.cli("set policer classify interface pg0 ip4-table %d" %
+                      table_index)
+        hits = self.get_hits()
+        self.send_and_expect(self.pg0, pkts, self.pg1)
+        self.send_and_expect(self.pg0, pkts, self.pg1)
+        self.assertEqual(self.get_hits(), hits)
+
+        self.vapi.cli("set policer classify interface pg0 ip4-table %d del" %
+                      table_index)
+        self.send_and_expect(self.pg0, pkts, self.pg1)
+        self.send_and_expect(self.pg0, pkts, self.pg1)
+        self.assertGreater(self.get_hits(), hits)
+
+        self.delete_table(table_index)
+        route.remove_vpp_config()
+
+
 class TestIPPunt(VppTestCase):
     """ IPv4 Punt Police/Redirect """
 
@@ -1392,5 +1935,33 @@ class TestIPInput(VppTestCase):
         # Reset MTU for subsequent tests
         self.vapi.sw_interface_set_mtu(self.pg1.sw_if_index, [9000, 0, 0, 0])
 
+    def test_ip_input_mixed(self):
+        """ IP Input Exceptions mixed with good packets """
+
+        #
+        # headers are checked four at a time; one bad header in a
+        # group must not cost the others
+        #
+        def pkt(**kwargs):
+            return (Ether(src=self.pg0.remote_mac,
+                          dst=self.pg0.local_mac) /
+                    IP(src=self.pg0.remote_ip4,
+                       dst=self.pg1.remote_ip4, **kwargs) /
+                    UDP(sport=1234, dport=1234) /
+                    Raw('\xa5' * 100))
+
+        bad = [pkt(len=400), pkt(chksum=400), pkt(version=3),
+               pkt(frag=1), pkt(ttl=0)]
+        pkts = []
+        for i in range(65):
+            pkts.append(pkt(id=i))
+            if i % 3 == 0:
+                pkts.append(bad[i % len(bad)])
+
+        rx = self.send_and_expect(self.pg0, pkts, self.pg1)
+        self.assertEqual(len(rx), 65)
+        for i, p in enumerate(rx):
+            self.assertEqual(p[IP].id, i)
+
 if __name__ == '__main__':
     unittest.main(testRunner=VppTestRunner)
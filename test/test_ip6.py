@@ -366,6 +366,88 @@ class TestIPv6(TestIPv6ND):
             pkts = i.parent.get_capture()
             self.verify_capture(i, pkts)
 
+    def test_fib_mtrie(self):
+        """ IPv6 FIB mtrie lookup
+
+        Test scenario:
+            - Switch the default table's lookup to the mtrie
+            - Add overlapping routes of assorted lengths via pg1 and pg2
+            - Remove and re-add some, so the table's mtrie is refilled
+              from the covers and then overwritten again
+            - After each step check forwarding to addresses in each
+              prefix, and the table's mtrie against the hash
+        """
+        self.vapi.cli("set ip6 fib-lookup table 0 mtrie")
+        self.assertIn("lookup:mtrie", self.vapi.cli("show ip6 fib summary"))
+
+        def route(prefix, length, itf):
+            return VppIpRoute(self, prefix, length,
+                              [VppRoutePath(itf.remote_ip6,
+                                            itf.sw_if_index,
+                                            proto=DpoProto.DPO_PROTO_IP6)],
+                              is_ip6=1)
+
+        def check(expected):
+            reply = self.vapi.cli("test ip6 fib lookup table 0 "
+                                  "lookups 1000")
+            self.assertNotIn("disagrees", reply)
+
+            for (dst, itf) in expected:
+                pkts = [(Ether(src=self.pg0.remote_mac,
+                               dst=self.pg0.local_mac) /
+                         IPv6(src=self.pg0.remote_ip6, dst=dst) /
+                         UDP(sport=1234, dport=1234) /
+                         Raw('\xa5' * 100))]
+                if itf:
+                    rx = self.send_and_expect(self.pg0, pkts, itf)
+                    self.assertEqual(rx[0][IPv6].dst, dst)
+                else:
+                    self.send_and_assert_no_replies(self.pg0, pkts)
+
+        r32 = route("2001:db8::", 32, self.pg1)
+        r33 = route("2001:db8:8000::", 33, self.pg2)
+        r48 = route("2001:db8:1::", 48, self.pg2)
+        r64 = route("2001:db8:1:2::", 64, self.pg1)
+        r128 = route("2001:db8:1:2::5", 128, self.pg2)
+        for r in [r32, r33, r48, r64, r128]:
+            r.add_vpp_config()
+
+        in_32 = "2001:db8:2::1"
+        in_33 = "2001:db8:8000::1"
+        in_48 = "2001:db8:1:3::1"
+        in_64 = "2001:db8:1:2::6"
+        in_128 = "2001:db8:1:2::5"
+        outside = "2001:db9::1"
+
+        check([(in_32, self.pg1), (in_33, self.pg2), (in_48, self.pg2),
+               (in_64, self.pg1), (in_128, self.pg2), (outside, None)])
+
+        # remove prefixes covered by others: their slots go to the cover
+        r48.remove_vpp_config()
+        r128.remove_vpp_config()
+        check([(in_48, self.pg1), (in_64, self.pg1), (in_128, self.pg1)])
+
+        # remove the /64 whose cover is now the /32
+        r64.remove_vpp_config()
+        check([(in_64, self.pg1), (in_128, self.pg1)])
+
+        # more specifics back over the refilled slots
+        r64 = route("2001:db8:1:2::", 64, self.pg2)
+        r64.add_vpp_config()
+        r128.add_vpp_config()
+        check([(in_48, self.pg1), (in_64, self.pg2), (in_128, self.pg2)])
+
+        # removing the /32 leaves its more specifics in place
+        r32.remove_vpp_config()
+        check([(in_32, None), (in_48, None), (in_33, self.pg2),
+               (in_64, self.pg2), (in_128, self.pg2)])
+
+        for r in [r33, r64, r128]:
+            r.remove_vpp_config()
+        check([(in_33, None), (in_64, None), (in_128, None)])
+
+        self.vapi.cli("set ip6 fib-lookup table 0 hash")
+
     def test_ns(self):
         """ IPv6 Neighbour Solicitation Exceptions
 
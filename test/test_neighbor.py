@@ -1312,6 +1312,57 @@ class ARPTestCase(VppTestCase):
                                   self.pg1.sw_if_index,
                                   self.pg1.remote_hosts[2].ip4))
 
+    def test_arp_age(self):
+        """ ARP aging """
+
+        self.pg1.generate_remote_hosts(4)
+
+        #
+        # learn hosts 1 and 2 from their ARP requests to us, and add
+        # a static entry for host 3
+        #
+        pkts = [(Ether(dst="ff:ff:ff:ff:ff:ff", src=host.mac) /
+                 ARP(op="who-has",
+                     hwsrc=host.mac,
+                     pdst=self.pg1.local_ip4,
+                     psrc=host.ip4))
+                for host in self.pg1.remote_hosts[1:3]]
+        self.pg1.add_stream(pkts)
+        self.pg_enable_capture(self.pg_interfaces)
+        self.pg_start()
+        self.pg1.get_capture(2)
+
+        static_arp = VppNeighbor(self,
+                                 self.pg1.sw_if_index,
+                                 self.pg1.remote_hosts[3].mac,
+                                 self.pg1.remote_hosts[3].ip4,
+                                 is_static=1)
+        static_arp.add_vpp_config()
+
+        for host in self.pg1.remote_hosts[1:3]:
+            self.assertTrue(find_nbr(self,
+                                     self.pg1.sw_if_index,
+                                     host.ip4))
+        self.logger.info(self.vapi.cli("show ip arp summary"))
+
+        #
+        # with aging on the learned entries go, the static one stays
+        #
+        self.vapi.cli("set ip arp age 1")
+        self.sleep(3, "waiting for ARP entries to age")
+
+        for host in self.pg1.remote_hosts[1:3]:
+            self.assertFalse(find_nbr(self,
+                                      self.pg1.sw_if_index,
+                                      host.ip4))
+        self.assertTrue(find_nbr(self,
+                                 self.pg1.sw_if_index,
+                                 self.pg1.remote_hosts[3].ip4,
+                                 is_static=1))
+
+        self.vapi.cli("set ip arp age 0")
+        static_arp.remove_vpp_config()
+
 
 if __name__ == '__main__':
     unittest.main(testRunner=VppTestRunner)
@@ -0,0 +1,144 @@
+#!/usr/bin/env python
+"""Punt socket functional tests"""
+
+import os
+import socket
+import struct
+import unittest
+
+from scapy.packet import Raw
+from scapy.layers.l2 import Ether
+from scapy.layers.inet import IP, UDP
+
+from framework import VppTestCase, VppTestRunner
+
+# punt_packetdesc_t action
+PUNT_L2 = 0
+
+
+class TestPuntSocket(VppTestCase):
+    """ Punt Socket Test Case """
+
+    port = 1111
+
+    @classmethod
+    def setUpConstants(cls):
+        cls.server_path = "%s/socket_punt" % cls.tempdir
+        cls.extra_vpp_punt_config = ["punt", "{",
+                                     "socket", cls.server_path, "}"]
+        super(TestPuntSocket, cls).setUpConstants()
+
+    @classmethod
+    def setUpClass(cls):
+        super(TestPuntSocket, cls).setUpClass()
+        cls.create_pg_interfaces(range(1))
+
+    def setUp(self):
+        super(TestPuntSocket, self).setUp()
+        self.pg0.admin_up()
+        self.pg0.config_ip4()
+        self.pg0.resolve_arp()
+
+        self.client_path = "%s/socket_%d" % (self.tempdir, self.port)
+        if os.path.exists(self.client_path):
+            os.unlink(self.client_path)
+        self.client = socket.socket(socket.AF_UNIX, socket.SOCK_DGRAM)
+        self.client.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF,
+                               1024 * 1024)
+        self.client.bind(self.client_path)
+        self.vapi.punt_socket_register(self.port, self.client_path)
+
+    def tearDown(self):
+        super(TestPuntSocket, self).tearDown()
+        if not self.vpp_dead:
+            self.logger.info(self.vapi.cli("show punt socket"))
+            self.vapi.punt_socket_rate_limit(0, is_inject=1)
+            self.vapi.punt_socket_deregister(self.port)
+            self.pg0.unconfig_ip4()
+            self.pg0.admin_down()
+        self.client.close()
+
+    def receive_punted(self):
+        """ Read what was punted to the client, return the packets """
+        pkts = []
+        self.client.setblocking(0)
+        while True:
+            try:
+                data = self.client.recv(4096)
+            except socket.error:
+                break
+            # punt_packetdesc_t, then the packet
+            pkts.append(Ether(data[8:]))
+        return pkts
+
+    def get_punt_counters(self, prefix):
+        # "<prefix> <n>, rate limited <n>[, socket full <n>]"
+        for line in self.vapi.cli("show punt socket").splitlines():
+            line = line.strip()
+            if line.startswith(prefix):
+                f = line.replace(",", "").split()
+                return int(f[1]), int(f[4])
+        return 0, 0
+
+    def create_stream(self, n):
+        return [(Ether(src=self.pg0.remote_mac, dst=self.pg0.local_mac) /
+                 IP(src=self.pg0.remote_ip4, dst=self.pg0.local_ip4) /
+                 UDP(sport=1234, dport=self.port) /
+                 Raw(struct.pack("!I", i) + '\xa5' * 60))
+                for i in range(n)]
+
+    def test_punt_rate_limit(self):
+        """ Punt socket rate limit """
+        # a burst of 10 and so little rate that the stream cannot earn
+        # more than a token
+        self.vapi.punt_socket_rate_limit(1, 10, l4_port=self.port)
+        self.send_and_assert_no_replies(self.pg0, self.create_stream(30))
+
+        rx = self.receive_punted()
+        n_punted, n_limited = self.get_punt_counters("punted")
+        self.assertIn(len(rx), (10, 11))
+        self.assertEqual(n_punted, len(rx))
+        self.assertEqual(n_limited, 30 - len(rx))
+        for i, p in enumerate(rx):
+            self.assertEqual(p[UDP].dport, self.port)
+            self.assertEqual(struct.unpack("!I", p[Raw].load[:4])[0], i)
+
+        # without the limit all are punted
+        self.vapi.punt_socket_rate_limit(0, l4_port=self.port)
+        self.send_and_assert_no_replies(self.pg0, self.create_stream(30))
+        self.assertEqual(len(self.receive_punted()), 30)
+        self.assertEqual(self.get_punt_counters("punted"),
+                         (n_punted + 30, n_limited))
+
+    def test_inject_rate_limit(self):
+        """ Punt socket inject rate limit """
+        self.vapi.punt_socket_rate_limit(1, 5, is_inject=1)
+
+        desc = struct.pack("=II", self.pg0.sw_if_index, PUNT_L2)
+        pkts = [(Ether(src=self.pg0.local_mac, dst=self.pg0.remote_mac) /
+                 IP(src=self.pg0.local_ip4, dst=self.pg0.remote_ip4) /
+                 UDP(sport=self.port, dport=1234) /
+                 Raw(struct.pack("!I", i) + '\xa5' * 60))
+                for i in range(20)]
+
+        self.pg_enable_capture(self.pg_interfaces)
+        for p in pkts:
+            self.client.sendto(desc + str(p), self.server_path)
+
+        # the socket is read asynchronously, wait for all to be counted.
+        # as with the punt limit, the stream may earn one more token
+        for _ in range(20):
+            n_injected, n_limited = self.get_punt_counters("injected")
+            if n_injected + n_limited == 20:
+                break
+            self.sleep(.1)
+        self.assertIn(n_injected, (5, 6))
+        self.assertEqual(n_limited, 20 - n_injected)
+
+        rx = self.pg0.get_capture(n_injected)
+        for i, p in enumerate(rx):
+            self.assertEqual(struct.unpack("!I", p[Raw].load[:4])[0], i)
+
+
+if __name__ == '__main__':
+    unittest.main(testRunner=VppTestRunner)
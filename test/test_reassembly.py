@@ -1,4 +1,5 @@
 #!/usr/bin/env python
+import re
 import unittest
 from random import shuffle
 
@@ -352,6 +353,180 @@ class TestIPv4Reassembly(VppTestCase):
         self.src_if.assert_nothing_captured()
 
 
+class TestIPv4SVReassembly(VppTestCase):
+    """ IPv4 Shallow Virtual Reassembly """
+
+    @classmethod
+    def setUpClass(cls):
+        super(TestIPv4SVReassembly, cls).setUpClass()
+
+        cls.create_pg_interfaces([0, 1])
+        cls.src_if = cls.pg0
+        cls.dst_if = cls.pg1
+
+        # setup all interfaces
+        for i in cls.pg_interfaces:
+            i.admin_up()
+            i.config_ip4()
+            i.resolve_arp()
+
+    def setUp(self):
+        """ Test setup - force timeout on existing reassemblies """
+        super(TestIPv4SVReassembly, self).setUp()
+        self.vapi.cli("set interface ip4-sv-reassembly %s" %
+                      self.src_if.name)
+        self.vapi.cli("set ip4-sv-reassembly timeout 0 "
+                      "expire-walk-interval 10")
+        self.sleep(.25)
+        self.vapi.cli("set ip4-sv-reassembly timeout 1000000 "
+                      "max-reassembly-length 3 expire-walk-interval 10000")
+
+    def tearDown(self):
+        super(TestIPv4SVReassembly, self).tearDown()
+        self.logger.debug(self.vapi.ppcli("show ip4-sv-reassembly details"))
+        self.vapi.cli("set interface ip4-sv-reassembly %s disable" %
+                      self.src_if.name)
+
+    def create_fragments(self, count, size, fragment_size, sport=None,
+                         dport=5678, first_id=0):
+        """ fragments of count UDP packets, a list per packet """
+        packets = []
+        for i in range(count):
+            p = (Ether(dst=self.src_if.local_mac,
+                       src=self.src_if.remote_mac) /
+                 IP(id=first_id + i, src=self.src_if.remote_ip4,
+                    dst=self.dst_if.remote_ip4) /
+                 UDP(sport=sport + i if sport else 1234, dport=dport) /
+                 Raw('x' * size))
+            packets.append(fragment_rfc791(p, fragment_size))
+        return packets
+
+    def verify_fragments(self, capture, fragments):
+        """ the fragments are forwarded as they are, not reassembled """
+        sent = sorted((f[IP].id, f[IP].frag, len(f[IP].payload))
+                      for f in fragments)
+        received = sorted((p[IP].id, p[IP].frag, len(p[IP].payload))
+                          for p in capture)
+        self.assertEqual(sent, received)
+
+    def test_in_order(self):
+        """ fragments in order """
+
+        fragments = [f for frags in self.create_fragments(16, 1000, 400)
+                     for f in frags]
+
+        self.pg_enable_capture()
+        self.src_if.add_stream(fragments)
+        self.pg_start()
+
+        packets = self.dst_if.get_capture(len(fragments))
+        self.verify_fragments(packets, fragments)
+        self.src_if.assert_nothing_captured()
+
+    def test_reversed(self):
+        """ fragments in reverse order are held until the first """
+
+        fragments = [f for frags in self.create_fragments(16, 1000, 400)
+                     for f in reversed(frags)]
+
+        self.pg_enable_capture()
+        self.src_if.add_stream(fragments)
+        self.pg_start()
+
+        packets = self.dst_if.get_capture(len(fragments))
+        self.verify_fragments(packets, fragments)
+        self.src_if.assert_nothing_captured()
+
+    def test_annotations(self):
+        """ fragments are annotated with their packet's L4 info """
+
+        # a packet's fragments, in order and reversed, and a packet
+        # that is not fragmented
+        frags = self.create_fragments(4, 1000, 400, sport=1000)
+        fragments = frags[0] + frags[1] + list(reversed(frags[2])) + \
+            list(reversed(frags[3]))
+        whole = (Ether(dst=self.src_if.local_mac,
+                       src=self.src_if.remote_mac) /
+                 IP(id=100, src=self.src_if.remote_ip4,
+                    dst=self.dst_if.remote_ip4) /
+                 UDP(sport=1111, dport=2222) /
+                 Raw('x' * 100))
+
+        self.vapi.cli("clear trace")
+        self.pg_enable_capture()
+        self.src_if.add_stream(fragments + [whole])
+        self.pg_start()
+        self.dst_if.get_capture(len(fragments) + 1)
+
+        trace = self.vapi.cli("show trace max 50")
+        forwarded = re.findall(r"\[forwarded\] reass id: \d+, "
+                               r"(first|non-first) fragment "
+                               r"proto: (\S+), src port: (\d+), "
+                               r"dst port: (\d+)", trace)
+        expected = []
+        for i, f in enumerate(frags):
+            expected.append(("first", "udp", str(1000 + i), "5678"))
+            expected.extend([("non-first", "udp", str(1000 + i), "5678")] *
+                            (len(f) - 1))
+        self.assertEqual(sorted(forwarded), sorted(expected))
+        self.assertIn("[not-fragmented] proto: udp, src port: 1111, "
+                      "dst port: 2222", trace)
+
+    def udp_rule(self, is_permit, dport_first=0, dport_last=65535):
+        return {'is_permit': is_permit, 'is_ipv6': 0, 'proto': 17,
+                'srcport_or_icmptype_first': 0,
+                'srcport_or_icmptype_last': 65535,
+                'src_ip_prefix_len': 0, 'src_ip_addr': '\x00' * 4,
+                'dstport_or_icmpcode_first': dport_first,
+                'dstport_or_icmpcode_last': dport_last,
+                'dst_ip_prefix_len': 0, 'dst_ip_addr': '\x00' * 4}
+
+    def test_acl(self):
+        """ ACL plugin matches non-first fragments on their ports """
+
+        # a non-first fragment without its ports would match the first
+        # UDP rule, the deny, whatever its packet's destination port
+        rules = [self.udp_rule(0, 9999, 9999), self.udp_rule(1)]
+        reply = self.vapi.acl_add_replace(acl_index=0xffffffff, r=rules)
+        self.vapi.acl_interface_set_acl_list(
+            sw_if_index=self.src_if.sw_if_index, n_input=1,
+            acls=[reply.acl_index])
+
+        permitted = [f for frags in self.create_fragments(4, 1000, 400)
+                     for f in frags]
+        denied = [f for frags in self.create_fragments(4, 1000, 400,
+                                                       dport=9999,
+                                                       first_id=100)
+                  for f in reversed(frags)]
+
+        self.pg_enable_capture()
+        self.src_if.add_stream(permitted + denied)
+        self.pg_start()
+
+        packets = self.dst_if.get_capture(len(permitted))
+        self.verify_fragments(packets, permitted)
+
+        self.vapi.acl_interface_set_acl_list(
+            sw_if_index=self.src_if.sw_if_index, n_input=0, acls=[])
+        self.vapi.acl_del(reply.acl_index)
+
+    def test_too_many_fragments(self):
+        """ fragments beyond the cache length are dropped """
+
+        # 6 fragments per packet; without the first, the first 3 are
+        # cached and the 4th drops them all
+        fragments = [f for frags in self.create_fragments(16, 2000, 400)
+                     for f in reversed(frags[1:5])]
+
+        self.pg_enable_capture()
+        self.src_if.add_stream(fragments)
+        self.pg_start()
+
+        self.dst_if.assert_nothing_captured()
+        self.assertIn("too many fragments before first",
+                      self.vapi.ppcli("show error"))
+
+
 class TestIPv6Reassembly(VppTestCase):
     """ IPv6 Reassembly """
 
@@ -22,6 +22,7 @@ if do_import:
 # from vnet/vnet/mpls/mpls_types.h
 MPLS_IETF_MAX_LABEL = 0xfffff
 MPLS_LABEL_INVALID = MPLS_IETF_MAX_LABEL + 1
+VNET_API_ERROR_EAGAIN = -150
 
 
 class L2_VTR_OP:
@@ -208,14 +209,18 @@ class VppPapiProvider(object):
         """ """
         return self.api(self.papi.show_version, {})
 
-    def pg_create_interface(self, pg_index):
+    def pg_create_interface(self, pg_index, gso_enabled=0, gso_size=0):
         """
 
         :param pg_index:
+        :param gso_enabled: generate TCP packets as GSO packets
+        :param gso_size: the segment payload size of those packets
 
         """
         return self.api(self.papi.pg_create_interface,
-                        {"interface_id": pg_index})
+                        {"interface_id": pg_index,
+                         "gso_enabled": gso_enabled,
+                         "gso_size": gso_size})
 
     def sw_interface_dump(self, filter=None):
         """
@@ -229,6 +234,43 @@ class VppPapiProvider(object):
             args = {}
         return self.api(self.papi.sw_interface_dump, args)
 
+    def api_paged(self, api_fn, api_args, page_size=0):
+        """ Read all entries of a paged (cursor based) dump
+
+        :param api_fn: the '_get' API function
+        :param api_args: the request's arguments, less the cursor
+        :param page_size: entries per request, 0 for as many as VPP will
+                          send in one go (Default value = 0)
+        :returns: (details, the number of requests made)
+        """
+        details = []
+        n_pages = 0
+        args = dict(api_args)
+        args['cursor'] = 0
+        args['max_entries'] = page_size
+        while True:
+            reply, page = self.api(api_fn, args)
+            n_pages += 1
+            details.extend(page)
+            if reply.retval not in (0, VNET_API_ERROR_EAGAIN):
+                raise UnexpectedApiReturnValueError(
+                    "%s failed with %d" % (api_fn.__name__, reply.retval))
+            if reply.cursor == 0xffffffff:
+                return details, n_pages
+            args['cursor'] = reply.cursor
+
+    def sw_interface_get(self, filter=None, page_size=0):
+        """ Read all interfaces, page_size at a time
+
+        :param filter:  (Default value = None)
+        :param page_size:  (Default value = 0)
+        """
+        if filter is not None:
+            args = {"name_filter_valid": 1, "name_filter": filter}
+        else:
+            args = {}
+        return self.api_paged(self.papi.sw_interface_get, args, page_size)
+
     def sw_interface_set_table(self, sw_if_index, is_ipv6, table_id):
         """ Set the IPvX Table-id for the Interface
 
@@ -944,12 +986,36 @@ class VppPapiProvider(object):
              'next_hop_via_label': next_hop_via_label,
              'next_hop_out_label_stack': next_hop_out_label_stack})
 
+    def ip_route_add_del_bulk(self, routes, table_id=0, is_add=1,
+                              is_ipv6=0):
+        """ Add / del many routes in one request
+
+        :param routes: list of dicts with the dst_address,
+                       dst_address_length and (encoded) path of each route
+        :param table_id:  (Default value = 0)
+        :param is_add:  (Default value = 1)
+        :param is_ipv6:  (Default value = 0)
+        """
+        return self.api(
+            self.papi.ip_route_add_del_bulk,
+            {'table_id': table_id,
+             'is_add': is_add,
+             'is_ipv6': is_ipv6,
+             'n_routes': len(routes),
+             'routes': routes})
+
     def ip_fib_dump(self):
         return self.api(self.papi.ip_fib_dump, {})
 
     def ip6_fib_dump(self):
         return self.api(self.papi.ip6_fib_dump, {})
 
+    def ip_fib_get(self, page_size=0):
+        return self.api_paged(self.papi.ip_fib_get, {}, page_size)
+
+    def ip6_fib_get(self, page_size=0):
+        return self.api_paged(self.papi.ip6_fib_get, {}, page_size)
+
     def ip_neighbor_add_del(self,
                             sw_if_index,
                             mac_address,
@@ -1561,6 +1627,24 @@ class VppPapiProvider(object):
             {'ip_address': ip_address,
              'vrf_id': vrf_id})
 
+    def nat44_user_session_get(
+            self,
+            ip_address,
+            vrf_id,
+            page_size=0):
+        """Read all of a NAT44 user's sessions, page_size at a time
+
+        :param ip_address: ip adress of the user to be dumped
+        :param vrf_id: VRF ID
+        :param page_size: (Default value = 0)
+        :return: (S-NAT sessions, number of requests made)
+        """
+        return self.api_paged(
+            self.papi.nat44_user_session_get,
+            {'ip_address': ip_address,
+             'vrf_id': vrf_id},
+            page_size)
+
     def nat44_user_dump(self):
         """Dump NAT44 users
 
@@ -2882,6 +2966,9 @@ class VppPapiProvider(object):
                         {'acl_index': acl_index},
                         expected_retval=expected_retval)
 
+    def acl_get(self, page_size=0):
+        return self.api_paged(self.papi.acl_get, {}, page_size)
+
     def acl_interface_list_dump(self, sw_if_index=0xFFFFFFFF,
                                 expected_retval=0):
         return self.api(self.papi.acl_interface_list_dump,
@@ -3309,6 +3396,24 @@ class VppPapiProvider(object):
                          'pathname': pathname,
                          'header_version': header_version})
 
+    def punt_socket_deregister(self, l4_port, is_ip4=1, l4_protocol=0x11):
+        """ Stop punting to socket """
+        return self.api(self.papi.punt_socket_deregister,
+                        {'is_ip4': is_ip4,
+                         'l4_protocol': l4_protocol,
+                         'l4_port': l4_port})
+
+    def punt_socket_rate_limit(self, rate, burst=0, is_inject=0,
+                               l4_port=0, is_ip4=1, l4_protocol=0x11):
+        """ Rate limit the punt socket """
+        return self.api(self.papi.punt_socket_rate_limit,
+                        {'is_inject': is_inject,
+                         'is_ip4': is_ip4,
+                         'l4_protocol': l4_protocol,
+                         'l4_port': l4_port,
+                         'rate': rate,
+                         'burst': burst})
+
     def ip_reassembly_set(self, timeout_ms, max_reassemblies,
                           expire_walk_interval_ms, is_ip6=0):
         """ Set IP reassembly parameters """
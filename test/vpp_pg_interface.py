@@ -82,11 +82,13 @@ class VppPGInterface(VppInterface):
         self._out_history_counter += 1
         return v
 
-    def __init__(self, test, pg_index):
-        """ Create VPP packet-generator interface """
+    def __init__(self, test, pg_index, gso_size=0):
+        """ Create VPP packet-generator interface, generating TCP packets
+        as GSO packets of gso_size segments if gso_size is given """
         super(VppPGInterface, self).__init__(test)
 
-        r = test.vapi.pg_create_interface(pg_index)
+        r = test.vapi.pg_create_interface(pg_index, 1 if gso_size else 0,
+                                          gso_size)
         self.set_sw_if_index(r.sw_if_index)
 
         self._in_history_counter = 0